@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace mb = mir::benchmark;
+
+namespace
+{
+void usage(char const* program)
+{
+    std::cerr << "Usage: " << program
+              << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]"
+                 " [--benchmark_format=console|csv]" << std::endl;
+}
+
+bool parse(int argc, char const* argv[], mb::Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const arg{argv[i]};
+        auto const value = [&](char const* option) -> char const*
+            {
+                auto const length = std::strlen(option);
+                return arg.compare(0, length, option) == 0 ? argv[i] + length : nullptr;
+            };
+
+        if (auto const v = value("--benchmark_filter="))
+            options.filter = std::regex{v};
+        else if (auto const v = value("--benchmark_min_time="))
+            options.measured_time = std::chrono::duration<double>{std::strtod(v, nullptr)};
+        else if (auto const v = value("--benchmark_format="))
+            options.csv = std::string{v} == "csv";
+        else
+            return false;
+    }
+
+    return true;
+}
+}
+
+int mb::main(int argc, char const* argv[], char const* name, std::function<void(Options const&)> const& benchmark)
+try
+{
+    Options options;
+
+    if (!parse(argc, argv, options))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    benchmark(options);
+
+    return EXIT_SUCCESS;
+}
+catch (std::exception const& error)
+{
+    std::cerr << name << " benchmark failed: " << error.what() << std::endl;
+    return EXIT_FAILURE;
+}
+
+mb::ResultTable::ResultTable(std::ostream& out, Options const& options, int name_width, std::vector<Column> columns) :
+    out(out),
+    csv{options.csv},
+    name_width{name_width},
+    columns{std::move(columns)}
+{
+    if (csv)
+    {
+        out << "name";
+        for (auto const& column : this->columns)
+            out << ',' << column.csv_name;
+        out << std::endl;
+    }
+    else
+    {
+        auto width = name_width;
+        out << std::left << std::setw(name_width) << "Configuration" << std::right;
+        for (auto const& column : this->columns)
+        {
+            out << std::setw(column.width) << column.heading;
+            width += column.width;
+        }
+        out << "\n" << std::string(width, '-') << std::endl;
+    }
+}
+
+void mb::ResultTable::print_row(std::string const& name, std::initializer_list<double> values)
+{
+    if (values.size() != columns.size())
+        throw std::logic_error{"Result row for " + name + " doesn't match the table's columns"};
+
+    auto column = columns.begin();
+
+    if (csv)
+    {
+        out << name;
+        for (auto const value : values)
+            out << ',' << value;
+    }
+    else
+    {
+        out << std::left << std::setw(name_width) << name << std::right << std::fixed;
+        for (auto const value : values)
+        {
+            out << std::setprecision(column->precision) << std::setw(column->width) << value;
+            ++column;
+        }
+    }
+
+    out << std::endl;
+}
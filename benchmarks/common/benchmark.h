@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MIR_BENCHMARK_BENCHMARK_H_
+#define MIR_BENCHMARK_BENCHMARK_H_
+
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <iosfwd>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace benchmark
+{
+/// The options the benchmarks share, named after Google Benchmark's so scripts can drive either
+struct Options
+{
+    std::regex filter{".*"};                            ///< --benchmark_filter=<regex>
+    std::chrono::duration<double> measured_time{2.0};   ///< --benchmark_min_time=<seconds>
+    bool csv{false};                                    ///< --benchmark_format=console|csv
+};
+
+/**
+ * Runs \a benchmark with the options given on the command line, and returns
+ * the exit status for main(). Bad options print the usage, and exceptions are
+ * reported as "<name> benchmark failed".
+ */
+int main(int argc, char const* argv[], char const* name, std::function<void(Options const&)> const& benchmark);
+
+/// Prints one row per configuration, either as an aligned table or as CSV
+class ResultTable
+{
+public:
+    struct Column
+    {
+        char const* heading;    ///< As shown in the console table
+        char const* csv_name;
+        int width;
+        int precision;
+    };
+
+    ResultTable(std::ostream& out, Options const& options, int name_width, std::vector<Column> columns);
+
+    void print_row(std::string const& name, std::initializer_list<double> values);
+
+private:
+    std::ostream& out;
+    bool const csv;
+    int const name_width;
+    std::vector<Column> const columns;
+};
+}
+}
+
+#endif // MIR_BENCHMARK_BENCHMARK_H_
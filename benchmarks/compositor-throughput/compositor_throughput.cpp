@@ -0,0 +1,416 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Drives the real SurfaceStack and MultiThreadedCompositor against a
+ * headless display so compositor overheads can be tracked on machines
+ * without a GPU. Each configuration builds a scene programmatically, runs
+ * it with client threads submitting buffers as fast as they can, and
+ * reports per configuration:
+ *
+ *   frames/s       composited frames per second, per output
+ *   allocs/frame   heap allocations on the compositing threads per frame
+ *   waits/frame    voluntary context switches on the compositing threads
+ *                  per frame; each is a block on a contended lock or an
+ *                  idle wait for a client buffer
+ *   submit(us)     mean time a client spends in submit_buffer(), which
+ *                  grows with contention on stream and scene locks
+ *
+ * Takes the options in benchmarks/common/benchmark.h.
+ */
+
+#include "src/server/report/null_report_factory.h"
+#include "src/server/scene/surface_stack.h"
+#include "src/server/scene/basic_surface.h"
+#include "src/server/compositor/multi_threaded_compositor.h"
+#include "src/server/compositor/stream.h"
+
+#include "mir/compositor/display_buffer_compositor.h"
+#include "mir/compositor/display_buffer_compositor_factory.h"
+#include "mir/compositor/display_listener.h"
+#include "mir/compositor/scene_element.h"
+#include "mir/geometry/rectangle.h"
+#include "mir/scene/surface_creation_parameters.h"
+
+#include "benchmarks/common/benchmark.h"
+#include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "mir/test/allocation_counter.h"
+#include "mir/test/doubles/null_display.h"
+#include "mir/test/doubles/null_display_sync_group.h"
+#include "mir/test/doubles/stub_buffer.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mb = mir::benchmark;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace mr = mir::report;
+namespace ms = mir::scene;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+namespace mtf = mir_test_framework;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+
+namespace
+{
+struct Configuration
+{
+    char const* name;
+    unsigned surfaces;
+    unsigned streams_per_surface;
+    bool overlapping;
+    unsigned translucent_percent;
+    unsigned outputs;
+    unsigned clients;
+};
+
+Configuration const configurations[] = {
+    // name                        surfaces streams overlap alpha% outputs clients
+    {"1_surface",                        1,      1,  false,     0,      1,      1},
+    {"16_tiled",                        16,      1,  false,     0,      1,      4},
+    {"16_overlapping_opaque",           16,      1,   true,     0,      1,      4},
+    {"16_overlapping_alpha50",          16,      1,   true,    50,      1,      4},
+    {"16_overlapping_alpha100",         16,      1,   true,   100,      1,      4},
+    {"16_overlapping_4_streams",        16,      4,   true,    50,      1,      4},
+    {"64_overlapping_alpha50",          64,      1,   true,    50,      1,      8},
+    {"64_overlapping_2_outputs",        64,      1,   true,    50,      2,      8},
+    {"256_overlapping_alpha50",        256,      1,   true,    50,      1,      8},
+};
+
+geom::Size const output_size{1920, 1080};
+int const buffers_per_stream{3};
+
+struct CompositorCounters
+{
+    std::atomic<std::uint64_t> frames{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> waits{0};
+};
+
+struct Sample
+{
+    std::uint64_t frames{0};
+    std::uint64_t allocations{0};
+    std::uint64_t waits{0};
+    std::uint64_t submits{0};
+    nanoseconds submit_time{0};
+};
+
+/*
+ * Wraps the headless compositor to account for the compositing thread.
+ * AllocationCounter and RUSAGE_THREAD are both per calling thread, so they
+ * are sampled from inside composite() and published through atomics.
+ */
+class MeasuringCompositor : public mc::DisplayBufferCompositor
+{
+public:
+    MeasuringCompositor(
+        std::unique_ptr<mc::DisplayBufferCompositor> wrapped,
+        std::shared_ptr<CompositorCounters> const& counters) :
+        wrapped{std::move(wrapped)},
+        counters{counters}
+    {
+    }
+
+    void composite(mc::SceneElementSequence&& scene_sequence) override
+    {
+        if (!allocation_counter)
+            allocation_counter = std::make_unique<mt::AllocationCounter>();
+
+        wrapped->composite(std::move(scene_sequence));
+
+        rusage usage;
+        getrusage(RUSAGE_THREAD, &usage);
+
+        counters->allocations.store(allocation_counter->count(), std::memory_order_relaxed);
+        counters->waits.store(usage.ru_nvcsw, std::memory_order_relaxed);
+        counters->frames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    std::unique_ptr<mc::DisplayBufferCompositor> const wrapped;
+    std::shared_ptr<CompositorCounters> const counters;
+    std::unique_ptr<mt::AllocationCounter> allocation_counter;
+};
+
+class MeasuringCompositorFactory : public mc::DisplayBufferCompositorFactory
+{
+public:
+    std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(mg::DisplayBuffer& display_buffer) override
+    {
+        auto const counters = std::make_shared<CompositorCounters>();
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            all_counters.push_back(counters);
+        }
+        return std::make_unique<MeasuringCompositor>(headless.create_compositor_for(display_buffer), counters);
+    }
+
+    void add_to(Sample& sample) const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        for (auto const& counters : all_counters)
+        {
+            sample.frames += counters->frames.load(std::memory_order_relaxed);
+            sample.allocations += counters->allocations.load(std::memory_order_relaxed);
+            sample.waits += counters->waits.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    mtf::HeadlessDisplayBufferCompositorFactory headless;
+    std::mutex mutable mutex;
+    std::vector<std::shared_ptr<CompositorCounters>> all_counters;
+};
+
+/*
+ * One sync group, and so one compositing thread, per output, with the
+ * outputs laid out left to right.
+ */
+class HeadlessDisplay : public mtd::NullDisplay
+{
+public:
+    explicit HeadlessDisplay(unsigned outputs)
+    {
+        for (unsigned i = 0; i != outputs; ++i)
+        {
+            geom::Rectangle const area{{i * output_size.width.as_int(), 0}, output_size};
+            groups.push_back(std::make_unique<mtd::StubDisplaySyncGroup>(std::vector<geom::Rectangle>{area}));
+        }
+    }
+
+    void for_each_display_sync_group(std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        for (auto& group : groups)
+            f(*group);
+    }
+
+private:
+    std::vector<std::unique_ptr<mtd::StubDisplaySyncGroup>> groups;
+};
+
+struct NullDisplayListener : mc::DisplayListener
+{
+    void add_display(geom::Rectangle const&) override {}
+    void remove_display(geom::Rectangle const&) override {}
+};
+
+struct ClientStream
+{
+    std::shared_ptr<mc::Stream> stream;
+    std::vector<std::shared_ptr<mg::Buffer>> buffers;
+};
+
+geom::Rectangle surface_area(Configuration const& config, unsigned index)
+{
+    auto const desktop_width = output_size.width.as_int() * static_cast<int>(config.outputs);
+    auto const desktop_height = output_size.height.as_int();
+
+    if (config.overlapping)
+    {
+        // Cascade windows of a third of the output, wrapping across the desktop
+        geom::Size const size{output_size.width.as_int() / 3, output_size.height.as_int() / 3};
+        int const step{24};
+        auto const columns = std::max(1, (desktop_width - size.width.as_int()) / step);
+        auto const rows = std::max(1, (desktop_height - size.height.as_int()) / step);
+        auto const column = static_cast<int>(index) % columns;
+        auto const row = (static_cast<int>(index) + static_cast<int>(index) / columns) % rows;
+        return {{column * step, row * step}, size};
+    }
+
+    // Tile the desktop with a square-ish grid of non-overlapping windows
+    int tiles_across{1};
+    while (tiles_across * tiles_across < static_cast<int>(config.surfaces))
+        ++tiles_across;
+    geom::Size const size{desktop_width / tiles_across, desktop_height / tiles_across};
+    auto const column = static_cast<int>(index) % tiles_across;
+    auto const row = static_cast<int>(index) / tiles_across;
+    return {{column * size.width.as_int(), row * size.height.as_int()}, size};
+}
+
+Sample run(Configuration const& config, duration<double> measured_time)
+{
+    auto const scene_report = mr::null_scene_report();
+    auto const stack = std::make_shared<ms::SurfaceStack>(scene_report);
+    ms::SurfaceCreationParameters const params;
+
+    std::vector<ClientStream> client_streams;
+    std::vector<std::shared_ptr<ms::BasicSurface>> surfaces;
+
+    for (unsigned i = 0; i != config.surfaces; ++i)
+    {
+        auto const area = surface_area(config, i);
+        geom::Size const stream_size{
+            area.size.width.as_int() / static_cast<int>(config.streams_per_surface),
+            area.size.height.as_int()};
+
+        std::list<ms::StreamInfo> streams;
+        for (unsigned j = 0; j != config.streams_per_surface; ++j)
+        {
+            ClientStream client_stream{std::make_shared<mc::Stream>(stream_size, mir_pixel_format_abgr_8888), {}};
+            client_stream.stream->allow_framedropping(true);
+            for (int k = 0; k != buffers_per_stream; ++k)
+                client_stream.buffers.push_back(std::make_shared<mtd::StubBuffer>(stream_size));
+
+            geom::Displacement const offset{static_cast<int>(j) * stream_size.width.as_int(), 0};
+            streams.push_back({client_stream.stream, offset, stream_size});
+            client_streams.push_back(std::move(client_stream));
+        }
+
+        auto const surface = std::make_shared<ms::BasicSurface>(
+            "benchmark", area, mir_pointer_unconfined, streams, nullptr, scene_report);
+
+        // Spread the translucent surfaces evenly through the stack
+        if (i * config.translucent_percent / 100 != (i + 1) * config.translucent_percent / 100)
+            surface->set_alpha(0.5f);
+
+        // Give every stream something to composite before the clock starts
+        for (auto const& info : streams)
+            info.stream->submit_buffer(std::make_shared<mtd::StubBuffer>(stream_size));
+
+        stack->add_surface(surface, params.input_mode);
+        surfaces.push_back(surface);
+    }
+
+    auto const factory = std::make_shared<MeasuringCompositorFactory>();
+    mc::MultiThreadedCompositor compositor{
+        std::make_shared<HeadlessDisplay>(config.outputs),
+        stack,
+        factory,
+        std::make_shared<NullDisplayListener>(),
+        mr::null_compositor_report(),
+        milliseconds{0},    // No vblank to wait for: composite as fast as possible
+        true};
+
+    struct ClientCounters
+    {
+        std::atomic<std::uint64_t> submits{0};
+        std::atomic<std::int64_t> submit_ns{0};
+    };
+    std::vector<ClientCounters> client_counters(config.clients);
+    std::atomic<bool> running{true};
+
+    compositor.start();
+
+    std::vector<std::thread> clients;
+    for (unsigned c = 0; c != config.clients; ++c)
+    {
+        clients.emplace_back(
+            [&, c]
+            {
+                auto& counters = client_counters[c];
+                unsigned frame{0};
+                while (running.load(std::memory_order_relaxed))
+                {
+                    for (auto i = c; i < client_streams.size(); i += config.clients)
+                    {
+                        auto const& client_stream = client_streams[i];
+                        auto const& buffer = client_stream.buffers[frame % client_stream.buffers.size()];
+
+                        auto const start = steady_clock::now();
+                        client_stream.stream->submit_buffer(buffer);
+                        auto const elapsed = steady_clock::now() - start;
+
+                        counters.submit_ns.fetch_add(
+                            duration_cast<nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+                        counters.submits.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    ++frame;
+                    std::this_thread::yield();
+                }
+            });
+    }
+
+    auto const sample = [&]
+        {
+            Sample result;
+            factory->add_to(result);
+            for (auto const& counters : client_counters)
+            {
+                result.submits += counters.submits.load(std::memory_order_relaxed);
+                result.submit_time += nanoseconds{counters.submit_ns.load(std::memory_order_relaxed)};
+            }
+            return result;
+        };
+
+    // Let the compositing threads create their compositors and settle
+    std::this_thread::sleep_for(milliseconds{250});
+
+    auto const before = sample();
+    std::this_thread::sleep_for(measured_time);
+    auto const after = sample();
+
+    running = false;
+    for (auto& client : clients)
+        client.join();
+    compositor.stop();
+
+    Sample delta;
+    delta.frames = after.frames - before.frames;
+    delta.allocations = after.allocations - before.allocations;
+    delta.waits = after.waits - before.waits;
+    delta.submits = after.submits - before.submits;
+    delta.submit_time = after.submit_time - before.submit_time;
+    return delta;
+}
+
+double per(double total, std::uint64_t count)
+{
+    return count ? total / count : 0.0;
+}
+
+}
+
+int main(int argc, char const* argv[])
+{
+    return mb::main(argc, argv, "compositor throughput", [](mb::Options const& options)
+        {
+            mb::ResultTable table{std::cout, options, 32, {
+                {"frames/s",     "frames_per_second",     12, 1},
+                {"allocs/frame", "allocations_per_frame", 15, 1},
+                {"waits/frame",  "waits_per_frame",       14, 2},
+                {"submit(us)",   "submit_us",             13, 2}}};
+
+            for (auto const& config : configurations)
+            {
+                if (!std::regex_search(config.name, options.filter))
+                    continue;
+
+                auto const result = run(config, options.measured_time);
+
+                table.print_row(config.name, {
+                    result.frames / options.measured_time.count() / config.outputs,
+                    per(result.allocations, result.frames),
+                    per(result.waits, result.frames),
+                    per(duration<double, std::micro>{result.submit_time}.count(), result.submits)});
+            }
+        });
+}
@@ -24,6 +24,7 @@
 #include <cmath>
 
 #include <chrono>
+#include <fstream>
 #include <iostream>
 
 #include <gtest/gtest.h>
@@ -53,14 +54,15 @@ geom::Point interpolated_touch_at_time(geom::Point touch_start, geom::Point touc
 double pixel_lag_for_sample_at_time(geom::Point touch_start_point, geom::Point touch_end_point,
     std::chrono::high_resolution_clock::time_point touch_start_time,
     std::chrono::high_resolution_clock::time_point touch_end_time,
-    TouchSamples::Sample const& sample)
+    TouchSamples::Sample const& sample,
+    bool predicted = false)
 {
     auto expected_point = interpolated_touch_at_time(touch_start_point, touch_end_point, touch_start_time,
         touch_end_time, sample.frame_time);
 
     geom::Displacement const displacement{
-        sample.x - expected_point.x.as_int(),
-        sample.y - expected_point.y.as_int()};
+        (predicted ? sample.predicted_x : sample.x) - expected_point.x.as_int(),
+        (predicted ? sample.predicted_y : sample.y) - expected_point.y.as_int()};
 
     return std::sqrt(displacement.length_squared());
 }
@@ -68,13 +70,14 @@ double pixel_lag_for_sample_at_time(geom::Point touch_start_point, geom::Point t
 double compute_average_frame_offset(std::vector<TouchSamples::Sample> const& results,
     geom::Point touch_start_point, geom::Point touch_end_point,
     std::chrono::high_resolution_clock::time_point touch_start_time,
-    std::chrono::high_resolution_clock::time_point touch_end_time)
+    std::chrono::high_resolution_clock::time_point touch_end_time,
+    bool predicted = false)
 {
     double sum = 0;
     for (auto const& sample : results)
     {
         auto distance = pixel_lag_for_sample_at_time(touch_start_point, touch_end_point, touch_start_time, 
-            touch_end_time, sample);
+            touch_end_time, sample, predicted);
         sum += distance;
     }
     return sum / results.size();
@@ -84,8 +87,54 @@ struct Results
 {
     double average_pixel_offset;
     double frame_uniformity;
+    double average_predicted_pixel_offset;
 };
 
+struct FrameTiming
+{
+    double average_latency_ms;
+    double frame_interval_jitter_ms;
+};
+
+/*
+ * Latency is measured from an event leaving the input device to the first
+ * frame submitted after it was received. Jitter is the standard deviation
+ * of the interval between frames.
+ */
+FrameTiming compute_frame_timing(std::vector<TouchSamples::Sample> const& results)
+{
+    using ms = std::chrono::duration<double, std::milli>;
+
+    if (results.empty())
+        return {0, 0};
+
+    double latency_sum = 0;
+    for (auto const& sample : results)
+        latency_sum += ms(sample.frame_time - sample.event_time).count();
+
+    std::vector<double> intervals;
+    for (auto i = 1u; i < results.size(); ++i)
+    {
+        if (results[i].frame_time != results[i-1].frame_time)
+            intervals.push_back(ms(results[i].frame_time - results[i-1].frame_time).count());
+    }
+
+    double jitter = 0;
+    if (!intervals.empty())
+    {
+        double mean = 0;
+        for (auto interval : intervals)
+            mean += interval;
+        mean /= intervals.size();
+
+        for (auto interval : intervals)
+            jitter += (interval - mean)*(interval - mean);
+        jitter = std::sqrt(jitter/intervals.size());
+    }
+
+    return {latency_sum / results.size(), jitter};
+}
+
 Results compute_frame_uniformity(std::vector<TouchSamples::Sample> const& results,
     geom::Point touch_start_point, geom::Point touch_end_point,
     std::chrono::high_resolution_clock::time_point touch_start_time,
@@ -102,7 +151,11 @@ Results compute_frame_uniformity(std::vector<TouchSamples::Sample> const& result
         sum += (distance-average_pixel_offset)*(distance-average_pixel_offset);
     }
     double uniformity = std::sqrt(sum/results.size());
-    return {average_pixel_offset, uniformity};
+
+    auto average_predicted_pixel_offset = compute_average_frame_offset(results, touch_start_point, touch_end_point,
+        touch_start_time, touch_end_time, true);
+
+    return {average_pixel_offset, uniformity, average_predicted_pixel_offset};
 }
 
 }
@@ -117,12 +170,16 @@ TEST(FrameUniformity, average_frame_offset)
     std::chrono::milliseconds touch_duration{1000};
     
     int const run_count = 1;
-    double average_lag = 0, average_uniformity = 0;
+    double average_lag = 0, average_uniformity = 0, average_predicted_lag = 0;
+    double average_latency = 0, average_jitter = 0;
 
     // Ensure we load the correct platform libraries
     setenv("MIR_CLIENT_PLATFORM_PATH",
            (mtf::library_path() + "/client-modules").c_str(),
            true);
+
+    // Have the server attach predicted positions so we can see how much lag they hide
+    setenv("MIR_SERVER_INPUT_PREDICTION", "true", true);
     
     for (int i = 0; i < run_count; i++)
     {
@@ -135,17 +192,34 @@ TEST(FrameUniformity, average_frame_offset)
         auto touch_end_time = touch_timings.touch_end;
         auto samples = t.client_results()->get();
 
+        if (auto const trace_path = getenv("MIR_FRAME_UNIFORMITY_TRACE"))
+        {
+            std::ofstream trace{trace_path};
+            TouchSamples::write_trace(trace, samples);
+        }
+
         auto results = compute_frame_uniformity(samples, touch_start_point, touch_end_point,
             touch_start_time, touch_end_time);
         
         average_lag += results.average_pixel_offset;
         average_uniformity += results.frame_uniformity;
+        average_predicted_lag += results.average_predicted_pixel_offset;
+
+        auto const timing = compute_frame_timing(samples);
+        average_latency += timing.average_latency_ms;
+        average_jitter += timing.frame_interval_jitter_ms;
     }
     
     average_lag /= run_count;
     average_uniformity /= run_count;
+    average_predicted_lag /= run_count;
+    average_latency /= run_count;
+    average_jitter /= run_count;
     
     std::cout << "Average pixel lag: " << average_lag << "px" << std::endl;
+    std::cout << "Average pixel lag of predicted positions: " << average_predicted_lag << "px" << std::endl;
     std::cout << "Frame Uniformity (smaller scores are more uniform): " << average_uniformity << "px per sample\n"
         << std::endl;
+    std::cout << "Average input-to-frame latency: " << average_latency << "ms" << std::endl;
+    std::cout << "Frame interval jitter: " << average_jitter << "ms\n" << std::endl;
 }
@@ -18,6 +18,9 @@
 
 #include "touch_samples.h"
 
+#include <istream>
+#include <ostream>
+
 void TouchSamples::record_frame_time(std::chrono::high_resolution_clock::time_point time)
 {
     std::unique_lock<std::mutex> lg(guard);
@@ -52,11 +55,45 @@ void TouchSamples::record_pointer_coordinates(std::chrono::high_resolution_clock
     }
     auto x = mir_touch_event_axis_value(tev, 0, mir_touch_axis_x);
     auto y = mir_touch_event_axis_value(tev, 0, mir_touch_axis_y);
+    auto predicted_x = mir_touch_event_axis_value(tev, 0, mir_touch_axis_predicted_x);
+    auto predicted_y = mir_touch_event_axis_value(tev, 0, mir_touch_axis_predicted_y);
     // TODO: Record both event time and reception time
-    samples_being_prepared.push_back(Sample{x, y, reception_time, {}});
+    samples_being_prepared.push_back(Sample{x, y, predicted_x, predicted_y, reception_time, {}});
 }
 
 std::vector<TouchSamples::Sample> TouchSamples::get()
 {
     return completed_samples;
 }
+
+void TouchSamples::write_trace(std::ostream& out, std::vector<Sample> const& samples)
+{
+    using std::chrono::nanoseconds;
+
+    for (auto const& sample : samples)
+    {
+        out << nanoseconds{sample.event_time.time_since_epoch()}.count() << ' '
+            << nanoseconds{sample.frame_time.time_since_epoch()}.count() << ' '
+            << sample.x << ' ' << sample.y << ' '
+            << sample.predicted_x << ' ' << sample.predicted_y << '\n';
+    }
+}
+
+std::vector<TouchSamples::Sample> TouchSamples::read_trace(std::istream& in)
+{
+    using time_point = std::chrono::high_resolution_clock::time_point;
+    using std::chrono::nanoseconds;
+
+    std::vector<Sample> samples;
+    nanoseconds::rep event_time, frame_time;
+    Sample sample;
+
+    while (in >> event_time >> frame_time >> sample.x >> sample.y >> sample.predicted_x >> sample.predicted_y)
+    {
+        sample.event_time = time_point{std::chrono::duration_cast<time_point::duration>(nanoseconds{event_time})};
+        sample.frame_time = time_point{std::chrono::duration_cast<time_point::duration>(nanoseconds{frame_time})};
+        samples.push_back(sample);
+    }
+
+    return samples;
+}
@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <chrono>
+#include <iosfwd>
 #include <mutex>
 
 #include <mir_toolkit/event.h>
@@ -36,6 +37,9 @@ public:
     {
         // Coordinates of the touch
         float x,y;
+        // Where the server predicted the touch would be on screen (x,y if
+        // input prediction is off)
+        float predicted_x, predicted_y;
         // Time at which the event left the input device
         std::chrono::high_resolution_clock::time_point event_time;
         // Submission time of first frame after receipt of event, e.g.
@@ -43,6 +47,13 @@ public:
         std::chrono::high_resolution_clock::time_point frame_time;
     };
     std::vector<Sample> get();
+
+    // A trace is one sample per line: event time and frame time (in
+    // nanoseconds since the clock's epoch), x, y, predicted x, predicted y.
+    // Traces written by the benchmark can be replayed elsewhere, e.g. through
+    // the server's motion predictor.
+    static void write_trace(std::ostream& out, std::vector<Sample> const& samples);
+    static std::vector<Sample> read_trace(std::istream& in);
         
     void record_frame_time(std::chrono::high_resolution_clock::time_point time);
     void record_pointer_coordinates(std::chrono::high_resolution_clock::time_point reception_time,
@@ -18,6 +18,7 @@
 
 #include "vsync_simulating_graphics_platform.h"
 
+#include "mir/graphics/atomic_frame.h"
 #include "mir/graphics/platform_ipc_operations.h"
 #include "mir/graphics/platform_ipc_package.h"
 
@@ -59,18 +60,27 @@ struct StubDisplaySyncGroup : mg::DisplaySyncGroup
             std::this_thread::sleep_for(next_sync - now);
         
         last_sync = now;
+
+        // Report the simulated vblank so the compositor can schedule against it
+        last_frame.increment_now();
     }
 
     std::chrono::milliseconds recommended_sleep() const override
     {
         return std::chrono::milliseconds::zero();
     }
+
+    bool variable_refresh_active() const override
+    {
+        return false;
+    }
     
     double const vsync_rate_in_hz;
 
     std::chrono::high_resolution_clock::time_point last_sync;
 
     mtd::StubDisplayBuffer buffer;
+    mg::AtomicFrame last_frame;
 };
 
 struct StubDisplay : public mtd::StubDisplay
@@ -86,6 +96,11 @@ struct StubDisplay : public mtd::StubDisplay
         exec(group);
     }
 
+    mg::Frame last_frame_on(unsigned) const override
+    {
+        return group.last_frame.load();
+    }
+
     StubDisplaySyncGroup group;
 };
 
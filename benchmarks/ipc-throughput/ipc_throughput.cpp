@@ -0,0 +1,418 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Measures the client/server protocol path: MirProtobufRpcChannel on the
+ * client, and SocketMessenger, ProtobufMessageProcessor and SessionMediator
+ * on the server. An in-process headless server is started, and K synthetic
+ * clients connect to it over its Unix socket, each with a window, and issue
+ * a weighted mix of requests back to back. Reported per configuration:
+ *
+ *   rpcs/s         completed requests per second, over all clients
+ *   p99(us)        99th percentile round trip, over all request types
+ *   ~syscalls/msg  socket calls per message, client and server together;
+ *                  an estimate, as they are counted where Mir calls the socket
+ *                  and a Boost.Asio read or write can take more than one call
+ *   copied/msg     message bytes copied after serialization, per message
+ *   events/s       event messages the server sent per second, including
+ *                  the buffers it hands back to clients
+ *
+ * submit_buffer is issued through mir_buffer_stream_swap_buffers_sync(), so
+ * its round trip includes waiting for a buffer back; the other requests are
+ * made directly on the connection's DisplayServer and timed until their
+ * completion runs. The event flood configuration has the server push input
+ * configuration events to every session while the clients make requests.
+ *
+ * Takes the options in benchmarks/common/benchmark.h.
+ */
+
+#include "benchmarks/common/benchmark.h"
+#include "mir_test_framework/async_server_runner.h"
+#include "mir_test_framework/any_surface.h"
+#include "mir_test_framework/executable_path.h"
+#include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "mir/test/signal.h"
+
+#include "src/client/mir_connection.h"
+#include "src/client/rpc/mir_display_server.h"
+
+#include "mir/input/mir_input_config.h"
+#include "mir/scene/null_session_listener.h"
+#include "mir/scene/session.h"
+#include "mir/time/latency_histogram.h"
+#include "mir/trace/transport_counters.h"
+
+#include "mir_toolkit/mir_client_library.h"
+#include "mir_toolkit/debug/surface.h"
+
+#include "mir_protobuf.pb.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mb = mir::benchmark;
+namespace mp = mir::protobuf;
+namespace ms = mir::scene;
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+namespace mtr = mir::trace;
+
+using namespace std::chrono;
+
+namespace
+{
+enum class Rpc
+{
+    submit_buffer,
+    modify_surface,
+    pong,
+    configure_display
+};
+
+struct Weighted
+{
+    Rpc rpc;
+    unsigned weight;
+};
+
+struct Configuration
+{
+    char const* name;
+    unsigned clients;
+    std::vector<Weighted> mix;
+    bool event_flood;
+};
+
+std::vector<Configuration> const configurations{
+    {"pong_1_client",                1, {{Rpc::pong, 1}}, false},
+    {"pong_8_clients",               8, {{Rpc::pong, 1}}, false},
+    {"modify_surface_8_clients",     8, {{Rpc::modify_surface, 1}}, false},
+    {"submit_buffer_8_clients",      8, {{Rpc::submit_buffer, 1}}, false},
+    {"configure_display_4_clients",  4, {{Rpc::configure_display, 1}}, false},
+    {"mixed_8_clients",              8, {{Rpc::submit_buffer, 70}, {Rpc::modify_surface, 20}, {Rpc::pong, 10}}, false},
+    {"mixed_32_clients",            32, {{Rpc::submit_buffer, 70}, {Rpc::modify_surface, 20}, {Rpc::pong, 10}}, false},
+    {"event_flood_8_clients",        8, {{Rpc::pong, 1}}, true},
+};
+
+seconds const rpc_timeout{10};
+
+/// Keeps the sessions so the event flood can reach them
+class SessionTracker : public ms::NullSessionListener
+{
+public:
+    void starting(std::shared_ptr<ms::Session> const& session) override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        sessions.push_back(session);
+    }
+
+    void stopping(std::shared_ptr<ms::Session> const& session) override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        sessions.erase(std::remove(sessions.begin(), sessions.end(), session), sessions.end());
+    }
+
+    std::vector<std::shared_ptr<ms::Session>> current() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return sessions;
+    }
+
+private:
+    std::mutex mutable mutex;
+    std::vector<std::shared_ptr<ms::Session>> sessions;
+};
+
+class HeadlessServer : public mtf::AsyncServerRunner
+{
+public:
+    HeadlessServer()
+    {
+        add_to_environment("MIR_SERVER_PLATFORM_GRAPHICS_LIB", mtf::server_platform("graphics-dummy.so").c_str());
+        add_to_environment("MIR_SERVER_PLATFORM_INPUT_LIB", mtf::server_platform("input-stub.so").c_str());
+        add_to_environment("MIR_SERVER_ENABLE_KEY_REPEAT", "false");
+
+        server.override_the_display_buffer_compositor_factory(
+            [] { return std::make_shared<mtf::HeadlessDisplayBufferCompositorFactory>(); });
+        server.override_the_session_listener([this] { return session_tracker; });
+
+        start_server();
+    }
+
+    ~HeadlessServer()
+    {
+        stop_server();
+    }
+
+    std::shared_ptr<SessionTracker> const session_tracker{std::make_shared<SessionTracker>()};
+};
+
+class SyntheticClient
+{
+public:
+    SyntheticClient(std::string const& connect_string) :
+        connection{mir_connect_sync(connect_string.c_str(), "ipc-benchmark")}
+    {
+        if (!mir_connection_is_valid(connection))
+        {
+            auto const error = std::string{"Failed to connect: "} + mir_connection_get_error_message(connection);
+            mir_connection_release(connection);
+            BOOST_THROW_EXCEPTION(std::runtime_error{error});
+        }
+
+        window = mtf::make_any_surface(connection);
+        surface_id = mir_debug_window_id(window);
+        display_config = connection->snapshot_display_configuration();
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        stream = mir_window_get_buffer_stream(window);
+        // Don't throttle submissions to the (simulated) refresh rate
+        mir_wait_for(mir_buffer_stream_set_swapinterval(stream, 0));
+#pragma GCC diagnostic pop
+    }
+
+    ~SyntheticClient()
+    {
+        mir_window_release_sync(window);
+        mir_connection_release(connection);
+    }
+
+    nanoseconds call(Rpc rpc)
+    {
+        auto const start = steady_clock::now();
+
+        switch (rpc)
+        {
+        case Rpc::submit_buffer:
+            mir_buffer_stream_swap_buffers_sync(stream);
+            return steady_clock::now() - start;
+
+        case Rpc::modify_surface:
+        {
+            mp::SurfaceModifications modifications;
+            modifications.mutable_surface_id()->set_value(surface_id);
+            modifications.mutable_surface_specification()->set_name(++serial % 2 ? "odd" : "even");
+            connection->display_server().modify_surface(&modifications, &ignored, completion());
+            break;
+        }
+
+        case Rpc::pong:
+        {
+            mp::PingEvent ping;
+            ping.set_serial(++serial);
+            connection->display_server().pong(&ping, &ignored, completion());
+            break;
+        }
+
+        case Rpc::configure_display:
+            connection->display_server().configure_display(display_config.get(), &config_response, completion());
+            break;
+        }
+
+        if (!done.wait_for(rpc_timeout))
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Timed out waiting for a request to complete"});
+        return steady_clock::now() - start;
+    }
+
+private:
+    google::protobuf::Closure* completion()
+    {
+        done.reset();
+        return google::protobuf::NewCallback(&done, &mt::Signal::raise);
+    }
+
+    MirConnection* const connection;
+    MirWindow* window;
+    MirBufferStream* stream;
+    int surface_id;
+    std::unique_ptr<mp::DisplayConfiguration> display_config;
+
+    mt::Signal done;
+    mp::Void ignored;
+    mp::DisplayConfiguration config_response;
+    int32_t serial{0};
+};
+
+struct Totals
+{
+    uint64_t messages{0};
+    uint64_t syscalls{0};
+    uint64_t bytes_copied{0};
+    uint64_t events_sent{0};
+};
+
+Totals transport_totals()
+{
+    Totals totals;
+    for (auto side : {mtr::TransportSide::client, mtr::TransportSide::server})
+    {
+        auto const& counters = mtr::transport_counters(side);
+        totals.messages += counters.messages_sent.load(std::memory_order_relaxed);
+        totals.syscalls += counters.syscalls.load(std::memory_order_relaxed);
+        totals.bytes_copied += counters.bytes_copied.load(std::memory_order_relaxed);
+        totals.events_sent += counters.events_sent.load(std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+struct Result
+{
+    double rpcs_per_second;
+    nanoseconds p99;
+    double syscalls_per_message;
+    double bytes_copied_per_message;
+    double events_per_second;
+};
+
+Result run(HeadlessServer& server, Configuration const& config, duration<double> measured_time)
+{
+    std::vector<std::unique_ptr<SyntheticClient>> clients;
+    for (unsigned i = 0; i != config.clients; ++i)
+        clients.push_back(std::make_unique<SyntheticClient>(server.new_connection()));
+
+    unsigned total_weight{0};
+    for (auto const& weighted : config.mix)
+        total_weight += weighted.weight;
+
+    mir::time::LatencyHistogram round_trips;
+    std::atomic<uint64_t> completed{0};
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> running{true};
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i != config.clients; ++i)
+    {
+        threads.emplace_back(
+            [&, i]
+            {
+                std::minstd_rand random{i + 1};
+                std::uniform_int_distribution<unsigned> pick{0, total_weight - 1};
+
+                while (running.load(std::memory_order_relaxed))
+                {
+                    auto choice = pick(random);
+                    auto rpc = config.mix.front().rpc;
+                    for (auto const& weighted : config.mix)
+                    {
+                        if (choice < weighted.weight)
+                        {
+                            rpc = weighted.rpc;
+                            break;
+                        }
+                        choice -= weighted.weight;
+                    }
+
+                    auto const round_trip = clients[i]->call(rpc);
+
+                    if (measuring.load(std::memory_order_relaxed))
+                    {
+                        round_trips.record(round_trip);
+                        completed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+
+    std::thread flood;
+    if (config.event_flood)
+    {
+        flood = std::thread{
+            [&]
+            {
+                MirInputConfig const input_config;
+                while (running.load(std::memory_order_relaxed))
+                {
+                    for (auto const& session : server.session_tracker->current())
+                        session->send_input_config(input_config);
+                    std::this_thread::yield();
+                }
+            }};
+    }
+
+    // Let connections settle before measuring
+    std::this_thread::sleep_for(milliseconds{250});
+
+    auto const before = transport_totals();
+    measuring = true;
+    std::this_thread::sleep_for(measured_time);
+    measuring = false;
+    auto const after = transport_totals();
+    auto const rpcs = completed.load();
+
+    running = false;
+    for (auto& thread : threads)
+        thread.join();
+    if (flood.joinable())
+        flood.join();
+
+    clients.clear();
+
+    auto const messages = after.messages - before.messages;
+    auto const per_message = [messages](uint64_t total) { return messages ? double(total) / messages : 0.0; };
+
+    return {
+        rpcs / measured_time.count(),
+        round_trips.value_at_percentile(99),
+        per_message(after.syscalls - before.syscalls),
+        per_message(after.bytes_copied - before.bytes_copied),
+        (after.events_sent - before.events_sent) / measured_time.count()};
+}
+
+}
+
+int main(int argc, char const* argv[])
+{
+    return mb::main(argc, argv, "IPC", [](mb::Options const& options)
+        {
+            HeadlessServer server;
+
+            mb::ResultTable table{std::cout, options, 30, {
+                {"rpcs/s",            "rpcs_per_second",                    11, 0},
+                {"p99(us)",           "p99_us",                             10, 1},
+                {"~syscalls/msg",     "estimated_syscalls_per_message",     15, 2},
+                {"copied/msg",        "bytes_copied_per_message",           12, 1},
+                {"events/s",          "events_per_second",                  11, 0}}};
+
+            for (auto const& config : configurations)
+            {
+                if (!std::regex_search(config.name, options.filter))
+                    continue;
+
+                auto const result = run(server, config, options.measured_time);
+
+                table.print_row(config.name, {
+                    result.rpcs_per_second,
+                    duration<double, std::micro>{result.p99}.count(),
+                    result.syscalls_per_message,
+                    result.bytes_copied_per_message,
+                    result.events_per_second});
+            }
+        });
+}
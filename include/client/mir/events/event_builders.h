@@ -159,6 +159,13 @@ EventUPtr make_event(MirInputDeviceId device_id, std::chrono::nanoseconds timest
 
 EventUPtr clone_event(MirEvent const& event);
 void transform_positions(MirEvent& event, mir::geometry::Displacement const& movement);
+// Zeroes the relative motion and scroll axes of a pointer event
+void clear_relative_motion(MirEvent& event);
+// Folds a later pointer motion event into an earlier one
+void accumulate_motion(MirEvent& event, MirEvent const& later);
+// Attaches the position a pointer or touch is expected to be presented at
+void set_predicted_position(MirEvent& event, float x, float y);
+void set_predicted_position(MirEvent& event, size_t touch_index, float x, float y);
 void set_window_id(MirEvent& event, int window_id);
 
 EventUPtr make_start_drag_and_drop_event(frontend::SurfaceId const& surface_id, std::vector<uint8_t> const& handle);
@@ -69,7 +69,17 @@ typedef enum {
 /* Relative axis containing the last reported y differential from the pointer */
     mir_pointer_axis_relative_y = 5,
 
-    mir_pointer_axes
+    mir_pointer_axes,
+
+/* The axes below were added after mir_pointer_axes, so that it keeps the
+   value clients were built against */
+
+/* Absolute axis containing the x coordinate the pointer is predicted to have
+   when a frame drawn in response to this event is presented. The same as
+   mir_pointer_axis_x if the server made no prediction */
+    mir_pointer_axis_predicted_x = 7,
+/* Absolute axis containing the predicted y coordinate of the pointer */
+    mir_pointer_axis_predicted_y = 8
 } MirPointerAxis;
 
 /* 
@@ -73,7 +73,17 @@ typedef enum {
    point */
     mir_touch_axis_size = 5,
 
-    mir_touch_axes
+    mir_touch_axes,
+
+/* The axes below were added after mir_touch_axes, so that it keeps the
+   value clients were built against */
+
+/* Axis representing the x coordinate the touch is predicted to have when a
+   frame drawn in response to this event is presented. The same as
+   mir_touch_axis_x if the server made no prediction */
+    mir_touch_axis_predicted_x = 7,
+/* Axis representing the predicted y coordinate for the touch */
+    mir_touch_axis_predicted_y = 8
 } MirTouchAxis;
 
 /**
@@ -22,32 +22,130 @@
 #include "mir/fd.h"
 #include "mir/dispatch/dispatchable.h"
 
-#include <list>
-#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace mir
 {
 namespace dispatch
 {
 
+/**
+ * A queue of actions to be run on whichever thread dispatches it.
+ *
+ * Enqueueing is lock-free and may be done from any number of threads. The
+ * watch_fd() is only signalled when the queue goes from idle to having work
+ * pending, and a single dispatch() runs every action that was pending when it
+ * started. Queue nodes come from a per-queue pool of pool_size nodes, and
+ * actions whose captures fit in inline_capacity bytes are stored in the node
+ * itself, so steady-state enqueueing does not touch the heap.
+ *
+ * Concurrent dispatch() calls are serialised. An action must not dispatch()
+ * the queue that is running it.
+ */
 class ActionQueue : public Dispatchable
 {
 public:
     ActionQueue();
+    ~ActionQueue();
+
     Fd watch_fd() const override;
 
     void enqueue(std::function<void()> const& action);
 
+    template<typename Action>
+    void enqueue(Action&& action);
+
     bool dispatch(FdEvents events) override;
     FdEvents relevant_events() const override;
+
+    static std::size_t constexpr inline_capacity = 6 * sizeof(void*);
+    static std::size_t constexpr pool_size = 64;
+
 private:
+    ActionQueue(ActionQueue const&) = delete;
+    ActionQueue& operator=(ActionQueue const&) = delete;
+
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<std::uint32_t> next_free{0};
+        void (*invoke)(Node&){nullptr};
+        void (*destroy)(Node&){nullptr};
+        typename std::aligned_storage<inline_capacity, alignof(std::max_align_t)>::type storage;
+    };
+
+    template<typename Stored>
+    struct InlineAction
+    {
+        template<typename Action>
+        static void emplace(Node& node, Action&& action)
+        {
+            new (&node.storage) Stored(std::forward<Action>(action));
+            node.invoke = [](Node& n) { (*reinterpret_cast<Stored*>(&n.storage))(); };
+            node.destroy = [](Node& n) { reinterpret_cast<Stored*>(&n.storage)->~Stored(); };
+        }
+    };
+
+    template<typename Stored>
+    struct HeapAction
+    {
+        template<typename Action>
+        static void emplace(Node& node, Action&& action)
+        {
+            new (&node.storage) Stored*(new Stored(std::forward<Action>(action)));
+            node.invoke = [](Node& n) { (**reinterpret_cast<Stored**>(&n.storage))(); };
+            node.destroy = [](Node& n) { delete *reinterpret_cast<Stored**>(&n.storage); };
+        }
+    };
+
+    Node* allocate_node();
+    void release_node(Node* node);
+    void push(Node* node);
     bool consume();
     void wake();
+
     mir::Fd event_fd;
-    std::mutex list_lock;
-    std::list<std::function<void()>> actions;
+
+    std::unique_ptr<Node[]> const pool;
+    /// (generation << 32) | (1 + index) of the first free pool node, or 0 if none
+    std::atomic<std::uint64_t> free_nodes{0};
+
+    /// Producers link new nodes in at head; the dispatching thread consumes from tail
+    std::atomic<Node*> head;
+    Node* tail;
+    std::atomic<bool> wakeup_pending{false};
+    std::mutex dispatch_mutex;
 };
+
+template<typename Action>
+void ActionQueue::enqueue(Action&& action)
+{
+    using Stored = typename std::decay<Action>::type;
+    using Emplacer = typename std::conditional<
+        sizeof(Stored) <= inline_capacity && alignof(Stored) <= alignof(std::max_align_t),
+        InlineAction<Stored>,
+        HeapAction<Stored>>::type;
+
+    auto const node = allocate_node();
+    try
+    {
+        Emplacer::emplace(*node, std::forward<Action>(action));
+    }
+    catch (...)
+    {
+        release_node(node);
+        throw;
+    }
+    push(node);
+}
 }
 }
 
@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FNV1A_HASH_H_
+#define MIR_FNV1A_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace mir
+{
+/**
+ * 64-bit FNV-1a, for cache keys and file names that have to be the same in
+ * every process. It is cheap and well spread, but not collision resistant:
+ * callers that would misbehave on a collision must compare what they hashed.
+ */
+class Fnv1aHash
+{
+public:
+    void add(void const* data, size_t size)
+    {
+        for (auto byte = static_cast<unsigned char const*>(data); size--; ++byte)
+        {
+            hash ^= *byte;
+            hash *= prime;
+        }
+    }
+
+    /// Adds the bytes of \a value in host byte order
+    template<typename T>
+    void add(T const& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only the bytes of plain values can be hashed");
+        add(&value, sizeof value);
+    }
+
+    void add(std::string const& text)
+    {
+        add(text.data(), text.size());
+    }
+
+    uint64_t value() const
+    {
+        return hash;
+    }
+
+private:
+    static uint64_t constexpr offset_basis = 14695981039346656037ull;
+    static uint64_t constexpr prime = 1099511628211ull;
+
+    uint64_t hash{offset_basis};
+};
+}
+
+#endif // MIR_FNV1A_HASH_H_
@@ -19,6 +19,7 @@
 #ifndef MIR_LOGGING_LOGGER_H_
 #define MIR_LOGGING_LOGGER_H_
 
+#include <cstdarg>
 #include <memory>
 #include <string>
 
@@ -63,6 +64,9 @@ protected:
 };
 
 void log(Severity severity, const std::string& message, const std::string& component);
+/// Logs a printf-style message, leaving the formatting to loggers that can defer it
+void vlog(Severity severity, char const* component, char const* format, va_list args)
+     __attribute__ ((format (printf, 3, 0)));
 void set_logger(std::shared_ptr<Logger> const& new_logger);
 
 }
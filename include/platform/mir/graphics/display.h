@@ -86,6 +86,16 @@ public:
      */
     virtual std::chrono::milliseconds recommended_sleep() const = 0;
 
+    /**
+     * Returns true while the displays are refreshing at a variable rate
+     * (adaptive sync), driven by when frames are posted rather than by a
+     * fixed vblank. The compositor should then post each frame as soon as
+     * it is ready instead of aligning it to a predicted vblank.
+     *
+     * Groups that cannot refresh at a variable rate need not override this.
+     */
+    virtual bool variable_refresh_active() const { return false; }
+
     virtual ~DisplaySyncGroup() = default;
 protected:
     DisplaySyncGroup() = default;
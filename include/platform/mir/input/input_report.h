@@ -41,6 +41,16 @@ public:
     virtual void opened_input_device(char const* device_name, char const* input_platform) = 0;
     virtual void failed_to_open_input_device(char const* device_name, char const* input_platform) = 0;
 
+    // Input platform modules call the functions above: add new ones after them,
+    // with default implementations, so that the modules' calls keep their slots
+
+    /// An event was handled more than its deadline after the kernel timestamped it
+    virtual void missed_input_deadline(int64_t /*event_time*/, int64_t /*lateness*/, uint64_t /*missed_count*/) {}
+
+    /// Latency percentiles, in nanoseconds after the event time, of events reaching an input stage
+    virtual void input_stage_latency(
+        char const* /*stage*/, uint64_t /*count*/, int64_t /*p50*/, int64_t /*p99*/, int64_t /*p999*/) {}
+
 protected:
     InputReport() = default;
     InputReport(InputReport const&) = delete;
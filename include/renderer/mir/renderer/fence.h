@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_FENCE_H_
+#define MIR_RENDERER_FENCE_H_
+
+namespace mir
+{
+namespace renderer
+{
+
+/**
+ * A point in the stream of GPU work issued by a Renderer.
+ */
+class Fence
+{
+public:
+    virtual ~Fence() = default;
+
+    /// Blocks until the GPU has completed all work issued before the fence.
+    /// May be called from any thread.
+    virtual void wait() = 0;
+
+protected:
+    Fence() = default;
+    Fence(Fence const&) = delete;
+    Fence& operator=(Fence const&) = delete;
+};
+
+}
+}
+
+#endif // MIR_RENDERER_FENCE_H_
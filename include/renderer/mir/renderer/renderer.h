@@ -21,8 +21,10 @@
 
 #include "mir/geometry/rectangle.h"
 #include "mir/graphics/renderable.h"
+#include "mir/renderer/fence.h"
 #include "mir_toolkit/common.h"
 #include <glm/glm.hpp>
+#include <memory>
 
 namespace mir
 {
@@ -39,6 +41,14 @@ public:
     virtual void render(graphics::RenderableList const&) const = 0;
     virtual void suspend() = 0; // called when render() is skipped
 
+    /**
+     * Fences the GPU work issued by the last render(), so the buffers it
+     * sampled can be handed back to clients once that work completes.
+     * Called with a valid GL context. Returns nullptr if the renderer can't
+     * fence; the buffers are then released as soon as render() returns.
+     */
+    virtual std::unique_ptr<Fence> fence_frame() const { return nullptr; }
+
 protected:
     Renderer() = default;
     Renderer(const Renderer&) = delete;
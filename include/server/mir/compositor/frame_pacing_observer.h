@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_FRAME_PACING_OBSERVER_H_
+#define MIR_COMPOSITOR_FRAME_PACING_OBSERVER_H_
+
+#include "mir/graphics/display_configuration.h"
+
+namespace mir
+{
+namespace compositor
+{
+class BufferStream;
+
+/**
+ * Notification of frame pacing problems, as the compositor detects them.
+ *
+ * Streams are identified by address, so they can be matched against
+ * scene::Surface::primary_buffer_stream(). The stream may already have been
+ * destroyed when the notification is delivered, so it must not be
+ * dereferenced.
+ */
+class FramePacingObserver
+{
+public:
+    /**
+     * Notification that a frame reached an output later than it was composited for.
+     *
+     * \param [in] output           The output the frame was posted to.
+     * \param [in] vblanks_missed   How many refreshes late the frame was.
+     */
+    virtual void missed_deadline(graphics::DisplayConfigurationOutputId output, unsigned vblanks_missed) = 0;
+
+    /**
+     * Notification that a frame was posted before the output had moved on
+     * from the previous one.
+     *
+     * Only one of the two frames was ever shown, so the work spent
+     * compositing the other was wasted.
+     *
+     * \param [in] output   The output the frame was posted to.
+     */
+    virtual void repeated_frame(graphics::DisplayConfigurationOutputId output) = 0;
+
+    /**
+     * Notification that a client frame was replaced by a newer one before
+     * it could be composited.
+     *
+     * \param [in] stream   The stream the frame was submitted to.
+     */
+    virtual void client_frame_dropped(BufferStream const* stream) = 0;
+
+    /**
+     * Notification of the rate a client's frames have been reaching the
+     * screen at, counting the new frames the compositor takes from the
+     * stream rather than those the client submits. Measured roughly once a
+     * second while new frames keep being composited.
+     *
+     * \param [in] stream               The stream the frames were taken from.
+     * \param [in] frames_per_second    The measured rate.
+     */
+    virtual void client_frame_rate(BufferStream const* stream, float frames_per_second) = 0;
+
+protected:
+    FramePacingObserver() = default;
+    virtual ~FramePacingObserver() = default;
+    FramePacingObserver(FramePacingObserver const&) = delete;
+    FramePacingObserver& operator=(FramePacingObserver const&) = delete;
+};
+}
+}
+
+#endif //MIR_COMPOSITOR_FRAME_PACING_OBSERVER_H_
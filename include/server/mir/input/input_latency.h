@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_INPUT_LATENCY_H_
+#define MIR_INPUT_INPUT_LATENCY_H_
+
+#include <chrono>
+#include <cstdint>
+
+namespace mir
+{
+namespace input
+{
+/// The stages of the server's input path, in the order events pass them
+enum class InputStage
+{
+    device,             ///< the input platform handed the event to the server
+    seat,               ///< the seat started processing the event
+    filter_chain,       ///< the event entered the event filter chain
+    surface_dispatch,   ///< the event was delivered to a surface
+    socket_write        ///< the event was written to the client connection
+};
+
+/**
+ * Tracks how long input events take to reach each stage of the input path.
+ *
+ * Latencies are measured from an event's own timestamp (normally when the
+ * kernel saw the input) to when the event reached a stage, so comparing the
+ * percentiles of consecutive stages shows where tail latency is added.
+ */
+class InputLatency
+{
+public:
+    struct Percentiles
+    {
+        uint64_t count;
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p99;
+        std::chrono::nanoseconds p999;
+    };
+
+    virtual ~InputLatency() = default;
+
+    /// Called by each stage for an event with the given event time
+    virtual void event_reached(InputStage stage, std::chrono::nanoseconds event_time) = 0;
+
+    virtual Percentiles percentiles(InputStage stage) const = 0;
+
+protected:
+    InputLatency() = default;
+    InputLatency(InputLatency const&) = delete;
+    InputLatency& operator=(InputLatency const&) = delete;
+};
+}
+}
+
+#endif // MIR_INPUT_INPUT_LATENCY_H_
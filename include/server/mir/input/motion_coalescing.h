@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_MOTION_COALESCING_H_
+#define MIR_INPUT_MOTION_COALESCING_H_
+
+namespace mir
+{
+namespace input
+{
+
+/// How pointer motion is paced on its way to a surface
+enum class MotionCoalescing
+{
+    /// Every motion event is delivered as it arrives (full device rate)
+    none,
+    /// Motion arriving within a frame is accumulated into a single event
+    per_frame,
+    /// Motion arriving within a frame is held and delivered when the frame
+    /// ends, every event intact (for clients that want the full-rate history).
+    /// Each event is still sent as a message of its own, so this paces the
+    /// client's wakeups to the frame rate but does not reduce socket writes.
+    per_frame_with_history
+};
+
+}
+}
+
+#endif /* MIR_INPUT_MOTION_COALESCING_H_ */
@@ -22,6 +22,7 @@
 #include "mir/geometry/point.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/input/input_reception_mode.h"
+#include "mir/input/motion_coalescing.h"
 
 #include "mir_toolkit/event.h"
 
@@ -51,6 +52,8 @@ public:
     virtual bool input_area_contains(geometry::Point const& point) const = 0;
     virtual std::shared_ptr<graphics::CursorImage> cursor_image() const = 0;
     virtual InputReceptionMode reception_mode() const = 0;
+    /// Surfaces that don't pace their motion get every event as it arrives
+    virtual MotionCoalescing motion_coalescing() const { return MotionCoalescing::none; }
     virtual void consume(MirEvent const* event) = 0;
 
 protected:
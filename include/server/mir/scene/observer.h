@@ -23,6 +23,10 @@
 
 namespace mir
 {
+namespace geometry
+{
+struct Rectangle;
+}
 namespace scene
 {
 class Surface;
@@ -41,6 +45,11 @@ public:
     // and will require full recomposition.
     virtual void scene_changed() = 0;
 
+    // Used to indicate that only the appearance of the damaged area has changed (for example
+    // an input visualization has moved), so only outputs showing it need recomposition.
+    // Observers that don't track damage treat it as any other scene change.
+    virtual void scene_damaged(geometry::Rectangle const& /*damage*/) { scene_changed(); }
+
     // Called at observer registration to notify of already existing surfaces.
     virtual void surface_exists(Surface* surface) = 0;
     // Called when observer is unregistered, for example, to provide a place to
@@ -97,6 +97,8 @@ public:
     virtual void remove_observer(std::weak_ptr<SurfaceObserver> const& observer) = 0;
 
     virtual void set_reception_mode(input::InputReceptionMode mode) = 0;
+    /// Surfaces that only support MotionCoalescing::none ignore this
+    virtual void set_motion_coalescing(input::MotionCoalescing /*mode*/) {}
 
     virtual void request_client_surface_close() = 0;
     virtual std::shared_ptr<Surface> parent() const = 0;
@@ -34,7 +34,7 @@ namespace mir
 template<class Observer>
 class ObserverRegistrar;
 
-namespace compositor { class Compositor; class DisplayBufferCompositorFactory; class CompositorReport; }
+namespace compositor { class Compositor; class DisplayBufferCompositorFactory; class CompositorReport; class FramePacingObserver; }
 namespace frontend { class SessionAuthorizer; class Session; class SessionMediatorObserver; }
 namespace graphics { class Cursor; class Platform; class Display; class GLConfig; class DisplayConfigurationPolicy; class DisplayConfigurationObserver; }
 namespace input { class CompositeEventFilter; class InputDispatcher; class CursorListener; class CursorImages; class TouchVisualizer; class InputDeviceHub;}
@@ -70,6 +70,7 @@ class CoordinateTranslator;
 namespace input
 {
 class SeatObserver;
+class InputLatency;
 }
 
 class Fd;
@@ -428,10 +429,17 @@ public:
     auto the_seat_observer_registrar() const ->
         std::shared_ptr<ObserverRegistrar<input::SeatObserver>>;
 
+    /// \return the per-stage input latency statistics
+    auto the_input_latency() const -> std::shared_ptr<input::InputLatency>;
+
     /// \return a registrar to add and remove SessionMediatorObservers
     auto the_session_mediator_observer_registrar() const ->
         std::shared_ptr<ObserverRegistrar<frontend::SessionMediatorObserver>>;
 
+    /// \return a registrar to add and remove FramePacingObservers
+    auto the_frame_pacing_observer_registrar() const ->
+        std::shared_ptr<ObserverRegistrar<compositor::FramePacingObserver>>;
+
 
 /** @} */
 
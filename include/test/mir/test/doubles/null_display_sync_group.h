@@ -60,6 +60,11 @@ public:
         return std::chrono::milliseconds::zero();
     }
 
+    bool variable_refresh_active() const override
+    {
+        return false;
+    }
+
 private:
     std::vector<geometry::Rectangle> const output_rects;
     std::vector<StubDisplayBuffer> display_buffers;
@@ -82,6 +87,11 @@ struct NullDisplaySyncGroup : graphics::DisplaySyncGroup
         return std::chrono::milliseconds::zero();
     }
 
+    bool variable_refresh_active() const override
+    {
+        return false;
+    }
+
     NullDisplayBuffer db;
 };
 
@@ -24,7 +24,7 @@
 #include "mir/events/event_private.h"
 #include "mir/events/surface_placement_event.h"
 #include "mir/cookie/blob.h"
-#include "mir/input/xkb_mapper.h"
+#include "mir/input/keymap_cache.h"
 #include "mir/input/keymap.h"
 
 #include <string.h>
@@ -343,18 +343,9 @@ mir::EventUPtr mev::make_event(mf::SurfaceId const& surface_id, MirInputDeviceId
     auto e = new_event<MirKeymapEvent>();
     auto ep = make_uptr_event(e);
 
-    auto ctx = mi::make_unique_context();
-    auto map = mi::make_unique_keymap(ctx.get(), mi::Keymap{model, layout, variant, options});
-
-    if (!map.get())
-        BOOST_THROW_EXCEPTION(std::runtime_error("failed to assemble keymap from given parameters"));
-
     e->set_surface_id(surface_id.as_value());
     e->set_device_id(id);
-    // TODO consider caching compiled keymaps
-    auto buffer = xkb_keymap_get_as_string(map.get(), XKB_KEYMAP_FORMAT_TEXT_V1);
-    e->set_buffer(buffer);
-    std::free(buffer);
+    e->set_buffer(mi::KeymapCache::instance()->keymap_string(mi::Keymap{model, layout, variant, options}).c_str());
 
     return ep;
 }
@@ -404,6 +395,8 @@ void mev::transform_positions(MirEvent& event, mir::geometry::Displacement const
         if (input_type == mir_input_event_type_pointer)
         {
             auto pev = event.to_input()->to_pointer();
+            pev->set_predicted_x(pev->predicted_x() - movement.dx.as_int());
+            pev->set_predicted_y(pev->predicted_y() - movement.dy.as_int());
             pev->set_x(pev->x() - movement.dx.as_int());
             pev->set_y(pev->y() - movement.dy.as_int());
         }
@@ -412,6 +405,9 @@ void mev::transform_positions(MirEvent& event, mir::geometry::Displacement const
             auto tev = event.to_input()->to_touch();
             for (unsigned i = 0; i < tev->pointer_count(); i++)
             {
+                tev->set_predicted_x(i, tev->predicted_x(i) - movement.dx.as_int());
+                tev->set_predicted_y(i, tev->predicted_y(i) - movement.dy.as_int());
+
                 auto x = tev->x(i);
                 auto y = tev->y(i);
                 tev->set_x(i, x - movement.dx.as_int());
@@ -421,6 +417,62 @@ void mev::transform_positions(MirEvent& event, mir::geometry::Displacement const
     }
 }
 
+void mev::clear_relative_motion(MirEvent& event)
+{
+    if (event.type() != mir_event_type_input ||
+        event.to_input()->input_type() != mir_input_event_type_pointer)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Relative motion is only valid for pointer events."));
+
+    auto const pev = event.to_input()->to_pointer();
+    pev->set_dx(0.0f);
+    pev->set_dy(0.0f);
+    pev->set_hscroll(0.0f);
+    pev->set_vscroll(0.0f);
+}
+
+void mev::accumulate_motion(MirEvent& event, MirEvent const& later)
+{
+    if (event.type() != mir_event_type_input ||
+        event.to_input()->input_type() != mir_input_event_type_pointer ||
+        later.type() != mir_event_type_input ||
+        later.to_input()->input_type() != mir_input_event_type_pointer)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Motion can only be accumulated between pointer events."));
+
+    auto const pev = event.to_input()->to_pointer();
+    auto const lev = later.to_input()->to_pointer();
+    event.to_input()->set_event_time(later.to_input()->event_time());
+    pev->set_x(lev->x());
+    pev->set_y(lev->y());
+    pev->set_predicted_x(lev->predicted_x());
+    pev->set_predicted_y(lev->predicted_y());
+    pev->set_dx(pev->dx() + lev->dx());
+    pev->set_dy(pev->dy() + lev->dy());
+    pev->set_hscroll(pev->hscroll() + lev->hscroll());
+    pev->set_vscroll(pev->vscroll() + lev->vscroll());
+}
+
+void mev::set_predicted_position(MirEvent& event, float x, float y)
+{
+    if (event.type() != mir_event_type_input ||
+        event.to_input()->input_type() != mir_input_event_type_pointer)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Predicted position is only valid for pointer events."));
+
+    auto const pev = event.to_input()->to_pointer();
+    pev->set_predicted_x(x);
+    pev->set_predicted_y(y);
+}
+
+void mev::set_predicted_position(MirEvent& event, size_t touch_index, float x, float y)
+{
+    if (event.type() != mir_event_type_input ||
+        event.to_input()->input_type() != mir_input_event_type_touch)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Predicted touch position is only valid for touch events."));
+
+    auto const tev = event.to_input()->to_touch();
+    tev->set_predicted_x(touch_index, x);
+    tev->set_predicted_y(touch_index, y);
+}
+
 mir::EventUPtr mev::make_event(MirInputDeviceId device_id, std::chrono::nanoseconds timestamp,
                                std::vector<uint8_t> const& cookie, MirInputEventModifiers modifiers,
                                std::vector<mev::ContactState> const& contacts)
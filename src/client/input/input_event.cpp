@@ -224,6 +224,10 @@ float mir_touch_event_axis_value(MirTouchEvent const* event,
         return std::max(
             event->touch_major(touch_index),
             event->touch_minor(touch_index));
+    case mir_touch_axis_predicted_x:
+        return event->predicted_x(touch_index);
+    case mir_touch_axis_predicted_y:
+        return event->predicted_y(touch_index);
     default:
         return -1;
     }
@@ -285,6 +289,10 @@ float mir_pointer_event_axis_value(MirPointerEvent const* pev, MirPointerAxis ax
        return pev->vscroll();
    case mir_pointer_axis_hscroll:
        return pev->hscroll();
+   case mir_pointer_axis_predicted_x:
+       return pev->predicted_x();
+   case mir_pointer_axis_predicted_y:
+       return pev->predicted_y();
    default:
        mir::log_critical("Invalid axis enumeration " + std::to_string(axis));
        abort();
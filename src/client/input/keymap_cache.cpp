@@ -0,0 +1,286 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/keymap_cache.h"
+#include "mir/fnv1a_hash.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mi = mir::input;
+
+namespace
+{
+/// Keymaps from buffers beyond this number are dropped once no mapper uses them
+size_t const max_buffer_keymaps = 16;
+
+/// Serialises compilation and every reference count change on shared xkb objects
+std::recursive_mutex& xkb_guard()
+{
+    static auto const guard = new std::recursive_mutex;
+    return *guard;
+}
+
+void unref_context(xkb_context* context)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    xkb_context_unref(context);
+}
+
+void unref_keymap(xkb_keymap* keymap)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    xkb_keymap_unref(keymap);
+}
+
+void unref_state(xkb_state* state)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    xkb_state_unref(state);
+}
+
+void unref_compose_table(xkb_compose_table* table)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    xkb_compose_table_unref(table);
+}
+
+void unref_compose_state(xkb_compose_state* state)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    xkb_compose_state_unref(state);
+}
+
+std::shared_ptr<xkb_keymap> share(mi::XKBKeymapPtr keymap)
+{
+    return mi::XKBKeymapPtr{keymap.release(), &unref_keymap};
+}
+
+std::string serialise(xkb_keymap* keymap)
+{
+    auto const buffer = xkb_keymap_get_as_string(keymap, XKB_KEYMAP_FORMAT_TEXT_V1);
+    if (!buffer)
+        BOOST_THROW_EXCEPTION(std::runtime_error("failed to serialise keymap"));
+
+    std::string text{buffer};
+    std::free(buffer);
+    return text;
+}
+
+std::string key_for(mi::Keymap const& names)
+{
+    return names.model + '\t' + names.layout + '\t' + names.variant + '\t' + names.options;
+}
+
+/// FNV-1a, as file names have to be stable across processes
+std::string file_name_for(std::string const& key)
+{
+    mir::Fnv1aHash hash;
+    hash.add(key);
+    return std::to_string(hash.value()) + ".xkb";
+}
+
+void make_directories(std::string const& path)
+{
+    for (auto pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+    {
+        mkdir(path.substr(0, pos).c_str(), 0700);
+        if (pos == std::string::npos)
+            break;
+    }
+}
+
+std::string persist_dir_from_environment()
+{
+    if (!getenv("MIR_KEYMAP_CACHE"))
+        return {};
+    if (auto const cache_home = getenv("XDG_CACHE_HOME"))
+        return std::string{cache_home} + "/mir/keymaps";
+    if (auto const home = getenv("HOME"))
+        return std::string{home} + "/.cache/mir/keymaps";
+    return {};
+}
+}
+
+struct mi::KeymapCache::Self
+{
+    explicit Self(std::string const& persist_dir)
+        : persist_dir{persist_dir}
+    {
+    }
+
+    struct NamedKeymap
+    {
+        std::shared_ptr<xkb_keymap> keymap;
+        std::string text;
+    };
+
+    NamedKeymap const& from_names(Keymap const& names);
+    std::string load(std::string const& key) const;
+    void store(std::string const& key, std::string const& text) const;
+
+    std::string const persist_dir;
+    XKBContextPtr const context{xkb_context_new(xkb_context_flags(0)), &unref_context};
+    std::unordered_map<std::string, NamedKeymap> by_names;
+    std::unordered_map<std::string, std::shared_ptr<xkb_keymap>> by_buffer;
+    std::unordered_map<std::string, XKBComposeTablePtr> compose_tables;
+};
+
+auto mi::KeymapCache::Self::from_names(Keymap const& names) -> NamedKeymap const&
+{
+    auto const key = key_for(names);
+    auto const cached = by_names.find(key);
+    if (cached != by_names.end())
+        return cached->second;
+
+    XKBKeymapPtr compiled{nullptr, &xkb_keymap_unref};
+    auto text = load(key);
+    if (!text.empty())
+    {
+        compiled.reset(xkb_keymap_new_from_string(
+            context.get(), text.c_str(), XKB_KEYMAP_FORMAT_TEXT_V1, xkb_keymap_compile_flags(0)));
+    }
+
+    if (!compiled)
+    {
+        compiled = make_unique_keymap(context.get(), names);
+        text = serialise(compiled.get());
+        store(key, text);
+    }
+
+    return by_names.emplace(key, NamedKeymap{share(std::move(compiled)), std::move(text)}).first->second;
+}
+
+std::string mi::KeymapCache::Self::load(std::string const& key) const
+{
+    if (persist_dir.empty())
+        return {};
+
+    std::ifstream in{persist_dir + "/" + file_name_for(key)};
+    std::string stored_key;
+    if (!std::getline(in, stored_key) || stored_key != key)
+        return {};
+
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+void mi::KeymapCache::Self::store(std::string const& key, std::string const& text) const
+{
+    if (persist_dir.empty())
+        return;
+
+    make_directories(persist_dir);
+
+    // Write then rename so that concurrent readers never see a partial keymap
+    auto const path = persist_dir + "/" + file_name_for(key);
+    auto const temporary = path + "." + std::to_string(getpid());
+    {
+        std::ofstream out{temporary};
+        out << key << '\n' << text;
+        if (out.flush())
+        {
+            out.close();
+            if (rename(temporary.c_str(), path.c_str()) == 0)
+                return;
+        }
+    }
+    unlink(temporary.c_str());
+}
+
+mi::KeymapCache::KeymapCache(std::string const& persist_dir)
+    : self{std::make_unique<Self>(persist_dir)}
+{
+}
+
+mi::KeymapCache::~KeymapCache() = default;
+
+std::shared_ptr<xkb_keymap> mi::KeymapCache::keymap(Keymap const& names)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    return self->from_names(names).keymap;
+}
+
+std::shared_ptr<xkb_keymap> mi::KeymapCache::keymap(char const* buffer, size_t size)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+
+    std::string key{buffer, size};
+    auto const cached = self->by_buffer.find(key);
+    if (cached != self->by_buffer.end())
+        return cached->second;
+
+    auto keymap = share(make_unique_keymap(self->context.get(), buffer, size));
+
+    if (self->by_buffer.size() >= max_buffer_keymaps)
+    {
+        for (auto i = self->by_buffer.begin(); i != self->by_buffer.end();)
+        {
+            if (i->second.use_count() == 1)
+                i = self->by_buffer.erase(i);
+            else
+                ++i;
+        }
+    }
+
+    self->by_buffer.emplace(std::move(key), keymap);
+    return keymap;
+}
+
+std::string mi::KeymapCache::keymap_string(Keymap const& names)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    return self->from_names(names).text;
+}
+
+mi::XKBComposeStatePtr mi::KeymapCache::make_compose_state(std::string const& locale)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+
+    auto table = self->compose_tables.find(locale);
+    if (table == self->compose_tables.end())
+    {
+        XKBComposeTablePtr compiled{
+            xkb_compose_table_new_from_locale(self->context.get(), locale.c_str(), XKB_COMPOSE_COMPILE_NO_FLAGS),
+            &unref_compose_table};
+        table = self->compose_tables.emplace(locale, std::move(compiled)).first;
+    }
+
+    if (!table->second)
+        return {nullptr, &unref_compose_state};
+
+    return {xkb_compose_state_new(table->second.get(), XKB_COMPOSE_STATE_NO_FLAGS), &unref_compose_state};
+}
+
+mi::XKBStatePtr mi::KeymapCache::make_state(xkb_keymap* keymap)
+{
+    std::lock_guard<std::recursive_mutex> lock{xkb_guard()};
+    return {xkb_state_new(keymap), &unref_state};
+}
+
+std::shared_ptr<mi::KeymapCache> mi::KeymapCache::instance()
+{
+    static auto const cache = std::make_shared<KeymapCache>(persist_dir_from_environment());
+    return cache;
+}
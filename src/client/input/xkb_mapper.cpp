@@ -19,6 +19,7 @@
  */
 
 #include "mir/input/xkb_mapper.h"
+#include "mir/input/keymap_cache.h"
 #include "mir/input/keymap.h"
 #include "mir/events/event_private.h"
 #include "mir/events/event_builders.h"
@@ -98,26 +99,6 @@ uint32_t to_xkb_scan_code(uint32_t evdev_scan_code)
     // xkb scancodes are offset by 8 from evdev scancodes for compatibility with X protocol.
     return evdev_scan_code + 8;
 }
-
-
-mi::XKBComposeStatePtr make_unique_compose_state(mi::XKBComposeTablePtr const& table)
-{
-    return {xkb_compose_state_new(table.get(), XKB_COMPOSE_STATE_NO_FLAGS), &xkb_compose_state_unref};
-}
-
-mi::XKBComposeTablePtr make_unique_compose_table_from_locale(mi::XKBContextPtr const& context, std::string const& locale)
-{
-    return {xkb_compose_table_new_from_locale(
-            context.get(),
-            locale.c_str(),
-            XKB_COMPOSE_COMPILE_NO_FLAGS),
-           &xkb_compose_table_unref};
-}
-
-mi::XKBStatePtr make_unique_state(xkb_keymap* keymap)
-{
-    return {xkb_state_new(keymap), xkb_state_unref};
-}
 }
 
 mi::XKBContextPtr mi::make_unique_context()
@@ -154,11 +135,25 @@ mi::XKBKeymapPtr mi::make_unique_keymap(xkb_context* context, char const* buffer
 }
 
 mircv::XKBMapper::XKBMapper() :
-    context{make_unique_context()},
-    compose_table{make_unique_compose_table_from_locale(context, get_locale_from_environment())}
+    compose_locale{get_locale_from_environment()}
 {
 }
 
+mi::KeymapCache& mircv::XKBMapper::the_cache()
+{
+    // Nothing XKB is touched until the first keymap arrives, so that creating
+    // a window doesn't wait for it
+    std::call_once(cache_created, [this]
+        {
+            cache = KeymapCache::instance();
+            // A keymap means key presses are coming: compile the compose table now
+            // rather than on the first of them
+            cache->make_compose_state(compose_locale);
+        });
+
+    return *cache;
+}
+
 void mircv::XKBMapper::set_key_state(MirInputDeviceId id, std::vector<uint32_t> const& key_state)
 {
     std::lock_guard<std::mutex> lg(guard);
@@ -235,39 +230,39 @@ mircv::XKBMapper::XkbMappingState* mircv::XKBMapper::get_keymapping_state(MirInp
 
 void mircv::XKBMapper::set_keymap_for_all_devices(Keymap const& new_keymap)
 {
-    set_keymap(make_unique_keymap(context.get(), new_keymap));
+    set_keymap(the_cache().keymap(new_keymap));
 }
 
 void mircv::XKBMapper::set_keymap_for_all_devices(char const* buffer, size_t len)
 {
-    set_keymap(make_unique_keymap(context.get(), buffer, len));
+    set_keymap(the_cache().keymap(buffer, len));
 }
 
-void mircv::XKBMapper::set_keymap(XKBKeymapPtr new_keymap)
+void mircv::XKBMapper::set_keymap(std::shared_ptr<xkb_keymap> const& new_keymap)
 {
     std::lock_guard<std::mutex> lg(guard);
-    default_keymap = std::move(new_keymap);
+    default_keymap = new_keymap;
     device_mapping.clear();
 }
 
 void mircv::XKBMapper::set_keymap_for_device(MirInputDeviceId id, Keymap const& new_keymap)
 {
-    set_keymap(id, make_unique_keymap(context.get(), new_keymap));
+    set_keymap(id, the_cache().keymap(new_keymap));
 }
 
 void mircv::XKBMapper::set_keymap_for_device(MirInputDeviceId id, char const* buffer, size_t len)
 {
-    set_keymap(id, make_unique_keymap(context.get(), buffer, len));
+    set_keymap(id, the_cache().keymap(buffer, len));
 }
 
-void mircv::XKBMapper::set_keymap(MirInputDeviceId id, XKBKeymapPtr new_keymap)
+void mircv::XKBMapper::set_keymap(MirInputDeviceId id, std::shared_ptr<xkb_keymap> const& new_keymap)
 {
     std::lock_guard<std::mutex> lg(guard);
 
     device_mapping.erase(id);
     device_mapping.emplace(std::piecewise_construct,
                            std::forward_as_tuple(id),
-                           std::forward_as_tuple(std::make_unique<XkbMappingState>(std::move(new_keymap))));
+                           std::forward_as_tuple(std::make_unique<XkbMappingState>(new_keymap)));
 }
 
 void mircv::XKBMapper::clear_all_keymaps()
@@ -304,13 +299,13 @@ MirInputEventModifiers mircv::XKBMapper::device_modifiers(MirInputDeviceId id) c
 }
 
 mircv::XKBMapper::XkbMappingState::XkbMappingState(std::shared_ptr<xkb_keymap> const& keymap)
-    : keymap{keymap}, state{make_unique_state(this->keymap.get())}
+    : keymap{keymap}, state{KeymapCache::make_state(this->keymap.get())}
 {
 }
 
 void mircv::XKBMapper::XkbMappingState::set_key_state(std::vector<uint32_t> const& key_state)
 {
-    state = make_unique_state(keymap.get());
+    state = KeymapCache::make_state(keymap.get());
     modifier_state = mir_input_event_modifier_none;
     std::unordered_set<uint32_t> pressed_codes;
     std::string t;
@@ -395,21 +390,21 @@ mircv::XKBMapper::ComposeState* mircv::XKBMapper::get_compose_state(MirInputDevi
     {
         return dev_compose_state->second.get();
     }
-    if (compose_table)
+    if (auto state = the_cache().make_compose_state(compose_locale))
     {
         decltype(device_composing.begin()) insertion_pos;
         std::tie(insertion_pos, std::ignore) =
             device_composing.emplace(std::piecewise_construct,
                                      std::forward_as_tuple(id),
-                                     std::forward_as_tuple(std::make_unique<ComposeState>(compose_table)));
+                                     std::forward_as_tuple(std::make_unique<ComposeState>(std::move(state))));
 
         return insertion_pos->second.get();
     }
     return nullptr;
 }
 
-mircv::XKBMapper::ComposeState::ComposeState(XKBComposeTablePtr const& table) :
-    state{make_unique_compose_state(table)}
+mircv::XKBMapper::ComposeState::ComposeState(XKBComposeStatePtr state) :
+    state{std::move(state)}
 {
 }
 
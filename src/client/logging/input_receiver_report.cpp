@@ -33,6 +33,9 @@ namespace mcll = mir::client::logging;
 namespace
 {
 std::string const component{"input-receiver"};
+
+// Matches how often the server reports its input stage latencies
+uint64_t const latency_report_interval{1000};
 }
 
 mcll::InputReceiverReport::InputReceiverReport(std::shared_ptr<ml::Logger> const& logger)
@@ -48,4 +51,31 @@ void mcll::InputReceiverReport::received_event(
     ss << "Received event:" << event << std::endl;
 
     logger->log(ml::Severity::debug, ss.str(), component);
+
+    if (mir_event_get_type(&event) == mir_event_type_input)
+    {
+        std::chrono::nanoseconds const event_time{mir_input_event_get_event_time(mir_event_get_input_event(&event))};
+        latency.record(std::chrono::steady_clock::now().time_since_epoch() - event_time);
+
+        if (latency.count() % latency_report_interval == 0)
+            log_latency();
+    }
+}
+
+void mcll::InputReceiverReport::log_latency()
+{
+    auto const us = [this](double percentile)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(latency.value_at_percentile(percentile)).count();
+        };
+    std::stringstream ss;
+
+    ss << "Input latency"
+       << " stage=client_receive"
+       << " events=" << latency.count()
+       << " p50=" << us(50.0) << "us"
+       << " p99=" << us(99.0) << "us"
+       << " p999=" << us(99.9) << "us";
+
+    logger->log(ml::Severity::informational, ss.str(), component);
 }
@@ -20,6 +20,7 @@
 #define MIR_CLIENT_LOGGING_INPUT_RECEIVER_REPORT_H_
 
 #include "mir/input/input_receiver_report.h"
+#include "mir/time/latency_histogram.h"
 
 #include <memory>
 
@@ -44,7 +45,11 @@ public:
     void received_event(MirEvent const& event) override;
 
 private:
+    void log_latency();
+
     std::shared_ptr<mir::logging::Logger> const logger;
+    /// How long after their event time input events reached the client
+    time::LatencyHistogram latency;
 };
 
 }
@@ -32,6 +32,7 @@
 #include "mir/input/input_devices.h"
 #include "connection_configuration.h"
 #include "display_configuration.h"
+#include "startup_timeline.h"
 #include "connection_surface_map.h"
 #include "lifecycle_control.h"
 #include "error_stream.h"
@@ -304,6 +305,7 @@ MirConnection::MirConnection(std::string const& error_message) :
     channel(),
     server(nullptr),
     debug(nullptr),
+    startup_timeline{mcl::make_startup_timeline(nullptr)},
     error_message(error_message),
     nbuffers(get_nbuffers_from_env())
 {
@@ -318,6 +320,7 @@ MirConnection::MirConnection(
         server(channel),
         debug(channel),
         logger(conf.the_logger()),
+        startup_timeline{mcl::make_startup_timeline(logger)},
         void_response{mcl::make_protobuf_object<mir::protobuf::Void>()},
         connect_result{mcl::make_protobuf_object<mir::protobuf::Connection>()},
         connect_done{false},
@@ -412,10 +415,33 @@ mf::SurfaceId MirConnection::next_error_id(std::unique_lock<std::mutex> const&)
 
 void MirConnection::surface_created(SurfaceCreationRequest* request)
 {
+    auto const is_request = [&request](std::shared_ptr<MirConnection::SurfaceCreationRequest> const& r)
+        { return request == r.get(); };
+
+    // The first window may need the client platform, and creating that loads
+    // a module, so do it before taking mutex
+    std::shared_ptr<mcl::ClientPlatform> client_platform;
+    std::exception_ptr client_platform_error;
+    {
+        std::lock_guard<decltype(mutex)> lock(mutex);
+        if (std::none_of(surface_requests.begin(), surface_requests.end(), is_request))
+            return;
+    }
+    if (request->response->buffer_stream().has_id())
+    {
+        try
+        {
+            client_platform = the_client_platform();
+        }
+        catch (std::exception const&)
+        {
+            client_platform_error = std::current_exception();
+        }
+    }
+
     std::unique_lock<decltype(mutex)> lock(mutex);
     //make sure this request actually was made.
-    auto request_it = std::find_if(surface_requests.begin(), surface_requests.end(),
-        [&request](std::shared_ptr<MirConnection::SurfaceCreationRequest> r){ return request == r.get(); });
+    auto request_it = std::find_if(surface_requests.begin(), surface_requests.end(), is_request);
     if (request_it == surface_requests.end())
         return;
 
@@ -431,9 +457,12 @@ void MirConnection::surface_created(SurfaceCreationRequest* request)
     {
         try
         {
+            if (client_platform_error)
+                std::rethrow_exception(client_platform_error);
+
             default_stream = std::make_shared<mcl::BufferStream>(
-                this, nullptr, request->wh, server, platform, surface_map, buffer_factory,
-                surface_proto->buffer_stream(), make_perf_report(logger), name,
+                this, nullptr, request->wh, server, client_platform, surface_map, buffer_factory,
+                surface_proto->buffer_stream(), mcl::first_frame_report(startup_timeline, make_perf_report(logger)), name,
                 mir::geometry::Size{surface_proto->width(), surface_proto->height()}, nbuffers);
             surface_map->insert(default_stream->rpc_id(), default_stream);
         }
@@ -467,6 +496,7 @@ void MirConnection::surface_created(SurfaceCreationRequest* request)
         surf = std::make_shared<MirWindow>(
             this, server, &debug, default_stream, spec, *surface_proto, request->wh);
         surface_map->insert(mf::SurfaceId{surface_proto->id().value()}, surf);
+        startup_timeline->reached(mcl::StartupTimeline::Stage::first_window);
     }
 
     callback(surf.get(), context);
@@ -614,9 +644,10 @@ void MirConnection::connected(MirConnectedCallback callback, void * context)
         }
 
         /*
-         * We need to create the client platform after the connection has been
-         * established, to ensure that the client platform has access to all
-         * needed data (e.g. platform package).
+         * The client platform (and its EGL native display) is created on first
+         * use rather than here: loading and probing the platform modules is a
+         * large part of connecting, and clients that only use some of the API
+         * shouldn't wait for it.
          */
         auto default_lifecycle_event_handler = [this](MirLifecycleState transition)
             {
@@ -631,8 +662,6 @@ void MirConnection::connected(MirConnectedCallback callback, void * context)
                 }
             };
 
-        platform = client_platform_factory->create_client_platform(this);
-        native_display = platform->create_egl_native_display();
         display_configuration->set_configuration(connect_result->display_configuration());
         lifecycle_control->set_callback(default_lifecycle_event_handler);
         ping_handler->set_callback([this](int32_t serial)
@@ -651,6 +680,8 @@ void MirConnection::connected(MirConnectedCallback callback, void * context)
                                  boost::diagnostic_information(e));
     }
 
+    startup_timeline->reached(mcl::StartupTimeline::Stage::connected);
+
     callback(this, context);
     connect_wait_handle.result_received();
 }
@@ -737,7 +768,7 @@ MirWaitHandle* MirConnection::platform_operation(
     MirPlatformMessage const* request,
     MirPlatformOperationCallback callback, void* context)
 {
-    auto const client_response = platform->platform_operation(request);
+    auto const client_response = the_client_platform()->platform_operation(request);
     if (client_response)
     {
         set_error_message("");
@@ -782,7 +813,7 @@ bool MirConnection::is_valid(MirConnection *connection)
 
 void MirConnection::populate(MirPlatformPackage& platform_package)
 {
-    platform->populate(platform_package);
+    the_client_platform()->populate(platform_package);
 }
 
 void MirConnection::populate_server_package(MirPlatformPackage& platform_package)
@@ -895,7 +926,7 @@ void MirConnection::stream_created(StreamCreationRequest* request_raw)
     try
     {
         auto stream = std::make_shared<mcl::BufferStream>(
-            this, request->rs, request->wh, server, platform, surface_map, buffer_factory,
+            this, request->rs, request->wh, server, the_client_platform(), surface_map, buffer_factory,
             *protobuf_bs, make_perf_report(logger), std::string{},
             mir::geometry::Size{request->parameters.width(), request->parameters.height()}, nbuffers);
         surface_map->insert(mf::BufferStreamId(protobuf_bs->id().value()), stream);
@@ -959,7 +990,7 @@ std::shared_ptr<mir::client::BufferStream> MirConnection::create_client_buffer_s
     mir::protobuf::BufferStream const& a_protobuf_bs)
 {
     auto stream = std::make_shared<mcl::BufferStream>(
-        this, render_surface, nullptr, server, platform, surface_map, buffer_factory,
+        this, render_surface, nullptr, server, the_client_platform(), surface_map, buffer_factory,
         a_protobuf_bs, make_perf_report(logger), std::string{},
         mir::geometry::Size{width, height}, nbuffers);
     surface_map->insert(render_surface->stream_id(), stream);
@@ -1006,20 +1037,40 @@ std::shared_ptr<MirBufferStream> MirConnection::make_consumer_stream(
    mp::BufferStream const& protobuf_bs)
 {
     return std::make_shared<mcl::ScreencastStream>(
-        this, server, platform, protobuf_bs);
+        this, server, the_client_platform(), protobuf_bs);
 }
 
 EGLNativeDisplayType MirConnection::egl_native_display()
 {
+    auto const client_platform = the_client_platform();
     std::lock_guard<decltype(mutex)> lock(mutex);
 
+    if (!native_display)
+        native_display = client_platform->create_egl_native_display();
+
     return *native_display;
 }
 
-MirPixelFormat MirConnection::egl_pixel_format(EGLDisplay disp, EGLConfig conf) const
+MirPixelFormat MirConnection::egl_pixel_format(EGLDisplay disp, EGLConfig conf)
 {
+    auto const client_platform = the_client_platform();
     std::lock_guard<decltype(mutex)> lock(mutex);
-    return platform->get_egl_pixel_format(disp, conf);
+    return client_platform->get_egl_pixel_format(disp, conf);
+}
+
+std::shared_ptr<mcl::ClientPlatform> MirConnection::the_client_platform()
+{
+    std::lock_guard<decltype(platform_guard)> lock(platform_guard);
+
+    // Creating the platform only needs connect_result, which is write-once,
+    // so this doesn't need (and mustn't take) mutex
+    if (!platform)
+    {
+        platform = client_platform_factory->create_client_platform(this);
+        startup_timeline->reached(mcl::StartupTimeline::Stage::client_platform);
+    }
+
+    return platform;
 }
 
 void MirConnection::register_lifecycle_event_callback(MirLifecycleEventCallback callback, void* context)
@@ -1271,7 +1322,7 @@ std::shared_ptr<mcl::PresentationChain> MirConnection::create_presentation_chain
     mir::protobuf::BufferStream const& a_protobuf_bs)
 {
     if (!client_buffer_factory)
-        client_buffer_factory = platform->create_buffer_factory();
+        client_buffer_factory = the_client_platform()->create_buffer_factory();
     auto chain = std::make_shared<mcl::PresentationChain>(
         this, a_protobuf_bs.id().value(), server, client_buffer_factory, buffer_factory);
 
@@ -1292,7 +1343,7 @@ void MirConnection::allocate_buffer(
     buffer_request->set_buffer_usage(mir_buffer_usage_software);
 
     if (!client_buffer_factory)
-        client_buffer_factory = platform->create_buffer_factory();
+        client_buffer_factory = the_client_platform()->create_buffer_factory();
     buffer_factory->expect_buffer(
         client_buffer_factory, this,
         size, format, mir_buffer_usage_software,
@@ -1312,7 +1363,7 @@ void MirConnection::allocate_buffer(
     buffer_request->set_flags(native_flags);
 
     if (!client_buffer_factory)
-        client_buffer_factory = platform->create_buffer_factory();
+        client_buffer_factory = the_client_platform()->create_buffer_factory();
     buffer_factory->expect_buffer(
         client_buffer_factory, this,
         size, native_format, native_flags,
@@ -1396,7 +1447,7 @@ void MirConnection::render_surface_created(RenderSurfaceCreationRequest* request
         auto rs = std::make_shared<mcl::RenderSurface>(
             this,
             request->native_window,
-            platform,
+            the_client_platform(),
             protobuf_bs,
             request->logical_size);
         surface_map->insert(request->native_window.get(), rs);
@@ -1428,7 +1479,7 @@ auto MirConnection::create_render_surface_with_content(
     params.set_pixel_format(-1);
     params.set_buffer_usage(-1);
 
-    auto nw = platform->create_egl_native_window(nullptr);
+    auto nw = the_client_platform()->create_egl_native_window(nullptr);
     auto request = std::make_shared<RenderSurfaceCreationRequest>(
         callback, context, nw, logical_size);
 
@@ -1454,7 +1505,7 @@ auto MirConnection::create_render_surface_with_content(
 
 void* MirConnection::request_interface(char const* name, int version)
 {
-    if (!platform)
+    if (!connect_done || !client_platform_factory)
         BOOST_THROW_EXCEPTION(std::invalid_argument("cannot query extensions before connecting to server"));
 
     auto supported = std::find_if(extensions.begin(), extensions.end(),
@@ -1473,7 +1524,7 @@ void* MirConnection::request_interface(char const* name, int version)
     //this extension should move to the platform plugin.
     if (!strcmp(name, "mir_extension_graphics_module") && (version == 1))
         return &graphics_module_extension.value();
-    return platform->request_interface(name, version);
+    return the_client_platform()->request_interface(name, version);
 }
 
 void MirConnection::apply_input_configuration(MirInputConfig const* config)
@@ -69,6 +69,7 @@ class AsyncBufferFactory;
 class MirBuffer;
 class BufferStream;
 class PresentationChain;
+class StartupTimeline;
 
 namespace rpc
 {
@@ -170,7 +171,7 @@ public:
     static bool is_valid(MirConnection *connection);
 
     EGLNativeDisplayType egl_native_display();
-    MirPixelFormat       egl_pixel_format(EGLDisplay, EGLConfig) const;
+    MirPixelFormat       egl_pixel_format(EGLDisplay, EGLConfig);
 
     void on_stream_created(int id, MirBufferStream* stream);
 
@@ -313,8 +314,9 @@ private:
     struct Deregisterer
     { MirConnection* const self; ~Deregisterer(); } deregisterer;
 
-    mutable std::mutex mutex; // Protects all members of *this (except release_wait_handles)
+    mutable std::mutex mutex; // Protects all members of *this (except release_wait_handles and platform)
 
+    std::mutex platform_guard; // Protects platform, which the_client_platform() creates on first use
     std::shared_ptr<mir::client::ClientPlatform> platform;
     std::shared_ptr<mir::client::ConnectionSurfaceMap> surface_map;
     std::shared_ptr<mir::client::AsyncBufferFactory> buffer_factory;
@@ -322,9 +324,10 @@ private:
     mir::client::rpc::DisplayServer server;
     mir::client::rpc::DisplayServerDebug debug;
     std::shared_ptr<mir::logging::Logger> const logger;
+    std::shared_ptr<mir::client::StartupTimeline> const startup_timeline;
     std::unique_ptr<mir::protobuf::Void> void_response;
     std::unique_ptr<mir::protobuf::Connection> connect_result;
-    std::atomic<bool> connect_done;
+    std::atomic<bool> connect_done{false};
     std::unique_ptr<mir::protobuf::Void> ignored;
     std::unique_ptr<mir::protobuf::ConnectParameters> connect_parameters;
     std::unique_ptr<mir::protobuf::PlatformOperationMessage> platform_operation_reply;
@@ -371,6 +374,8 @@ private:
 
     MirConnection* next_valid{nullptr};
 
+    std::shared_ptr<mir::client::ClientPlatform> the_client_platform();
+
     void set_error_message(std::string const& error);
     void done_disconnect();
     void connected(MirConnectedCallback callback, void * context);
@@ -36,6 +36,7 @@
 #include "mir/events/event_builders.h"
 #include "mir/events/event_private.h"
 #include "mir/events/surface_placement_event.h"
+#include "mir/trace/transport_counters.h"
 
 #include "mir_protobuf.pb.h"  // For Buffer frig
 #include "mir_protobuf_wire.pb.h"
@@ -276,6 +277,11 @@ void mclr::MirProtobufRpcChannel::send_message(
     std::copy(header_bytes, header_bytes + sizeof header_bytes, send_buffer.begin());
     body.SerializeToArray(send_buffer.data() + sizeof header_bytes, size);
 
+    // The parameters were serialized separately, and are copied in with the invocation
+    mir::trace::count(
+        mir::trace::transport_counters(mir::trace::TransportSide::client).bytes_copied,
+        body.parameters().size());
+
     try
     {
         std::lock_guard<decltype(write_mutex)> lock(write_mutex);
@@ -492,6 +498,13 @@ void mclr::MirProtobufRpcChannel::on_data_available()
 
         result->ParseFromArray(body_bytes.data(), message_size);
 
+        // The nested response and events are copied out of the body as it is parsed
+        auto& totals = mir::trace::transport_counters(mir::trace::TransportSide::client);
+        mir::trace::count(totals.messages_received);
+        mir::trace::count(totals.bytes_copied, result->response().size());
+        for (auto const& event : result->events())
+            mir::trace::count(totals.bytes_copied, event.size());
+
         rpc_report->result_receipt_succeeded(*result);
     }
     catch (std::exception const& x)
@@ -20,6 +20,7 @@
 #include "mir/variable_length_array.h"
 #include "mir/thread_name.h"
 #include "mir/fd_socket_transmission.h"
+#include "mir/trace/transport_counters.h"
 
 #include <system_error>
 
@@ -35,6 +36,14 @@
 namespace mclr = mir::client::rpc;
 namespace md = mir::dispatch;
 
+namespace
+{
+mir::trace::TransportCounters& counters()
+{
+    return mir::trace::transport_counters(mir::trace::TransportSide::client);
+}
+}
+
 void mclr::TransportObservers::on_data_available()
 {
     for_each([](auto observer) { observer->on_data_available(); });
@@ -97,6 +106,7 @@ void mclr::StreamSocketTransport::receive_data(void* buffer, size_t bytes_reques
         header.msg_flags = 0;
 
         ssize_t const result = recvmsg(socket_fd, &header, MSG_NOSIGNAL | MSG_WAITALL);
+        mir::trace::count(counters().syscalls);
 
         if (result == 0)
         {
@@ -129,12 +139,18 @@ void mclr::StreamSocketTransport::receive_data(void* buffer, size_t bytes_reques
 
         bytes_read += result;
     }
+
+    mir::trace::count(counters().bytes_received, bytes_requested);
 }
 
 void mclr::StreamSocketTransport::receive_data(void* buffer, size_t bytes_requested, std::vector<mir::Fd>& fds)
 try
 {
     mir::receive_data(socket_fd, buffer, bytes_requested, fds);
+
+    mir::trace::count(counters().syscalls);
+    mir::trace::count(counters().bytes_received, bytes_requested);
+    mir::trace::count(counters().fds_received, fds.size());
 }
 catch (socket_disconnected_error &e)
 {
@@ -153,6 +169,7 @@ void mclr::StreamSocketTransport::send_message(
                                     buffer.data() + bytes_written,
                                     buffer.size() - bytes_written,
                                     MSG_NOSIGNAL);
+        mir::trace::count(counters().syscalls);
 
         if (result < 0)
         {
@@ -175,7 +192,14 @@ void mclr::StreamSocketTransport::send_message(
     }
 
     if (!fds.empty())
+    {
         mir::send_fds(socket_fd, fds);
+        mir::trace::count(counters().syscalls);
+        mir::trace::count(counters().fds_sent, fds.size());
+    }
+
+    mir::trace::count(counters().messages_sent);
+    mir::trace::count(counters().bytes_sent, buffer.size());
 }
 
 mir::Fd mclr::StreamSocketTransport::watch_fd() const
@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "startup_timeline.h"
+#include "perf_report.h"
+#include "mir/logging/logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace mcl = mir::client;
+namespace ml = mir::logging;
+
+namespace
+{
+char const* const component = "startup"; // Note context is already within client
+
+char const* const stage_names[] = {"connected", "client platform", "first window", "first frame"};
+
+class FirstFrameReport : public mcl::PerfReport
+{
+public:
+    FirstFrameReport(
+        std::shared_ptr<mcl::StartupTimeline> const& timeline,
+        std::shared_ptr<mcl::PerfReport> const& report) :
+        timeline{timeline},
+        report{report}
+    {
+    }
+
+    void name_surface(char const* name) override
+    {
+        report->name_surface(name);
+    }
+
+    void begin_frame(int buffer_id) override
+    {
+        report->begin_frame(buffer_id);
+    }
+
+    void end_frame(int buffer_id) override
+    {
+        timeline->reached(mcl::StartupTimeline::Stage::first_frame);
+        report->end_frame(buffer_id);
+    }
+
+private:
+    std::shared_ptr<mcl::StartupTimeline> const timeline;
+    std::shared_ptr<mcl::PerfReport> const report;
+};
+}
+
+mcl::StartupTimeline::StartupTimeline(std::shared_ptr<ml::Logger> const& logger) :
+    logger{logger},
+    start{std::chrono::steady_clock::now()}
+{
+}
+
+void mcl::StartupTimeline::reached(Stage stage)
+{
+    if (!enabled())
+        return;
+
+    auto const now = std::chrono::steady_clock::now();
+    auto const index = static_cast<int>(stage);
+
+    std::lock_guard<std::mutex> lock{mutex};
+    if (seen[index])
+        return;
+
+    seen[index] = true;
+    at[index] = now - start;
+
+    if (stage != Stage::first_frame)
+        return;
+
+    char msg[256];
+    int length = snprintf(msg, sizeof msg, "Startup timeline:");
+    for (int i = 0; i != static_cast<int>(Stage::count) && length < static_cast<int>(sizeof msg); ++i)
+    {
+        if (seen[i])
+        {
+            length += snprintf(msg + length, sizeof msg - length, " %s %.1fms%s",
+                               stage_names[i],
+                               std::chrono::duration<double, std::milli>{at[i]}.count(),
+                               i + 1 != static_cast<int>(Stage::count) ? "," : "");
+        }
+        else
+        {
+            length += snprintf(msg + length, sizeof msg - length, " %s (not needed)%s",
+                               stage_names[i],
+                               i + 1 != static_cast<int>(Stage::count) ? "," : "");
+        }
+    }
+
+    logger->log(ml::Severity::informational, msg, component);
+}
+
+auto mcl::make_startup_timeline(std::shared_ptr<ml::Logger> const& logger) -> std::shared_ptr<StartupTimeline>
+{
+    // Like MIR_CLIENT_PERF_REPORT, configured directly from the environment
+    auto const report_target = getenv("MIR_CLIENT_STARTUP_REPORT");
+    if (report_target && !strcmp(report_target, "log"))
+        return std::make_shared<StartupTimeline>(logger);
+
+    return std::make_shared<StartupTimeline>(nullptr);
+}
+
+auto mcl::first_frame_report(
+    std::shared_ptr<StartupTimeline> const& timeline,
+    std::shared_ptr<PerfReport> const& report) -> std::shared_ptr<PerfReport>
+{
+    if (!timeline->enabled())
+        return report;
+
+    return std::make_shared<FirstFrameReport>(timeline, report);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_CLIENT_STARTUP_TIMELINE_H_
+#define MIR_CLIENT_STARTUP_TIMELINE_H_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace mir
+{
+namespace logging
+{
+class Logger;
+}
+namespace client
+{
+class PerfReport;
+
+/**
+ * Records how long a client takes from creating its connection to submitting
+ * its first frame, and logs the timeline once that frame is submitted.
+ */
+class StartupTimeline
+{
+public:
+    enum class Stage { connected, client_platform, first_window, first_frame, count };
+
+    /// A null logger disables the timeline
+    explicit StartupTimeline(std::shared_ptr<logging::Logger> const& logger);
+
+    /// Records the first time \p stage is reached
+    void reached(Stage stage);
+
+    bool enabled() const { return logger != nullptr; }
+
+private:
+    std::shared_ptr<logging::Logger> const logger;
+    std::chrono::steady_clock::time_point const start;
+
+    std::mutex mutex;
+    std::chrono::steady_clock::duration at[static_cast<int>(Stage::count)];
+    bool seen[static_cast<int>(Stage::count)]{};
+};
+
+/// Enabled by MIR_CLIENT_STARTUP_REPORT=log
+std::shared_ptr<StartupTimeline> make_startup_timeline(std::shared_ptr<logging::Logger> const& logger);
+
+/// Passes frames on to \p report, recording the first one on \p timeline
+std::shared_ptr<PerfReport> first_frame_report(
+    std::shared_ptr<StartupTimeline> const& timeline,
+    std::shared_ptr<PerfReport> const& report);
+}
+}
+
+#endif /* MIR_CLIENT_STARTUP_TIMELINE_H_ */
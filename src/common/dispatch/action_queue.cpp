@@ -20,14 +20,102 @@
 
 #include <boost/throw_exception.hpp>
 #include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <functional>
+#include <system_error>
+
+/*
+ * The queue is an intrusive multi-producer, single-consumer list in the style
+ * of Vyukov's MPSC queue: producers atomically swap themselves in as the new
+ * head and then link the previous head to themselves; the consumer owns tail,
+ * which is always a node whose action has already been run (initially a stub).
+ *
+ * There is a brief window where a producer has swapped head but not yet
+ * linked the previous node. The consumer treats that as "empty" - the
+ * producer is guaranteed to signal the eventfd once it has finished linking,
+ * because it only tests wakeup_pending after linking.
+ *
+ * Nodes are recycled through a Treiber stack of pool indices. Any producer
+ * may pop from it, so its head carries a generation count that every update
+ * bumps: a pop that raced with a pop and push of the same node then fails
+ * its compare-exchange instead of installing a stale successor.
+ */
 
 mir::dispatch::ActionQueue::ActionQueue()
-    : event_fd{eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK|EFD_SEMAPHORE)}
+    : event_fd{eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK)},
+      pool{new Node[pool_size]},
+      head{nullptr},
+      tail{nullptr}
 {
     if (event_fd < 0)
         BOOST_THROW_EXCEPTION((std::system_error{errno,
                                                  std::system_category(),
                                                  "Failed to create event fd for action queue"}));
+
+    for (std::uint32_t i = 0; i != pool_size - 1; ++i)
+        pool[i].next_free.store(i + 2, std::memory_order_relaxed);
+    free_nodes.store(1);
+
+    tail = allocate_node();
+    head.store(tail);
+}
+
+mir::dispatch::ActionQueue::~ActionQueue()
+{
+    // Actions that never got dispatched are discarded without being run
+    auto node = tail->next.load(std::memory_order_acquire);
+    release_node(tail);
+
+    while (node)
+    {
+        auto const next = node->next.load(std::memory_order_acquire);
+        node->destroy(*node);
+        release_node(node);
+        node = next;
+    }
+}
+
+auto mir::dispatch::ActionQueue::allocate_node() -> Node*
+{
+    auto top = free_nodes.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        auto const index = static_cast<std::uint32_t>(top);
+        if (!index)
+            return new Node;  // The pool is exhausted; it is refilled as actions are dispatched
+
+        auto const node = &pool[index - 1];
+        auto const generation = (top >> 32) + 1;
+        auto const next = (generation << 32) | node->next_free.load(std::memory_order_relaxed);
+
+        if (free_nodes.compare_exchange_weak(top, next, std::memory_order_acquire))
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            return node;
+        }
+    }
+}
+
+void mir::dispatch::ActionQueue::release_node(Node* node)
+{
+    std::less<Node const*> const before;
+    if (before(node, &pool[0]) || !before(node, &pool[0] + pool_size))
+    {
+        delete node;
+        return;
+    }
+
+    auto const index = static_cast<std::uint32_t>(node - &pool[0]) + 1;
+    auto top = free_nodes.load(std::memory_order_relaxed);
+
+    do
+    {
+        node->next_free.store(static_cast<std::uint32_t>(top), std::memory_order_relaxed);
+    }
+    while (!free_nodes.compare_exchange_weak(
+        top, (((top >> 32) + 1) << 32) | index, std::memory_order_release, std::memory_order_relaxed));
 }
 
 mir::Fd mir::dispatch::ActionQueue::watch_fd() const
@@ -37,9 +125,17 @@ mir::Fd mir::dispatch::ActionQueue::watch_fd() const
 
 void mir::dispatch::ActionQueue::enqueue(std::function<void()> const& action)
 {
-    std::unique_lock<std::mutex> lock(list_lock);
-    actions.push_back(action);
-    wake();
+    enqueue<std::function<void()> const&>(action);
+}
+
+void mir::dispatch::ActionQueue::push(Node* node)
+{
+    auto const prev = head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+
+    // Only the first action of a batch needs to wake the dispatcher
+    if (!wakeup_pending.exchange(true))
+        wake();
 }
 
 bool mir::dispatch::ActionQueue::dispatch(FdEvents events)
@@ -47,22 +143,49 @@ bool mir::dispatch::ActionQueue::dispatch(FdEvents events)
     if (events&FdEvent::error)
         return false;
 
-    if (!consume())
-    {
-        // Another thread has won the race to process this event
-        // That's OK, just bail.
-        return true;
-    }
+    // A thread that finds the queue being drained waits its turn rather than
+    // returning at once: otherwise, with the eventfd still readable, a
+    // level-triggered loop would keep calling back in until the drain ended.
+    std::lock_guard<std::mutex> const lock{dispatch_mutex};
+
+    consume();
+
+    // Anything enqueued after this point will signal the eventfd again. The
+    // exchange also synchronises with every producer that saw the flag set,
+    // so their nodes are visible to the loop below.
+    wakeup_pending.exchange(false);
 
-    std::function<void()> action_to_process;
+    // Run only what was pending when we started, so that an action which
+    // enqueues another action cannot starve the rest of the dispatcher.
+    auto const last = head.load(std::memory_order_acquire);
 
+    while (tail != last)
     {
-        std::unique_lock<std::mutex> lock(list_lock);
-        action_to_process = actions.front();
-        actions.pop_front();
-    }
+        auto const next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            break;  // A producer is mid-push; it will wake us when done
+
+        release_node(tail);
+        tail = next;
+
+        struct Destroy
+        {
+            ~Destroy() { node.destroy(node); }
+            Node& node;
+        } const destroy_on_exit{*next};
 
-    action_to_process();
+        try
+        {
+            next->invoke(*next);
+        }
+        catch (...)
+        {
+            // Make sure the remaining actions still get dispatched
+            if (!wakeup_pending.exchange(true))
+                wake();
+            throw;
+        }
+    }
 
     return true;
 }
@@ -19,6 +19,7 @@
 #include <boost/throw_exception.hpp>
 
 #include "mir/log.h"
+#include "mir/fixed_block_pool.h"
 #include "mir/events/event.h"
 #include "mir/events/close_surface_event.h"
 #include "mir/events/input_configuration_event.h"
@@ -39,6 +40,37 @@
 
 namespace ml = mir::logging;
 
+namespace
+{
+using EventStoragePool = mir::FixedBlockPool<sizeof(MirEvent), 64>;
+
+EventStoragePool& event_storage()
+{
+    // Deliberately never destroyed: events can outlive static destruction
+    static auto const pool = new EventStoragePool;
+    return *pool;
+}
+}
+
+void* MirEvent::operator new(std::size_t size)
+{
+    if (size == sizeof(MirEvent))
+        return event_storage().allocate();
+
+    return ::operator new(size);
+}
+
+void MirEvent::operator delete(void* event, std::size_t size) noexcept
+{
+    if (!event)
+        return;
+
+    if (size == sizeof(MirEvent))
+        event_storage().release(event);
+    else
+        ::operator delete(event);
+}
+
 MirEvent::MirEvent(MirEvent const& e)
 {
     auto reader = e.event.asReader();
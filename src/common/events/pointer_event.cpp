@@ -21,6 +21,8 @@
 
 #include <boost/throw_exception.hpp>
 
+#include <cmath>
+
 MirPointerEvent::MirPointerEvent()
 {
     event.initInput();
@@ -84,6 +86,28 @@ void MirPointerEvent::set_y(float y)
     event.getInput().getPointer().setY(y);
 }
 
+float MirPointerEvent::predicted_x() const
+{
+    auto const predicted = event.asReader().getInput().getPointer().getPredictedX();
+    return std::isnan(predicted) ? x() : predicted;
+}
+
+void MirPointerEvent::set_predicted_x(float x)
+{
+    event.getInput().getPointer().setPredictedX(x);
+}
+
+float MirPointerEvent::predicted_y() const
+{
+    auto const predicted = event.asReader().getInput().getPointer().getPredictedY();
+    return std::isnan(predicted) ? y() : predicted;
+}
+
+void MirPointerEvent::set_predicted_y(float y)
+{
+    event.getInput().getPointer().setPredictedY(y);
+}
+
 float MirPointerEvent::dx() const
 {
     return event.asReader().getInput().getPointer().getDx();
@@ -19,6 +19,8 @@
 #include <boost/throw_exception.hpp>
 #include "mir/events/touch_event.h"
 
+#include <cmath>
+
 MirTouchEvent::MirTouchEvent()
 {
     event.initInput();
@@ -117,6 +119,36 @@ void MirTouchEvent::set_y(size_t index, float y)
     event.getInput().getTouch().getContacts()[index].setY(y);
 }
 
+float MirTouchEvent::predicted_x(size_t index) const
+{
+    throw_if_out_of_bounds(index);
+
+    auto const predicted = event.asReader().getInput().getTouch().getContacts()[index].getPredictedX();
+    return std::isnan(predicted) ? x(index) : predicted;
+}
+
+void MirTouchEvent::set_predicted_x(size_t index, float x)
+{
+    throw_if_out_of_bounds(index);
+
+    event.getInput().getTouch().getContacts()[index].setPredictedX(x);
+}
+
+float MirTouchEvent::predicted_y(size_t index) const
+{
+    throw_if_out_of_bounds(index);
+
+    auto const predicted = event.asReader().getInput().getTouch().getContacts()[index].getPredictedY();
+    return std::isnan(predicted) ? y(index) : predicted;
+}
+
+void MirTouchEvent::set_predicted_y(size_t index, float y)
+{
+    throw_if_out_of_bounds(index);
+
+    event.getInput().getTouch().getContacts()[index].setPredictedY(y);
+}
+
 float MirTouchEvent::touch_major(size_t index) const
 {
     throw_if_out_of_bounds(index);
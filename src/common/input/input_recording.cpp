@@ -0,0 +1,178 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_recording.h"
+#include "mir/events/event.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace mi = mir::input;
+
+namespace
+{
+char const magic[] = {'M', 'I', 'R', 'I', 'N', 'R', 'E', 'C'};
+uint32_t const format_version{1};
+
+// A serialized event is a few hundred bytes; anything much larger is garbage
+uint32_t const max_payload_size{1 << 20};
+
+template<typename T>
+void write_value(std::string& buffer, T value)
+{
+    buffer.append(reinterpret_cast<char const*>(&value), sizeof value);
+}
+
+void write_string(std::string& buffer, std::string const& value)
+{
+    write_value(buffer, static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+template<typename T>
+T read_value(std::string const& buffer, size_t& offset)
+{
+    T value;
+    if (buffer.size() - offset < sizeof value)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Truncated input recording record"));
+    std::memcpy(&value, buffer.data() + offset, sizeof value);
+    offset += sizeof value;
+    return value;
+}
+
+std::string read_string(std::string const& buffer, size_t& offset)
+{
+    auto const size = read_value<uint32_t>(buffer, offset);
+    if (buffer.size() - offset < size)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Truncated input recording record"));
+    std::string value{buffer.data() + offset, size};
+    offset += size;
+    return value;
+}
+
+template<typename T>
+bool read_raw(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof value));
+}
+}
+
+mi::InputRecordingWriter::InputRecordingWriter(std::ostream& out)
+    : out(out)
+{
+    out.write(magic, sizeof magic);
+    out.write(reinterpret_cast<char const*>(&format_version), sizeof format_version);
+}
+
+void mi::InputRecordingWriter::device_added(
+    std::chrono::nanoseconds timestamp,
+    uint32_t device,
+    RecordedInputDevice const& info)
+{
+    std::string payload;
+    write_value(payload, info.capabilities);
+    write_string(payload, info.name);
+    write_string(payload, info.unique_id);
+    write_record(InputRecord::Type::device_added, timestamp, device, payload);
+}
+
+void mi::InputRecordingWriter::device_removed(std::chrono::nanoseconds timestamp, uint32_t device)
+{
+    write_record(InputRecord::Type::device_removed, timestamp, device, {});
+}
+
+void mi::InputRecordingWriter::event(std::chrono::nanoseconds timestamp, uint32_t device, MirEvent const& event)
+{
+    write_record(InputRecord::Type::event, timestamp, device, MirEvent::serialize(&event));
+}
+
+void mi::InputRecordingWriter::write_record(
+    InputRecord::Type type,
+    std::chrono::nanoseconds timestamp,
+    uint32_t device,
+    std::string const& payload)
+{
+    std::string record;
+    record.reserve(sizeof(uint8_t) + sizeof(int64_t) + 2 * sizeof(uint32_t) + payload.size());
+    write_value(record, static_cast<uint8_t>(type));
+    write_value(record, static_cast<int64_t>(timestamp.count()));
+    write_value(record, device);
+    write_value(record, static_cast<uint32_t>(payload.size()));
+    record.append(payload);
+
+    out.write(record.data(), record.size());
+}
+
+mi::InputRecordingReader::InputRecordingReader(std::istream& in)
+    : in(in)
+{
+    char header[sizeof magic];
+    uint32_t version;
+
+    if (!in.read(header, sizeof header) || std::memcmp(header, magic, sizeof magic) != 0)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Not an input recording"));
+
+    if (!read_raw(in, version) || version != format_version)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unsupported input recording version"));
+}
+
+bool mi::InputRecordingReader::next(InputRecord& record)
+{
+    uint8_t type;
+    if (!read_raw(in, type))
+        return false;
+
+    int64_t timestamp;
+    uint32_t device;
+    uint32_t size;
+    if (!read_raw(in, timestamp) || !read_raw(in, device) || !read_raw(in, size) || size > max_payload_size)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Truncated input recording record"));
+
+    std::string payload(size, '\0');
+    if (size && !in.read(&payload[0], size))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Truncated input recording record"));
+
+    record.type = static_cast<InputRecord::Type>(type);
+    record.timestamp = std::chrono::nanoseconds{timestamp};
+    record.device = device;
+    record.info = RecordedInputDevice{};
+    record.event.reset();
+
+    switch (record.type)
+    {
+    case InputRecord::Type::device_added:
+    {
+        size_t offset = 0;
+        record.info.capabilities = read_value<uint32_t>(payload, offset);
+        record.info.name = read_string(payload, offset);
+        record.info.unique_id = read_string(payload, offset);
+        break;
+    }
+    case InputRecord::Type::device_removed:
+        break;
+    case InputRecord::Type::event:
+        record.event = MirEvent::deserialize(payload);
+        break;
+    default:
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unknown input recording record type"));
+    }
+
+    return true;
+}
@@ -18,7 +18,6 @@
 
 #include "mir/log.h"
 #include "mir/logging/logger.h"
-#include <cstdio>
 
 #include <exception>
 #include <boost/exception/diagnostic_information.hpp>
@@ -28,15 +27,7 @@ namespace mir {
 void logv(logging::Severity sev, char const* component,
           char const* fmt, va_list va)
 {
-    char message[1024];
-    int max = sizeof(message) - 1;
-    int len = vsnprintf(message, max, fmt, va);
-    if (len > max)
-        len = max;
-    message[len] = '\0';
-
-    // Suboptimal: Constructing a std::string for message/component.
-    logging::log(sev, message, component);
+    logging::vlog(sev, component, fmt, va);
 }
 
 void log(logging::Severity sev, char const* component,
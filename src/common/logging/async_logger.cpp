@@ -0,0 +1,804 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <type_traits>
+
+#include <unistd.h>
+#include <wchar.h>
+
+namespace ml = mir::logging;
+
+namespace
+{
+enum class RecordKind : uint8_t
+{
+    padding,
+    text,       ///< the payload is the message
+    printf      ///< the payload is the format string, then the captured arguments
+};
+
+struct RecordHeader
+{
+    uint32_t size;              ///< of the whole record, padded to record_alignment
+    uint32_t payload_size;
+    uint16_t component_size;
+    RecordKind kind;
+    uint8_t severity;
+    int64_t time;               ///< CLOCK_REALTIME, in nanoseconds
+};
+
+size_t constexpr record_alignment = 8;
+size_t constexpr max_component_size = 256;
+size_t constexpr max_formatted_size = 4096;
+
+size_t aligned(size_t size)
+{
+    return (size + record_alignment - 1) & ~(record_alignment - 1);
+}
+
+int64_t realtime_now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+std::atomic<uint64_t> next_logger_id{1};
+
+enum class Length { none, hh, h, l, ll, j, z, t, L };
+
+/// A printf conversion specification, e.g. "%-*.3lld"
+struct Conversion
+{
+    char const* flags;
+    size_t flags_size;
+    bool width_from_argument;
+    char const* width;
+    size_t width_size;
+    bool has_precision;
+    bool precision_from_argument;
+    int precision;
+    Length length;
+    char conversion;
+    char const* end;
+};
+
+// Parses the conversion at `start` (which points at the '%'), false for those we can't defer
+bool parse_conversion(char const* start, Conversion& c)
+{
+    auto p = start + 1;
+
+    c.flags = p;
+    while (*p && strchr("-+ #0'", *p)) ++p;
+    c.flags_size = p - c.flags;
+
+    c.width_from_argument = *p == '*';
+    c.width = p;
+    if (c.width_from_argument)
+        ++p;
+    else
+        while ('0' <= *p && *p <= '9') ++p;
+    c.width_size = p - c.width;
+
+    // Positional arguments ("%1$d") can't be captured in order
+    if (*p == '$')
+        return false;
+
+    c.has_precision = *p == '.';
+    c.precision_from_argument = false;
+    c.precision = 0;
+    if (c.has_precision)
+    {
+        ++p;
+        if (*p == '*')
+        {
+            c.precision_from_argument = true;
+            ++p;
+        }
+        else
+        {
+            while ('0' <= *p && *p <= '9')
+                c.precision = c.precision * 10 + (*p++ - '0');
+        }
+    }
+
+    c.length = Length::none;
+    switch (*p)
+    {
+    case 'h': c.length = p[1] == 'h' ? Length::hh : Length::h; p += p[1] == 'h' ? 2 : 1; break;
+    case 'l': c.length = p[1] == 'l' ? Length::ll : Length::l; p += p[1] == 'l' ? 2 : 1; break;
+    case 'q': c.length = Length::ll; ++p; break;
+    case 'j': c.length = Length::j; ++p; break;
+    case 'z': c.length = Length::z; ++p; break;
+    case 't': c.length = Length::t; ++p; break;
+    case 'L': c.length = Length::L; ++p; break;
+    default: break;
+    }
+
+    c.conversion = *p;
+    if (!*p || !strchr("diouxXcsp" "eEfFgGaA", *p))
+        return false;
+    c.end = p + 1;
+
+    return true;
+}
+
+template<typename T>
+void append(std::vector<char>& buffer, T value)
+{
+    auto const bytes = reinterpret_cast<char const*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof value);
+}
+
+template<typename T>
+T extract(char const*& cursor)
+{
+    T value;
+    memcpy(&value, cursor, sizeof value);
+    cursor += sizeof value;
+    return value;
+}
+
+// Integer arguments are narrowed as printf would, then stored at full width
+bool capture_integer(va_list& args, Conversion const& c, std::vector<char>& buffer)
+{
+    bool const is_signed = c.conversion == 'd' || c.conversion == 'i';
+    using ssize = std::make_signed<size_t>::type;
+    using uptrdiff = std::make_unsigned<ptrdiff_t>::type;
+
+    switch (c.length)
+    {
+    case Length::hh:
+        if (is_signed) append<long long>(buffer, static_cast<signed char>(va_arg(args, int)));
+        else append<unsigned long long>(buffer, static_cast<unsigned char>(va_arg(args, unsigned)));
+        return true;
+    case Length::h:
+        if (is_signed) append<long long>(buffer, static_cast<short>(va_arg(args, int)));
+        else append<unsigned long long>(buffer, static_cast<unsigned short>(va_arg(args, unsigned)));
+        return true;
+    case Length::none:
+        if (is_signed) append<long long>(buffer, va_arg(args, int));
+        else append<unsigned long long>(buffer, va_arg(args, unsigned));
+        return true;
+    case Length::l:
+        if (is_signed) append<long long>(buffer, va_arg(args, long));
+        else append<unsigned long long>(buffer, va_arg(args, unsigned long));
+        return true;
+    case Length::ll:
+        if (is_signed) append<long long>(buffer, va_arg(args, long long));
+        else append<unsigned long long>(buffer, va_arg(args, unsigned long long));
+        return true;
+    case Length::j:
+        if (is_signed) append<long long>(buffer, va_arg(args, intmax_t));
+        else append<unsigned long long>(buffer, va_arg(args, uintmax_t));
+        return true;
+    case Length::z:
+        if (is_signed) append<long long>(buffer, va_arg(args, ssize));
+        else append<unsigned long long>(buffer, va_arg(args, size_t));
+        return true;
+    case Length::t:
+        if (is_signed) append<long long>(buffer, va_arg(args, ptrdiff_t));
+        else append<unsigned long long>(buffer, va_arg(args, uptrdiff));
+        return true;
+    case Length::L:
+        return false;
+    }
+    return false;
+}
+
+/// Stores the arguments \p format refers to, in order, so they can be formatted later
+bool capture_arguments(char const* format, va_list& args, std::vector<char>& buffer)
+{
+    for (auto p = format; *p;)
+    {
+        if (*p != '%')
+        {
+            ++p;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            p += 2;
+            continue;
+        }
+
+        Conversion c;
+        if (!parse_conversion(p, c))
+            return false;
+
+        if (c.width_from_argument)
+            append<int>(buffer, va_arg(args, int));
+
+        auto precision = c.has_precision ? c.precision : -1;
+        if (c.precision_from_argument)
+        {
+            precision = va_arg(args, int);
+            append<int>(buffer, precision);
+        }
+
+        switch (c.conversion)
+        {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            if (!capture_integer(args, c, buffer))
+                return false;
+            break;
+
+        case 'c':
+            if (c.length == Length::l)
+                append<long long>(buffer, va_arg(args, wint_t));
+            else
+                append<long long>(buffer, va_arg(args, int));
+            break;
+
+        case 's':
+        {
+            if (c.length != Length::none)
+                return false;
+            auto string = va_arg(args, char const*);
+            if (!string)
+                string = "(null)";
+            uint32_t const size = precision >= 0 ? strnlen(string, precision) : strlen(string);
+            append<uint32_t>(buffer, size);
+            buffer.insert(buffer.end(), string, string + size);
+            buffer.push_back('\0');
+            break;
+        }
+
+        case 'p':
+            append<uintptr_t>(buffer, reinterpret_cast<uintptr_t>(va_arg(args, void*)));
+            break;
+
+        default:
+            if (c.length == Length::L)
+                append<long double>(buffer, va_arg(args, long double));
+            else
+                append<long double>(buffer, va_arg(args, double));
+            break;
+        }
+
+        p = c.end;
+    }
+
+    return true;
+}
+
+template<typename... Argument>
+void append_formatted(std::string& out, char const* spec, Argument... argument)
+{
+    char buffer[256];
+    auto const size = snprintf(buffer, sizeof buffer, spec, argument...);
+    if (size < 0)
+        return;
+
+    if (static_cast<size_t>(size) < sizeof buffer)
+    {
+        out.append(buffer, size);
+    }
+    else
+    {
+        std::vector<char> large(size + 1);
+        snprintf(large.data(), large.size(), spec, argument...);
+        out.append(large.data(), size);
+    }
+}
+
+/// Formats a message captured by capture_arguments()
+void format_captured(char const* format, char const* arguments, std::string& out)
+{
+    for (auto p = format; *p;)
+    {
+        auto const literal_end = strchr(p, '%');
+        if (!literal_end)
+        {
+            out.append(p);
+            break;
+        }
+        out.append(p, literal_end - p);
+        p = literal_end;
+
+        if (p[1] == '%')
+        {
+            out += '%';
+            p += 2;
+            continue;
+        }
+
+        Conversion c;
+        parse_conversion(p, c);
+
+        // Rebuild the conversion for the width the argument was stored at
+        char spec[64] = "%";
+        size_t spec_size = 1;
+        auto const add = [&](char const* text, size_t size)
+            {
+                size = std::min(size, sizeof spec - 4 - spec_size);
+                memcpy(spec + spec_size, text, size);
+                spec_size += size;
+            };
+        auto const finish = [&](char const* length)
+            {
+                add(length, strlen(length));
+                spec[spec_size] = c.conversion;
+                spec[spec_size + 1] = '\0';
+                return spec;
+            };
+
+        char number[16];
+        add(c.flags, c.flags_size);
+        if (c.width_from_argument)
+            add(number, snprintf(number, sizeof number, "%d", extract<int>(arguments)));
+        else
+            add(c.width, c.width_size);
+
+        auto precision = c.precision;
+        if (c.precision_from_argument)
+            precision = extract<int>(arguments);
+        if (c.has_precision && precision >= 0)
+            add(number, snprintf(number, sizeof number, ".%d", precision));
+
+        switch (c.conversion)
+        {
+        case 'd': case 'i':
+            append_formatted(out, finish("ll"), extract<long long>(arguments));
+            break;
+
+        case 'o': case 'u': case 'x': case 'X':
+            append_formatted(out, finish("ll"), extract<unsigned long long>(arguments));
+            break;
+
+        case 'c':
+            if (c.length == Length::l)
+                append_formatted(out, finish("l"), static_cast<wint_t>(extract<long long>(arguments)));
+            else
+                append_formatted(out, finish(""), static_cast<int>(extract<long long>(arguments)));
+            break;
+
+        case 's':
+        {
+            auto const size = extract<uint32_t>(arguments);
+            append_formatted(out, finish(""), arguments);
+            arguments += size + 1;
+            break;
+        }
+
+        case 'p':
+            append_formatted(out, finish(""), reinterpret_cast<void*>(extract<uintptr_t>(arguments)));
+            break;
+
+        default:
+            append_formatted(out, finish("L"), extract<long double>(arguments));
+            break;
+        }
+
+        p = c.end;
+    }
+}
+
+void append_prefix(std::string& line, int64_t time, ml::Severity severity, char const* component, size_t component_size)
+{
+    static char const* const lut[5] =
+    {
+        "<CRITICAL> ",
+        "<ERROR> ",
+        "<WARNING> ",
+        "",
+        "<DEBUG> "
+    };
+
+    // Lines mostly arrive in batches logged within the same second
+    thread_local time_t cached_seconds{-1};
+    thread_local char cached_date[32];
+
+    time_t const seconds = time / 1000000000;
+    if (seconds != cached_seconds)
+    {
+        tm local;
+        localtime_r(&seconds, &local);
+        strftime(cached_date, sizeof cached_date, "%F %T", &local);
+        cached_seconds = seconds;
+    }
+
+    char microseconds[16];
+    auto const size = snprintf(microseconds, sizeof microseconds, ".%06ld", static_cast<long>(time % 1000000000 / 1000));
+
+    line += '[';
+    line += cached_date;
+    line.append(microseconds, size);
+    line += "] ";
+    line += lut[static_cast<int>(severity)];
+    line.append(component, component_size);
+    line += ": ";
+}
+
+void write_all(int fd, std::vector<char> const& buffer)
+{
+    for (size_t written = 0; written < buffer.size();)
+    {
+        auto const result = write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        written += result;
+    }
+}
+}
+
+/// A single-producer, single-consumer ring of variable sized records
+class ml::AsyncLogger::Ring
+{
+public:
+    explicit Ring(size_t size) :
+        buffer(size)
+    {
+        staging.reserve(1024);
+    }
+
+    /// Producer: writes a record of \p size bytes with \p fill, or returns false if there's no room
+    template<typename Fill>
+    bool write(size_t size, Fill const& fill)
+    {
+        auto position = head.load(std::memory_order_relaxed);
+        auto const free = buffer.size() - (position - tail.load(std::memory_order_acquire));
+        auto const contiguous = buffer.size() - position % buffer.size();
+        auto const padding = size > contiguous ? contiguous : 0;
+
+        if (padding + size > free)
+            return false;
+
+        if (padding >= sizeof(RecordHeader))
+        {
+            RecordHeader header{static_cast<uint32_t>(padding), 0, 0, RecordKind::padding, 0, 0};
+            memcpy(&buffer[position % buffer.size()], &header, sizeof header);
+        }
+        position += padding;
+
+        fill(&buffer[position % buffer.size()]);
+        head.store(position + size, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: calls \p read for each record written so far, then frees them
+    template<typename Read>
+    void read_all(Read const& read)
+    {
+        auto position = tail.load(std::memory_order_relaxed);
+        auto const end = head.load(std::memory_order_acquire);
+
+        while (position != end)
+        {
+            auto const contiguous = buffer.size() - position % buffer.size();
+            if (contiguous < sizeof(RecordHeader))
+            {
+                position += contiguous;
+                continue;
+            }
+
+            auto const record = &buffer[position % buffer.size()];
+            RecordHeader header;
+            memcpy(&header, record, sizeof header);
+
+            if (header.kind != RecordKind::padding)
+                read(header, record + sizeof header);
+
+            position += header.size;
+        }
+
+        tail.store(position, std::memory_order_release);
+    }
+
+    size_t used() const
+    {
+        return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+    }
+
+    size_t size() const { return buffer.size(); }
+
+    std::vector<char> staging;              ///< Producer only
+    std::atomic<uint64_t> dropped{0};
+    uint64_t dropped_reported{0};           ///< Consumer only
+    std::atomic<bool> orphaned{false};
+
+private:
+    std::vector<char> buffer;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+};
+
+ml::AsyncLogger::AsyncLogger() :
+    AsyncLogger(STDOUT_FILENO, STDERR_FILENO, default_ring_size)
+{
+}
+
+ml::AsyncLogger::AsyncLogger(int out_fd, int err_fd, size_t ring_size) :
+    out_fd{out_fd},
+    err_fd{err_fd},
+    ring_size{aligned(std::max<size_t>(ring_size, 1024))},
+    id{next_logger_id.fetch_add(1)},
+    writer{[this] { write_loop(); }}
+{
+}
+
+ml::AsyncLogger::~AsyncLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    wakeup.notify_one();
+    writer.join();
+
+    std::lock_guard<std::mutex> lock{rings_mutex};
+    for (auto const& ring : rings)
+        ring->orphaned = true;
+}
+
+auto ml::AsyncLogger::ring_for_this_thread() -> Ring&
+{
+    thread_local std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> thread_rings;
+
+    for (auto const& entry : thread_rings)
+    {
+        if (entry.first == id)
+            return *entry.second;
+    }
+
+    thread_rings.erase(
+        std::remove_if(thread_rings.begin(), thread_rings.end(),
+            [](auto const& entry) { return entry.second->orphaned.load(); }),
+        thread_rings.end());
+
+    auto const ring = std::make_shared<Ring>(ring_size);
+    {
+        std::lock_guard<std::mutex> lock{rings_mutex};
+        rings.push_back(ring);
+    }
+    thread_rings.emplace_back(id, ring);
+
+    return *ring;
+}
+
+void ml::AsyncLogger::log(Severity severity, std::string const& message, std::string const& component)
+{
+    auto& ring = ring_for_this_thread();
+
+    auto const component_size = std::min(component.size(), max_component_size);
+    auto const message_size = std::min(
+        message.size(),
+        ring_size / 4 - sizeof(RecordHeader) - component_size);
+    auto const size = aligned(sizeof(RecordHeader) + component_size + message_size);
+
+    auto const written = ring.write(size, [&](char* record)
+        {
+            RecordHeader const header{
+                static_cast<uint32_t>(size),
+                static_cast<uint32_t>(message_size),
+                static_cast<uint16_t>(component_size),
+                RecordKind::text,
+                static_cast<uint8_t>(severity),
+                realtime_now()};
+            memcpy(record, &header, sizeof header);
+            memcpy(record + sizeof header, component.data(), component_size);
+            memcpy(record + sizeof header + component_size, message.data(), message_size);
+        });
+
+    if (!written)
+    {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    wake_writer(ring, severity);
+}
+
+void ml::AsyncLogger::log(char const* component, Severity severity, char const* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    logv(component, severity, format, args);
+    va_end(args);
+}
+
+void ml::AsyncLogger::logv(char const* component, Severity severity, char const* format, va_list args)
+{
+    auto& ring = ring_for_this_thread();
+    auto& payload = ring.staging;
+
+    payload.assign(format, format + strlen(format) + 1);
+
+    va_list capture;
+    va_copy(capture, args);
+    auto const captured = capture_arguments(format, capture, payload);
+    va_end(capture);
+
+    auto const component_size = std::min(strlen(component), max_component_size);
+    auto kind = RecordKind::printf;
+
+    if (!captured || sizeof(RecordHeader) + component_size + payload.size() > ring_size / 4)
+    {
+        // Formats we can't defer, and unusually large messages, are formatted here instead
+        char message[max_formatted_size];
+        auto const size = vsnprintf(message, sizeof message, format, args);
+        payload.assign(message, message + std::min<size_t>(std::max(size, 0), sizeof message - 1));
+        kind = RecordKind::text;
+    }
+
+    auto const size = aligned(sizeof(RecordHeader) + component_size + payload.size());
+
+    auto const written = ring.write(size, [&](char* record)
+        {
+            RecordHeader const header{
+                static_cast<uint32_t>(size),
+                static_cast<uint32_t>(payload.size()),
+                static_cast<uint16_t>(component_size),
+                kind,
+                static_cast<uint8_t>(severity),
+                realtime_now()};
+            memcpy(record, &header, sizeof header);
+            memcpy(record + sizeof header, component, component_size);
+            memcpy(record + sizeof header + component_size, payload.data(), payload.size());
+        });
+
+    if (!written)
+    {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    wake_writer(ring, severity);
+}
+
+void ml::AsyncLogger::wake_writer(Ring& ring, Severity severity)
+{
+    if (severity == Severity::critical)
+    {
+        flush();
+        return;
+    }
+
+    // Otherwise the writer drains the rings periodically, and is only hurried along when
+    // one is filling up or there's something worth seeing promptly
+    if ((severity < Severity::informational || ring.used() > ring.size() / 2) &&
+        !wake_requested.load(std::memory_order_relaxed) &&
+        !wake_requested.exchange(true))
+    {
+        wakeup.notify_one();
+    }
+}
+
+void ml::AsyncLogger::flush()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+
+    auto const target = ++flushes_requested;
+    wakeup.notify_one();
+
+    flushed.wait(lock, [&] { return flushes_done >= target || stopping; });
+}
+
+uint64_t ml::AsyncLogger::dropped_messages() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void ml::AsyncLogger::write_loop()
+{
+    std::vector<char> out;
+    std::vector<char> err;
+
+    std::unique_lock<std::mutex> lock{mutex};
+
+    while (true)
+    {
+        wakeup.wait_for(lock, std::chrono::milliseconds{20},
+            [this] { return stopping || wake_requested.load() || flushes_requested != flushes_done; });
+
+        auto const flush_target = flushes_requested;
+        auto const stop = stopping;
+        wake_requested = false;
+        lock.unlock();
+
+        drain(out, err);
+        write_all(out_fd, out);
+        write_all(err_fd, err);
+        out.clear();
+        err.clear();
+
+        lock.lock();
+        flushes_done = flush_target;
+        flushed.notify_all();
+
+        if (stop)
+            break;
+    }
+}
+
+void ml::AsyncLogger::drain(std::vector<char>& out, std::vector<char>& err)
+{
+    // All lines are formatted into one buffer, then written out in the order they were logged
+    struct Line
+    {
+        int64_t time;
+        bool is_error;
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Line> lines;
+    std::string text;
+
+    std::lock_guard<std::mutex> lock{rings_mutex};
+
+    for (auto const& ring : rings)
+    {
+        ring->read_all([&](RecordHeader const& header, char const* data)
+            {
+                auto const severity = static_cast<Severity>(header.severity);
+                auto const payload = data + header.component_size;
+                auto const begin = text.size();
+
+                append_prefix(text, header.time, severity, data, header.component_size);
+
+                if (header.kind == RecordKind::text)
+                {
+                    text.append(payload, header.payload_size);
+                }
+                else
+                {
+                    auto const arguments = payload + strlen(payload) + 1;
+                    format_captured(payload, arguments, text);
+                }
+
+                text += '\n';
+                lines.push_back({header.time, severity < Severity::informational, begin, text.size()});
+            });
+
+        auto const dropped_now = ring->dropped.load(std::memory_order_relaxed);
+        if (dropped_now != ring->dropped_reported)
+        {
+            auto const now = realtime_now();
+            auto const begin = text.size();
+            append_prefix(text, now, Severity::warning, "logging", strlen("logging"));
+            text += std::to_string(dropped_now - ring->dropped_reported) +
+                " messages dropped because a thread logged faster than they could be written\n";
+            lines.push_back({now, true, begin, text.size()});
+            ring->dropped_reported = dropped_now;
+        }
+    }
+
+    // Rings whose thread has exited are only referenced from here
+    rings.erase(
+        std::remove_if(rings.begin(), rings.end(),
+            [](auto const& ring) { return ring.use_count() == 1 && ring->used() == 0; }),
+        rings.end());
+
+    std::stable_sort(lines.begin(), lines.end(), [](Line const& a, Line const& b) { return a.time < b.time; });
+
+    for (auto const& line : lines)
+    {
+        auto& buffer = line.is_error ? err : out;
+        buffer.insert(buffer.end(), text.begin() + line.begin, text.begin() + line.end);
+    }
+}
@@ -17,10 +17,13 @@
  */
 
 #include "mir/logging/dumb_console_logger.h"
+#include "mir/logging/async_logger.h"
 #include "mir/logging/logger.h"
 
 #include <mutex>
+#include <atomic>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 
 namespace ml = mir::logging;
@@ -40,17 +43,39 @@ void ml::Logger::log(char const* component, Severity severity, char const* forma
 
 namespace
 {
+// The std::atomic_load() overloads for shared_ptr aren't lock-free (libstdc++
+// takes one of a small pool of mutexes), so each thread keeps its own copy of
+// the logger instead, and only takes log_mutex to refresh it when
+// set_logger() has bumped logger_generation since the thread last looked.
+// A replaced logger lives on until every thread that used it logs again or exits.
 std::mutex log_mutex;
 std::shared_ptr<ml::Logger> the_logger;
+std::atomic<uint64_t> logger_generation{1};
 
 std::shared_ptr<ml::Logger> get_logger()
 {
-    std::lock_guard<decltype(log_mutex)> lock{log_mutex};
+    struct ThreadLogger
+    {
+        uint64_t generation{0};
+        std::shared_ptr<ml::Logger> logger;
+    };
+    thread_local ThreadLogger current;
+
+    auto const generation = logger_generation.load(std::memory_order_acquire);
+
+    if (current.generation != generation)
+    {
+        std::lock_guard<decltype(log_mutex)> lock{log_mutex};
+
+        if (!the_logger)
+            the_logger = std::make_shared<ml::DumbConsoleLogger>();
 
-    if (!the_logger)
-        the_logger = std::make_shared<ml::DumbConsoleLogger>();
+        current.logger = the_logger;
+        current.generation = generation;
+    }
 
-    return the_logger;
+    // A copy, in case the logger logs and a newer logger replaces current.logger
+    return current.logger;
 }
 }
 
@@ -61,12 +86,31 @@ void ml::log(ml::Severity severity, const std::string& message, const std::strin
     logger->log(severity, message, component);
 }
 
+void ml::vlog(Severity severity, char const* component, char const* format, va_list args)
+{
+    auto const logger = get_logger();
+
+    // Logger only takes a va_list through AsyncLogger, which formats on its own thread
+    if (auto const async = dynamic_cast<AsyncLogger*>(logger.get()))
+    {
+        async->logv(component, severity, format, args);
+        return;
+    }
+
+    char message[1024];
+    vsnprintf(message, sizeof message, format, args);
+
+    // Suboptimal: Constructing a std::string for message/component.
+    logger->log(severity, std::string{message}, std::string{component});
+}
+
 void ml::set_logger(std::shared_ptr<Logger> const& new_logger)
 {
     if (new_logger)
     {
         std::lock_guard<decltype(log_mutex)> lock{log_mutex};
         the_logger = new_logger;
+        logger_generation.fetch_add(1, std::memory_order_release);
     }
 }
 
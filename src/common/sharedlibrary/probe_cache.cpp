@@ -0,0 +1,154 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/probe_cache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+struct Line
+{
+    std::string kind;
+    mir::ProbeCache::Entry entry;
+};
+
+std::vector<Line> read_lines(std::string const& file)
+{
+    std::vector<Line> lines;
+    std::ifstream in{file};
+
+    for (std::string text; std::getline(in, text);)
+    {
+        std::istringstream fields{text};
+        Line line;
+        fields >> line.kind >> line.entry.device_set >> line.entry.priority >> line.entry.mtime;
+        fields >> std::ws;
+        std::getline(fields, line.entry.module);
+
+        if (fields.fail() || line.entry.module.empty())
+            continue;
+
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+void make_parent_directories(std::string const& file)
+{
+    for (auto slash = file.find('/', 1); slash != std::string::npos; slash = file.find('/', slash + 1))
+        mkdir(file.substr(0, slash).c_str(), 0700);
+}
+}
+
+mir::ProbeCache::ProbeCache(std::string const& file) :
+    file{file}
+{
+}
+
+std::string mir::ProbeCache::default_file()
+{
+    if (auto const file = getenv("MIR_PLATFORM_PROBE_CACHE"))
+        return std::string{file} == "off" ? std::string{} : file;
+
+    if (auto const dir = getenv("XDG_CACHE_HOME"))
+        return std::string{dir} + "/mir/platform-probe-cache";
+
+    if (auto const home = getenv("HOME"))
+        return std::string{home} + "/.cache/mir/platform-probe-cache";
+
+    return {};
+}
+
+int64_t mir::ProbeCache::mtime_of(std::string const& path)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return -1;
+
+    return info.st_mtim.tv_sec * int64_t{1000000000} + info.st_mtim.tv_nsec;
+}
+
+auto mir::ProbeCache::lookup(std::string const& kind, uint64_t device_set) const
+-> optional_value<Entry>
+{
+    if (file.empty())
+        return {};
+
+    for (auto const& line : read_lines(file))
+    {
+        if (line.kind != kind)
+            continue;
+
+        if (line.entry.device_set == device_set && line.entry.mtime == mtime_of(line.entry.module))
+            return line.entry;
+
+        return {};
+    }
+
+    return {};
+}
+
+void mir::ProbeCache::store(std::string const& kind, Entry const& entry)
+{
+    if (file.empty())
+        return;
+
+    auto lines = read_lines(file);
+
+    bool replaced{false};
+    for (auto& line : lines)
+    {
+        if (line.kind == kind)
+        {
+            line.entry = entry;
+            replaced = true;
+        }
+    }
+
+    if (!replaced)
+        lines.push_back({kind, entry});
+
+    // Write a whole new file and rename it into place so that a concurrent
+    // start never reads a half written cache
+    make_parent_directories(file);
+    auto const tmp = file + "." + std::to_string(getpid());
+    {
+        std::ofstream out{tmp, std::ios::trunc};
+        for (auto const& line : lines)
+        {
+            out << line.kind << ' ' << line.entry.device_set << ' ' << line.entry.priority << ' '
+                << line.entry.mtime << ' ' << line.entry.module << '\n';
+        }
+
+        if (!out.flush())
+        {
+            unlink(tmp.c_str());
+            return;
+        }
+    }
+
+    if (rename(tmp.c_str(), file.c_str()) != 0)
+        unlink(tmp.c_str());
+}
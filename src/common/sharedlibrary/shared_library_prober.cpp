@@ -21,7 +21,10 @@
 
 #include <boost/filesystem.hpp>
 
+#include <condition_variable>
+#include <mutex>
 #include <system_error>
+#include <thread>
 #include <cstring>
 
 namespace
@@ -63,10 +66,7 @@ bool greater_soname_version(boost::filesystem::path const& lhs, boost::filesyste
 }
 }
 
-void mir::select_libraries_for_path(
-    std::string const& path,
-    std::function<Selection(std::shared_ptr<mir::SharedLibrary> const&)> const& selector,
-    mir::SharedLibraryProberReport& report)
+std::vector<std::string> mir::library_paths_for(std::string const& path, mir::SharedLibraryProberReport& report)
 {
     report.probing_path(path);
     // We use the error_code overload because we want to throw a std::system_error
@@ -84,17 +84,29 @@ void mir::select_libraries_for_path(
     for (; iterator != boost::filesystem::directory_iterator() ; ++iterator)
     {
         if (path_has_library_extension(iterator->path()))
-            libraries.push_back(iterator->path().string());
+            libraries.push_back(iterator->path());
     }
 
     std::sort(libraries.begin(), libraries.end(), &greater_soname_version);
 
-    for(auto& lib : libraries)
+    std::vector<std::string> library_paths;
+    for (auto const& library : libraries)
+        library_paths.push_back(library.string());
+
+    return library_paths;
+}
+
+void mir::select_libraries_for_path(
+    std::string const& path,
+    std::function<Selection(std::shared_ptr<mir::SharedLibrary> const&)> const& selector,
+    mir::SharedLibraryProberReport& report)
+{
+    for(auto& lib : library_paths_for(path, report))
     {
         try
         {
             report.loading_library(lib);
-            auto const shared_lib = std::make_shared<mir::SharedLibrary>(lib.string());
+            auto const shared_lib = std::make_shared<mir::SharedLibrary>(lib);
 
             if (selector(shared_lib) == Selection::quit)
                 return;
@@ -119,3 +131,91 @@ mir::libraries_for_path(std::string const& path, mir::SharedLibraryProberReport&
 
     return result;
 }
+
+std::vector<mir::ProbedLibrary> mir::probe_libraries_in_parallel(
+    std::vector<std::string> const& library_paths,
+    std::function<int(SharedLibrary const&)> const& probe,
+    std::chrono::milliseconds timeout,
+    SharedLibraryProberReport& report)
+{
+    /*
+     * Shared with the probing threads, so that a thread we give up waiting
+     * for can still finish (and unload its library) safely afterwards.
+     */
+    struct Probing
+    {
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::vector<ProbedLibrary> results;
+        std::vector<std::exception_ptr> errors;
+        std::vector<bool> done;
+        size_t outstanding;
+    };
+
+    auto const probing = std::make_shared<Probing>();
+    probing->results.resize(library_paths.size());
+    probing->errors.resize(library_paths.size());
+    probing->done.resize(library_paths.size(), false);
+    probing->outstanding = library_paths.size();
+
+    for (size_t i = 0; i != library_paths.size(); ++i)
+    {
+        report.loading_library(library_paths[i]);
+
+        std::thread{
+            [probing, probe, i, path = library_paths[i]]
+            {
+                ProbedLibrary result{path, nullptr, 0};
+                std::exception_ptr error;
+                try
+                {
+                    result.library = std::make_shared<SharedLibrary>(path);
+                    result.priority = probe(*result.library);
+                }
+                catch (...)
+                {
+                    // Handed back to the calling thread, as escaping here would terminate
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock{probing->mutex};
+                probing->results[i] = std::move(result);
+                probing->errors[i] = error;
+                probing->done[i] = true;
+                --probing->outstanding;
+                probing->finished.notify_all();
+            }}.detach();
+    }
+
+    std::vector<ProbedLibrary> probed;
+
+    std::unique_lock<std::mutex> lock{probing->mutex};
+    probing->finished.wait_for(lock, timeout, [&] { return probing->outstanding == 0; });
+
+    for (size_t i = 0; i != library_paths.size(); ++i)
+    {
+        if (!probing->done[i])
+        {
+            report.loading_failed(library_paths[i], std::runtime_error{"Probe timed out"});
+        }
+        else if (auto const error = probing->errors[i])
+        {
+            // Only load and probe failures are reported: anything else is an
+            // error for the caller, as when libraries were probed on its thread
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (std::runtime_error const& err)
+            {
+                report.loading_failed(library_paths[i], err);
+            }
+        }
+        else
+        {
+            probed.push_back(std::move(probing->results[i]));
+        }
+    }
+
+    return probed;
+}
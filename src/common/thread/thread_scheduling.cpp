@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/thread_scheduling.h"
+
+#define MIR_LOG_COMPONENT "thread"
+#include "mir/log.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+int parse_int(std::string const& text, std::string const& what)
+{
+    std::size_t consumed{0};
+    int value{0};
+
+    try
+    {
+        value = std::stoi(text, &consumed);
+    }
+    catch (std::logic_error const&)
+    {
+        consumed = 0;
+    }
+
+    if (text.empty() || consumed != text.size())
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Invalid " + what + ": \"" + text + "\""));
+
+    return value;
+}
+
+std::vector<int> parse_cpus(std::string const& cpus)
+{
+    std::vector<int> result;
+    std::string::size_type start{0};
+
+    while (start < cpus.size())
+    {
+        auto end = cpus.find(',', start);
+        if (end == std::string::npos)
+            end = cpus.size();
+
+        auto const item = cpus.substr(start, end - start);
+        auto const dash = item.find('-');
+
+        int const first = parse_int(item.substr(0, dash), "CPU");
+        int const last = dash == std::string::npos ? first : parse_int(item.substr(dash + 1), "CPU");
+
+        if (first < 0 || last < first || last >= CPU_SETSIZE)
+            BOOST_THROW_EXCEPTION(std::invalid_argument("Invalid CPU range: \"" + item + "\""));
+
+        for (int cpu = first; cpu <= last; ++cpu)
+            result.push_back(cpu);
+
+        start = end + 1;
+    }
+
+    return result;
+}
+}
+
+mir::ThreadScheduling mir::parse_thread_scheduling(std::string const& policy, std::string const& cpus)
+{
+    ThreadScheduling result;
+    result.cpus = parse_cpus(cpus);
+
+    if (policy.empty() || policy == "inherit")
+        return result;
+
+    auto const colon = policy.find(':');
+    auto const name = policy.substr(0, colon);
+
+    if (colon == std::string::npos)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Missing priority in thread scheduling: \"" + policy + "\""));
+
+    auto const priority = parse_int(policy.substr(colon + 1), "thread priority");
+
+    if (name == "fifo" || name == "rr")
+    {
+        result.policy = name == "fifo" ? ThreadScheduling::Policy::fifo : ThreadScheduling::Policy::round_robin;
+
+        auto const policy_id = name == "fifo" ? SCHED_FIFO : SCHED_RR;
+        if (priority < sched_get_priority_min(policy_id) || priority > sched_get_priority_max(policy_id))
+            BOOST_THROW_EXCEPTION(std::invalid_argument("Real-time priority out of range: \"" + policy + "\""));
+    }
+    else if (name == "nice")
+    {
+        result.policy = ThreadScheduling::Policy::nice;
+
+        if (priority < -20 || priority > 19)
+            BOOST_THROW_EXCEPTION(std::invalid_argument("Nice value out of range: \"" + policy + "\""));
+    }
+    else
+    {
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Unknown thread scheduling policy: \"" + policy + "\""));
+    }
+
+    result.priority = priority;
+    return result;
+}
+
+void mir::apply_thread_scheduling(ThreadScheduling const& scheduling)
+{
+    switch (scheduling.policy)
+    {
+    case ThreadScheduling::Policy::inherit:
+        break;
+
+    case ThreadScheduling::Policy::nice:
+        // On Linux the nice value is per-thread when addressed by tid
+        if (setpriority(PRIO_PROCESS, syscall(SYS_gettid), scheduling.priority) != 0)
+            log_warning("Failed to set nice value %d: %s", scheduling.priority, strerror(errno));
+        break;
+
+    case ThreadScheduling::Policy::fifo:
+    case ThreadScheduling::Policy::round_robin:
+    {
+        sched_param param{};
+        param.sched_priority = scheduling.priority;
+        auto const policy = scheduling.policy == ThreadScheduling::Policy::fifo ? SCHED_FIFO : SCHED_RR;
+
+        if (auto const error = pthread_setschedparam(pthread_self(), policy, &param))
+            log_warning("Failed to set real-time priority %d: %s", scheduling.priority, strerror(error));
+        break;
+    }
+    }
+
+    if (!scheduling.cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (auto const cpu : scheduling.cpus)
+            CPU_SET(cpu, &set);
+
+        if (auto const error = pthread_setaffinity_np(pthread_self(), sizeof set, &set))
+            log_warning("Failed to set CPU affinity: %s", strerror(error));
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/time/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mt = mir::time;
+
+namespace
+{
+uint64_t constexpr half_sub_bucket_count = 1 << 6;
+}
+
+mt::LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void mt::LatencyHistogram::record(std::chrono::nanoseconds latency)
+{
+    uint64_t const value = std::max<int64_t>(latency.count(), 0);
+
+    buckets[index_for(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t mt::LatencyHistogram::count() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds mt::LatencyHistogram::value_at_percentile(double percentile) const
+{
+    auto const recorded = count();
+    if (recorded == 0)
+        return std::chrono::nanoseconds{0};
+
+    auto const target = std::max<uint64_t>(
+        static_cast<uint64_t>(std::ceil(std::min(percentile, 100.0) / 100.0 * recorded)), 1);
+
+    uint64_t seen{0};
+    for (size_t index = 0; index != bucket_count; ++index)
+    {
+        seen += buckets[index].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return std::chrono::nanoseconds{highest_value_in(index)};
+    }
+
+    // Only reachable while other threads are recording
+    return std::chrono::nanoseconds{highest_value_in(bucket_count - 1)};
+}
+
+void mt::LatencyHistogram::reset()
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+}
+
+size_t mt::LatencyHistogram::index_for(uint64_t value)
+{
+    uint64_t const max_value = (uint64_t{1} << max_value_bits) - 1;
+    value = std::min(value, max_value);
+
+    if (value < (1u << sub_bucket_bits))
+        return value;
+
+    // Values in [2^n, 2^(n+1)) share a magnitude and are split by their top bits
+    int const magnitude = 63 - __builtin_clzll(value);
+    int const shift = magnitude - sub_bucket_bits + 1;
+    auto const mantissa = value >> shift;
+
+    return (1u << sub_bucket_bits) + (shift - 1) * half_sub_bucket_count + (mantissa - half_sub_bucket_count);
+}
+
+uint64_t mt::LatencyHistogram::highest_value_in(size_t index)
+{
+    if (index < (1u << sub_bucket_bits))
+        return index;
+
+    auto const offset = index - (1u << sub_bucket_bits);
+    auto const shift = offset / half_sub_bucket_count + 1;
+    auto const mantissa = half_sub_bucket_count + offset % half_sub_bucket_count;
+
+    return ((mantissa + 1) << shift) - 1;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/trace/allocation_profile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace mt = mir::trace;
+
+namespace
+{
+// Plain thread-local data: reading it from operator new must not itself allocate
+thread_local mt::AllocationSite* current_site{nullptr};
+
+std::atomic<mt::AllocationSite*> sites{nullptr};
+
+void count(std::atomic<uint64_t>& counter, uint64_t by = 1)
+{
+    counter.fetch_add(by, std::memory_order_relaxed);
+}
+
+#ifdef MIR_ALLOC_PROFILING
+void report_sites()
+{
+    fprintf(stderr, "Allocation profile:\n");
+    fprintf(stderr, "  %-24s %12s %12s %12s %14s %10s\n",
+            "site", "entries", "allocations", "frees", "bytes", "per entry");
+
+    for (auto site = mt::allocation_sites(); site; site = site->next)
+    {
+        auto const entries = site->entries.load();
+        auto const allocations = site->allocations.load();
+        fprintf(stderr, "  %-24s %12llu %12llu %12llu %14llu %10.2f\n",
+                site->name,
+                static_cast<unsigned long long>(entries),
+                static_cast<unsigned long long>(allocations),
+                static_cast<unsigned long long>(site->deallocations.load()),
+                static_cast<unsigned long long>(site->bytes_allocated.load()),
+                entries ? static_cast<double>(allocations) / entries : 0.0);
+    }
+}
+
+void* allocate(std::size_t size)
+{
+    if (auto const site = current_site)
+    {
+        count(site->allocations);
+        count(site->bytes_allocated, size);
+    }
+
+    if (size == 0)
+        size = 1;
+
+    for (;;)
+    {
+        if (auto const memory = std::malloc(size))
+            return memory;
+
+        auto const handler = std::get_new_handler();
+        if (!handler)
+            return nullptr;
+
+        handler();
+    }
+}
+
+void deallocate(void* memory) noexcept
+{
+    if (!memory)
+        return;
+
+    if (auto const site = current_site)
+        count(site->deallocations);
+
+    std::free(memory);
+}
+#endif
+}
+
+mt::AllocationSite::AllocationSite(char const* name) :
+    name{name}
+{
+#ifdef MIR_ALLOC_PROFILING
+    static bool const reporting = [] { return std::atexit(&report_sites) == 0; }();
+    (void)reporting;
+#endif
+
+    next = sites.load();
+    while (!sites.compare_exchange_weak(next, this))
+        ;
+}
+
+mt::AllocationScope::AllocationScope(AllocationSite& site) :
+    enclosing{current_site}
+{
+    count(site.entries);
+    current_site = &site;
+}
+
+mt::AllocationScope::~AllocationScope()
+{
+    current_site = enclosing;
+}
+
+auto mt::allocation_sites() -> AllocationSite const*
+{
+    return sites.load();
+}
+
+auto mt::current_allocation_site() -> AllocationSite*
+{
+    return current_site;
+}
+
+#ifdef MIR_ALLOC_PROFILING
+void* operator new(std::size_t size)
+{
+    if (auto const memory = allocate(size))
+        return memory;
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    try
+    {
+        return allocate(size);
+    }
+    catch (std::bad_alloc const&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const& nothrow) noexcept
+{
+    return operator new(size, nothrow);
+}
+
+void operator delete(void* memory) noexcept
+{
+    deallocate(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    deallocate(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    deallocate(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    deallocate(memory);
+}
+
+void operator delete(void* memory, std::nothrow_t const&) noexcept
+{
+    deallocate(memory);
+}
+
+void operator delete[](void* memory, std::nothrow_t const&) noexcept
+{
+    deallocate(memory);
+}
+#endif
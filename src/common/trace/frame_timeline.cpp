@@ -0,0 +1,293 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/trace/frame_timeline.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace mt = mir::trace;
+
+struct mt::FrameTimeline::Event
+{
+    /// 0 when never written, odd while being written, 2 * (index + 1) once written
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<int64_t> begin{0};
+    std::atomic<int64_t> end{0};
+    std::atomic<uint64_t> frame{0};
+    std::atomic<uint64_t> surface{0};
+    std::atomic<uint64_t> buffer{0};
+    std::atomic<int32_t> tid{0};
+    std::atomic<uint8_t> stage{0};
+};
+
+namespace
+{
+char const* name_of(mt::FrameStage stage)
+{
+    switch (stage)
+    {
+    case mt::FrameStage::client_submit: return "client_submit";
+    case mt::FrameStage::compositor_wake: return "compositor_wake";
+    case mt::FrameStage::scene_elements: return "scene_elements";
+    case mt::FrameStage::render: return "render";
+    case mt::FrameStage::swap: return "swap";
+    case mt::FrameStage::page_flip: return "page_flip";
+    case mt::FrameStage::buffer_release: return "buffer_release";
+    }
+    return "unknown";
+}
+
+int32_t this_thread_id()
+{
+    thread_local int32_t const tid = syscall(SYS_gettid);
+    return tid;
+}
+
+std::string thread_name(int32_t tid)
+{
+    std::ifstream comm{"/proc/self/task/" + std::to_string(tid) + "/comm"};
+    std::string name;
+    if (!std::getline(comm, name) || name.empty())
+        name = "thread " + std::to_string(tid);
+    return name;
+}
+
+// Trace event timestamps are in microseconds
+void write_microseconds(std::ostream& out, int64_t ns)
+{
+    auto const fraction = std::to_string(ns % 1000);
+    out << ns / 1000 << '.' << std::string(3 - fraction.size(), '0') << fraction;
+}
+
+// Tracing threads keep their own reference to the installed timeline, and
+// only take timeline_mutex to refresh it after set_frame_timeline() has bumped
+// timeline_generation. A replaced timeline is freed once every thread that
+// traced to it has traced again or exited.
+std::mutex timeline_mutex;
+std::shared_ptr<mt::FrameTimeline> installed_timeline;
+std::atomic<uint64_t> timeline_generation{0};
+
+struct ThreadTimeline
+{
+    uint64_t generation{0};
+    std::shared_ptr<mt::FrameTimeline> timeline;
+};
+
+ThreadTimeline const& this_thread_timeline()
+{
+    thread_local ThreadTimeline current;
+
+    auto const generation = timeline_generation.load(std::memory_order_acquire);
+
+    if (current.generation != generation)
+    {
+        std::lock_guard<decltype(timeline_mutex)> lock{timeline_mutex};
+        current.timeline = installed_timeline;
+        current.generation = generation;
+    }
+
+    return current;
+}
+
+thread_local uint64_t this_thread_frame{0};
+}
+
+mt::FrameTimeline::FrameTimeline(size_t capacity) :
+    capacity{capacity},
+    events{capacity ? new Event[capacity] : nullptr}
+{
+    if (!capacity)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Frame timeline capacity must be positive"));
+}
+
+mt::FrameTimeline::~FrameTimeline() = default;
+
+void mt::FrameTimeline::record(
+    FrameStage stage,
+    std::chrono::nanoseconds begin,
+    std::chrono::nanoseconds end,
+    uint64_t frame,
+    uint64_t surface,
+    uint64_t buffer)
+{
+    auto const index = next.fetch_add(1, std::memory_order_relaxed);
+    auto& event = events[index % capacity];
+
+    // A seqlock per slot lets write_chrome_json() skip slots that are being overwritten
+    event.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.begin.store(begin.count(), std::memory_order_relaxed);
+    event.end.store(end.count(), std::memory_order_relaxed);
+    event.frame.store(frame, std::memory_order_relaxed);
+    event.surface.store(surface, std::memory_order_relaxed);
+    event.buffer.store(buffer, std::memory_order_relaxed);
+    event.tid.store(this_thread_id(), std::memory_order_relaxed);
+    event.stage.store(static_cast<uint8_t>(stage), std::memory_order_relaxed);
+
+    event.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+void mt::FrameTimeline::write_chrome_json(std::ostream& out) const
+{
+    auto const pid = getpid();
+    auto const end = next.load(std::memory_order_acquire);
+    auto const begin = end > capacity ? end - capacity : 0;
+
+    std::set<int32_t> threads;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    char const* separator = "\n";
+    for (auto index = begin; index != end; ++index)
+    {
+        auto const& event = events[index % capacity];
+
+        auto const sequence = event.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2)
+            continue;
+
+        auto const event_begin = event.begin.load(std::memory_order_relaxed);
+        auto const event_end = event.end.load(std::memory_order_relaxed);
+        auto const frame = event.frame.load(std::memory_order_relaxed);
+        auto const surface = event.surface.load(std::memory_order_relaxed);
+        auto const buffer = event.buffer.load(std::memory_order_relaxed);
+        auto const tid = event.tid.load(std::memory_order_relaxed);
+        auto const stage = static_cast<FrameStage>(event.stage.load(std::memory_order_relaxed));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        threads.insert(tid);
+
+        out << separator << "{\"name\":\"" << name_of(stage) << "\",\"cat\":\"frame\",";
+        if (event_end == event_begin)
+        {
+            out << "\"ph\":\"i\",\"s\":\"t\",";
+        }
+        else
+        {
+            out << "\"ph\":\"X\",\"dur\":";
+            write_microseconds(out, event_end - event_begin);
+            out << ',';
+        }
+        out << "\"ts\":";
+        write_microseconds(out, event_begin);
+        out << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"args\":{";
+
+        char const* arg_separator = "";
+        if (frame)
+        {
+            out << "\"frame\":" << frame;
+            arg_separator = ",";
+        }
+        if (surface)
+        {
+            out << arg_separator << "\"surface\":" << surface;
+            arg_separator = ",";
+        }
+        if (buffer)
+            out << arg_separator << "\"buffer\":" << buffer;
+        out << "}}";
+
+        separator = ",\n";
+    }
+
+    // Name the threads, so the timeline shows "Mir/Comp" rather than a bare thread ID
+    for (auto const tid : threads)
+    {
+        out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+            << ",\"args\":{\"name\":\"";
+        for (auto const c : thread_name(tid))
+        {
+            if (c == '"' || c == '\\')
+                out << '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                out << c;
+        }
+        out << "\"}}";
+        separator = ",\n";
+    }
+
+    out << "\n]}\n";
+}
+
+void mt::set_frame_timeline(std::shared_ptr<FrameTimeline> const& timeline)
+{
+    std::lock_guard<decltype(timeline_mutex)> lock{timeline_mutex};
+    installed_timeline = timeline;
+    timeline_generation.fetch_add(1, std::memory_order_release);
+}
+
+mt::FrameTimeline* mt::frame_timeline()
+{
+    return this_thread_timeline().timeline.get();
+}
+
+std::chrono::nanoseconds mt::frame_trace_now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+}
+
+void mt::set_current_frame(uint64_t frame)
+{
+    this_thread_frame = frame;
+}
+
+uint64_t mt::current_frame()
+{
+    return this_thread_frame;
+}
+
+void mt::trace_frame_event(FrameStage stage, uint64_t surface, uint64_t buffer)
+{
+    if (auto const timeline = frame_timeline())
+    {
+        auto const now = frame_trace_now();
+        timeline->record(stage, now, now, this_thread_frame, surface, buffer);
+    }
+}
+
+mt::FrameStageTrace::FrameStageTrace(FrameStage stage, uint64_t surface, uint64_t buffer) :
+    timeline{frame_timeline()},
+    generation{this_thread_timeline().generation},
+    stage{stage},
+    surface{surface},
+    buffer{buffer},
+    begin{timeline ? frame_trace_now() : std::chrono::nanoseconds{0}}
+{
+}
+
+mt::FrameStageTrace::~FrameStageTrace()
+{
+    // If the timeline was replaced meanwhile this thread may have let go of it
+    if (timeline && this_thread_timeline().generation == generation)
+        timeline->record(stage, begin, frame_trace_now(), this_thread_frame, surface, buffer);
+}
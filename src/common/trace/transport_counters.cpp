@@ -0,0 +1,35 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/trace/transport_counters.h"
+
+namespace mt = mir::trace;
+
+namespace
+{
+// Keep each side on its own cache line; in-process tests run both
+struct alignas(64) AlignedCounters : mt::TransportCounters
+{
+};
+
+AlignedCounters client_counters;
+AlignedCounters server_counters;
+}
+
+mt::TransportCounters& mt::transport_counters(TransportSide side)
+{
+    return side == TransportSide::client ? client_counters : server_counters;
+}
@@ -23,6 +23,11 @@
 
 namespace mgl = mir::gl;
 
+mgl::DefaultProgramFactory::DefaultProgramFactory(std::shared_ptr<memory::Account> const& texture_account) :
+    texture_account{texture_account}
+{
+}
+
 std::unique_ptr<mgl::Program>
 mgl::DefaultProgramFactory::create_gl_program(
     std::string const& vertex_shader,
@@ -35,5 +40,5 @@ mgl::DefaultProgramFactory::create_gl_program(
 
 std::unique_ptr<mgl::TextureCache> mgl::DefaultProgramFactory::create_texture_cache() const
 {
-    return std::make_unique<RecentlyUsedCache>();
+    return std::make_unique<RecentlyUsedCache>(texture_account);
 }
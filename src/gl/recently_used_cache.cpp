@@ -29,6 +29,11 @@ namespace mgl = mir::gl;
 namespace geom = mir::geometry;
 namespace mrgl = mir::renderer::gl;
 
+mgl::RecentlyUsedCache::RecentlyUsedCache(std::shared_ptr<memory::Account> const& texture_account) :
+    texture_account{texture_account}
+{
+}
+
 std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const& renderable)
 {
     auto const& buffer = renderable.buffer();
@@ -45,6 +50,18 @@ std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const&
         texture_source->bind();
         texture.resource = buffer;
         texture.last_bound_buffer = buffer_id;
+
+        if (texture_account)
+        {
+            auto const size = buffer->size();
+            auto const bytes = size_t(size.width.as_int()) * size.height.as_int() *
+                MIR_BYTES_PER_PIXEL(buffer->pixel_format());
+            if (bytes != texture.charge.bytes())
+            {
+                texture.charge = mir::memory::Charge{};
+                texture.charge = texture_account->charge(mir::memory::Subsystem::textures, bytes);
+            }
+        }
     }
     texture_source->secure_for_render();
 
@@ -24,6 +24,7 @@
 #include "mir/gl/texture.h"
 #include "mir/graphics/buffer_id.h"
 #include "mir/graphics/renderable.h"
+#include "mir/memory/accounting.h"
 #include <unordered_map>
 
 namespace mir
@@ -34,6 +35,9 @@ namespace gl
 class RecentlyUsedCache : public TextureCache
 {
 public:
+    /// The textures loaded are charged to texture_account, if there is one
+    explicit RecentlyUsedCache(std::shared_ptr<memory::Account> const& texture_account = nullptr);
+
     std::shared_ptr<Texture> load(graphics::Renderable const& renderable) override;
     void invalidate() override;
     void drop_unused() override;
@@ -49,8 +53,10 @@ private:
         bool used{true};
         bool valid_binding{false};
         std::shared_ptr<graphics::Buffer> resource;
+        memory::Charge charge;
     };
 
+    std::shared_ptr<memory::Account> const texture_account;
     std::unordered_map<graphics::Renderable::ID, Entry> textures;
 };
 }
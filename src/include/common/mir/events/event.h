@@ -25,6 +25,7 @@
 
 #include <capnp/message.h>
 
+#include <cstddef>
 #include <cstring>
 
 struct MirEvent
@@ -32,6 +33,10 @@ struct MirEvent
     MirEvent(MirEvent const& event);
     MirEvent& operator=(MirEvent const& event);
 
+    // Event storage is recycled through a small pool rather than the heap
+    static void* operator new(std::size_t size);
+    static void operator delete(void* event, std::size_t size) noexcept;
+
     MirEventType type() const;
 
     MirInputEvent* to_input();
@@ -76,7 +81,12 @@ struct MirEvent
 protected:
     MirEvent() = default;
 
-    ::capnp::MallocMessageBuilder message;
+    // Room for a pointer or keyboard event, or a touch event of a few contacts,
+    // so building one needs no heap segment. Larger events spill to the heap.
+    static std::size_t constexpr inline_segment_words = 48;
+
+    ::capnp::word inline_segment[inline_segment_words]{};
+    ::capnp::MallocMessageBuilder message{kj::ArrayPtr<::capnp::word>{inline_segment, inline_segment_words}};
     mir::capnp::Event::Builder event{message.initRoot<mir::capnp::Event>()};
 };
 
@@ -57,6 +57,13 @@ struct MirPointerEvent : MirInputEvent
     float hscroll() const;
     void set_hscroll(float h);
 
+    // The predicted position; x() and y() unless a prediction has been set
+    float predicted_x() const;
+    void set_predicted_x(float x);
+
+    float predicted_y() const;
+    void set_predicted_y(float y);
+
     MirPointerAction action() const;
     void set_action(MirPointerAction action);
 
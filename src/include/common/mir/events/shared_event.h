@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_EVENTS_SHARED_EVENT_H_
+#define MIR_EVENTS_SHARED_EVENT_H_
+
+#include "mir_toolkit/event.h"
+#include "mir/fixed_block_pool.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace mir
+{
+using EventUPtr = std::unique_ptr<MirEvent, void(*)(MirEvent*)>;
+
+namespace events
+{
+namespace detail
+{
+using ControlBlockPool = FixedBlockPool<8 * sizeof(void*), 64>;
+
+inline ControlBlockPool& control_blocks()
+{
+    // Deliberately never destroyed: shared events can outlive static destruction
+    static auto const pool = new ControlBlockPool;
+    return *pool;
+}
+
+template<typename T>
+struct ControlBlockAllocator
+{
+    using value_type = T;
+
+    ControlBlockAllocator() = default;
+    template<typename U>
+    ControlBlockAllocator(ControlBlockAllocator<U> const&) {}
+
+    static bool pooled(std::size_t n)
+    {
+        return n == 1 && sizeof(T) <= ControlBlockPool::block_size && alignof(T) <= alignof(std::max_align_t);
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (pooled(n))
+            return static_cast<T*>(control_blocks().allocate());
+
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        if (pooled(n))
+            control_blocks().release(p);
+        else
+            ::operator delete(p);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(ControlBlockAllocator<T> const&, ControlBlockAllocator<U> const&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(ControlBlockAllocator<T> const&, ControlBlockAllocator<U> const&) { return false; }
+}
+
+/**
+ * Hands an event over to shared ownership.
+ *
+ * Converting an EventUPtr to a std::shared_ptr directly heap-allocates a
+ * control block for every event; this recycles them instead.
+ */
+inline std::shared_ptr<MirEvent> share_event(EventUPtr&& event)
+{
+    auto const deleter = event.get_deleter();
+    return {event.release(), deleter, detail::ControlBlockAllocator<MirEvent>{}};
+}
+}
+}
+
+#endif /* MIR_EVENTS_SHARED_EVENT_H_ */
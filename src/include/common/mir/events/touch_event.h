@@ -45,6 +45,13 @@ struct MirTouchEvent : MirInputEvent
     float y(size_t index) const;
     void set_y(size_t index, float y);
 
+    // The predicted position; x() and y() unless a prediction has been set
+    float predicted_x(size_t index) const;
+    void set_predicted_x(size_t index, float x);
+
+    float predicted_y(size_t index) const;
+    void set_predicted_y(size_t index, float y);
+
     float touch_major(size_t index) const;
     void set_touch_major(size_t index, float major);
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FIXED_BLOCK_POOL_H_
+#define MIR_FIXED_BLOCK_POOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace mir
+{
+
+/**
+ * A bounded free list of equally sized heap blocks.
+ *
+ * Blocks come from the heap the first time they are needed and are kept for
+ * reuse when released, up to MaxFree of them; any surplus goes straight back
+ * to the heap. Objects created and destroyed at a steady rate therefore stop
+ * touching the allocator once the pool has warmed up.
+ */
+template<std::size_t BlockSize, std::size_t MaxFree>
+class FixedBlockPool
+{
+public:
+    static std::size_t constexpr block_size = BlockSize < sizeof(void*) ? sizeof(void*) : BlockSize;
+
+    FixedBlockPool() = default;
+
+    ~FixedBlockPool()
+    {
+        while (free_list)
+        {
+            auto const next = free_list->next;
+            ::operator delete(free_list);
+            free_list = next;
+        }
+    }
+
+    void* allocate()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (free_list)
+            {
+                auto const block = free_list;
+                free_list = block->next;
+                --free_count;
+                return block;
+            }
+        }
+
+        return ::operator new(block_size);
+    }
+
+    void release(void* block) noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (free_count < MaxFree)
+            {
+                free_list = new (block) FreeBlock{free_list};
+                ++free_count;
+                return;
+            }
+        }
+
+        ::operator delete(block);
+    }
+
+private:
+    FixedBlockPool(FixedBlockPool const&) = delete;
+    FixedBlockPool& operator=(FixedBlockPool const&) = delete;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    std::mutex mutex;
+    FreeBlock* free_list{nullptr};
+    std::size_t free_count{0};
+};
+
+}
+
+#endif /* MIR_FIXED_BLOCK_POOL_H_ */
@@ -0,0 +1,108 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_INPUT_RECORDING_H_
+#define MIR_INPUT_INPUT_RECORDING_H_
+
+#include "mir_toolkit/event.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace input
+{
+/**
+ * The device description stored in an input recording. Capabilities hold the
+ * raw bits of mir::input::DeviceCapabilities.
+ */
+struct RecordedInputDevice
+{
+    std::string name;
+    std::string unique_id;
+    uint32_t capabilities;
+};
+
+struct InputRecord
+{
+    enum class Type : uint8_t
+    {
+        device_added = 1,
+        device_removed = 2,
+        event = 3
+    };
+
+    Type type;
+    std::chrono::nanoseconds timestamp;
+    uint32_t device;
+    RecordedInputDevice info;           ///< only set for device_added
+    std::shared_ptr<MirEvent> event;    ///< only set for event
+};
+
+/**
+ * Writes a stream of timestamped device additions, removals and input events.
+ *
+ * The format is a fixed header followed by records of
+ *   uint8 type, int64 timestamp, uint32 device, uint32 payload size, payload
+ * in host byte order. Event payloads hold MirEvent::serialize() bytes, so a
+ * recording is only meant to be replayed on the machine type it came from.
+ */
+class InputRecordingWriter
+{
+public:
+    explicit InputRecordingWriter(std::ostream& out);
+
+    void device_added(std::chrono::nanoseconds timestamp, uint32_t device, RecordedInputDevice const& info);
+    void device_removed(std::chrono::nanoseconds timestamp, uint32_t device);
+    void event(std::chrono::nanoseconds timestamp, uint32_t device, MirEvent const& event);
+
+private:
+    InputRecordingWriter(InputRecordingWriter const&) = delete;
+    InputRecordingWriter& operator=(InputRecordingWriter const&) = delete;
+
+    void write_record(InputRecord::Type type, std::chrono::nanoseconds timestamp, uint32_t device,
+                      std::string const& payload);
+
+    std::ostream& out;
+};
+
+class InputRecordingReader
+{
+public:
+    /// \throws std::runtime_error if the stream does not start with a recording header
+    explicit InputRecordingReader(std::istream& in);
+
+    /**
+     * Reads the next record.
+     * \returns false at the end of the recording
+     * \throws std::runtime_error on a truncated or malformed record
+     */
+    bool next(InputRecord& record);
+
+private:
+    InputRecordingReader(InputRecordingReader const&) = delete;
+    InputRecordingReader& operator=(InputRecordingReader const&) = delete;
+
+    std::istream& in;
+};
+}
+}
+
+#endif // MIR_INPUT_INPUT_RECORDING_H_
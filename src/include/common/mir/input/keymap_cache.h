@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_KEYMAP_CACHE_H_
+#define MIR_INPUT_KEYMAP_CACHE_H_
+
+#include "mir/input/xkb_mapper.h"
+#include "mir/input/keymap.h"
+
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace input
+{
+
+/**
+ * Compiled XKB keymaps and compose tables shared across a process.
+ *
+ * Compiling a keymap from RMLVO names, or a compose table from a locale, takes
+ * tens of milliseconds. The cache compiles each at most once and hands the
+ * result to every XKBMapper that asks for it. Keymaps supplied as serialised
+ * buffers are cached by content, so several mappers receiving the same keymap
+ * from the server share one compilation.
+ *
+ * libxkbcommon reference counts are not thread safe, so states referring to a
+ * cached keymap or compose table must be created with make_state() and
+ * make_compose_state(), which serialise the reference counting.
+ *
+ * If persist_dir is not empty, keymaps compiled from names are also written
+ * there in serialised form and later processes only need to parse them. The
+ * persisted keymaps are not invalidated when the XKB data files change.
+ */
+class KeymapCache
+{
+public:
+    explicit KeymapCache(std::string const& persist_dir);
+    ~KeymapCache();
+
+    std::shared_ptr<xkb_keymap> keymap(Keymap const& names);
+    std::shared_ptr<xkb_keymap> keymap(char const* buffer, size_t size);
+
+    /// The keymap for names serialised as XKB_KEYMAP_FORMAT_TEXT_V1
+    std::string keymap_string(Keymap const& names);
+
+    /// A new compose state for locale, or a null state if locale has no compose table
+    XKBComposeStatePtr make_compose_state(std::string const& locale);
+
+    static XKBStatePtr make_state(xkb_keymap* keymap);
+
+    /**
+     * The cache shared by the process. Keymaps are persisted below
+     * $XDG_CACHE_HOME/mir/keymaps when MIR_KEYMAP_CACHE is set in the environment.
+     */
+    static std::shared_ptr<KeymapCache> instance();
+
+private:
+    KeymapCache(KeymapCache const&) = delete;
+    KeymapCache& operator=(KeymapCache const&) = delete;
+
+    struct Self;
+    std::unique_ptr<Self> const self;
+};
+}
+}
+
+#endif // MIR_INPUT_KEYMAP_CACHE_H_
@@ -46,6 +46,8 @@ using XKBStatePtr = std::unique_ptr<xkb_state, void(*)(xkb_state*)>;
 using XKBComposeTablePtr = std::unique_ptr<xkb_compose_table, void(*)(xkb_compose_table*)>;
 using XKBComposeStatePtr = std::unique_ptr<xkb_compose_state, void(*)(xkb_compose_state*)>;
 
+class KeymapCache;
+
 namespace receiver
 {
 
@@ -70,15 +72,15 @@ protected:
     XKBMapper& operator=(XKBMapper const&) = delete;
 
 private:
-    void set_keymap(MirInputDeviceId id, XKBKeymapPtr map);
-    void set_keymap(XKBKeymapPtr map);
+    void set_keymap(MirInputDeviceId id, std::shared_ptr<xkb_keymap> const& map);
+    void set_keymap(std::shared_ptr<xkb_keymap> const& map);
     void update_modifier();
 
     std::mutex mutable guard;
 
     struct ComposeState
     {
-        ComposeState(XKBComposeTablePtr const& table);
+        explicit ComposeState(XKBComposeStatePtr state);
         void update_and_map(MirEvent& event);
         xkb_keysym_t update_state(xkb_keysym_t mapped_key, MirKeyboardAction action, std::string& text);
     private:
@@ -107,9 +109,12 @@ private:
     XkbMappingState* get_keymapping_state(MirInputDeviceId id);
     ComposeState* get_compose_state(MirInputDeviceId id);
 
-    XKBContextPtr context;
+    KeymapCache& the_cache();
+
+    std::once_flag cache_created;
+    std::shared_ptr<KeymapCache> cache;
+    std::string const compose_locale;
     std::shared_ptr<xkb_keymap> default_keymap;
-    XKBComposeTablePtr compose_table;
 
     mir::optional_value<MirInputEventModifiers> modifier_state;
     std::unordered_map<MirInputDeviceId, std::unique_ptr<XkbMappingState>> device_mapping;
@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_LOGGING_ASYNC_LOGGER_H_
+#define MIR_LOGGING_ASYNC_LOGGER_H_
+
+#include "mir/logging/logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mir
+{
+namespace logging
+{
+/**
+ * A console logger that leaves formatting and writing to a background thread.
+ *
+ * Each thread that logs gets its own single-producer ring buffer, so logging
+ * takes no lock and never waits for I/O. printf-style messages are captured as
+ * their format string and raw arguments, and only formatted on the background
+ * thread. Lines are written in the same format as DumbConsoleLogger, stamped
+ * with the time they were logged.
+ *
+ * If a thread logs faster than its ring is drained, further messages are
+ * dropped and counted, and the count is logged once space is available again.
+ * Critical messages are written before log() returns.
+ */
+class AsyncLogger : public Logger
+{
+public:
+    AsyncLogger();
+    AsyncLogger(int out_fd, int err_fd, size_t ring_size);
+    ~AsyncLogger();
+
+    void log(Severity severity, std::string const& message, std::string const& component) override;
+    void log(char const* component, Severity severity, char const* format, ...) override
+         __attribute__ ((format (printf, 4, 5)));
+    /// The printf-style log(), for callers that already have a va_list
+    void logv(char const* component, Severity severity, char const* format, va_list args)
+         __attribute__ ((format (printf, 4, 0)));
+
+    /// Waits until everything logged before the call has been written
+    void flush();
+
+    uint64_t dropped_messages() const;
+
+    static size_t constexpr default_ring_size = 32 * 1024;
+
+private:
+    class Ring;
+
+    Ring& ring_for_this_thread();
+    void wake_writer(Ring& ring, Severity severity);
+    void write_loop();
+    void drain(std::vector<char>& out, std::vector<char>& err);
+
+    int const out_fd;
+    int const err_fd;
+    size_t const ring_size;
+    uint64_t const id;
+
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<Ring>> rings;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable flushed;
+    std::atomic<bool> wake_requested{false};
+    uint64_t flushes_requested{0};
+    uint64_t flushes_done{0};
+    bool stopping{false};
+
+    std::atomic<uint64_t> dropped{0};
+
+    std::thread writer;
+};
+}
+}
+
+#endif // MIR_LOGGING_ASYNC_LOGGER_H_
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_PROBE_CACHE_H_
+#define MIR_PROBE_CACHE_H_
+
+#include "mir/optional_value.h"
+
+#include <cstdint>
+#include <string>
+
+namespace mir
+{
+/**
+ * Remembers which platform module won probing last time, so that the next
+ * start can load just that module and check it still probes the same way.
+ *
+ * An entry only holds while the module file is unchanged (same mtime) and
+ * the caller's hash of what probing depends on (its "device set": devices,
+ * environment, options, installed drivers and candidate modules) matches, so
+ * a driver upgrade, a new module, new options or a new GPU falls back to a
+ * full probe. The cache is advisory: a missing, unreadable
+ * or unwritable file just means probing everything.
+ */
+class ProbeCache
+{
+public:
+    struct Entry
+    {
+        std::string module;
+        int64_t mtime;
+        uint64_t device_set;
+        int priority;
+    };
+
+    /// An empty \p file disables the cache
+    explicit ProbeCache(std::string const& file);
+
+    /// $MIR_PLATFORM_PROBE_CACHE if set ("off" disables the cache), otherwise under $XDG_CACHE_HOME
+    static std::string default_file();
+
+    /// Modification time of \p path in nanoseconds, or -1 if it can't be read
+    static int64_t mtime_of(std::string const& path);
+
+    /// The entry stored for \p kind, if it was for \p device_set and its module is unchanged
+    optional_value<Entry> lookup(std::string const& kind, uint64_t device_set) const;
+
+    void store(std::string const& kind, Entry const& entry);
+
+private:
+    std::string const file;
+};
+}
+
+#endif /* MIR_PROBE_CACHE_H_ */
@@ -21,6 +21,8 @@
 
 #include "shared_library_prober_report.h"
 
+#include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -38,6 +40,33 @@ void select_libraries_for_path(
     std::string const& path,
     std::function<Selection(std::shared_ptr<SharedLibrary> const&)> const& selector,
     SharedLibraryProberReport& report);
+
+/// The libraries in \p path, in the order select_libraries_for_path() tries them
+std::vector<std::string> library_paths_for(std::string const& path, SharedLibraryProberReport& report);
+
+struct ProbedLibrary
+{
+    std::string path;
+    std::shared_ptr<SharedLibrary> library;
+    int priority;
+};
+
+/**
+ * Loads each of \p library_paths and probes it, each on a thread of its
+ * own so that a slow probe doesn't hold up the others.
+ *
+ * Results are in the order of \p library_paths. Libraries that fail to load,
+ * whose probe throws std::runtime_error, or that are still probing after
+ * \p timeout are reported to \p report and left out. Any other exception from
+ * a probe is rethrown on the calling thread. A probe that times out
+ * is abandoned rather than interrupted: its thread keeps running, with its
+ * library loaded, so \p probe must only refer to things that outlive it.
+ */
+std::vector<ProbedLibrary> probe_libraries_in_parallel(
+    std::vector<std::string> const& library_paths,
+    std::function<int(SharedLibrary const&)> const& probe,
+    std::chrono::milliseconds timeout,
+    SharedLibraryProberReport& report);
 }
 
 
@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_THREAD_SCHEDULING_H_
+#define MIR_THREAD_SCHEDULING_H_
+
+#include <string>
+#include <vector>
+
+namespace mir
+{
+/**
+ * How a latency-sensitive thread (input reading, compositing) should be scheduled.
+ *
+ * The default leaves the thread exactly as it was created.
+ */
+struct ThreadScheduling
+{
+    enum class Policy
+    {
+        inherit,        ///< Leave the scheduling policy alone
+        nice,           ///< SCHED_OTHER with "priority" as the nice value
+        fifo,           ///< SCHED_FIFO with "priority" as the real-time priority
+        round_robin     ///< SCHED_RR with "priority" as the real-time priority
+    };
+
+    Policy policy{Policy::inherit};
+    int priority{0};
+
+    /// CPUs the thread may run on; empty means no restriction
+    std::vector<int> cpus;
+};
+
+/**
+ * Parses scheduling options of the form "fifo:<priority>", "rr:<priority>",
+ * "nice:<value>" or "inherit", and CPU lists of the form "0,2-3".
+ *
+ * \throws std::invalid_argument if either string is malformed
+ */
+ThreadScheduling parse_thread_scheduling(std::string const& policy, std::string const& cpus);
+
+/**
+ * Applies the scheduling to the calling thread.
+ *
+ * Real-time policies commonly need privileges the server does not have, so
+ * failure is logged and the thread carries on with what it has.
+ */
+void apply_thread_scheduling(ThreadScheduling const& scheduling);
+}
+
+#endif /* MIR_THREAD_SCHEDULING_H_ */
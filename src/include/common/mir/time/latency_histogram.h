@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TIME_LATENCY_HISTOGRAM_H_
+#define MIR_TIME_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace mir
+{
+namespace time
+{
+/**
+ * A high dynamic range histogram of latencies.
+ *
+ * Buckets are log-linear: each power of two range is split into equally
+ * sized sub-buckets, so any recorded value is reported within ~1.6% of what
+ * was recorded. Latencies from 0 up to ~68 seconds are tracked; longer ones
+ * count as the maximum.
+ *
+ * record() is wait-free and may be called from any number of threads; queries
+ * see a consistent enough snapshot for monitoring but are not atomic with
+ * respect to concurrent recording.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(std::chrono::nanoseconds latency);
+
+    uint64_t count() const;
+
+    /// The latency that \p percentile percent of recorded values are at or below
+    std::chrono::nanoseconds value_at_percentile(double percentile) const;
+
+    void reset();
+
+private:
+    LatencyHistogram(LatencyHistogram const&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+    static int constexpr sub_bucket_bits = 7;
+    static int constexpr max_value_bits = 36;
+    static size_t constexpr bucket_count =
+        (1 << sub_bucket_bits) + (max_value_bits - sub_bucket_bits) * (1 << (sub_bucket_bits - 1));
+
+    static size_t index_for(uint64_t value);
+    static uint64_t highest_value_in(size_t index);
+
+    std::array<std::atomic<uint64_t>, bucket_count> buckets;
+    std::atomic<uint64_t> total;
+};
+}
+}
+
+#endif // MIR_TIME_LATENCY_HISTOGRAM_H_
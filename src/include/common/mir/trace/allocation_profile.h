@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TRACE_ALLOCATION_PROFILE_H_
+#define MIR_TRACE_ALLOCATION_PROFILE_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace mir
+{
+namespace trace
+{
+/**
+ * A hot path whose heap use is profiled.
+ *
+ * In a MIR_ALLOC_PROFILING build operator new and delete are interposed, and
+ * each call is charged to the innermost AllocationScope on the calling
+ * thread. The totals of every site are written to stderr at exit. Sites are
+ * never destroyed: they are created as function statics by
+ * MIR_ALLOC_PROFILING_SCOPE().
+ */
+struct AllocationSite
+{
+    explicit AllocationSite(char const* name);
+
+    AllocationSite(AllocationSite const&) = delete;
+    AllocationSite& operator=(AllocationSite const&) = delete;
+
+    char const* const name;
+    std::atomic<uint64_t> entries{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    AllocationSite* next{nullptr};
+};
+
+/// Charges the calling thread's allocations to \p site while in scope
+class AllocationScope
+{
+public:
+    explicit AllocationScope(AllocationSite& site);
+    ~AllocationScope();
+
+    AllocationScope(AllocationScope const&) = delete;
+    AllocationScope& operator=(AllocationScope const&) = delete;
+
+private:
+    AllocationSite* const enclosing;
+};
+
+/// The most recently created site; the others follow through next
+AllocationSite const* allocation_sites();
+
+/// The site the calling thread's allocations are being charged to, if any
+AllocationSite* current_allocation_site();
+}
+}
+
+#ifdef MIR_ALLOC_PROFILING
+#define MIR_ALLOC_PROFILING_SCOPE(site_name) \
+    static ::mir::trace::AllocationSite mir_allocation_site{site_name}; \
+    ::mir::trace::AllocationScope const mir_allocation_scope{mir_allocation_site}
+#else
+#define MIR_ALLOC_PROFILING_SCOPE(site_name) static_cast<void>(0)
+#endif
+
+#endif // MIR_TRACE_ALLOCATION_PROFILE_H_
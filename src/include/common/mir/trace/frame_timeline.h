@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TRACE_FRAME_TIMELINE_H_
+#define MIR_TRACE_FRAME_TIMELINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+
+namespace mir
+{
+namespace trace
+{
+enum class FrameStage : uint8_t
+{
+    client_submit,      ///< A client submitted a buffer to a stream
+    compositor_wake,    ///< A compositor thread woke to composite a frame
+    scene_elements,     ///< Taking the scene snapshot for a frame
+    render,             ///< Rendering a frame, or handing it to overlays
+    swap,               ///< Swapping the rendered frame to the output
+    page_flip,          ///< From scheduling a page flip until the flip completed
+    buffer_release      ///< A client buffer was handed back to its client
+};
+
+/**
+ * An in-memory record of the most recent frame events.
+ *
+ * Events carry correlation IDs: the compositor frame they belong to, and the
+ * surface (buffer stream) and buffer they concern. Any of these may be 0 when
+ * not known at the point of tracing.
+ *
+ * record() is lock-free and may be called from any number of threads. Once
+ * the timeline is full the oldest events are overwritten.
+ */
+class FrameTimeline
+{
+public:
+    static size_t constexpr default_capacity = 64 * 1024;
+
+    explicit FrameTimeline(size_t capacity);
+    ~FrameTimeline();
+
+    /// Times are on CLOCK_MONOTONIC; an event with begin == end is instantaneous
+    void record(
+        FrameStage stage,
+        std::chrono::nanoseconds begin,
+        std::chrono::nanoseconds end,
+        uint64_t frame,
+        uint64_t surface,
+        uint64_t buffer);
+
+    /// Writes the recorded events in the Chrome trace event JSON format
+    void write_chrome_json(std::ostream& out) const;
+
+private:
+    FrameTimeline(FrameTimeline const&) = delete;
+    FrameTimeline& operator=(FrameTimeline const&) = delete;
+
+    struct Event;
+
+    size_t const capacity;
+    std::unique_ptr<Event[]> const events;
+    std::atomic<uint64_t> next{0};
+};
+
+/**
+ * Installs the timeline that frame tracing records to, or turns frame tracing
+ * off again if \a timeline is null.
+ *
+ * Frame tracing is off until a timeline is installed. Threads that traced to
+ * a replaced timeline keep it alive until they next trace or exit.
+ */
+void set_frame_timeline(std::shared_ptr<FrameTimeline> const& timeline);
+
+/**
+ * The timeline frame events are recorded to, or null if frame tracing is off.
+ *
+ * The timeline is only guaranteed to outlive the calling thread's next call
+ * into frame tracing.
+ */
+FrameTimeline* frame_timeline();
+
+std::chrono::nanoseconds frame_trace_now();
+
+/// Sets the frame events traced by this thread are attributed to
+void set_current_frame(uint64_t frame);
+uint64_t current_frame();
+
+/// Records an instantaneous event for the current frame, if frame tracing is on
+void trace_frame_event(FrameStage stage, uint64_t surface = 0, uint64_t buffer = 0);
+
+/// Records the lifetime of the object as a stage of the current frame, if frame tracing is on
+class FrameStageTrace
+{
+public:
+    explicit FrameStageTrace(FrameStage stage, uint64_t surface = 0, uint64_t buffer = 0);
+    ~FrameStageTrace();
+
+private:
+    FrameStageTrace(FrameStageTrace const&) = delete;
+    FrameStageTrace& operator=(FrameStageTrace const&) = delete;
+
+    FrameTimeline* const timeline;
+    uint64_t const generation;
+    FrameStage const stage;
+    uint64_t const surface;
+    uint64_t const buffer;
+    std::chrono::nanoseconds const begin;
+};
+}
+}
+
+#endif // MIR_TRACE_FRAME_TIMELINE_H_
@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TRACE_TRANSPORT_COUNTERS_H_
+#define MIR_TRACE_TRANSPORT_COUNTERS_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace mir
+{
+namespace trace
+{
+enum class TransportSide
+{
+    client,
+    server
+};
+
+/**
+ * Running totals for one side of the client/server protocol transport.
+ *
+ * syscalls estimates the socket calls made to move messages (reads, writes,
+ * fd passing and readability queries) but not the waits for readiness. It is
+ * counted where Mir calls into the socket, so reads and writes that Boost.Asio
+ * splits into several calls are undercounted.
+ * events_sent counts the messages the server sent unprompted, rather than in
+ * response to a request.
+ * bytes_copied counts the message bytes copied after serialization: into
+ * send buffers, and into and out of nested protobuf messages.
+ *
+ * All updates are relaxed atomic increments, so the totals are cheap enough
+ * to keep unconditionally.
+ */
+struct TransportCounters
+{
+    std::atomic<uint64_t> messages_sent{0};
+    std::atomic<uint64_t> messages_received{0};
+    std::atomic<uint64_t> events_sent{0};
+    std::atomic<uint64_t> syscalls{0};
+    std::atomic<uint64_t> bytes_sent{0};
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> bytes_copied{0};
+    std::atomic<uint64_t> fds_sent{0};
+    std::atomic<uint64_t> fds_received{0};
+};
+
+/// The transport totals for this process's clients or server
+TransportCounters& transport_counters(TransportSide side);
+
+inline void count(std::atomic<uint64_t>& counter, uint64_t by = 1)
+{
+    counter.fetch_add(by, std::memory_order_relaxed);
+}
+}
+}
+
+#endif // MIR_TRACE_TRANSPORT_COUNTERS_H_
@@ -20,15 +20,21 @@
 #define MIR_GL_DEFAULT_PROGRAM_FACTORY_H_
 
 #include "program_factory.h"
+#include <memory>
 #include <mutex>
 
 namespace mir
 {
+namespace memory { class Account; }
 namespace gl
 {
 class DefaultProgramFactory : public ProgramFactory
 {
 public:
+    DefaultProgramFactory() = default;
+    /// Texture caches created charge their textures to texture_account
+    explicit DefaultProgramFactory(std::shared_ptr<memory::Account> const& texture_account);
+
     std::unique_ptr<Program> create_gl_program(std::string const&, std::string const&) const override;
     std::unique_ptr<TextureCache> create_texture_cache() const override;
 
@@ -40,6 +46,7 @@ private:
      * have the same or shared EGL contexts.
      */
     std::mutex mutable mutex;
+    std::shared_ptr<memory::Account> const texture_account;
 };
 }
 }
@@ -21,11 +21,14 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include "mir/shared_library.h"
 #include "mir/options/program_option.h"
 
 namespace mir
 {
+class SharedLibraryProberReport;
+
 namespace graphics
 {
 class Platform;
@@ -34,6 +37,19 @@ std::shared_ptr<SharedLibrary> module_for_device(
          std::vector<std::shared_ptr<SharedLibrary>> const& modules,
          options::ProgramOption const& options);
 
+/**
+ * Picks the best graphics module in \p path.
+ *
+ * The modules are probed in parallel, and the winner is remembered in the
+ * mir::ProbeCache so that the next start only loads and re-probes that one.
+ * \p options is shared with the probing threads as a probe that times out
+ * may still be running after this returns.
+ */
+std::shared_ptr<SharedLibrary> module_for_device(
+         std::string const& path,
+         std::shared_ptr<options::ProgramOption const> const& options,
+         SharedLibraryProberReport& report);
+
 }
 }
 
@@ -44,6 +44,7 @@ extern char const* const connector_report_opt;
 extern char const* const scene_report_opt;
 extern char const* const input_report_opt;
 extern char const* const seat_report_opt;
+extern char const* const frame_pacing_report_opt;
 extern char const* const host_socket_opt;
 extern char const* const nested_passthrough_opt;
 extern char const* const frontend_threads_opt;
@@ -52,7 +53,21 @@ extern char const* const cursor_opt;
 extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
 extern char const* const composite_delay_opt;
+extern char const* const buffer_queue_depth_opt;
 extern char const* const enable_key_repeat_opt;
+extern char const* const input_thread_scheduling_opt;
+extern char const* const input_thread_affinity_opt;
+extern char const* const compositor_thread_scheduling_opt;
+extern char const* const compositor_thread_affinity_opt;
+extern char const* const input_prediction_opt;
+extern char const* const record_input_opt;
+extern char const* const metrics_socket_opt;
+extern char const* const async_logging_opt;
+extern char const* const frame_trace_opt;
+extern char const* const frame_trace_socket_opt;
+extern char const* const memory_quota_opt;
+extern char const* const memory_quota_action_opt;
+extern char const* const memory_accounting_socket_opt;
 
 extern char const* const name_opt;
 extern char const* const offscreen_opt;
@@ -62,6 +77,7 @@ extern char const* const enable_key_repeat_opt;
 extern char const* const off_opt_value;
 extern char const* const log_opt_value;
 extern char const* const lttng_opt_value;
+extern char const* const metrics_opt_value;
 
 extern char const* const platform_graphics_lib;
 extern char const* const platform_input_lib;
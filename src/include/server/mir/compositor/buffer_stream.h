@@ -49,6 +49,17 @@ public:
     virtual void drop_old_buffers() = 0;
     virtual bool has_submitted_buffer() const = 0;
     virtual bool framedropping() const = 0;
+
+    /**
+     * Bound the number of submitted buffers waiting for the compositor.
+     *
+     * Once the limit is reached each newly submitted buffer supersedes the
+     * oldest waiting one, which is returned to the client straight away. A
+     * depth of 1 keeps only the newest buffer ("mailbox"); 0 queues every
+     * buffer ("FIFO"). Framedropping, while allowed, always uses a depth of 1.
+     */
+    virtual void set_queue_depth(unsigned int max_queued) = 0;
+    virtual unsigned int queue_depth() const = 0;
 };
 
 }
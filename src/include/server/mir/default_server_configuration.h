@@ -54,6 +54,9 @@ class Drawer;
 class DisplayBufferCompositorFactory;
 class Compositor;
 class CompositorReport;
+class PresentationClock;
+class FramePacingMonitor;
+class FramePacingObserver;
 }
 namespace frontend
 {
@@ -127,6 +130,7 @@ class MirClientHostConnection;
 namespace input
 {
 class InputReport;
+class InputLatency;
 class SeatObserver;
 class Scene;
 class InputManager;
@@ -143,6 +147,16 @@ class Seat;
 class KeyMapper;
 }
 
+namespace metrics
+{
+class Registry;
+}
+
+namespace memory
+{
+class Accounting;
+}
+
 namespace logging
 {
 class Logger;
@@ -233,6 +247,8 @@ public:
     virtual std::shared_ptr<compositor::DisplayBufferCompositorFactory> the_display_buffer_compositor_factory();
     virtual std::shared_ptr<compositor::DisplayBufferCompositorFactory> wrap_display_buffer_compositor_factory(
         std::shared_ptr<compositor::DisplayBufferCompositorFactory> const& wrapped);
+    virtual std::shared_ptr<compositor::PresentationClock> the_presentation_clock();
+    virtual std::shared_ptr<compositor::FramePacingMonitor> the_frame_pacing_monitor();
     /** @} */
 
     /** @name compositor configuration - dependencies
@@ -240,6 +256,8 @@ public:
      *  @{ */
     virtual std::shared_ptr<graphics::GraphicBufferAllocator> the_buffer_allocator();
     virtual std::shared_ptr<compositor::Scene>                  the_scene();
+    virtual std::shared_ptr<ObserverRegistrar<compositor::FramePacingObserver>>
+        the_frame_pacing_observer_registrar();
     /** @} */
 
     /** @name frontend configuration - dependencies
@@ -314,6 +332,7 @@ public:
     /** @name input configuration
      *  @{ */
     virtual std::shared_ptr<input::InputReport> the_input_report();
+    virtual std::shared_ptr<input::InputLatency> the_input_latency();
     virtual std::shared_ptr<ObserverRegistrar<input::SeatObserver>> the_seat_observer_registrar();
     virtual std::shared_ptr<input::CompositeEventFilter> the_composite_event_filter();
 
@@ -342,6 +361,10 @@ public:
     virtual std::shared_ptr<time::Clock> the_clock();
     virtual std::shared_ptr<ServerActionQueue> the_server_action_queue();
     virtual std::shared_ptr<SharedLibraryProberReport>  the_shared_library_prober_report();
+    /// The metrics fed by reports configured as "metrics"
+    virtual std::shared_ptr<metrics::Registry> the_metrics_registry();
+    /// The memory held for each client, limited by the memory-quota option
+    virtual std::shared_ptr<memory::Accounting> the_memory_accounting();
 
 private:
     // We need to ensure the platform library is destroyed last as the
@@ -356,6 +379,7 @@ protected:
     std::shared_ptr<graphics::DisplayConfigurationObserver> the_display_configuration_observer();
     std::shared_ptr<input::SeatObserver> the_seat_observer();
     std::shared_ptr<frontend::SessionMediatorObserver> the_session_mediator_observer();
+    std::shared_ptr<compositor::FramePacingObserver> the_frame_pacing_observer();
 
     virtual std::shared_ptr<scene::MediatingDisplayChanger> the_mediating_display_changer();
     virtual std::shared_ptr<frontend::ProtobufIpcFactory> new_ipc_factory(
@@ -380,6 +404,7 @@ protected:
     CachedPtr<frontend::Connector>   prompt_connector;
 
     CachedPtr<input::InputReport> input_report;
+    CachedPtr<input::InputLatency> input_latency;
     CachedPtr<input::EventFilterChainDispatcher> event_filter_chain_dispatcher;
     CachedPtr<input::CompositeEventFilter> composite_event_filter;
     CachedPtr<input::InputManager>    input_manager;
@@ -422,6 +447,8 @@ protected:
     CachedPtr<compositor::DisplayBufferCompositorFactory> display_buffer_compositor_factory;
     CachedPtr<compositor::Compositor> compositor;
     CachedPtr<compositor::CompositorReport> compositor_report;
+    CachedPtr<compositor::PresentationClock> presentation_clock;
+    CachedPtr<compositor::FramePacingMonitor> frame_pacing_monitor;
     CachedPtr<logging::Logger> logger;
     CachedPtr<graphics::DisplayReport> display_report;
     CachedPtr<time::Clock> clock;
@@ -439,6 +466,8 @@ protected:
     CachedPtr<shell::HostLifecycleEventListener> host_lifecycle_event_listener;
     CachedPtr<shell::PersistentSurfaceStore> persistent_surface_store;
     CachedPtr<SharedLibraryProberReport> shared_library_prober_report;
+    CachedPtr<metrics::Registry> metrics_registry;
+    CachedPtr<memory::Accounting> memory_accounting;
     CachedPtr<shell::Shell> shell;
     CachedPtr<shell::ShellReport> shell_report;
     CachedPtr<scene::ApplicationNotRespondingDetector> application_not_responding_detector;
@@ -454,6 +483,8 @@ private:
         seat_observer_multiplexer;
     CachedPtr<ObserverMultiplexer<frontend::SessionMediatorObserver>>
         session_mediator_observer_multiplexer;
+    CachedPtr<ObserverMultiplexer<compositor::FramePacingObserver>>
+        frame_pacing_observer_multiplexer;
     std::shared_ptr<report::Reports> const reports;
 
     virtual std::string the_socket_file() const;
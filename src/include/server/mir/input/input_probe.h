@@ -21,6 +21,8 @@
 
 #include "mir/module_deleter.h"
 
+#include <memory>
+
 namespace mir
 {
 namespace graphics { class Platform; }
@@ -37,8 +39,9 @@ class InputReport;
 class Platform;
 class InputDeviceRegistry;
 
+/// Probes run on their own threads and may outlive the call, so they share \p options
 mir::UniqueModulePtr<Platform> probe_input_platforms(
-    options::Option const& options, std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
+    std::shared_ptr<options::Option const> const& options, std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
     std::shared_ptr<InputDeviceRegistry> const& device_registry, std::shared_ptr<InputReport> const& input_report,
     SharedLibraryProberReport & prober_report);
 
@@ -20,6 +20,9 @@
 #ifndef MIR_INPUT_INPUT_SCENE_H_
 #define MIR_INPUT_INPUT_SCENE_H_
 
+#include "mir/geometry/point.h"
+#include "mir/geometry/rectangle.h"
+
 #include <memory>
 #include <functional>
 
@@ -45,6 +48,9 @@ public:
 
     virtual void for_each(std::function<void(std::shared_ptr<input::Surface> const&)> const& callback) = 0;
 
+    /// The topmost surface whose input area contains point, or nullptr
+    virtual std::shared_ptr<input::Surface> input_surface_at(geometry::Point const& point) = 0;
+
     virtual void add_observer(std::shared_ptr<scene::Observer> const& observer) = 0;
     virtual void remove_observer(std::weak_ptr<scene::Observer> const& observer) = 0;
 
@@ -59,6 +65,10 @@ public:
     // TODO: How can something like SurfaceObserver be adapted to work with non surface renderables?
     virtual void emit_scene_changed() = 0;
 
+    // Cheaper than emit_scene_changed() for input visualizations that only moved or changed
+    // appearance: recomposition is limited to the outputs overlapping damage.
+    virtual void emit_scene_damaged(geometry::Rectangle const& damage) = 0;
+
 protected:
     Scene() = default;
     Scene(Scene const&) = delete;
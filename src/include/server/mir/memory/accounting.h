@@ -0,0 +1,198 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_MEMORY_ACCOUNTING_H_
+#define MIR_MEMORY_ACCOUNTING_H_
+
+#include <sys/types.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace memory
+{
+/// Where memory charged to an account is held
+enum class Subsystem
+{
+    shm_buffers,        ///< Software buffers allocated for mirclient connections
+    hardware_buffers,   ///< Hardware (GBM, EGL...) buffers allocated for mirclient connections
+    wayland_shm_copies, ///< The server's private copies of Wayland wl_shm buffers
+    textures,           ///< GL textures the renderer keeps for surfaces
+    ipc_resources       ///< Resources held until an IPC response has been sent
+};
+
+unsigned const subsystem_count = 5;
+
+char const* name_of(Subsystem subsystem);
+
+/// What happens to a client whose account would go over its quota
+enum class QuotaAction
+{
+    reject,     ///< The allocation fails, and the client is sent an error
+    disconnect  ///< The client is disconnected
+};
+
+class QuotaExceeded : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class Account;
+
+/**
+ * Memory charged to an Account, for as long as the Charge lives.
+ *
+ * A Charge should live exactly as long as the memory it accounts for, which is
+ * most easily done by making it a member of the object that owns the memory.
+ */
+class Charge
+{
+public:
+    Charge() = default;
+    Charge(Charge&& other) noexcept;
+    Charge& operator=(Charge&& other) noexcept;
+    ~Charge() noexcept;
+
+    size_t bytes() const { return bytes_; }
+
+    /**
+     * Change the amount charged, for memory charged before its exact size was known.
+     *
+     * \throws QuotaExceeded if the increase would take the account over its
+     *         quota; the charge is unchanged in that case.
+     */
+    void adjust(size_t bytes);
+
+private:
+    friend class Account;
+    Charge(std::shared_ptr<Account> const& account, Subsystem subsystem, size_t bytes);
+
+    void release() noexcept;
+
+    std::shared_ptr<Account> account;
+    Subsystem subsystem{Subsystem::shm_buffers};
+    size_t bytes_{0};
+};
+
+/**
+ * The memory used on behalf of one client, or of the server itself.
+ *
+ * Charging and releasing memory is lock-free.
+ */
+class Account : public std::enable_shared_from_this<Account>
+{
+public:
+    /// A quota_bytes of 0 means the account is unlimited
+    Account(std::string const& name, pid_t pid, size_t quota_bytes);
+
+    /**
+     * Charge bytes of subsystem memory to this account.
+     *
+     * \throws QuotaExceeded if this would take the account over its quota; nothing
+     *         is charged in that case.
+     */
+    Charge charge(Subsystem subsystem, size_t bytes);
+
+    struct Usage
+    {
+        size_t bytes;
+        size_t allocations;
+    };
+
+    Usage usage(Subsystem subsystem) const;
+    size_t total_bytes() const;
+
+    std::string const& name() const { return name_; }
+    pid_t pid() const { return pid_; }
+    size_t quota_bytes() const { return quota_bytes_; }
+
+private:
+    friend class Charge;
+    void reserve(Subsystem subsystem, size_t bytes);
+    void release(Subsystem subsystem, size_t bytes) noexcept;
+    void adjust(Subsystem subsystem, size_t from_bytes, size_t to_bytes);
+
+    struct Counters
+    {
+        std::atomic<size_t> bytes{0};
+        std::atomic<size_t> allocations{0};
+    };
+
+    std::string const name_;
+    pid_t const pid_;
+    size_t const quota_bytes_;
+    std::atomic<size_t> total{0};
+    std::array<Counters, subsystem_count> counters;
+};
+
+/**
+ * Tracks the memory the server holds, by client and by subsystem.
+ *
+ * Each client gets an Account when it connects, limited to the session quota
+ * (if any). Memory not owned by any one client is charged to the unlimited
+ * server account.
+ */
+class Accounting
+{
+public:
+    /// A session_quota_bytes of 0 means sessions are unlimited
+    Accounting(size_t session_quota_bytes, QuotaAction quota_action);
+    ~Accounting();
+
+    std::shared_ptr<Account> open_account(std::string const& name, pid_t pid);
+    std::shared_ptr<Account> const& server_account() const { return server; }
+
+    QuotaAction quota_action() const { return quota_action_; }
+
+    struct AccountUsage
+    {
+        std::string name;
+        pid_t pid;
+        std::array<Account::Usage, subsystem_count> usage;
+        size_t total_bytes;
+    };
+
+    /// The usage of the server account followed by each open account
+    std::vector<AccountUsage> snapshot() const;
+
+    /// Writes the snapshot as a table of bytes/allocations, with totals per subsystem
+    void write_report(std::ostream& out) const;
+
+private:
+    Accounting(Accounting const&) = delete;
+    Accounting& operator=(Accounting const&) = delete;
+
+    size_t const session_quota_bytes;
+    QuotaAction const quota_action_;
+    std::shared_ptr<Account> const server;
+
+    std::mutex mutable mutex;
+    std::vector<std::weak_ptr<Account>> accounts;
+};
+}
+}
+
+#endif // MIR_MEMORY_ACCOUNTING_H_
@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_METRICS_REGISTRY_H_
+#define MIR_METRICS_REGISTRY_H_
+
+#include "mir/time/latency_histogram.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mir
+{
+namespace metrics
+{
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/// A monotonically increasing count, exported as <name>_total
+class Counter
+{
+public:
+    void increment(uint64_t by = 1) { count.fetch_add(by, std::memory_order_relaxed); }
+    uint64_t value() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> count{0};
+};
+
+/// A value that can go up and down
+class Gauge
+{
+public:
+    void set(int64_t value) { current.store(value, std::memory_order_relaxed); }
+    void add(int64_t delta) { current.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t value() const { return current.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> current{0};
+};
+
+/**
+ * The server's metrics, for export in the OpenMetrics text format.
+ *
+ * Each metric is identified by its family name and label values, and is
+ * created by the first call asking for it; later calls return the same metric.
+ * Looking a metric up takes a lock, so callers on hot paths should look it up
+ * once and keep the reference, which stays valid for the registry's lifetime.
+ * Updating a metric is lock-free.
+ *
+ * Latency histograms are exported as summaries in seconds, with the 50th, 90th,
+ * 99th and 99.9th percentiles.
+ */
+class Registry
+{
+public:
+    Registry();
+    ~Registry();
+
+    Counter& counter(std::string const& name, std::string const& help, Labels const& labels = {});
+    Gauge& gauge(std::string const& name, std::string const& help, Labels const& labels = {});
+    /// A gauge set in nanoseconds and exported in seconds, like the summaries
+    Gauge& duration_gauge(std::string const& name, std::string const& help, Labels const& labels = {});
+    time::LatencyHistogram& histogram(std::string const& name, std::string const& help, Labels const& labels = {});
+
+    void write_openmetrics(std::ostream& out) const;
+
+private:
+    Registry(Registry const&) = delete;
+    Registry& operator=(Registry const&) = delete;
+
+    enum class Type;
+    struct Series;
+    struct Family;
+
+    static char const* type_name(Type type);
+    Series& series_for(std::string const& name, std::string const& help, Type type, Labels const& labels);
+
+    std::mutex mutable mutex;
+    std::vector<std::unique_ptr<Family>> families;
+};
+}
+}
+
+#endif // MIR_METRICS_REGISTRY_H_
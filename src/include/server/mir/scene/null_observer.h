@@ -34,6 +34,7 @@ public:
     void surface_added(Surface* surface);
     void surface_removed(Surface* surface);
     void surfaces_reordered();
+    void scene_damaged(geometry::Rectangle const& damage);
 
     // Called at observer registration to notify of already existing surfaces.
     void surface_exists(Surface* surface);
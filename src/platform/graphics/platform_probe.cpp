@@ -17,11 +17,113 @@
  */
 
 #include "mir/log.h"
+#include "mir/fnv1a_hash.h"
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
+#include "mir/probe_cache.h"
+#include "mir/shared_library_prober.h"
 
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace mg = mir::graphics;
+
+namespace
+{
+char const* const cache_kind = "graphics";
+std::chrono::milliseconds const probe_timeout{2000};
+
+int probe(mir::SharedLibrary const& module, mir::options::ProgramOption const& options)
+{
+    auto const probe = module.load_function<mg::PlatformProbe>(
+        "probe_graphics_platform",
+        MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+
+    return probe(options);
+}
+
+void log_driver_found(mir::SharedLibrary const& module)
+{
+    auto describe = module.load_function<mg::DescribeModule>(
+        "describe_graphics_module",
+        MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+    auto desc = describe();
+    mir::log_info("Found graphics driver: %s (version %d.%d.%d)",
+                  desc->name,
+                  desc->major_version,
+                  desc->minor_version,
+                  desc->micro_version);
+}
+
+/// What probing depends on: the DRM devices, any host display server, the
+/// options the probes read, the installed drivers and the modules that could
+/// be probed, as changing any of these can change which module wins
+uint64_t probe_inputs(std::vector<std::string> const& candidates, mir::options::ProgramOption const& options)
+{
+    mir::Fnv1aHash seed;
+
+    if (auto const dir = opendir("/dev/dri"))
+    {
+        std::vector<std::pair<std::string, dev_t>> devices;
+        while (auto const entry = readdir(dir))
+        {
+            struct stat info;
+            auto const path = std::string{"/dev/dri/"} + entry->d_name;
+            if (entry->d_name[0] != '.' && stat(path.c_str(), &info) == 0)
+                devices.emplace_back(entry->d_name, info.st_rdev);
+        }
+        closedir(dir);
+
+        std::sort(devices.begin(), devices.end());
+        for (auto const& device : devices)
+        {
+            seed.add(device.first.c_str(), device.first.size() + 1);
+            seed.add(device.second);
+        }
+    }
+
+    for (auto const var : {"DISPLAY", "WAYLAND_DISPLAY"})
+    {
+        auto const value = getenv(var);
+        std::string const text{value ? value : ""};
+        seed.add(text.c_str(), text.size() + 1);
+    }
+
+    // mesa-kms wins outright when nested or given a VT, and looks for --vt
+    // among the arguments it didn't parse
+    for (auto const option : {"vt", "host-socket"})
+        seed.add(options.is_set(option));
+
+    for (auto const& token : options.unparsed_command_line())
+        seed.add(token.c_str(), token.size() + 1);
+
+    // Installing or upgrading a driver, libEGL included, rebuilds the linker
+    // cache, and a libglvnd vendor is added or removed through these directories
+    for (auto const path : {"/etc/ld.so.cache", "/etc/glvnd/egl_vendor.d", "/usr/share/glvnd/egl_vendor.d"})
+        seed.add(mir::ProbeCache::mtime_of(path));
+
+    for (auto const& candidate : candidates)
+    {
+        seed.add(candidate.c_str(), candidate.size() + 1);
+        seed.add(mir::ProbeCache::mtime_of(candidate));
+    }
+
+    return seed.value();
+}
+
+double milliseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - start}.count();
+}
+}
+
 std::shared_ptr<mir::SharedLibrary>
 mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> const& modules, mir::options::ProgramOption const& options)
 {
@@ -31,26 +133,14 @@ mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> con
     {
         try
         {
-            auto probe = module->load_function<PlatformProbe>(
-                 "probe_graphics_platform",
-                 MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-
-            auto module_priority = probe(options);
+            auto module_priority = static_cast<PlatformPriority>(probe(*module, options));
             if (module_priority > best_priority_so_far)
             {
                 best_priority_so_far = module_priority;
                 best_module_so_far = module;
             }
 
-            auto describe = module->load_function<DescribeModule>(
-                "describe_graphics_module",
-                MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-            auto desc = describe();
-            mir::log_info("Found graphics driver: %s (version %d.%d.%d)",
-                          desc->name,
-                          desc->major_version,
-                          desc->minor_version,
-                          desc->micro_version);
+            log_driver_found(*module);
         }
         catch (std::runtime_error const&)
         {
@@ -62,3 +152,80 @@ mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> con
     }
     BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
 }
+
+std::shared_ptr<mir::SharedLibrary>
+mir::graphics::module_for_device(
+    std::string const& path,
+    std::shared_ptr<options::ProgramOption const> const& options,
+    SharedLibraryProberReport& report)
+{
+    auto const start = std::chrono::steady_clock::now();
+    auto const candidates = mir::library_paths_for(path, report);
+    if (candidates.empty())
+        BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find any platform plugins in: " + path}));
+
+    auto const inputs = probe_inputs(candidates, *options);
+    mir::ProbeCache cache{mir::ProbeCache::default_file()};
+
+    // Warm start: load only the module that won last time, and check it still does
+    if (auto const cached = cache.lookup(cache_kind, inputs))
+    {
+        auto const& entry = cached.value();
+        if (std::find(candidates.begin(), candidates.end(), entry.module) != candidates.end())
+        {
+            try
+            {
+                report.loading_library(entry.module);
+                auto const module = std::make_shared<mir::SharedLibrary>(entry.module);
+                if (probe(*module, *options) == entry.priority)
+                {
+                    log_driver_found(*module);
+                    mir::log_info("Graphics platform probing took %.1fms (warm start)", milliseconds_since(start));
+                    return module;
+                }
+            }
+            catch (std::runtime_error const& error)
+            {
+                report.loading_failed(entry.module, error);
+            }
+        }
+    }
+
+    // Cold start: load everything in parallel, but run the probes one at a time.
+    // The KMS probes take and drop DRM master on the same card, so one running
+    // alongside another can find the card mastered and report a lower priority.
+    // The lock is shared with the probe threads, which can outlive this call.
+    auto const probe_lock = std::make_shared<std::mutex>();
+    auto const probed = mir::probe_libraries_in_parallel(
+        candidates,
+        [options, probe_lock](mir::SharedLibrary const& module)
+        {
+            std::lock_guard<std::mutex> lock{*probe_lock};
+            return probe(module, *options);
+        },
+        probe_timeout,
+        report);
+
+    mir::ProbedLibrary const* best{nullptr};
+    for (auto const& module : probed)
+    {
+        try
+        {
+            log_driver_found(*module.library);
+        }
+        catch (std::runtime_error const&)
+        {
+        }
+
+        if (module.priority > static_cast<int>(unsupported) && (!best || module.priority > best->priority))
+            best = &module;
+    }
+
+    if (!best)
+        BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
+
+    cache.store(cache_kind, {best->path, mir::ProbeCache::mtime_of(best->path), inputs, best->priority});
+    mir::log_info("Graphics platform probing took %.1fms (cold start)", milliseconds_since(start));
+
+    return best->library;
+}
@@ -42,6 +42,7 @@ char const* const mo::connector_report_opt        = "connector-report";
 char const* const mo::scene_report_opt            = "scene-report";
 char const* const mo::input_report_opt            = "input-report";
 char const* const mo::seat_report_opt            = "seat-report";
+char const* const mo::frame_pacing_report_opt    = "frame-pacing-report";
 char const* const mo::shared_library_prober_report_opt = "shared-library-prober-report";
 char const* const mo::shell_report_opt            = "shell-report";
 char const* const mo::host_socket_opt             = "host-socket";
@@ -54,11 +55,26 @@ char const* const mo::cursor_opt                  = "cursor";
 char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
 char const* const mo::composite_delay_opt         = "composite-delay";
+char const* const mo::buffer_queue_depth_opt      = "buffer-queue-depth";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
+char const* const mo::input_thread_scheduling_opt = "input-thread-scheduling";
+char const* const mo::input_thread_affinity_opt   = "input-thread-affinity";
+char const* const mo::compositor_thread_scheduling_opt = "compositor-thread-scheduling";
+char const* const mo::compositor_thread_affinity_opt   = "compositor-thread-affinity";
+char const* const mo::input_prediction_opt        = "input-prediction";
+char const* const mo::record_input_opt            = "record-input";
+char const* const mo::metrics_socket_opt          = "metrics-socket";
+char const* const mo::async_logging_opt           = "async-logging";
+char const* const mo::frame_trace_opt             = "frame-trace";
+char const* const mo::frame_trace_socket_opt      = "frame-trace-socket";
+char const* const mo::memory_quota_opt            = "memory-quota";
+char const* const mo::memory_quota_action_opt     = "memory-quota-action";
+char const* const mo::memory_accounting_socket_opt = "memory-accounting-socket";
 
 char const* const mo::off_opt_value = "off";
 char const* const mo::log_opt_value = "log";
 char const* const mo::lttng_opt_value = "lttng";
+char const* const mo::metrics_opt_value = "metrics";
 
 char const* const mo::platform_graphics_lib = "platform-graphics-lib";
 char const* const mo::platform_input_lib = "platform-input-lib";
@@ -158,23 +174,26 @@ mo::DefaultConfiguration::DefaultConfiguration(
         (enable_input_opt, po::value<bool>()->default_value(enable_input_default),
             "Enable input.")
         (compositor_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "Compositor reporting [{log,lttng,off}]")
+            "Compositor reporting [{log,lttng,off}[,metrics]]")
         (connector_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Connector report. [{log,lttng,off}]")
         (display_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Display report. [{log,lttng,off}]")
         (input_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle to Input report. [{log,lttng,off}]")
+            "How to handle to Input report. [{log,lttng,off}[,metrics]]")
         (legacy_input_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Legacy Input report. [{log,off}]")
         (seat_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle to Seat report. [{log,off}]")
+        (frame_pacing_report_opt, po::value<std::string>()->default_value(off_opt_value),
+            "How to handle the frame pacing report (missed vblanks, repeated and dropped frames). "
+            "[{log,off}[,metrics]]")
         (session_mediator_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the SessionMediator report. [{log,lttng,off}]")
+            "How to handle the SessionMediator report. [{log,lttng,off}[,metrics]]")
         (msg_processor_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the MessageProcessor report. [{log,lttng,off}]")
+            "How to handle the MessageProcessor report. [{log,lttng,off}[,metrics]]")
         (scene_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the scene report. [{log,lttng,off}]")
+            "How to handle the scene report. [{log,lttng,off}[,metrics]]")
         (shared_library_prober_report_opt, po::value<std::string>()->default_value(log_opt_value),
             "How to handle the SharedLibraryProber report. [{log,lttng,off}]")
         (shell_report_opt, po::value<std::string>()->default_value(off_opt_value),
@@ -184,6 +203,10 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "frames from clients before compositing). Higher values result in "
             "lower latency but risk causing frame skipping. "
             "Default: A negative value means decide automatically.")
+        (buffer_queue_depth_opt, po::value<int>()->default_value(0),
+            "The most submitted buffers of each client stream that wait for the compositor. Once "
+            "reached, a new buffer supersedes the oldest waiting one. 1 shows only the newest buffer "
+            "(lowest latency); 0 means no limit.")
         (name_opt, po::value<std::string>(),
             "When nested, the name Mir uses when registering with the host.")
         (nested_passthrough_opt, po::value<bool>()->default_value(true),
@@ -198,6 +221,35 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Cursor (mouse pointer) to use [{auto,software}]")
         (enable_key_repeat_opt, po::value<bool>()->default_value(true),
              "Enable server generated key repeat")
+        (input_thread_scheduling_opt, po::value<std::string>()->default_value("inherit"),
+            "Scheduling of the input reading thread [{inherit,nice:<value>,fifo:<priority>,rr:<priority>}]")
+        (input_thread_affinity_opt, po::value<std::string>()->default_value(""),
+            "CPUs the input reading thread may run on, e.g. \"0,2-3\". Default: any")
+        (compositor_thread_scheduling_opt, po::value<std::string>()->default_value("inherit"),
+            "Scheduling of the compositor threads [{inherit,nice:<value>,fifo:<priority>,rr:<priority>}]")
+        (compositor_thread_affinity_opt, po::value<std::string>()->default_value(""),
+            "CPUs the compositor threads may run on, e.g. \"0,2-3\". Default: any")
+        (input_prediction_opt, po::value<bool>()->default_value(false),
+            "Attach the pointer and touch positions predicted for the next presented frame to input events")
+        (record_input_opt, po::value<std::string>(),
+            "Record the events of all input devices to the given file, for replay by the input-replay platform")
+        (metrics_socket_opt, po::value<std::string>(),
+            "Serve the metrics gathered by \"metrics\" reports in OpenMetrics text format on the given socket. "
+            "Reports can log and gather metrics together, as in --compositor-report=log,metrics")
+        (async_logging_opt, po::value<bool>()->default_value(false),
+            "Format and write log messages on a background thread instead of the thread logging them")
+        (frame_trace_opt, po::value<std::string>(),
+            "Record a timeline of recent frames in memory, and write it to the given file in Chrome trace "
+            "event JSON format whenever the server receives SIGUSR2")
+        (frame_trace_socket_opt, po::value<std::string>(),
+            "Record a timeline of recent frames in memory, and serve it in Chrome trace event JSON format "
+            "on the given socket")
+        (memory_quota_opt, po::value<int>()->default_value(0),
+            "Limit on the buffer memory the server holds for each client, in MiB. 0 means no limit")
+        (memory_quota_action_opt, po::value<std::string>()->default_value("reject"),
+            "What to do with a client that goes over its memory quota [{reject,disconnect}]")
+        (memory_accounting_socket_opt, po::value<std::string>(),
+            "Serve the memory held for each client, by subsystem, on the given socket")
         (fatal_except_opt, "On \"fatal error\" conditions [e.g. drivers behaving "
             "in unexpected ways] throw an exception (instead of a core dump)")
         (debug_opt, "Enable extra development debugging. "
@@ -217,17 +269,18 @@ void mo::DefaultConfiguration::add_platform_options()
         (platform_path,
          po::value<std::string>()->default_value(MIR_SERVER_PLATFORM_PATH),
         "");
-    mo::ProgramOption options;
-    options.parse_arguments(program_options, argc, argv);
+    // Shared, as platform probing may outlive this function (see mg::module_for_device())
+    auto const options = std::make_shared<mo::ProgramOption>();
+    options->parse_arguments(program_options, argc, argv);
 
     // TODO: We should just load all the platform plugins we can and present their options.
     auto env_libname = ::getenv("MIR_SERVER_PLATFORM_GRAPHICS_LIB");
     auto env_libpath = ::getenv("MIR_SERVER_PLATFORM_PATH");
     try
     {
-        if (options.is_set(platform_graphics_lib))
+        if (options->is_set(platform_graphics_lib))
         {
-            platform_graphics_library = std::make_shared<mir::SharedLibrary>(options.get<std::string>(platform_graphics_lib));
+            platform_graphics_library = std::make_shared<mir::SharedLibrary>(options->get<std::string>(platform_graphics_lib));
         }
         else if (env_libname)
         {
@@ -236,9 +289,8 @@ void mo::DefaultConfiguration::add_platform_options()
         else
         {
             mir::logging::NullSharedLibraryProberReport null_report;
-            auto const plugin_path = env_libpath ? env_libpath : options.get<std::string>(platform_path);
-            auto plugins = mir::libraries_for_path(plugin_path, null_report);
-            platform_graphics_library = mir::graphics::module_for_device(plugins, options);
+            auto const plugin_path = env_libpath ? env_libpath : options->get<std::string>(platform_path);
+            platform_graphics_library = mir::graphics::module_for_device(plugin_path, options, null_report);
         }
 
         auto add_platform_options = platform_graphics_library->load_function<mir::graphics::AddPlatformOptions>("add_graphics_platform_options", MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
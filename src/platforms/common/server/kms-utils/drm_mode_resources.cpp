@@ -281,6 +281,20 @@ mgk::ObjectProperties::ObjectProperties(
 {
 }
 
+mgk::ObjectProperties::ObjectProperties(
+    int drm_fd,
+    DRMModeCrtcUPtr const& crtc)
+    : ObjectProperties(drm_fd, crtc->crtc_id, DRM_MODE_OBJECT_CRTC)
+{
+}
+
+mgk::ObjectProperties::ObjectProperties(
+    int drm_fd,
+    DRMModeConnectorUPtr const& connector)
+    : ObjectProperties(drm_fd, connector->connector_id, DRM_MODE_OBJECT_CONNECTOR)
+{
+}
+
 uint64_t mgk::ObjectProperties::operator[](char const* name) const
 {
     return properties_table.at(name).value;
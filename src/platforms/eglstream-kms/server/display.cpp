@@ -230,6 +230,11 @@ public:
         return std::chrono::milliseconds{0};
     }
 
+    bool variable_refresh_active() const override
+    {
+        return false;
+    }
+
 private:
     EGLDisplay dpy;
     EGLContext ctx;
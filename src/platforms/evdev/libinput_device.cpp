@@ -29,6 +29,7 @@
 #include "mir/input/touchpad_settings.h"
 #include "mir/input/input_device_info.h"
 #include "mir/events/event_builders.h"
+#include "mir/events/shared_event.h"
 #include "mir/geometry/displacement.h"
 #include "mir/dispatch/dispatchable.h"
 #include "mir/fd.h"
@@ -39,6 +40,7 @@
 #include <libinput.h>
 #include <linux/input.h>  // only used to get constants for input reports
 #include <dlfcn.h>
+#include <time.h>
 
 #include <boost/exception/diagnostic_information.hpp>
 #include <cstring>
@@ -53,6 +55,13 @@ using namespace std::literals::chrono_literals;
 
 namespace
 {
+/*
+ * How long after the kernel timestamped an event we may take to hand it on
+ * before counting it as late: half a frame at 60Hz, so the event still has
+ * a chance of making the next composition.
+ */
+auto const input_deadline = 8ms;
+
 double touch_major(libinput_event_touch*, uint32_t, uint32_t)
 {
     return 8;
@@ -147,19 +156,19 @@ void mie::LibInputDevice::process_event(libinput_event* event)
         switch(libinput_event_get_type(event))
         {
         case LIBINPUT_EVENT_KEYBOARD_KEY:
-            sink->handle_input(convert_event(libinput_event_get_keyboard_event(event)));
+            sink->handle_input(mir::events::share_event(convert_event(libinput_event_get_keyboard_event(event))));
             break;
         case LIBINPUT_EVENT_POINTER_MOTION:
-            sink->handle_input(convert_motion_event(libinput_event_get_pointer_event(event)));
+            sink->handle_input(mir::events::share_event(convert_motion_event(libinput_event_get_pointer_event(event))));
             break;
         case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
-            sink->handle_input(convert_absolute_motion_event(libinput_event_get_pointer_event(event)));
+            sink->handle_input(mir::events::share_event(convert_absolute_motion_event(libinput_event_get_pointer_event(event))));
             break;
         case LIBINPUT_EVENT_POINTER_BUTTON:
-            sink->handle_input(convert_button_event(libinput_event_get_pointer_event(event)));
+            sink->handle_input(mir::events::share_event(convert_button_event(libinput_event_get_pointer_event(event))));
             break;
         case LIBINPUT_EVENT_POINTER_AXIS:
-            sink->handle_input(convert_axis_event(libinput_event_get_pointer_event(event)));
+            sink->handle_input(mir::events::share_event(convert_axis_event(libinput_event_get_pointer_event(event))));
             break;
         // touch events are processed as a batch of changes over all touch pointts
         case LIBINPUT_EVENT_TOUCH_DOWN:
@@ -177,7 +186,7 @@ void mie::LibInputDevice::process_event(libinput_event* event)
         case LIBINPUT_EVENT_TOUCH_FRAME:
             if (is_output_active())
             {
-                sink->handle_input(convert_touch_frame(libinput_event_get_touch_event(event)));
+                sink->handle_input(mir::events::share_event(convert_touch_frame(libinput_event_get_touch_event(event))));
             }
             break;
         default:
@@ -190,6 +199,17 @@ void mie::LibInputDevice::process_event(libinput_event* event)
     }
 }
 
+void mie::LibInputDevice::check_deadline(std::chrono::nanoseconds event_time)
+{
+    // libinput timestamps events against CLOCK_MONOTONIC
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    auto const lateness = std::chrono::seconds{now.tv_sec} + std::chrono::nanoseconds{now.tv_nsec} - event_time;
+
+    if (lateness > input_deadline)
+        report->missed_input_deadline(event_time.count(), lateness.count(), ++missed_deadlines);
+}
+
 mir::EventUPtr mie::LibInputDevice::convert_event(libinput_event_keyboard* keyboard)
 {
     std::chrono::nanoseconds const time = std::chrono::microseconds(libinput_event_keyboard_get_time_usec(keyboard));
@@ -198,6 +218,7 @@ mir::EventUPtr mie::LibInputDevice::convert_event(libinput_event_keyboard* keybo
                       mir_keyboard_action_up;
     auto const code = libinput_event_keyboard_get_key(keyboard);
     report->received_event_from_kernel(time.count(), EV_KEY, code, action);
+    check_deadline(time);
 
     return builder->key_event(time, action, xkb_keysym_t{0}, code);
 }
@@ -217,6 +238,7 @@ mir::EventUPtr mie::LibInputDevice::convert_button_event(libinput_event_pointer*
     auto const vscroll_value = 0.0f;
 
     report->received_event_from_kernel(time.count(), EV_KEY, pointer_button, action);
+    check_deadline(time);
 
     if (action == mir_pointer_action_button_down)
         button_state = MirPointerButton(button_state | uint32_t(pointer_button));
@@ -234,6 +256,7 @@ mir::EventUPtr mie::LibInputDevice::convert_motion_event(libinput_event_pointer*
     auto const vscroll_value = 0.0f;
 
     report->received_event_from_kernel(time.count(), EV_REL, 0, 0);
+    check_deadline(time);
 
     return builder->pointer_event(time, action, button_state,
                                   hscroll_value, vscroll_value,
@@ -256,6 +279,7 @@ mir::EventUPtr mie::LibInputDevice::convert_absolute_motion_event(libinput_event
     auto abs_y = libinput_event_pointer_get_absolute_y_transformed(pointer, height);
 
     report->received_event_from_kernel(time.count(), EV_ABS, 0, 0);
+    check_deadline(time);
     auto const old_pointer_pos = pointer_pos;
     pointer_pos = mir::geometry::Point{abs_x, abs_y};
     auto const movement = pointer_pos - old_pointer_pos;
@@ -300,6 +324,7 @@ mir::EventUPtr mie::LibInputDevice::convert_axis_event(libinput_event_pointer* p
     }
 
     report->received_event_from_kernel(time.count(), EV_REL, 0, 0);
+    check_deadline(time);
     return builder->pointer_event(time, action, button_state, hscroll_value, vscroll_value, relative_x_value,
                                   relative_y_value);
 }
@@ -308,6 +333,7 @@ mir::EventUPtr mie::LibInputDevice::convert_touch_frame(libinput_event_touch* to
 {
     std::chrono::nanoseconds const time = std::chrono::microseconds(libinput_event_touch_get_time_usec(touch));
     report->received_event_from_kernel(time.count(), EV_SYN, 0, 0);
+    check_deadline(time);
 
     // TODO make libinput indicate tool type
     auto const tool = mir_touch_tooltype_finger;
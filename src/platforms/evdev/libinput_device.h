@@ -28,6 +28,7 @@
 #include "mir/input/touchscreen_settings.h"
 #include "mir/geometry/point.h"
 
+#include <chrono>
 #include <vector>
 #include <map>
 
@@ -77,6 +78,7 @@ private:
     void handle_touch_down(libinput_event_touch* touch);
     void handle_touch_up(libinput_event_touch* touch);
     void handle_touch_motion(libinput_event_touch* touch);
+    void check_deadline(std::chrono::nanoseconds event_time);
     void update_device_info();
     bool is_output_active() const;
     OutputInfo get_output_info() const;
@@ -86,6 +88,7 @@ private:
 
     std::shared_ptr<InputReport> report;
     std::vector<LibInputDevicePtr> devices;
+    uint64_t missed_deadlines{0};
 
     InputSink* sink{nullptr};
     EventBuilder* builder{nullptr};
@@ -23,11 +23,13 @@
 #include "kms_display_configuration.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/graphics/cursor_image.h"
+#include "mir/fnv1a_hash.h"
 
 #include <xf86drm.h>
 
 #include <boost/exception/errinfo_errno.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 
@@ -39,6 +41,16 @@ namespace
 {
 const uint64_t fallback_cursor_size = 64;
 char const* const mir_drm_cursor_64x64 = "MIR_DRM_CURSOR_64x64";
+size_t const max_cached_images = 8;
+
+uint64_t image_hash(geom::Size size, std::vector<uint8_t> const& argb8888)
+{
+    mir::Fnv1aHash hash;
+    hash.add(size.width.as_uint32_t());
+    hash.add(size.height.as_uint32_t());
+    hash.add(argb8888.data(), argb8888.size());
+    return hash.value();
+}
 
 // Transforms a relative position within the display bounds described by \a rect which is rotated with \a orientation
 geom::Displacement transform(geom::Rectangle const& rect, geom::Displacement const& vector, MirOrientation orientation)
@@ -108,7 +120,8 @@ mgm::Cursor::GBMBOWrapper::GBMBOWrapper(int fd, MirOrientation orientation) :
             get_drm_cursor_height(fd),
             GBM_FORMAT_ARGB8888,
             GBM_BO_USE_CURSOR | GBM_BO_USE_WRITE)},
-    current_orientation{orientation}
+    current_orientation{orientation},
+    image_id{0}
 {
     if (!buffer) BOOST_THROW_EXCEPTION(std::runtime_error("failed to create gbm buffer"));
 }
@@ -129,7 +142,8 @@ inline mgm::Cursor::GBMBOWrapper::~GBMBOWrapper()
 mgm::Cursor::GBMBOWrapper::GBMBOWrapper(GBMBOWrapper&& from)
     : device{from.device},
       buffer{from.buffer},
-      current_orientation{from.current_orientation}
+      current_orientation{from.current_orientation},
+      image_id{from.image_id}
 {
     from.buffer = nullptr;
     from.device = nullptr;
@@ -149,6 +163,8 @@ mgm::Cursor::Cursor(
     std::shared_ptr<CurrentConfiguration> const& current_configuration) :
         output_container(output_container),
         current_position(),
+        image_id(0),
+        last_image_id(0),
         last_set_failed(false),
         min_buffer_width{std::numeric_limits<uint32_t>::max()},
         min_buffer_height{std::numeric_limits<uint32_t>::max()},
@@ -275,6 +291,73 @@ void mgm::Cursor::pad_and_write_image_data_locked(
     write_buffer_data_locked(lg, buffer, &padded[0], padded_size);
 }
 
+void mgm::Cursor::select_image_buffer_locked(
+    std::lock_guard<std::mutex> const& lg,
+    int drm_fd,
+    std::list<GBMBOWrapper>& device_buffers)
+{
+    auto const orientation = device_buffers.back().orientation();
+
+    auto const cached = std::find_if(
+        device_buffers.begin(),
+        device_buffers.end(),
+        [this, orientation](GBMBOWrapper const& candidate)
+            {
+                return candidate.image() == image_id && candidate.orientation() == orientation;
+            });
+
+    if (cached != device_buffers.end())
+    {
+        device_buffers.splice(device_buffers.end(), device_buffers, cached);
+        return;
+    }
+
+    // Prefer a buffer that has never held a complete image, then a new one, then the least recently used
+    auto const unused = std::find_if(
+        device_buffers.begin(),
+        device_buffers.end(),
+        [](GBMBOWrapper const& candidate) { return candidate.image() == 0; });
+
+    if (unused != device_buffers.end())
+        device_buffers.splice(device_buffers.end(), device_buffers, unused);
+    else if (device_buffers.size() < max_cached_images)
+        device_buffers.emplace_back(drm_fd, orientation);
+    else
+        device_buffers.splice(device_buffers.end(), device_buffers, device_buffers.begin());
+
+    auto& buffer = device_buffers.back();
+    buffer.change_orientation(orientation);
+    buffer.set_image(0);
+    pad_and_write_image_data_locked(lg, buffer);
+    buffer.set_image(image_id);
+}
+
+auto mgm::Cursor::identify_image_locked(std::lock_guard<std::mutex> const&) -> uint64_t
+{
+    auto const hash = image_hash(size, argb8888);
+
+    auto const known = std::find_if(
+        known_images.begin(),
+        known_images.end(),
+        [&](KnownImage const& image)
+            {
+                return image.hash == hash && image.size == size && image.argb8888 == argb8888;
+            });
+
+    if (known != known_images.end())
+    {
+        known_images.splice(known_images.end(), known_images, known);
+        return known_images.back().id;
+    }
+
+    if (known_images.size() == max_cached_images)
+        known_images.pop_front();
+
+    // Ids start at 1, as 0 marks a buffer without a complete image
+    known_images.push_back({hash, size, argb8888, ++last_image_id});
+    return last_image_id;
+}
+
 void mgm::Cursor::show()
 {
     std::lock_guard<std::mutex> lg(guard);
@@ -296,11 +379,12 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
     memcpy(argb8888.data(), cursor_image.as_argb_8888(), argb8888.size());
 
     hotspot = cursor_image.hotspot();
+    image_id = identify_image_locked(lg);
     {
         auto locked_buffers = buffers.lock();
         for (auto& pair : *locked_buffers)
         {
-            pad_and_write_image_data_locked(lg, pair.second);
+            select_image_buffer_locked(lg, pair.first, pair.second);
         }
     }
 
@@ -399,7 +483,11 @@ void mgm::Cursor::place_cursor_at_locked(
             auto const changed_orientation = buffer.change_orientation(orientation);
 
             if (changed_orientation)
+            {
+                buffer.set_image(0);
                 pad_and_write_image_data_locked(lg, buffer);
+                buffer.set_image(image_id);
+            }
 
             if (force_state || !output.has_cursor() || changed_orientation)
             {
@@ -433,12 +521,13 @@ mgm::Cursor::GBMBOWrapper& mgm::Cursor::buffer_for_output(KMSOutput const& outpu
 
     if (buffer_it != locked_buffers->end())
     {
-        return buffer_it->second;
+        return buffer_it->second.back();
     }
 
-    locked_buffers->push_back(std::make_pair(output.drm_fd(), GBMBOWrapper(output.drm_fd(), mir_orientation_normal)));
+    locked_buffers->emplace_back(output.drm_fd(), std::list<GBMBOWrapper>{});
+    locked_buffers->back().second.emplace_back(output.drm_fd(), mir_orientation_normal);
 
-    GBMBOWrapper& bo = locked_buffers->back().second;
+    GBMBOWrapper& bo = locked_buffers->back().second.back();
     if (gbm_bo_get_width(bo) < min_buffer_width)
     {
         min_buffer_width = gbm_bo_get_width(bo);
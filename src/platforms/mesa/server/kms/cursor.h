@@ -30,6 +30,7 @@
 #include <gbm.h>
 
 #include <functional>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -97,7 +98,12 @@ private:
     void pad_and_write_image_data_locked(
         std::lock_guard<std::mutex> const&,
         GBMBOWrapper& buffer);
+    void select_image_buffer_locked(
+        std::lock_guard<std::mutex> const&,
+        int drm_fd,
+        std::list<GBMBOWrapper>& device_buffers);
     void clear(std::lock_guard<std::mutex> const&);
+    auto identify_image_locked(std::lock_guard<std::mutex> const&) -> uint64_t;
 
     GBMBOWrapper& buffer_for_output(KMSOutput const& output);
     
@@ -108,6 +114,20 @@ private:
     geometry::Displacement hotspot;
     geometry::Size size;
     std::vector<uint8_t> argb8888;
+    uint64_t image_id;
+
+    // Images shown recently, so showing one again gets back the id its buffers
+    // were written with. The hash only narrows the search: ids are handed out
+    // after comparing the pixels, so two images never share one.
+    struct KnownImage
+    {
+        uint64_t hash;
+        geometry::Size size;
+        std::vector<uint8_t> argb8888;
+        uint64_t id;
+    };
+    std::list<KnownImage> known_images;
+    uint64_t last_image_id;
 
     bool visible;
     bool last_set_failed;
@@ -120,6 +140,10 @@ private:
         auto orientation() const -> MirOrientation { return current_orientation; }
         auto change_orientation(MirOrientation new_orientation) -> bool;
 
+        /// Identifies the image last written, 0 if the content is not a complete image
+        auto image() const -> uint64_t { return image_id; }
+        void set_image(uint64_t id) { image_id = id; }
+
         ~GBMBOWrapper();
 
         GBMBOWrapper(GBMBOWrapper&& from);
@@ -127,10 +151,13 @@ private:
         gbm_device* device;
         gbm_bo* buffer;
         MirOrientation current_orientation;
+        uint64_t image_id;
         GBMBOWrapper(GBMBOWrapper const&) = delete;
         GBMBOWrapper& operator=(GBMBOWrapper const&) = delete;
     };
-    Mutex<std::vector<std::pair<int, GBMBOWrapper>>> buffers;
+    // The buffers of each DRM device hold recently shown images, the one in use is last.
+    // Switching back to one of those images, as animated cursors do, only flips buffers.
+    Mutex<std::vector<std::pair<int, std::list<GBMBOWrapper>>>> buffers;
 
     uint32_t min_buffer_width;
     uint32_t min_buffer_height;
@@ -26,6 +26,7 @@
 #include "mir/log.h"
 #include "native_buffer.h"
 #include "mir/graphics/egl_error.h"
+#include "mir/trace/frame_timeline.h"
 
 #include <boost/throw_exception.hpp>
 #include <EGL/egl.h>
@@ -664,6 +665,21 @@ void mgm::DisplayBuffer::post()
             fatal_error("Failed to get front buffer object");
     }
 
+    /*
+     * Variable refresh is only worth having while a single fullscreen
+     * client is scanned out directly: the display then refreshes when the
+     * client's frame arrives, so 24/25/48Hz content plays without judder.
+     * While compositing a desktop we stay on a fixed refresh to avoid
+     * visible brightness flicker on some panels as the rate changes.
+     */
+    bool const want_variable_refresh =
+        bypass_buf && outputs.size() == 1 && outputs.front()->has_variable_refresh();
+    if (want_variable_refresh != variable_refresh)
+    {
+        if (outputs.front()->set_variable_refresh(want_variable_refresh))
+            variable_refresh = want_variable_refresh;
+    }
+
     /*
      * Try to schedule a page flip as first preference to avoid tearing.
      * [will complete in a background thread]
@@ -728,7 +744,7 @@ void mgm::DisplayBuffer::post()
     bypass_bufobj = nullptr;
 
     recommend_sleep = 0ms;
-    if (outputs.size() == 1)
+    if (outputs.size() == 1 && !variable_refresh)
     {
         auto const& output = outputs.front();
         auto const min_frame_interval = 1000ms / output->max_refresh_rate();
@@ -742,6 +758,11 @@ std::chrono::milliseconds mgm::DisplayBuffer::recommended_sleep() const
     return recommend_sleep;
 }
 
+bool mgm::DisplayBuffer::variable_refresh_active() const
+{
+    return variable_refresh;
+}
+
 bool mgm::DisplayBuffer::schedule_page_flip(FBHandle const& bufobj)
 {
     /*
@@ -844,6 +865,8 @@ void mgm::GBMOutputSurface::release_current()
 
 void mgm::GBMOutputSurface::swap_buffers()
 {
+    mir::trace::FrameStageTrace const trace{mir::trace::FrameStage::swap};
+
     if (!egl.swap_buffers())
         fatal_error("Failed to perform buffer swap");
 }
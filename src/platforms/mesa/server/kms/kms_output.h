@@ -64,6 +64,21 @@ public:
      */
     virtual int max_refresh_rate() const = 0;
 
+    /**
+     * Whether the connected display and driver support variable refresh
+     * rate (VESA Adaptive Sync/FreeSync) that we can control.
+     */
+    virtual bool has_variable_refresh() const = 0;
+
+    /**
+     * Enable or disable variable refresh. While enabled the display
+     * refreshes when a page flip arrives (within the panel's supported
+     * range) rather than on a fixed vblank schedule.
+     *
+     * \return  true if variable refresh is now in the requested state.
+     */
+    virtual bool set_variable_refresh(bool enabled) = 0;
+
     virtual bool set_crtc(FBHandle const& fb) = 0;
     virtual void clear_crtc() = 0;
     virtual bool schedule_page_flip(FBHandle const& fb) = 0;
@@ -18,6 +18,7 @@
 
 #include "kms_page_flipper.h"
 #include "mir/graphics/display_report.h"
+#include "mir/trace/frame_timeline.h"
 
 #include <stdexcept>
 #include <boost/throw_exception.hpp>
@@ -25,6 +26,7 @@
 
 #include <xf86drm.h>
 #include <xf86drmMode.h>
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 
@@ -70,7 +72,8 @@ bool mgm::KMSPageFlipper::schedule_flip(uint32_t crtc_id,
     if (pending_page_flips.find(crtc_id) != pending_page_flips.end())
         BOOST_THROW_EXCEPTION(std::logic_error("Page flip for crtc_id is already scheduled"));
 
-    pending_page_flips[crtc_id] = PageFlipEventData{crtc_id, connector_id, this};
+    pending_page_flips[crtc_id] = PageFlipEventData{
+        crtc_id, connector_id, this, mir::trace::current_frame(), mir::trace::frame_trace_now()};
 
     /*
      * It appears we can't tell the difference between flipping being
@@ -185,6 +188,17 @@ void mgm::KMSPageFlipper::notify_page_flip(uint32_t crtc_id, int64_t msc,
         frame.msc = msc;
         frame.ust = {clock_id, ust};
         report->report_vsync(pending->second.connector_id, frame);
+
+        if (auto const timeline = mir::trace::frame_timeline())
+        {
+            // The flip timestamp is only on the trace clock if the driver gives monotonic timestamps
+            auto const flipped = clock_id == CLOCK_MONOTONIC ? ust : mir::trace::frame_trace_now();
+            timeline->record(
+                mir::trace::FrameStage::page_flip,
+                pending->second.scheduled, std::max(flipped, pending->second.scheduled),
+                pending->second.frame, 0, crtc_id);
+        }
+
         pending_page_flips.erase(pending);
     }
 }
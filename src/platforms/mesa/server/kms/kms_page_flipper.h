@@ -45,6 +45,8 @@ struct PageFlipEventData
     uint32_t crtc_id;
     uint32_t connector_id;
     KMSPageFlipper* flipper;
+    uint64_t frame;                         ///< The frame being flipped to, for frame tracing
+    std::chrono::nanoseconds scheduled;
 };
 
 class KMSPageFlipper : public PageFlipper
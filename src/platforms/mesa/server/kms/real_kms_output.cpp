@@ -81,7 +81,9 @@ mgm::RealKMSOutput::RealKMSOutput(
       saved_crtc(),
       using_saved_crtc{true},
       has_cursor_{false},
-      power_mode(mir_power_mode_on)
+      power_mode(mir_power_mode_on),
+      vrr_capable{false},
+      vrr_enabled{false}
 {
     reset();
 
@@ -136,8 +138,22 @@ void mgm::RealKMSOutput::reset()
         }
     }
 
+    try
+    {
+        mgk::ObjectProperties connector_props{drm_fd_, connector};
+        vrr_capable = connector_props.has_property("vrr_capable") &&
+                      connector_props["vrr_capable"];
+    }
+    catch (std::exception const& e)
+    {
+        mir::log_debug("Failed to query properties of output %s: %s",
+                       mgk::connector_name(connector).c_str(), e.what());
+        vrr_capable = false;
+    }
+
     /* Discard previously current crtc */
     current_crtc = nullptr;
+    vrr_enabled = false;
 }
 
 geom::Size mgm::RealKMSOutput::size() const
@@ -152,6 +168,65 @@ int mgm::RealKMSOutput::max_refresh_rate() const
     return current_mode.vrefresh;
 }
 
+bool mgm::RealKMSOutput::has_variable_refresh() const
+{
+    return vrr_capable;
+}
+
+bool mgm::RealKMSOutput::set_variable_refresh(bool enabled)
+{
+    if (enabled == vrr_enabled)
+        return true;
+
+    if ((enabled && !vrr_capable) || !current_crtc)
+        return false;
+
+    /*
+     * VRR_ENABLED lives on the CRTC and is only present on kernels and
+     * drivers that support adaptive sync. Setting it through the object
+     * property API takes effect with the next page flip.
+     *
+     * This is reached from post() and clear_crtc(), so a driver without the
+     * property (or without the object property API) must not throw: stop
+     * offering variable refresh on this output instead.
+     */
+    uint32_t vrr_enabled_id{0};
+    try
+    {
+        mgk::ObjectProperties crtc_props{drm_fd_, current_crtc};
+        if (crtc_props.has_property("VRR_ENABLED"))
+            vrr_enabled_id = crtc_props.id_for("VRR_ENABLED");
+    }
+    catch (std::exception const& e)
+    {
+        mir::log_debug("Failed to query CRTC properties of output %s: %s",
+                       mgk::connector_name(connector).c_str(), e.what());
+    }
+
+    if (!vrr_enabled_id)
+    {
+        vrr_capable = false;
+        return !enabled;
+    }
+
+    if (auto const result = drmModeObjectSetProperty(
+            drm_fd_,
+            current_crtc->crtc_id,
+            DRM_MODE_OBJECT_CRTC,
+            vrr_enabled_id,
+            enabled))
+    {
+        mir::log_warning("Failed to %s variable refresh on output %s: %s",
+                         enabled ? "enable" : "disable",
+                         mgk::connector_name(connector).c_str(),
+                         strerror(-result));
+        return false;
+    }
+
+    vrr_enabled = enabled;
+    return true;
+}
+
 void mgm::RealKMSOutput::configure(geom::Displacement offset, size_t kms_mode_index)
 {
     fb_offset = offset;
@@ -198,6 +273,9 @@ void mgm::RealKMSOutput::clear_crtc()
         return;
     }
 
+    // Don't leave adaptive sync enabled for whoever uses the CRTC next
+    set_variable_refresh(false);
+
     auto result = drmModeSetCrtc(drm_fd_, current_crtc->crtc_id,
                                  0, 0, 0, nullptr, 0, nullptr);
     if (result)
@@ -50,6 +50,8 @@ public:
     void configure(geometry::Displacement fb_offset, size_t kms_mode_index) override;
     geometry::Size size() const override;
     int max_refresh_rate() const override;
+    bool has_variable_refresh() const override;
+    bool set_variable_refresh(bool enabled) override;
 
     bool set_crtc(FBHandle const& fb) override;
     void clear_crtc() override;
@@ -91,6 +93,9 @@ private:
     MirPowerMode power_mode;
     int dpms_enum_id;
 
+    bool vrr_capable;
+    bool vrr_enabled;
+
     std::mutex power_mutex;
 
     AtomicFrame last_frame_;
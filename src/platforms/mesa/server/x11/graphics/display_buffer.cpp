@@ -178,3 +178,8 @@ std::chrono::milliseconds mgx::DisplayBuffer::recommended_sleep() const
 {
     return std::chrono::milliseconds::zero();
 }
+
+bool mgx::DisplayBuffer::variable_refresh_active() const
+{
+    return false;
+}
@@ -68,6 +68,7 @@ public:
         std::function<void(graphics::DisplayBuffer&)> const& f) override;
     void post() override;
     std::chrono::milliseconds recommended_sleep() const override;
+    bool variable_refresh_active() const override;
 
     glm::mat2 transformation() const override;
     NativeDisplayBuffer* native_display_buffer() override;
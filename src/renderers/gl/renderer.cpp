@@ -29,6 +29,7 @@
 #include "mir/gl/texture.h"
 #include "mir/log.h"
 #include "mir/report_exception.h"
+#include "mir/renderer/fence.h"
 
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp>
@@ -38,12 +39,65 @@
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
 #include <cmath>
+#include <cstring>
 
 namespace mg = mir::graphics;
 namespace mgl = mir::gl;
+namespace mr = mir::renderer;
 namespace mrg = mir::renderer::gl;
 namespace geom = mir::geometry;
 
+namespace
+{
+class EGLFence : public mr::Fence
+{
+public:
+    EGLFence(
+        EGLDisplay display,
+        EGLSyncKHR sync,
+        PFNEGLDESTROYSYNCKHRPROC destroy_sync,
+        PFNEGLCLIENTWAITSYNCKHRPROC client_wait_sync) :
+        display{display},
+        sync{sync},
+        destroy_sync{destroy_sync},
+        client_wait_sync{client_wait_sync}
+    {
+    }
+
+    ~EGLFence()
+    {
+        destroy_sync(display, sync);
+    }
+
+    void wait() override
+    {
+        if (client_wait_sync(display, sync, 0, EGL_FOREVER_KHR) == EGL_FALSE)
+            mir::log_warning("Failed to wait for EGL fence: 0x%x", eglGetError());
+    }
+
+private:
+    EGLDisplay const display;
+    EGLSyncKHR const sync;
+    PFNEGLDESTROYSYNCKHRPROC const destroy_sync;
+    PFNEGLCLIENTWAITSYNCKHRPROC const client_wait_sync;
+};
+
+bool has_extension(EGLDisplay display, char const* extension)
+{
+    auto const extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions)
+        return false;
+
+    auto const length = strlen(extension);
+    for (auto p = strstr(extensions, extension); p; p = strstr(p + length, extension))
+    {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0'))
+            return true;
+    }
+    return false;
+}
+}
+
 mrg::CurrentRenderTarget::CurrentRenderTarget(mg::DisplayBuffer* display_buffer)
     : render_target{
         dynamic_cast<renderer::gl::RenderTarget*>(display_buffer->native_display_buffer())}
@@ -131,12 +185,14 @@ mrg::Renderer::Program::Program(GLuint program_id)
     alpha_uniform = glGetUniformLocation(id, "alpha");
 }
 
-mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
+mrg::Renderer::Renderer(
+    graphics::DisplayBuffer& display_buffer,
+    std::shared_ptr<memory::Account> const& texture_account)
     : render_target(&display_buffer),
       clear_color{0.0f, 0.0f, 0.0f, 0.0f},
       default_program(family.add_program(vshader, default_fshader)),
       alpha_program(family.add_program(vshader, alpha_fshader)),
-      texture_cache(mgl::DefaultProgramFactory().create_texture_cache())
+      texture_cache(mgl::DefaultProgramFactory(texture_account).create_texture_cache())
 {
     eglBindAPI(MIR_SERVER_EGL_OPENGL_API);
     EGLDisplay disp = eglGetCurrentDisplay();
@@ -153,6 +209,20 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
             auto val = eglQueryString(disp, s.id);
             mir::log_info(std::string(s.label) + ": " + (val ? val : ""));
         }
+
+        if (has_extension(disp, "EGL_KHR_fence_sync"))
+        {
+            eglCreateSyncKHR = reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(
+                eglGetProcAddress("eglCreateSyncKHR"));
+            eglDestroySyncKHR = reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(
+                eglGetProcAddress("eglDestroySyncKHR"));
+            eglClientWaitSyncKHR = reinterpret_cast<PFNEGLCLIENTWAITSYNCKHRPROC>(
+                eglGetProcAddress("eglClientWaitSyncKHR"));
+
+            if (!eglCreateSyncKHR || !eglDestroySyncKHR || !eglClientWaitSyncKHR)
+                eglCreateSyncKHR = nullptr;
+        }
+        mir::log_info("EGL fence sync: %s", eglCreateSyncKHR ? "yes" : "no");
     }
 
     struct {GLenum id; char const* label;} const glstrings[] =
@@ -222,6 +292,26 @@ void mrg::Renderer::render(mg::RenderableList const& renderables) const
         mir::log_debug("GL error: %d", gl_error);
 }
 
+std::unique_ptr<mr::Fence> mrg::Renderer::fence_frame() const
+{
+    if (!eglCreateSyncKHR)
+        return nullptr;
+
+    auto const display = eglGetCurrentDisplay();
+    auto const sync = eglCreateSyncKHR(display, EGL_SYNC_FENCE_KHR, nullptr);
+    if (sync == EGL_NO_SYNC_KHR)
+    {
+        mir::log_debug("Failed to create EGL fence: 0x%x", eglGetError());
+        return nullptr;
+    }
+
+    // The fence is waited on from another thread, which can't flush this
+    // context for us (EGL_SYNC_FLUSH_COMMANDS_BIT_KHR), so flush here.
+    glFlush();
+
+    return std::make_unique<EGLFence>(display, sync, eglDestroySyncKHR, eglClientWaitSyncKHR);
+}
+
 void mrg::Renderer::draw(mg::Renderable const& renderable,
                           Renderer::Program const& prog) const
 {
@@ -29,6 +29,8 @@
 #include "mir/renderer/gl/render_target.h"
 
 #include MIR_SERVER_GL_H
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -37,6 +39,7 @@ namespace mir
 {
 namespace gl { class TextureCache; }
 namespace graphics { class DisplayBuffer; }
+namespace memory { class Account; }
 namespace renderer
 {
 namespace gl
@@ -59,7 +62,9 @@ private:
 class Renderer : public renderer::Renderer
 {
 public:
-    Renderer(graphics::DisplayBuffer& display_buffer);
+    Renderer(
+        graphics::DisplayBuffer& display_buffer,
+        std::shared_ptr<memory::Account> const& texture_account = nullptr);
     virtual ~Renderer();
 
     // These are called with a valid GL context:
@@ -70,6 +75,8 @@ public:
     // This is called _without_ a GL context:
     void suspend() override;
 
+    std::unique_ptr<renderer::Fence> fence_frame() const override;
+
 private:
     mutable CurrentRenderTarget render_target;
 
@@ -130,6 +137,11 @@ private:
     glm::mat4 screen_to_gl_coords;
     glm::mat4 display_transform;
     std::vector<mir::gl::Primitive> mutable primitives;
+
+    /// Null unless the display supports EGL_KHR_fence_sync
+    PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR{nullptr};
+    PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR{nullptr};
+    PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR{nullptr};
 };
 
 }
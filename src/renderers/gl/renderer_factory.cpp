@@ -19,12 +19,18 @@
 #include "renderer_factory.h"
 #include "renderer.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/memory/accounting.h"
 
 namespace mrg = mir::renderer::gl;
 
+mrg::RendererFactory::RendererFactory(std::shared_ptr<memory::Accounting> const& accounting) :
+    accounting{accounting}
+{
+}
+
 std::unique_ptr<mir::renderer::Renderer>
 mrg::RendererFactory::create_renderer_for(
     graphics::DisplayBuffer& display_buffer)
 {
-    return std::make_unique<Renderer>(display_buffer);
+    return std::make_unique<Renderer>(display_buffer, accounting ? accounting->server_account() : nullptr);
 }
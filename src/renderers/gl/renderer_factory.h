@@ -21,8 +21,11 @@
 
 #include "mir/renderer/renderer_factory.h"
 
+#include <memory>
+
 namespace mir
 {
+namespace memory { class Accounting; }
 namespace renderer
 {
 namespace gl
@@ -31,8 +34,15 @@ namespace gl
 class RendererFactory : public renderer::RendererFactory
 {
 public:
+    RendererFactory() = default;
+    /// Renderers created charge their textures to the server account of accounting
+    explicit RendererFactory(std::shared_ptr<memory::Accounting> const& accounting);
+
     std::unique_ptr<renderer::Renderer> create_renderer_for(
         graphics::DisplayBuffer& display_buffer) override;
+
+private:
+    std::shared_ptr<memory::Accounting> const accounting;
 };
 
 }
@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "async_buffer_release.h"
+#include "mir/renderer/fence.h"
+#include "mir/thread_name.h"
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace mr = mir::renderer;
+
+mc::AsyncBufferRelease::AsyncBufferRelease() = default;
+
+mc::AsyncBufferRelease::~AsyncBufferRelease()
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        running = false;
+    }
+    pending_changed.notify_one();
+
+    if (thread.joinable())
+        thread.join();
+}
+
+void mc::AsyncBufferRelease::release_after(
+    std::unique_ptr<mr::Fence> fence,
+    mg::RenderableList&& renderables)
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        if (!thread.joinable())
+            thread = std::thread{[this] { run(); }};
+
+        pending.push_back(Frame{std::move(fence), std::move(renderables)});
+    }
+    pending_changed.notify_one();
+}
+
+void mc::AsyncBufferRelease::wait_until_released()
+{
+    std::unique_lock<decltype(mutex)> lock{mutex};
+    all_released.wait(lock, [this] { return pending.empty() && !releasing; });
+}
+
+void mc::AsyncBufferRelease::run()
+{
+    mir::set_thread_name("Mir/BufRelease");
+
+    std::unique_lock<decltype(mutex)> lock{mutex};
+    for (;;)
+    {
+        pending_changed.wait(lock, [this] { return !running || !pending.empty(); });
+        if (pending.empty())
+            return;
+
+        {
+            auto const frame = std::move(pending.front());
+            pending.pop_front();
+            releasing = true;
+
+            lock.unlock();
+            frame.fence->wait();
+        }   // The frame's buffers go back to their clients here
+        lock.lock();
+
+        releasing = false;
+        if (pending.empty())
+            all_released.notify_all();
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_ASYNC_BUFFER_RELEASE_H_
+#define MIR_COMPOSITOR_ASYNC_BUFFER_RELEASE_H_
+
+#include "mir/graphics/renderable.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mir
+{
+namespace renderer { class Fence; }
+namespace compositor
+{
+
+/**
+ * Drops the compositor's references to the renderables of a frame once the
+ * GPU has finished with them, handing their buffers back to clients.
+ *
+ * Waiting for the fence, and the IPC that returning buffers involves, both
+ * happen on a thread of our own rather than on the compositor threads. One
+ * instance is shared by all the compositors of a display; its thread is only
+ * started once a renderer hands it a fence.
+ */
+class AsyncBufferRelease
+{
+public:
+    AsyncBufferRelease();
+    ~AsyncBufferRelease();
+
+    void release_after(
+        std::unique_ptr<renderer::Fence> fence,
+        graphics::RenderableList&& renderables);
+
+    /// Blocks until every frame passed to release_after() has been released
+    void wait_until_released();
+
+private:
+    AsyncBufferRelease(AsyncBufferRelease const&) = delete;
+    AsyncBufferRelease& operator=(AsyncBufferRelease const&) = delete;
+
+    struct Frame
+    {
+        std::unique_ptr<renderer::Fence> fence;
+        graphics::RenderableList renderables;
+    };
+
+    void run();
+
+    std::mutex mutex;
+    std::condition_variable pending_changed;
+    std::condition_variable all_released;
+    std::deque<Frame> pending;
+    bool releasing{false};
+    bool running{true};
+    std::thread thread;
+};
+
+}
+}
+
+#endif /* MIR_COMPOSITOR_ASYNC_BUFFER_RELEASE_H_ */
@@ -34,7 +34,13 @@ namespace mg = mir::graphics;
 namespace ms = mir::scene;
 namespace mf = mir::frontend;
 
-mc::BufferStreamFactory::BufferStreamFactory()
+mc::BufferStreamFactory::BufferStreamFactory(
+    std::shared_ptr<FramePacingMonitor> const& pacing,
+    unsigned int queue_depth,
+    std::shared_ptr<metrics::Gauge> const& queued_buffers) :
+    pacing{pacing},
+    queue_depth{queue_depth},
+    queued_buffers{queued_buffers}
 {
 }
 
@@ -50,6 +56,9 @@ std::shared_ptr<mc::BufferStream> mc::BufferStreamFactory::create_buffer_stream(
     int,
     mg::BufferProperties const& buffer_properties)
 {
-    return std::make_shared<mc::Stream>(
-        buffer_properties.size, buffer_properties.format);
+    auto const stream = std::make_shared<mc::Stream>(
+        buffer_properties.size, buffer_properties.format, pacing, queued_buffers);
+    if (queue_depth)
+        stream->set_queue_depth(queue_depth);
+    return stream;
 }
@@ -31,13 +31,22 @@ namespace graphics
 {
 class GraphicBufferAllocator;
 }
+namespace metrics { class Gauge; }
 namespace compositor
 {
+class FramePacingMonitor;
 
 class BufferStreamFactory : public scene::BufferStreamFactory
 {
 public:
-    BufferStreamFactory();
+    /**
+     * Streams are created with a queue depth of \p queue_depth (see BufferStream::set_queue_depth()),
+     * and count the buffers they have waiting for the compositor in \p queued_buffers.
+     */
+    explicit BufferStreamFactory(
+        std::shared_ptr<FramePacingMonitor> const& pacing = nullptr,
+        unsigned int queue_depth = 0,
+        std::shared_ptr<metrics::Gauge> const& queued_buffers = nullptr);
 
     virtual ~BufferStreamFactory() {}
 
@@ -48,6 +57,11 @@ public:
     virtual std::shared_ptr<BufferStream> create_buffer_stream(
         frontend::BufferStreamId,
         graphics::BufferProperties const&) override;
+
+private:
+    std::shared_ptr<FramePacingMonitor> const pacing;
+    unsigned int const queue_depth;
+    std::shared_ptr<metrics::Gauge> const queued_buffers;
 };
 
 }
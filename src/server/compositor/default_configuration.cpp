@@ -22,9 +22,14 @@
 #include "buffer_stream_factory.h"
 #include "default_display_buffer_compositor_factory.h"
 #include "multi_threaded_compositor.h"
+#include "presentation_clock.h"
+#include "frame_pacing_monitor.h"
+#include "frame_pacing_observer_multiplexer.h"
 #include "gl/renderer_factory.h"
 #include "compositing_screencast.h"
 #include "mir/main_loop.h"
+#include "mir/abnormal_exit.h"
+#include "mir/metrics/registry.h"
 
 #include "mir/frontend/screencast.h"
 #include "mir/options/configuration.h"
@@ -39,9 +44,20 @@ std::shared_ptr<ms::BufferStreamFactory>
 mir::DefaultServerConfiguration::the_buffer_stream_factory()
 {
     return buffer_stream_factory(
-        []()
+        [this]()
         {
-            return std::make_shared<mc::BufferStreamFactory>();
+            auto const queue_depth = the_options()->get<int>(options::buffer_queue_depth_opt);
+            if (queue_depth < 0)
+                throw AbnormalExit{std::string{"Invalid "} + options::buffer_queue_depth_opt + " option: must not be negative"};
+
+            // Shares the registry's ownership, so streams can outlive this configuration
+            auto const registry = the_metrics_registry();
+            std::shared_ptr<metrics::Gauge> const queued_buffers{
+                registry,
+                &registry->gauge("mir_client_queued_buffers", "Client buffers waiting to be composited")};
+
+            return std::make_shared<mc::BufferStreamFactory>(
+                the_frame_pacing_monitor(), static_cast<unsigned int>(queue_depth), queued_buffers);
         });
 }
 
@@ -79,16 +95,58 @@ mir::DefaultServerConfiguration::the_compositor()
                 the_shell(),
                 the_compositor_report(),
                 composite_delay,
-                !the_options()->is_set(options::host_socket_opt));
+                !the_options()->is_set(options::host_socket_opt),
+                parse_thread_scheduling(
+                    the_options()->get<std::string>(options::compositor_thread_scheduling_opt),
+                    the_options()->get<std::string>(options::compositor_thread_affinity_opt)),
+                the_presentation_clock(),
+                the_frame_pacing_monitor());
+        });
+}
+
+std::shared_ptr<mc::PresentationClock> mir::DefaultServerConfiguration::the_presentation_clock()
+{
+    return presentation_clock(
+        []()
+        {
+            return std::make_shared<mc::PresentationClock>();
+        });
+}
+
+std::shared_ptr<mc::FramePacingMonitor> mir::DefaultServerConfiguration::the_frame_pacing_monitor()
+{
+    return frame_pacing_monitor(
+        [this]()
+        {
+            return std::make_shared<mc::FramePacingMonitor>(the_frame_pacing_observer(), the_clock());
+        });
+}
+
+std::shared_ptr<mc::FramePacingObserver> mir::DefaultServerConfiguration::the_frame_pacing_observer()
+{
+    return frame_pacing_observer_multiplexer(
+        [default_executor = the_main_loop()]()
+        {
+            return std::make_shared<mc::FramePacingObserverMultiplexer>(default_executor);
+        });
+}
+
+std::shared_ptr<mir::ObserverRegistrar<mc::FramePacingObserver>>
+mir::DefaultServerConfiguration::the_frame_pacing_observer_registrar()
+{
+    return frame_pacing_observer_multiplexer(
+        [default_executor = the_main_loop()]()
+        {
+            return std::make_shared<mc::FramePacingObserverMultiplexer>(default_executor);
         });
 }
 
 std::shared_ptr<mir::renderer::RendererFactory> mir::DefaultServerConfiguration::the_renderer_factory()
 {
     return renderer_factory(
-        []()
+        [this]()
         {
-            return std::make_shared<mir::renderer::gl::RendererFactory>();
+            return std::make_shared<mir::renderer::gl::RendererFactory>(the_memory_accounting());
         });
 }
 
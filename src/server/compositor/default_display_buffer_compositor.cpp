@@ -26,6 +26,8 @@
 #include "mir/graphics/buffer.h"
 #include "mir/compositor/buffer_stream.h"
 #include "mir/renderer/renderer.h"
+#include "mir/renderer/fence.h"
+#include "mir/trace/frame_timeline.h"
 #include "occlusion.h"
 #include <mutex>
 #include <cstdlib>
@@ -37,15 +39,24 @@ namespace mg = mir::graphics;
 mc::DefaultDisplayBufferCompositor::DefaultDisplayBufferCompositor(
     mg::DisplayBuffer& display_buffer,
     std::shared_ptr<mir::renderer::Renderer> const& renderer,
-    std::shared_ptr<mc::CompositorReport> const& report) :
+    std::shared_ptr<mc::CompositorReport> const& report,
+    std::shared_ptr<AsyncBufferRelease> const& buffer_release) :
     display_buffer(display_buffer),
     renderer(renderer),
-    report(report)
+    report(report),
+    buffer_release(buffer_release)
 {
 }
 
+mc::DefaultDisplayBufferCompositor::~DefaultDisplayBufferCompositor()
+{
+    // Our fences must not outlive the renderer that created them
+    buffer_release->wait_until_released();
+}
+
 void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& scene_elements)
 {
+    mir::trace::FrameStageTrace const trace{mir::trace::FrameStage::render};
     report->began_frame(this);
 
     auto const& view_area = display_buffer.view_area();
@@ -66,9 +77,9 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
      * Note: Buffer lifetimes are ensured by the two objects holding
      *       references to them; scene_elements and renderable_list.
      *       So no buffer is going to be released back to the client till
-     *       both of those containers get destroyed (end of the function).
-     *       Actually, there's a third reference held by the texture cache
-     *       in GLRenderer, but that gets released earlier in render().
+     *       both of those containers are done with. Actually, there's a
+     *       third reference held by the texture cache in GLRenderer, but
+     *       that gets released earlier in render().
      */
     scene_elements.clear();  // Those in use are still in renderable_list
 
@@ -82,21 +93,20 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
         renderer->set_output_transform(display_buffer.transformation());
         renderer->set_viewport(view_area);
         renderer->render(renderable_list);
+        auto fence = renderer->fence_frame();
 
         report->renderables_in_frame(this, renderable_list);
         report->rendered_frame(this);
 
         /*
-         * This is used for the 'early release' optimization to release buffers
-         * we did use back to clients before starting on the potentially slow
-         * post() call.
-         * FIXME: This clear() call is blocking a little because we drive IPC
-         *        here (LP: #1395421). However if the early release
-         *        optimization is disabled or absent (LP: #1561418) then this
-         *        clear() doesn't contribute anything. In that case the
-         *        problematic IPC (LP: #1395421) will instead occur in buffer
-         *        acquisition calls when we composite the next frame.
+         * Early release: hand the buffers we sampled back to clients as soon
+         * as the GPU is done with them, rather than after the potentially
+         * slow post(). When we have a fence the wait for it, and the IPC
+         * that releasing buffers drives (LP: #1395421), happen on the
+         * release thread instead of here.
          */
+        if (fence)
+            buffer_release->release_after(std::move(fence), std::move(renderable_list));
         renderable_list.clear();
     }
 
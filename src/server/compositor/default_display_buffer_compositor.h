@@ -21,6 +21,7 @@
 
 #include "mir/compositor/display_buffer_compositor.h"
 #include "mir/compositor/compositor_report.h"
+#include "async_buffer_release.h"
 #include <memory>
 
 namespace mir
@@ -44,7 +45,9 @@ public:
     DefaultDisplayBufferCompositor(
         graphics::DisplayBuffer& display_buffer,
         std::shared_ptr<renderer::Renderer> const& renderer,
-        std::shared_ptr<CompositorReport> const& report);
+        std::shared_ptr<CompositorReport> const& report,
+        std::shared_ptr<AsyncBufferRelease> const& buffer_release = std::make_shared<AsyncBufferRelease>());
+    ~DefaultDisplayBufferCompositor();
 
     void composite(SceneElementSequence&& scene_sequence) override;
 
@@ -52,6 +55,7 @@ private:
     graphics::DisplayBuffer& display_buffer;
     std::shared_ptr<renderer::Renderer> const renderer;
     std::shared_ptr<CompositorReport> const report;
+    std::shared_ptr<AsyncBufferRelease> const buffer_release;
 };
 
 }
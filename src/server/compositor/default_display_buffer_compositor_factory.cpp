@@ -22,6 +22,7 @@
 #include "mir/graphics/display_buffer.h"
 
 #include "default_display_buffer_compositor.h"
+#include "async_buffer_release.h"
 
 namespace mc = mir::compositor;
 namespace mg = mir::graphics;
@@ -30,7 +31,8 @@ mc::DefaultDisplayBufferCompositorFactory::DefaultDisplayBufferCompositorFactory
     std::shared_ptr<mir::renderer::RendererFactory> const& renderer_factory,
     std::shared_ptr<mc::CompositorReport> const& report) :
     renderer_factory{renderer_factory},
-    report{report}
+    report{report},
+    buffer_release{std::make_shared<AsyncBufferRelease>()}
 {
 }
 
@@ -40,5 +42,5 @@ mc::DefaultDisplayBufferCompositorFactory::create_compositor_for(
 {
     auto renderer = renderer_factory->create_renderer_for(display_buffer);
     return std::make_unique<DefaultDisplayBufferCompositor>(
-         display_buffer, std::move(renderer), report);
+         display_buffer, std::move(renderer), report, buffer_release);
 }
@@ -22,6 +22,8 @@
 #include "mir/compositor/display_buffer_compositor_factory.h"
 #include "mir/compositor/compositor_report.h"
 
+#include <memory>
+
 namespace mir
 {
 namespace renderer
@@ -31,6 +33,7 @@ class RendererFactory;
 ///  Compositing. Combining renderables into a display image.
 namespace compositor
 {
+class AsyncBufferRelease;
 
 class DefaultDisplayBufferCompositorFactory : public DisplayBufferCompositorFactory
 {
@@ -44,6 +47,7 @@ public:
 private:
     std::shared_ptr<renderer::RendererFactory> const renderer_factory;
     std::shared_ptr<CompositorReport> const report;
+    std::shared_ptr<AsyncBufferRelease> const buffer_release;
 };
 
 }
@@ -29,7 +29,11 @@ mc::DroppingSchedule::DroppingSchedule()
 
 void mc::DroppingSchedule::schedule(std::shared_ptr<mg::Buffer> const& buffer)
 {
+    //superseded buffer goes back to the client once we've released the lock
+    std::shared_ptr<mg::Buffer> superseded;
+
     std::lock_guard<decltype(mutex)> lk(mutex);
+    superseded = std::move(the_only_buffer);
     the_only_buffer = buffer;
 }
 
@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_pacing_monitor.h"
+#include "mir/compositor/frame_pacing_observer.h"
+#include "mir/time/clock.h"
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+std::chrono::milliseconds const mc::FramePacingMonitor::frame_rate_window{1000};
+
+mc::FramePacingMonitor::FramePacingMonitor(
+    std::shared_ptr<FramePacingObserver> const& observer,
+    std::shared_ptr<time::Clock> const& clock) :
+    observer{observer},
+    clock{clock}
+{
+}
+
+namespace
+{
+uint64_t const frame_count_bits{16};
+uint64_t const frame_count_mask{(uint64_t{1} << frame_count_bits) - 1};
+}
+
+void mc::FramePacingMonitor::frame_posted(
+    OutputPacing& pacing,
+    mg::DisplayConfigurationOutputId output,
+    optional_value<Timestamp> const& target_vblank,
+    std::chrono::nanoseconds period,
+    mg::Frame const& displayed)
+{
+    // Platforms without real timing information never advance the MSC
+    if (displayed.msc <= 0)
+        return;
+
+    auto& last = pacing.last_displayed;
+    bool repeated{false};
+    unsigned vblanks_missed{0};
+
+    if (last.msc == displayed.msc && last.ust == displayed.ust)
+    {
+        // The output is still showing what we posted last time
+        repeated = true;
+    }
+    else if (target_vblank &&
+             period > std::chrono::nanoseconds::zero() &&
+             displayed.ust.clock_id == target_vblank.value().clock_id)
+    {
+        // Round to the nearest vblank, as the reported UST jitters a little
+        auto const lateness = displayed.ust - target_vblank.value();
+        if (lateness > period / 2)
+            vblanks_missed = (lateness + period / 2) / period;
+    }
+
+    last = displayed;
+
+    if (repeated)
+        observer->repeated_frame(output);
+    else if (vblanks_missed > 0)
+        observer->missed_deadline(output, vblanks_missed);
+}
+
+void mc::FramePacingMonitor::client_frame_composited(
+    BufferStream const* stream,
+    StreamPacing& pacing,
+    mg::BufferID buffer)
+{
+    auto const buffer_key = uint64_t{buffer.as_value()} + 1;
+    if (pacing.last_buffer.exchange(buffer_key, std::memory_order_relaxed) == buffer_key)
+        return;
+
+    auto const now = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(clock->now().time_since_epoch()).count());
+    auto const window_ms = static_cast<uint64_t>(frame_rate_window.count());
+
+    optional_value<float> frame_rate;
+    auto window = pacing.window.load(std::memory_order_relaxed);
+    uint64_t next_window;
+    do
+    {
+        auto const window_start = window >> frame_count_bits;
+        auto const frames_in_window = window & frame_count_mask;
+        auto const elapsed = now - window_start;
+
+        frame_rate = optional_value<float>{};
+        if (frames_in_window == 0 || now < window_start || elapsed > 2 * window_ms)
+        {
+            // First frame, or the client has been idle: start measuring afresh
+            next_window = (now << frame_count_bits) | 1;
+        }
+        else if (elapsed >= window_ms)
+        {
+            frame_rate = frames_in_window * 1000.0f / elapsed;
+            next_window = (now << frame_count_bits) | 1;
+        }
+        else
+        {
+            next_window = window + (frames_in_window < frame_count_mask ? 1 : 0);
+        }
+    }
+    while (!pacing.window.compare_exchange_weak(window, next_window, std::memory_order_relaxed));
+
+    if (frame_rate)
+        observer->client_frame_rate(stream, frame_rate.value());
+}
+
+void mc::FramePacingMonitor::client_frame_dropped(BufferStream const* stream)
+{
+    observer->client_frame_dropped(stream);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_FRAME_PACING_MONITOR_H_
+#define MIR_COMPOSITOR_FRAME_PACING_MONITOR_H_
+
+#include "mir/graphics/display_configuration.h"
+#include "mir/graphics/frame.h"
+#include "mir/graphics/buffer_id.h"
+#include "mir/optional_value.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace mir
+{
+namespace time { class Clock; }
+namespace compositor
+{
+class BufferStream;
+class FramePacingObserver;
+
+/**
+ * Watches for uneven frame delivery, both from the compositor to the
+ * outputs and from clients to the compositor, and tells a
+ * FramePacingObserver about it.
+ *
+ * Compositing threads report each frame they post along with the vblank
+ * they were aiming for, and streams report the frames the compositor takes
+ * from them and those clients replace before the compositor gets to them.
+ *
+ * This sits on every compositing and submission path, so it takes no locks:
+ * the state it needs is kept by the caller, in an OutputPacing owned by the
+ * compositing thread and a StreamPacing owned by each stream.
+ */
+class FramePacingMonitor
+{
+public:
+    typedef graphics::Frame::Timestamp Timestamp;
+
+    /// What frame_posted() remembers of an output between frames
+    struct OutputPacing
+    {
+        graphics::Frame last_displayed;
+    };
+
+    /// What client_frame_composited() remembers of a stream between frames
+    class StreamPacing
+    {
+    public:
+        StreamPacing() = default;
+        StreamPacing(StreamPacing const&) = delete;
+        StreamPacing& operator=(StreamPacing const&) = delete;
+
+    private:
+        friend class FramePacingMonitor;
+
+        // One more than the id of the last buffer taken; zero before the first
+        std::atomic<uint64_t> last_buffer{0};
+        // The window start in milliseconds above the frame count, so both
+        // are updated together by whichever compositor takes a new frame
+        std::atomic<uint64_t> window{0};
+    };
+
+    FramePacingMonitor(
+        std::shared_ptr<FramePacingObserver> const& observer,
+        std::shared_ptr<time::Clock> const& clock);
+
+    /**
+     * A frame has been posted to \p output.
+     *
+     * \param [in,out] pacing       The output's state, kept by the thread
+     *                              compositing it
+     * \param [in] output           The output the frame was posted to
+     * \param [in] target_vblank    The vblank compositing started in time
+     *                              for, if the compositor could predict it
+     * \param [in] period           The output's refresh period
+     * \param [in] displayed        The most recent frame the output reports
+     *                              as read after post()
+     */
+    void frame_posted(
+        OutputPacing& pacing,
+        graphics::DisplayConfigurationOutputId output,
+        optional_value<Timestamp> const& target_vblank,
+        std::chrono::nanoseconds period,
+        graphics::Frame const& displayed);
+
+    /**
+     * A compositor has taken \p buffer from \p stream to show it.
+     *
+     * Every compositor showing the stream takes the same buffer until one
+     * of them moves on, so only a change of buffer counts as a new frame.
+     * The measured rate is thus the rate client frames reach the screen,
+     * not the rate they are submitted at.
+     *
+     * \param [in] stream           The stream the buffer was taken from
+     * \param [in,out] pacing       The stream's state, kept by the stream
+     * \param [in] buffer           The buffer the compositor took
+     */
+    void client_frame_composited(
+        BufferStream const* stream,
+        StreamPacing& pacing,
+        graphics::BufferID buffer);
+
+    void client_frame_dropped(BufferStream const* stream);
+
+    /// How long client frame rates are averaged over before being reported
+    static std::chrono::milliseconds const frame_rate_window;
+
+private:
+    std::shared_ptr<FramePacingObserver> const observer;
+    std::shared_ptr<time::Clock> const clock;
+};
+
+}
+}
+
+#endif // MIR_COMPOSITOR_FRAME_PACING_MONITOR_H_
@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_pacing_observer_multiplexer.h"
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+mc::FramePacingObserverMultiplexer::FramePacingObserverMultiplexer(
+    std::shared_ptr<mir::Executor> const& default_executor)
+    : ObserverMultiplexer(*default_executor),
+      executor{default_executor}
+{
+}
+
+void mc::FramePacingObserverMultiplexer::missed_deadline(
+    mg::DisplayConfigurationOutputId output,
+    unsigned vblanks_missed)
+{
+    for_each_observer(&mc::FramePacingObserver::missed_deadline, output, vblanks_missed);
+}
+
+void mc::FramePacingObserverMultiplexer::repeated_frame(mg::DisplayConfigurationOutputId output)
+{
+    for_each_observer(&mc::FramePacingObserver::repeated_frame, output);
+}
+
+void mc::FramePacingObserverMultiplexer::client_frame_dropped(BufferStream const* stream)
+{
+    for_each_observer(&mc::FramePacingObserver::client_frame_dropped, stream);
+}
+
+void mc::FramePacingObserverMultiplexer::client_frame_rate(BufferStream const* stream, float frames_per_second)
+{
+    for_each_observer(&mc::FramePacingObserver::client_frame_rate, stream, frames_per_second);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_scheduler.h"
+
+#include <algorithm>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+namespace
+{
+/*
+ * Extrapolating the vblank grid too far from the last real frame lets small
+ * errors in the measured period accumulate. After this many periods without
+ * a new frame we stop predicting and just composite immediately.
+ */
+int const max_extrapolated_frames = 32;
+}
+
+mc::FrameScheduler::FrameScheduler(
+    std::chrono::nanoseconds nominal_period,
+    std::chrono::nanoseconds safety_margin) :
+    safety_margin{safety_margin},
+    period{nominal_period}
+{
+    render_times.fill(std::chrono::nanoseconds::zero());
+}
+
+void mc::FrameScheduler::frame_displayed(mg::Frame const& frame)
+{
+    // Platforms without real timing information never advance the MSC
+    if (frame.msc <= 0 || (frame.msc == last_frame.msc && frame.ust == last_frame.ust))
+        return;
+
+    if (last_frame.msc > 0 &&
+        frame.msc > last_frame.msc &&
+        frame.ust.clock_id == last_frame.ust.clock_id)
+    {
+        auto const measured = (frame.ust - last_frame.ust) / (frame.msc - last_frame.msc);
+
+        if (measured > std::chrono::nanoseconds::zero())
+        {
+            // Smooth out the scheduling jitter in the reported timestamps
+            if (period > std::chrono::nanoseconds::zero())
+                period += (measured - period) / 8;
+            else
+                period = measured;
+        }
+    }
+
+    last_frame = frame;
+}
+
+void mc::FrameScheduler::frame_rendered(std::chrono::nanoseconds render_time)
+{
+    render_times[next_render_time] = render_time;
+    next_render_time = (next_render_time + 1) % render_times.size();
+}
+
+mir::optional_value<mc::FrameScheduler::Timestamp>
+mc::FrameScheduler::next_vblank(Timestamp now) const
+{
+    if (last_frame.msc <= 0 ||
+        period <= std::chrono::nanoseconds::zero() ||
+        now.clock_id != last_frame.ust.clock_id)
+    {
+        return {};
+    }
+
+    auto const since_last_frame = std::max(now - last_frame.ust, std::chrono::nanoseconds::zero());
+    if (since_last_frame > period * max_extrapolated_frames)
+        return {};
+
+    // The earliest vblank we can still render in time for
+    auto const budget = render_budget();
+    auto const frames_ahead = std::max<long long>(
+        1, (since_last_frame + budget + period - std::chrono::nanoseconds{1}) / period);
+
+    return last_frame.ust + period * frames_ahead;
+}
+
+mir::optional_value<mc::FrameScheduler::Timestamp>
+mc::FrameScheduler::next_deadline(Timestamp now) const
+{
+    auto const budget = render_budget();
+    if (budget >= period)
+        return {};
+
+    // The latest we can start compositing for the next achievable vblank
+    if (auto const target_vblank = next_vblank(now))
+        return target_vblank.value() - budget;
+
+    return {};
+}
+
+std::chrono::nanoseconds mc::FrameScheduler::frame_period() const
+{
+    return period;
+}
+
+std::chrono::nanoseconds mc::FrameScheduler::render_budget() const
+{
+    return *std::max_element(render_times.begin(), render_times.end()) + safety_margin;
+}
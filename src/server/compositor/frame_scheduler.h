@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_FRAME_SCHEDULER_H_
+#define MIR_COMPOSITOR_FRAME_SCHEDULER_H_
+
+#include "mir/graphics/frame.h"
+#include "mir/optional_value.h"
+
+#include <array>
+#include <chrono>
+
+namespace mir
+{
+namespace compositor
+{
+
+/**
+ * Predicts when an output will next vblank, from the MSC/UST of frames it
+ * has already displayed, and from that when compositing needs to start so
+ * the result is ready just in time.
+ *
+ * Starting as late as possible means client buffers that arrive while we
+ * wait are "late latched" into the upcoming frame instead of waiting a
+ * whole extra frame.
+ */
+class FrameScheduler
+{
+public:
+    typedef graphics::Frame::Timestamp Timestamp;
+
+    /**
+     * \param [in] nominal_period  Refresh period from the output's current
+     *                             mode, or zero if unknown. Refined by
+     *                             measurement once frames are displayed.
+     * \param [in] safety_margin   Extra time allowed on top of the
+     *                             slowest recently measured render.
+     */
+    FrameScheduler(std::chrono::nanoseconds nominal_period,
+                   std::chrono::nanoseconds safety_margin);
+
+    /// The most recent frame reported by the output, as read after post()
+    void frame_displayed(graphics::Frame const& frame);
+
+    /// Time from sampling the scene until the frame was ready to post()
+    void frame_rendered(std::chrono::nanoseconds render_time);
+
+    /**
+     * When to start compositing to make the earliest vblank still
+     * achievable from \p now. Empty if there is not enough timing
+     * information (or it is too stale) to predict, in which case the caller
+     * should just composite immediately.
+     */
+    optional_value<Timestamp> next_deadline(Timestamp now) const;
+
+    /**
+     * The earliest vblank that compositing started at \p now can still
+     * make. Empty if there is not enough recent timing information.
+     */
+    optional_value<Timestamp> next_vblank(Timestamp now) const;
+
+    std::chrono::nanoseconds frame_period() const;
+    std::chrono::nanoseconds render_budget() const;
+
+private:
+    std::chrono::nanoseconds safety_margin;
+    std::chrono::nanoseconds period;
+    graphics::Frame last_frame;
+
+    std::array<std::chrono::nanoseconds, 16> render_times;
+    unsigned next_render_time{0};
+};
+
+}
+}
+
+#endif // MIR_COMPOSITOR_FRAME_SCHEDULER_H_
@@ -17,8 +17,12 @@
  */
 
 #include "multi_threaded_compositor.h"
+#include "frame_scheduler.h"
+#include "presentation_clock.h"
+#include "frame_pacing_monitor.h"
 #include "mir/graphics/display.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/graphics/display_configuration.h"
 #include "mir/compositor/display_buffer_compositor.h"
 #include "mir/compositor/display_buffer_compositor_factory.h"
 #include "mir/compositor/display_listener.h"
@@ -31,7 +35,10 @@
 #include "mir/raii.h"
 #include "mir/unwind_helpers.h"
 #include "mir/thread_name.h"
+#include "mir/trace/frame_timeline.h"
+#include "mir/trace/allocation_profile.h"
 
+#include <atomic>
 #include <thread>
 #include <chrono>
 #include <condition_variable>
@@ -43,6 +50,55 @@ namespace mc = mir::compositor;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
 
+namespace
+{
+struct OutputTiming
+{
+    mir::optional_value<unsigned> output_id;
+    std::chrono::nanoseconds nominal_period{0};
+};
+
+/*
+ * The sync group doesn't know which output(s) it drives, but for the
+ * purposes of frame timing any output showing the same area will do.
+ */
+OutputTiming timing_for(mg::Display const& display, mg::DisplaySyncGroup& group)
+{
+    OutputTiming timing;
+    mir::optional_value<mir::geometry::Rectangle> view_area;
+
+    group.for_each_display_buffer([&view_area](mg::DisplayBuffer& buffer)
+        { if (!view_area) view_area = buffer.view_area(); });
+
+    if (!view_area)
+        return timing;
+
+    display.configuration()->for_each_output(
+        [&](mg::DisplayConfigurationOutput const& output)
+        {
+            if (timing.output_id || !output.used || output.extents() != view_area.value())
+                return;
+
+            timing.output_id = static_cast<unsigned>(output.id.as_value());
+
+            if (output.current_mode_index < output.modes.size())
+            {
+                auto const hz = output.modes[output.current_mode_index].vrefresh_hz;
+                if (hz > 0)
+                    timing.nominal_period = std::chrono::nanoseconds{static_cast<long long>(1e9 / hz)};
+            }
+        });
+
+    return timing;
+}
+
+// Allowance for variation in render time beyond the worst recently seen
+auto const render_safety_margin = 2ms;
+
+// Frames are numbered across all compositing threads, so a frame number identifies one frame
+std::atomic<uint64_t> next_frame_number{1};
+}
+
 namespace mir
 {
 namespace compositor
@@ -53,12 +109,17 @@ class CompositingFunctor
 public:
     CompositingFunctor(
         std::shared_ptr<mc::DisplayBufferCompositorFactory> const& db_compositor_factory,
+        mg::Display const& display,
         mg::DisplaySyncGroup& group,
         std::shared_ptr<mc::Scene> const& scene,
         std::shared_ptr<DisplayListener> const& display_listener,
         std::chrono::milliseconds fixed_composite_delay,
-        std::shared_ptr<CompositorReport> const& report) :
+        std::shared_ptr<CompositorReport> const& report,
+        ThreadScheduling const& thread_scheduling,
+        std::shared_ptr<PresentationClock> const& presentation_clock,
+        std::shared_ptr<FramePacingMonitor> const& frame_pacing) :
         compositor_factory{db_compositor_factory},
+        display(display),
         group(group),
         scene(scene),
         running{true},
@@ -66,6 +127,9 @@ public:
         force_sleep{fixed_composite_delay},
         display_listener{display_listener},
         report{report},
+        thread_scheduling{thread_scheduling},
+        presentation_clock{presentation_clock},
+        frame_pacing{frame_pacing},
         started_future{started.get_future()}
     {
     }
@@ -74,6 +138,7 @@ public:
     try
     {
         mir::set_thread_name("Mir/Comp");
+        mir::apply_thread_scheduling(thread_scheduling);
 
         std::vector<std::tuple<mg::DisplayBuffer*, std::unique_ptr<mc::DisplayBufferCompositor>>> compositors;
         group.for_each_display_buffer(
@@ -108,6 +173,10 @@ public:
                     scene->unregister_compositor(std::get<1>(compositor).get());
             });
 
+        auto const timing = timing_for(display, group);
+        FrameScheduler scheduler{timing.nominal_period, render_safety_margin};
+        auto const now = []{ return FrameScheduler::Timestamp::now(CLOCK_MONOTONIC); };
+
         started.set_value();
 
         try
@@ -118,6 +187,22 @@ public:
                 /* Wait until compositing has been scheduled or we are stopped */
                 run_cv.wait(lock, [&]{ return (frames_scheduled > 0) || !running; });
 
+                /*
+                 * If we know when the next vblank is, hold off sampling the
+                 * scene until just before it. Any client buffers arriving
+                 * in the meantime make it into this frame rather than the
+                 * next one. With variable refresh there is no fixed vblank
+                 * to wait for; the display refreshes when we post.
+                 */
+                if (running &&
+                    force_sleep < std::chrono::milliseconds::zero() &&
+                    !group.variable_refresh_active())
+                {
+                    auto const wait_start = now();
+                    if (auto const deadline = scheduler.next_deadline(wait_start))
+                        run_cv.wait_for(lock, deadline.value() - wait_start, [&]{ return !running; });
+                }
+
                 /*
                  * Check if we are running before compositing, since we may have
                  * been stopped while waiting for the run_cv above.
@@ -135,23 +220,64 @@ public:
                     not_posted_yet = false;
                     lock.unlock();
 
+                    MIR_ALLOC_PROFILING_SCOPE("compositor.frame");
+
+                    mir::trace::set_current_frame(next_frame_number++);
+                    mir::trace::trace_frame_event(mir::trace::FrameStage::compositor_wake);
+
+                    auto const render_start = now();
+                    // With variable refresh there is no vblank grid to miss
+                    auto const target_vblank = group.variable_refresh_active() ?
+                        mir::optional_value<FrameScheduler::Timestamp>{} : scheduler.next_vblank(render_start);
+
                     for (auto& tuple : compositors)
                     {
                         auto& compositor = std::get<1>(tuple);
-                        compositor->composite(scene->scene_elements_for(compositor.get()));
+                        auto scene_elements = [&]
+                            {
+                                mir::trace::FrameStageTrace const trace{mir::trace::FrameStage::scene_elements};
+                                return scene->scene_elements_for(compositor.get());
+                            }();
+                        compositor->composite(std::move(scene_elements));
                     }
+                    scheduler.frame_rendered(now() - render_start);
+
                     group.post();
 
+                    if (timing.output_id)
+                    {
+                        auto const displayed = display.last_frame_on(timing.output_id.value());
+
+                        if (frame_pacing)
+                        {
+                            frame_pacing->frame_posted(
+                                output_pacing,
+                                mg::DisplayConfigurationOutputId{static_cast<int>(timing.output_id.value())},
+                                target_vblank,
+                                scheduler.frame_period(),
+                                displayed);
+                        }
+
+                        scheduler.frame_displayed(displayed);
+                    }
+
+                    if (presentation_clock)
+                        presentation_clock->frame_scheduled(scheduler);
+
                     /*
                      * "Predictive bypass" optimization: If the last frame was
                      * bypassed/overlayed or you simply have a fast GPU, it is
                      * beneficial to sleep for most of the next frame. This reduces
                      * the latency between snapshotting the scene and post()
                      * completing by almost a whole frame.
+                     *
+                     * When the vblank timing is known the wait for the
+                     * deadline above does this more precisely.
                      */
-                    auto delay = force_sleep >= std::chrono::milliseconds::zero() ?
-                                 force_sleep : group.recommended_sleep();
-                    std::this_thread::sleep_for(delay);
+                    if (force_sleep >= std::chrono::milliseconds::zero())
+                        std::this_thread::sleep_for(force_sleep);
+                    else if (group.variable_refresh_active() || !scheduler.next_deadline(now()))
+                        std::this_thread::sleep_for(group.recommended_sleep());
 
                     lock.lock();
 
@@ -232,6 +358,7 @@ public:
 
 private:
     std::shared_ptr<mc::DisplayBufferCompositorFactory> const compositor_factory;
+    mg::Display const& display;
     mg::DisplaySyncGroup& group;
     std::shared_ptr<mc::Scene> const scene;
     bool running;
@@ -241,6 +368,10 @@ private:
     std::condition_variable run_cv;
     std::shared_ptr<DisplayListener> const display_listener;
     std::shared_ptr<CompositorReport> const report;
+    ThreadScheduling const thread_scheduling;
+    std::shared_ptr<PresentationClock> const presentation_clock;
+    std::shared_ptr<FramePacingMonitor> const frame_pacing;
+    FramePacingMonitor::OutputPacing output_pacing;
     std::promise<void> started;
     std::future<void> started_future;
     bool not_posted_yet = true;
@@ -256,7 +387,10 @@ mc::MultiThreadedCompositor::MultiThreadedCompositor(
     std::shared_ptr<DisplayListener> const& display_listener,
     std::shared_ptr<CompositorReport> const& compositor_report,
     std::chrono::milliseconds fixed_composite_delay,
-    bool compose_on_start)
+    bool compose_on_start,
+    ThreadScheduling const& thread_scheduling,
+    std::shared_ptr<PresentationClock> const& presentation_clock,
+    std::shared_ptr<FramePacingMonitor> const& frame_pacing)
     : display{display},
       scene{scene},
       display_buffer_compositor_factory{db_compositor_factory},
@@ -265,6 +399,9 @@ mc::MultiThreadedCompositor::MultiThreadedCompositor(
       state{CompositorState::stopped},
       fixed_composite_delay{fixed_composite_delay},
       compose_on_start{compose_on_start},
+      thread_scheduling{thread_scheduling},
+      presentation_clock{presentation_clock},
+      frame_pacing{frame_pacing},
       thread_pool{1}
 {
     observer = std::make_shared<ms::LegacySceneChangeNotification>(
@@ -367,8 +504,8 @@ void mc::MultiThreadedCompositor::create_compositing_threads()
     display->for_each_display_sync_group([this](mg::DisplaySyncGroup& group)
     {
         auto thread_functor = std::make_unique<mc::CompositingFunctor>(
-            display_buffer_compositor_factory, group, scene, display_listener,
-            fixed_composite_delay, report);
+            display_buffer_compositor_factory, *display, group, scene, display_listener,
+            fixed_composite_delay, report, thread_scheduling, presentation_clock, frame_pacing);
 
         futures.push_back(thread_pool.run(std::ref(*thread_functor), &group));
         thread_functors.push_back(std::move(thread_functor));
@@ -21,6 +21,7 @@
 
 #include "mir/compositor/compositor.h"
 #include "mir/thread/basic_thread_pool.h"
+#include "mir/thread_scheduling.h"
 
 #include <mutex>
 #include <memory>
@@ -49,6 +50,8 @@ class DisplayListener;
 class CompositingFunctor;
 class Scene;
 class CompositorReport;
+class PresentationClock;
+class FramePacingMonitor;
 
 enum class CompositorState
 {
@@ -68,7 +71,10 @@ public:
         std::shared_ptr<DisplayListener> const& display_listener,
         std::shared_ptr<CompositorReport> const& compositor_report,
         std::chrono::milliseconds fixed_composite_delay,  // -1 = automatic
-        bool compose_on_start);
+        bool compose_on_start,
+        ThreadScheduling const& thread_scheduling = {},
+        std::shared_ptr<PresentationClock> const& presentation_clock = {},
+        std::shared_ptr<FramePacingMonitor> const& frame_pacing = {});
     ~MultiThreadedCompositor();
 
     void start();
@@ -90,6 +96,9 @@ private:
     std::atomic<CompositorState> state;
     std::chrono::milliseconds fixed_composite_delay;
     bool compose_on_start;
+    ThreadScheduling const thread_scheduling;
+    std::shared_ptr<PresentationClock> const presentation_clock;
+    std::shared_ptr<FramePacingMonitor> const frame_pacing;
 
     void schedule_compositing(int number_composites);
     void schedule_compositing(int number_composites, geometry::Rectangle const& damage) const;
@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "presentation_clock.h"
+
+namespace mc = mir::compositor;
+
+mc::PresentationClock::PresentationClock() :
+    latest{std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero()}
+{
+}
+
+void mc::PresentationClock::frame_scheduled(FrameScheduler const& scheduler)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    latest = scheduler;
+}
+
+mir::optional_value<std::chrono::nanoseconds>
+mc::PresentationClock::next_presentation(std::chrono::nanoseconds now) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (auto const vblank = latest.next_vblank(FrameScheduler::Timestamp{CLOCK_MONOTONIC, now}))
+        return vblank.value().nanoseconds;
+
+    auto const period = latest.frame_period();
+    if (period > std::chrono::nanoseconds::zero())
+        return now + period;
+
+    return {};
+}
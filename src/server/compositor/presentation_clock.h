@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_PRESENTATION_CLOCK_H_
+#define MIR_COMPOSITOR_PRESENTATION_CLOCK_H_
+
+#include "frame_scheduler.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace mir
+{
+namespace compositor
+{
+
+/**
+ * Shares the compositor's vblank schedule with code outside the compositing
+ * threads (such as input prediction) that needs to know when newly drawn
+ * content will reach the screen.
+ *
+ * Compositing threads publish their FrameScheduler after each frame. With
+ * several outputs the most recently composited one wins.
+ */
+class PresentationClock
+{
+public:
+    PresentationClock();
+
+    void frame_scheduled(FrameScheduler const& scheduler);
+
+    /**
+     * When content that arrives at \p now (on CLOCK_MONOTONIC) is expected
+     * to be on screen. Without real vblank timing this is assumed to be a
+     * frame away; empty if no output has even reported a refresh rate.
+     */
+    optional_value<std::chrono::nanoseconds> next_presentation(std::chrono::nanoseconds now) const;
+
+private:
+    std::mutex mutable mutex;
+    FrameScheduler latest;
+};
+
+}
+}
+
+#endif // MIR_COMPOSITOR_PRESENTATION_CLOCK_H_
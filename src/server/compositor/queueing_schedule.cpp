@@ -23,12 +23,30 @@
 namespace mc = mir::compositor;
 namespace mg = mir::graphics;
 
+mc::QueueingSchedule::QueueingSchedule() :
+    QueueingSchedule(0)
+{
+}
+
+mc::QueueingSchedule::QueueingSchedule(unsigned int max_depth) :
+    max_depth{max_depth}
+{
+}
+
 void mc::QueueingSchedule::schedule(std::shared_ptr<graphics::Buffer> const& buffer)
 {
+    //superseded buffer goes back to the client once we've released the lock
+    std::shared_ptr<mg::Buffer> superseded;
+
     std::lock_guard<decltype(mutex)> lk(mutex);
     auto it = std::find(queue.begin(), queue.end(), buffer);
     if (it != queue.end())
         queue.erase(it);
+    else if (max_depth && queue.size() >= max_depth)
+    {
+        superseded = std::move(queue.front());
+        queue.pop_front();
+    }
     queue.emplace_back(buffer);
 }
 
@@ -28,14 +28,25 @@ namespace mir
 namespace graphics { class Buffer; }
 namespace compositor
 {
+/**
+ * Composites submitted buffers in the order they were submitted.
+ *
+ * If max_depth is non-zero at most that many buffers wait for the compositor;
+ * scheduling another drops the oldest, releasing it back to the client. A depth
+ * of one gives mailbox behaviour, zero leaves the queue unbounded.
+ */
 class QueueingSchedule : public Schedule
 {
 public:
+    QueueingSchedule();
+    explicit QueueingSchedule(unsigned int max_depth);
+
     void schedule(std::shared_ptr<graphics::Buffer> const& buffer) override;
     unsigned int num_scheduled() override;
     std::shared_ptr<graphics::Buffer> next_buffer() override;
 
 private:
+    unsigned int const max_depth;
     std::mutex mutable mutex;
     std::deque<std::shared_ptr<graphics::Buffer>> queue;
 };
@@ -20,7 +20,10 @@
 #include "stream.h"
 #include "queueing_schedule.h"
 #include "dropping_schedule.h"
+#include "frame_pacing_monitor.h"
 #include "mir/graphics/buffer.h"
+#include "mir/metrics/registry.h"
+#include "mir/trace/frame_timeline.h"
 #include <boost/throw_exception.hpp>
 
 namespace mc = mir::compositor;
@@ -29,36 +32,52 @@ namespace mg = mir::graphics;
 namespace ms = mir::scene;
 namespace geom = mir::geometry;
 
-enum class mc::Stream::ScheduleMode {
-    Queueing,
-    Dropping
-};
-
 mc::Stream::Stream(
-    geom::Size size, MirPixelFormat pf) :
-    schedule_mode(ScheduleMode::Queueing),
+    geom::Size size,
+    MirPixelFormat pf,
+    std::shared_ptr<FramePacingMonitor> const& pacing,
+    std::shared_ptr<metrics::Gauge> const& queued_buffers) :
+    dropping(false),
+    max_queued(0),
     schedule(std::make_shared<mc::QueueingSchedule>()),
     arbiter(std::make_shared<mc::MultiMonitorArbiter>(schedule)),
     size(size),
     pf(pf),
-    first_frame_posted(false)
+    first_frame_posted(false),
+    pacing(pacing),
+    queued_buffers(queued_buffers),
+    reported_queued(0)
 {
 }
 
-mc::Stream::~Stream() = default;
+mc::Stream::~Stream()
+{
+    if (queued_buffers)
+        queued_buffers->add(-int64_t{reported_queued});
+}
 
 void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
 {
     if (!buffer)
         BOOST_THROW_EXCEPTION(std::invalid_argument("cannot submit null buffer"));
 
+    mir::trace::trace_frame_event(
+        mir::trace::FrameStage::client_submit, reinterpret_cast<uintptr_t>(this), buffer->id().as_value());
+
+    bool superseded_frame{false};
     {
         std::lock_guard<decltype(mutex)> lk(mutex); 
         first_frame_posted = true;
         pf = buffer->pixel_format();
+        // When dropping, a frame the compositor hasn't taken yet is replaced
+        superseded_frame = dropping && schedule->num_scheduled() > 0;
         schedule->schedule(buffer);
+        report_queued_buffers(lk);
     }
     observers.frame_posted(1, buffer->size());
+
+    if (pacing && superseded_frame)
+        pacing->client_frame_dropped(this);
 }
 
 void mc::Stream::with_most_recent_buffer_do(std::function<void(mg::Buffer&)> const& fn)
@@ -86,7 +105,15 @@ void mc::Stream::remove_observer(std::weak_ptr<ms::SurfaceObserver> const& obser
 
 std::shared_ptr<mg::Buffer> mc::Stream::lock_compositor_buffer(void const* id)
 {
-    return arbiter->compositor_acquire(id);
+    auto const buffer = arbiter->compositor_acquire(id);
+    if (queued_buffers)
+    {
+        std::lock_guard<decltype(mutex)> lk(mutex);
+        report_queued_buffers(lk);
+    }
+    if (pacing)
+        pacing->client_frame_composited(this, pacing_state, buffer->id());
+    return buffer;
 }
 
 geom::Size mc::Stream::stream_size()
@@ -102,28 +129,48 @@ void mc::Stream::resize(geom::Size const& new_size)
     size = new_size; 
 }
 
-void mc::Stream::allow_framedropping(bool dropping)
+void mc::Stream::allow_framedropping(bool allow)
 {
     std::lock_guard<decltype(mutex)> lk(mutex); 
-    if (dropping && schedule_mode == ScheduleMode::Queueing)
-    {
-        transition_schedule(std::make_shared<mc::DroppingSchedule>(), lk);
-        schedule_mode = ScheduleMode::Dropping;
-    }
-    else if (!dropping && schedule_mode == ScheduleMode::Dropping)
-    {
-        transition_schedule(std::make_shared<mc::QueueingSchedule>(), lk);
-        schedule_mode = ScheduleMode::Queueing;
-    }
+    if (allow == dropping)
+        return;
+
+    dropping = allow;
+    transition_schedule(make_schedule(lk), lk);
 }
 
 bool mc::Stream::framedropping() const
 {
-    return schedule_mode == ScheduleMode::Dropping;
+    std::lock_guard<decltype(mutex)> lk(mutex);
+    return dropping;
+}
+
+void mc::Stream::set_queue_depth(unsigned int new_max_queued)
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+    if (new_max_queued == max_queued)
+        return;
+
+    max_queued = new_max_queued;
+    if (!dropping)
+        transition_schedule(make_schedule(lk), lk);
+}
+
+unsigned int mc::Stream::queue_depth() const
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+    return dropping ? 1 : max_queued;
+}
+
+std::shared_ptr<mc::Schedule> mc::Stream::make_schedule(std::lock_guard<std::mutex> const&) const
+{
+    if (dropping)
+        return std::make_shared<mc::DroppingSchedule>();
+    return std::make_shared<mc::QueueingSchedule>(max_queued);
 }
 
 void mc::Stream::transition_schedule(
-    std::shared_ptr<mc::Schedule>&& new_schedule, std::lock_guard<std::mutex> const&)
+    std::shared_ptr<mc::Schedule>&& new_schedule, std::lock_guard<std::mutex> const& lk)
 {
     std::vector<std::shared_ptr<mg::Buffer>> transferred_buffers;
     while(schedule->num_scheduled())
@@ -132,6 +179,17 @@ void mc::Stream::transition_schedule(
         new_schedule->schedule(buffer);
     schedule = new_schedule;
     arbiter->set_schedule(schedule);
+    report_queued_buffers(lk);
+}
+
+void mc::Stream::report_queued_buffers(std::lock_guard<std::mutex> const&)
+{
+    if (!queued_buffers)
+        return;
+
+    auto const queued = schedule->num_scheduled();
+    queued_buffers->add(int64_t{queued} - int64_t{reported_queued});
+    reported_queued = queued;
 }
 
 int mc::Stream::buffers_ready_for_compositor(void const* id) const
@@ -156,6 +214,7 @@ void mc::Stream::drop_old_buffers()
     }
 
     arbiter->advance_schedule();
+    report_queued_buffers(lk);
 }
 
 bool mc::Stream::has_submitted_buffer() const
@@ -26,6 +26,7 @@
 #include "mir/lockable_callback.h"
 #include "mir/geometry/size.h"
 #include "multi_monitor_arbiter.h"
+#include "frame_pacing_monitor.h"
 #include <mutex>
 #include <memory>
 #include <set>
@@ -33,13 +34,19 @@
 namespace mir
 {
 namespace frontend { class ClientBuffers; }
+namespace metrics { class Gauge; }
 namespace compositor
 {
 class Schedule;
 class Stream : public BufferStream
 {
 public:
-    Stream(geometry::Size sz, MirPixelFormat format);
+    /// Buffers waiting to be composited are counted in \p queued_buffers, which may be shared by many streams
+    Stream(
+        geometry::Size sz,
+        MirPixelFormat format,
+        std::shared_ptr<FramePacingMonitor> const& pacing = nullptr,
+        std::shared_ptr<metrics::Gauge> const& queued_buffers = nullptr);
     ~Stream();
 
     void submit_buffer(std::shared_ptr<graphics::Buffer> const& buffer) override;
@@ -57,18 +64,26 @@ public:
     void drop_old_buffers() override;
     bool has_submitted_buffer() const override;
     void set_scale(float scale) override;
+    void set_queue_depth(unsigned int max_queued) override;
+    unsigned int queue_depth() const override;
 
 private:
-    enum class ScheduleMode;
+    std::shared_ptr<Schedule> make_schedule(std::lock_guard<std::mutex> const&) const;
     void transition_schedule(std::shared_ptr<Schedule>&& new_schedule, std::lock_guard<std::mutex> const&);
+    void report_queued_buffers(std::lock_guard<std::mutex> const&);
 
     std::mutex mutable mutex;
-    ScheduleMode schedule_mode;
+    bool dropping;
+    unsigned int max_queued;
     std::shared_ptr<Schedule> schedule;
     std::shared_ptr<MultiMonitorArbiter> const arbiter;
     geometry::Size size; 
     MirPixelFormat pf;
     bool first_frame_posted;
+    std::shared_ptr<FramePacingMonitor> const pacing;
+    FramePacingMonitor::StreamPacing pacing_state;
+    std::shared_ptr<metrics::Gauge> const queued_buffers;
+    unsigned int reported_queued;
 
     scene::SurfaceObservers observers;
 };
@@ -25,7 +25,9 @@
 #include "mir/emergency_cleanup.h"
 #include "mir/default_configuration.h"
 #include "mir/cookie/authority.h"
+#include "mir/memory/accounting.h"
 
+#include "mir/logging/async_logger.h"
 #include "mir/logging/dumb_console_logger.h"
 #include "mir/options/program_option.h"
 #include "mir/frontend/session_credentials.h"
@@ -207,6 +209,29 @@ std::shared_ptr<mir::cookie::Authority> mir::DefaultServerConfiguration::the_coo
         });
 }
 
+auto mir::DefaultServerConfiguration::the_memory_accounting() -> std::shared_ptr<memory::Accounting>
+{
+    return memory_accounting(
+        [this]
+        {
+            auto const quota_mib = the_options()->get<int>(options::memory_quota_opt);
+            if (quota_mib < 0)
+                throw AbnormalExit{std::string{"Invalid "} + options::memory_quota_opt + " option: must not be negative"};
+
+            auto const action = the_options()->get<std::string>(options::memory_quota_action_opt);
+            memory::QuotaAction quota_action;
+            if (action == "reject")
+                quota_action = memory::QuotaAction::reject;
+            else if (action == "disconnect")
+                quota_action = memory::QuotaAction::disconnect;
+            else
+                throw AbnormalExit{std::string{"Invalid "} + options::memory_quota_action_opt + " option: " +
+                    action + " (valid options are: \"reject\" and \"disconnect\")"};
+
+            return std::make_shared<memory::Accounting>(size_t(quota_mib) * 1024 * 1024, quota_action);
+        });
+}
+
 std::function<void()> mir::DefaultServerConfiguration::the_stop_callback()
 {
     return []{};
@@ -225,8 +250,11 @@ auto mir::DefaultServerConfiguration::the_logger()
     -> std::shared_ptr<ml::Logger>
 {
     return logger(
-        []() -> std::shared_ptr<ml::Logger>
+        [this]() -> std::shared_ptr<ml::Logger>
         {
+            if (the_options()->get<bool>(options::async_logging_opt))
+                return std::make_shared<ml::AsyncLogger>();
+
             return std::make_shared<ml::DumbConsoleLogger>();
         });
 }
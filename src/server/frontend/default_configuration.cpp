@@ -44,7 +44,8 @@ mir::DefaultServerConfiguration::the_connection_creator()
                 new_ipc_factory(session_authorizer),
                 session_authorizer,
                 the_graphics_platform()->make_ipc_operations(),
-                the_message_processor_report());
+                the_message_processor_report(),
+                the_input_latency());
         });
 }
 
@@ -124,7 +125,8 @@ mir::DefaultServerConfiguration::the_prompt_connection_creator()
                 new_ipc_factory(session_authorizer),
                 session_authorizer,
                 the_graphics_platform()->make_ipc_operations(),
-                the_message_processor_report());
+                the_message_processor_report(),
+                the_input_latency());
         });
 }
 
@@ -168,7 +170,8 @@ mir::DefaultServerConfiguration::new_ipc_factory(
                 the_application_not_responding_detector(),
                 the_cookie_authority(),
                 the_input_configuration_changer(),
-                the_extensions());
+                the_extensions(),
+                the_memory_accounting());
 }
 
 std::shared_ptr<mf::SessionMediatorObserver>
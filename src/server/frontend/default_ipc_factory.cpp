@@ -29,6 +29,7 @@
 #include "event_sink_factory.h"
 #include "mir/graphics/graphic_buffer_allocator.h"
 #include "mir/cookie/authority.h"
+#include "mir/memory/accounting.h"
 #include "mir/executor.h"
 #include "mir/signal_blocker.h"
 #include "mir/thread_name.h"
@@ -234,11 +235,12 @@ mf::DefaultIpcFactory::DefaultIpcFactory(
     std::shared_ptr<scene::ApplicationNotRespondingDetector> const& anr_detector,
     std::shared_ptr<mir::cookie::Authority> const& cookie_authority,
     std::shared_ptr<InputConfigurationChanger> const& input_changer,
-    std::vector<mir::ExtensionDescription> const& extensions) :
+    std::vector<mir::ExtensionDescription> const& extensions,
+    std::shared_ptr<memory::Accounting> const& accounting) :
     shell(shell),
     no_prompt_shell(std::make_shared<NoPromptShell>(shell)),
     sm_observer(sm_observer),
-    cache(std::make_shared<ResourceCache>()),
+    cache(std::make_shared<ResourceCache>(accounting ? accounting->server_account() : nullptr)),
     platform_ipc_operations(platform_ipc_operations),
     display_changer(display_changer),
     buffer_allocator(buffer_allocator),
@@ -249,7 +251,8 @@ mf::DefaultIpcFactory::DefaultIpcFactory(
     anr_detector{anr_detector},
     cookie_authority(cookie_authority),
     input_changer(input_changer),
-    extensions(extensions)
+    extensions(extensions),
+    accounting(accounting)
 {
 }
 
@@ -339,5 +342,6 @@ std::shared_ptr<mf::detail::DisplayServer> mf::DefaultIpcFactory::make_mediator(
         input_changer,
         extensions,
         buffer_allocator,
-        buffer_return_ipc_executor());
+        buffer_return_ipc_executor(),
+        accounting);
 }
@@ -40,6 +40,10 @@ namespace input
 {
 class CursorImages;
 }
+namespace memory
+{
+class Accounting;
+}
 
 namespace scene
 {
@@ -73,7 +77,8 @@ public:
         std::shared_ptr<scene::ApplicationNotRespondingDetector> const& anr_detector,
         std::shared_ptr<cookie::Authority> const& cookie_authority,
         std::shared_ptr<InputConfigurationChanger> const& input_Changer,
-        std::vector<mir::ExtensionDescription> const& extensions);
+        std::vector<mir::ExtensionDescription> const& extensions,
+        std::shared_ptr<memory::Accounting> const& accounting);
 
     std::shared_ptr<detail::DisplayServer> make_ipc_server(
         SessionCredentials const &creds,
@@ -112,6 +117,7 @@ private:
     std::shared_ptr<cookie::Authority> const cookie_authority;
     std::shared_ptr<InputConfigurationChanger> const input_changer;
     std::vector<mir::ExtensionDescription> const extensions;
+    std::shared_ptr<memory::Accounting> const accounting;
     std::shared_ptr<mir::Executor> const execution_queue;
 };
 }
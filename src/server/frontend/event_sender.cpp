@@ -22,6 +22,7 @@
 #include "mir/graphics/display_configuration.h"
 #include "mir/variable_length_array.h"
 #include "mir/input/device.h"
+#include "mir/input/input_latency.h"
 #include "mir/input/mir_input_config.h"
 #include "mir/input/mir_input_config_serialization.h"
 #include "mir/input/mir_pointer_config.h"
@@ -32,6 +33,7 @@
 
 #include "mir/graphics/buffer.h"
 #include "mir/client_visible_error.h"
+#include "mir/trace/transport_counters.h"
 
 #include "mir_protobuf_wire.pb.h"
 #include "mir_protobuf.pb.h"
@@ -44,9 +46,11 @@ namespace mi = mir::input;
 
 mfd::EventSender::EventSender(
     std::shared_ptr<MessageSender> const& socket_sender,
-    std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer) :
+    std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer,
+    std::shared_ptr<mi::InputLatency> const& input_latency) :
     sender(socket_sender),
-    buffer_packer(buffer_packer)
+    buffer_packer(buffer_packer),
+    input_latency(input_latency)
 {
 }
 
@@ -59,6 +63,11 @@ void mfd::EventSender::handle_event(MirEvent const& e)
     ev->set_raw(MirEvent::serialize(&e));
 
     send_event_sequence(seq, {});
+
+    if (input_latency && mir_event_get_type(&e) == mir_event_type_input)
+        input_latency->event_reached(
+            mi::InputStage::socket_write,
+            std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(&e))});
 }
 
 void mfd::EventSender::handle_display_config_change(
@@ -113,9 +122,15 @@ void mfd::EventSender::send_event_sequence(mp::EventSequence& seq, FdSets const&
     send_buffer.resize(result.ByteSize());
     result.SerializeWithCachedSizesToArray(send_buffer.data());
 
+    // The sequence is copied into the result, then again as the result is serialized
+    mir::trace::count(
+        mir::trace::transport_counters(mir::trace::TransportSide::server).bytes_copied,
+        2 * static_cast<size_t>(seq.GetCachedSize()));
+
     try
     {
         sender->send(reinterpret_cast<char*>(send_buffer.data()), send_buffer.size(), fds);
+        mir::trace::count(mir::trace::transport_counters(mir::trace::TransportSide::server).events_sent);
     }
     catch (std::exception const& error)
     {
@@ -26,6 +26,7 @@
 namespace mir
 {
 namespace graphics { class PlatformIpcOperations; }
+namespace input { class InputLatency; }
 namespace protobuf
 {
 class EventSequence;
@@ -42,7 +43,8 @@ class EventSender : public  mir::frontend::EventSink
 public:
     explicit EventSender(
         std::shared_ptr<MessageSender> const& socket_sender,
-        std::shared_ptr<graphics::PlatformIpcOperations> const& buffer_packer);
+        std::shared_ptr<graphics::PlatformIpcOperations> const& buffer_packer,
+        std::shared_ptr<input::InputLatency> const& input_latency = {});
     void handle_event(MirEvent const& e) override;
     void handle_lifecycle_event(MirLifecycleState state) override;
     void handle_display_config_change(graphics::DisplayConfiguration const& config) override;
@@ -60,6 +62,7 @@ private:
 
     std::shared_ptr<MessageSender> const sender;
     std::shared_ptr<graphics::PlatformIpcOperations> const buffer_packer;
+    std::shared_ptr<input::InputLatency> const input_latency;
 };
 
 }
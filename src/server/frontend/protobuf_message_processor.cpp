@@ -24,6 +24,8 @@
 #include "mir/frontend/template_protobuf_message_processor.h"
 #include <mir/protobuf/display_server_debug.h>
 #include "mir/client_visible_error.h"
+#include "mir/memory/accounting.h"
+#include "mir/trace/allocation_profile.h"
 
 #include "mir_protobuf_wire.pb.h"
 
@@ -131,6 +133,11 @@ void invoke(
     {
         throw;
     }
+    catch (mir::memory::QuotaExceeded const& /*err*/)
+    {
+        // Only escapes the mediator when the quota action is to disconnect
+        throw;
+    }
     catch (mir::ClientVisibleError const& error)
     {
         auto client_error = result_message->mutable_structured_error();
@@ -191,6 +198,8 @@ bool mfd::ProtobufMessageProcessor::dispatch(
     Invocation const& invocation,
     std::vector<mir::Fd> const& side_channel_fds)
 {
+    MIR_ALLOC_PROFILING_SCOPE("rpc.dispatch");
+
     report->received_invocation(display_server.get(), invocation.id(), invocation.method_name());
 
     bool result = true;
@@ -21,6 +21,7 @@
 #include "message_sender.h"
 #include "mir/frontend/client_constants.h"
 #include "mir/variable_length_array.h"
+#include "mir/trace/transport_counters.h"
 #include "socket_messenger.h"
 
 namespace mfd = mir::frontend::detail;
@@ -53,6 +54,11 @@ void mfd::ProtobufResponder::send_response(
         send_response_result.SerializeWithCachedSizesToArray(send_response_buffer.data());
     }
 
+    // The response is copied into the result, then again as the result is serialized
+    mir::trace::count(
+        mir::trace::transport_counters(mir::trace::TransportSide::server).bytes_copied,
+        2 * static_cast<size_t>(response->GetCachedSize()));
+
     sender->send(reinterpret_cast<char*>(send_response_buffer.data()), send_response_buffer.size(), fd_sets);
     resource_cache->free_resource(response);
 }
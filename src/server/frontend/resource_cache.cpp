@@ -18,12 +18,26 @@
 
 #include "resource_cache.h"
 
+mir::frontend::ResourceCache::ResourceCache(std::shared_ptr<memory::Account> const& account) :
+    account{account}
+{
+}
+
 void mir::frontend::ResourceCache::save_resource(
     google::protobuf::MessageLite* key,
     std::shared_ptr<void> const& value)
 {
     std::lock_guard<std::mutex> lock(guard);
-    resources[key] = value;
+    auto const existing = resources.find(key);
+    if (existing != resources.end())
+    {
+        existing->second = value;
+    }
+    else
+    {
+        resources.emplace(key, value);
+        charge_for(key);
+    }
 }
 
 void mir::frontend::ResourceCache::save_fd(
@@ -32,6 +46,14 @@ void mir::frontend::ResourceCache::save_fd(
 {
     std::lock_guard<std::mutex> lock(guard);
     fd_resources.emplace(key, fd);
+    charge_for(key);
+}
+
+void mir::frontend::ResourceCache::charge_for(google::protobuf::MessageLite* key)
+{
+    // The size of a retained resource is opaque to us, so only the number retained is counted
+    if (account)
+        charges.emplace(key, account->charge(memory::Subsystem::ipc_resources, 0));
 }
 
 void mir::frontend::ResourceCache::free_resource(google::protobuf::MessageLite* key)
@@ -49,6 +71,7 @@ void mir::frontend::ResourceCache::free_resource(google::protobuf::MessageLite*
 
         resources.erase(key);
         fd_resources.erase(key);
+        charges.erase(key);
     }
 
 }
@@ -20,6 +20,7 @@
 #define MIR_FRONTEND_RESOURCE_CACHE_H_
 
 #include "mir/fd.h"
+#include "mir/memory/accounting.h"
 
 #include <map>
 #include <memory>
@@ -54,6 +55,9 @@ public:
 class ResourceCache : public MessageResourceCache
 {
 public:
+    /// Each retained resource is counted against account, if there is one
+    explicit ResourceCache(std::shared_ptr<memory::Account> const& account = nullptr);
+
     void save_resource(google::protobuf::MessageLite* key, std::shared_ptr<void> const& value);
     void save_fd(google::protobuf::MessageLite* key, Fd const& fd);
     void free_resource(google::protobuf::MessageLite* key);
@@ -62,9 +66,16 @@ private:
     typedef std::map<google::protobuf::MessageLite*, std::shared_ptr<void>> Resources;
     typedef std::multimap<google::protobuf::MessageLite*, mir::Fd> FdResources;
 
+    typedef std::multimap<google::protobuf::MessageLite*, memory::Charge> Charges;
+
+    void charge_for(google::protobuf::MessageLite* key);
+
+    std::shared_ptr<memory::Account> const account;
+
     std::mutex guard;
     Resources resources;
     FdResources fd_resources;
+    Charges charges;
 };
 
 }
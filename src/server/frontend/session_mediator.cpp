@@ -61,6 +61,7 @@
 #include "mir/module_properties.h"
 #include "mir/graphics/graphic_buffer_allocator.h"
 #include "mir/executor.h"
+#include "mir/trace/frame_timeline.h"
 
 #include "mir/geometry/rectangles.h"
 #include "protobuf_buffer_packer.h"
@@ -114,7 +115,8 @@ mf::SessionMediator::SessionMediator(
     std::shared_ptr<mf::InputConfigurationChanger> const& input_changer,
     std::vector<mir::ExtensionDescription> const& extensions,
     std::shared_ptr<mg::GraphicBufferAllocator> const& allocator,
-    mir::Executor& executor) :
+    mir::Executor& executor,
+    std::shared_ptr<mir::memory::Accounting> const& accounting) :
     client_pid_(0),
     shell(shell),
     ipc_operations(ipc_operations),
@@ -134,7 +136,8 @@ mf::SessionMediator::SessionMediator(
     input_changer(input_changer),
     extensions(extensions),
     allocator{allocator},
-    executor{executor}
+    executor{executor},
+    accounting{accounting}
 {
 }
 
@@ -164,6 +167,9 @@ void mf::SessionMediator::connect(
     weak_session = session;
     connection_context.handle_client_connect(session);
 
+    if (accounting)
+        account = accounting->open_account(request->application_name(), client_pid_);
+
     auto ipc_package = ipc_operations->connection_ipc_package();
     auto platform = response->mutable_platform();
 
@@ -396,6 +402,8 @@ namespace
         }
         ~AutoSendBuffer()
         {
+            mir::trace::trace_frame_event(mir::trace::FrameStage::buffer_release, 0, buffer->id().as_value());
+
             executor.spawn(
                 [maybe_sink = sink, maybe_to_send = std::weak_ptr<mg::Buffer>(buffer)]()
                 {
@@ -464,6 +472,20 @@ void mf::SessionMediator::submit_buffer(
 
 namespace
 {
+size_t buffer_bytes(geom::Size size, MirPixelFormat format)
+{
+    return size_t(size.width.as_int()) * size.height.as_int() * MIR_BYTES_PER_PIXEL(format);
+}
+
+// Native formats mean nothing to MIR_BYTES_PER_PIXEL(), so those requests are
+// taken to be 32 bits per pixel until the allocated buffer says otherwise
+size_t requested_bytes(mir::protobuf::BufferStreamParameters const& req)
+{
+    auto const format = req.has_pixel_format() ?
+        static_cast<MirPixelFormat>(req.pixel_format()) : mir_pixel_format_argb_8888;
+    return buffer_bytes(geom::Size{req.width(), req.height()}, format);
+}
+
 bool validate_buffer_request(mir::protobuf::BufferStreamParameters const& req)
 {
     // A valid buffer request has either flags & native_format set
@@ -498,6 +520,7 @@ void mf::SessionMediator::allocate_buffers(
     {
         auto const& req = request->buffer_requests(i);
         std::shared_ptr<mg::Buffer> buffer;
+        auto subsystem = mir::memory::Subsystem::hardware_buffers;
         try
         {
             if (!validate_buffer_request(req))
@@ -505,6 +528,15 @@ void mf::SessionMediator::allocate_buffers(
                 BOOST_THROW_EXCEPTION(std::logic_error("Invalid buffer request"));
             }
 
+            // Charge for the buffer before allocating it, so a client over its quota
+            // can't make the server allocate first; the charge is corrected below
+            if (req.has_buffer_usage() && static_cast<mg::BufferUsage>(req.buffer_usage()) == mg::BufferUsage::software)
+                subsystem = mir::memory::Subsystem::shm_buffers;
+
+            mir::memory::Charge charge;
+            if (account)
+                charge = account->charge(subsystem, requested_bytes(req));
+
             if (req.has_flags() && req.has_native_format())
             {
                 buffer = allocator->alloc_buffer(
@@ -529,6 +561,9 @@ void mf::SessionMediator::allocate_buffers(
                 }
             }
 
+            if (account)
+                charge.adjust(buffer_bytes(buffer->size(), buffer->pixel_format()));
+
             if (request->has_id())
             {
                 auto const stream_id = mf::BufferStreamId{request->id().value()};
@@ -539,8 +574,20 @@ void mf::SessionMediator::allocate_buffers(
 
             // TODO: Throw if insert fails (duplicate ID)?
             buffer_cache.insert(std::make_pair(buffer->id(), buffer));
+            buffer_charges[buffer->id()] = std::move(charge);
             event_sink->add_buffer(*buffer);
         }
+        catch (mir::memory::QuotaExceeded const& err)
+        {
+            observer->session_error(session->name(), __PRETTY_FUNCTION__, err.what());
+            if (accounting->quota_action() == mir::memory::QuotaAction::disconnect)
+                throw;
+
+            event_sink->error_buffer(
+                geom::Size{req.width(), req.height()},
+                static_cast<MirPixelFormat>(req.pixel_format()),
+                err.what());
+        }
         catch (std::exception const& err)
         {
             event_sink->error_buffer(
@@ -591,6 +638,7 @@ void mf::SessionMediator::release_buffers(
     for (auto const& buffer_id : to_release)
     {
         buffer_cache.erase(buffer_id);
+        buffer_charges.erase(buffer_id);
     }
    done->Run();
 }
@@ -1040,6 +1088,7 @@ void mf::SessionMediator::release_buffer_stream(
     for (auto match = associated_range.first; match != associated_range.second; ++match)
     {
         buffer_cache.erase(match->second);
+        buffer_charges.erase(match->second);
     }
     stream_associated_buffers.erase(id);
 
@@ -29,6 +29,7 @@
 #include "mir/frontend/buffer_stream_id.h"
 #include "mir/graphics/platform_ipc_operations.h"
 #include "mir/graphics/buffer_id.h"
+#include "mir/memory/accounting.h"
 #include "mir/protobuf/display_server_debug.h"
 #include "mir_toolkit/common.h"
 
@@ -130,7 +131,8 @@ public:
         std::shared_ptr<InputConfigurationChanger> const& input_changer,
         std::vector<mir::ExtensionDescription> const& extensions,
         std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator,
-        mir::Executor& executor);
+        mir::Executor& executor,
+        std::shared_ptr<memory::Accounting> const& accounting);
 
     ~SessionMediator() noexcept;
 
@@ -308,6 +310,9 @@ private:
     std::unordered_multimap<BufferStreamId, graphics::BufferID> stream_associated_buffers;
     std::shared_ptr<graphics::GraphicBufferAllocator> const allocator;
     mir::Executor& executor;
+    std::shared_ptr<memory::Accounting> const accounting;
+    std::shared_ptr<memory::Account> account;
+    std::unordered_map<graphics::BufferID, memory::Charge> buffer_charges;
 
     ScreencastBufferTracker screencast_buffer_tracker;
 
@@ -23,6 +23,7 @@
 #include "mir/frontend/session_credentials.h"
 #include "mir/protobuf/protocol_version.h"
 #include "mir/log.h"
+#include "mir/trace/transport_counters.h"
 
 #include "mir_protobuf_wire.pb.h"
 
@@ -100,6 +101,11 @@ try
     mir::protobuf::wire::Invocation invocation;
     invocation.ParseFromArray(body.data(), body.size());
 
+    auto& totals = mir::trace::transport_counters(mir::trace::TransportSide::server);
+    mir::trace::count(totals.messages_received);
+    mir::trace::count(totals.bytes_received, header_size + body.size());
+    mir::trace::count(totals.bytes_copied, invocation.parameters().size());
+
     int const v = invocation.has_protocol_version() ?
                   invocation.protocol_version() :
                   -1;
@@ -21,6 +21,7 @@
 #include "mir/variable_length_array.h"
 #include "mir/fd_socket_transmission.h"
 #include "mir/raii.h"
+#include "mir/trace/transport_counters.h"
 
 #include <boost/throw_exception.hpp>
 
@@ -34,6 +35,14 @@ namespace mfd = mf::detail;
 namespace bs = boost::system;
 namespace ba = boost::asio;
 
+namespace
+{
+mir::trace::TransportCounters& counters()
+{
+    return mir::trace::transport_counters(mir::trace::TransportSide::server);
+}
+}
+
 mfd::SocketMessenger::SocketMessenger(std::shared_ptr<ba::local::stream_protocol::socket> const& socket)
     : socket(socket),
       socket_fd{IntOwnedFd{socket->native_handle()}}
@@ -91,12 +100,21 @@ void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& f
 
     for (auto const& fds : fd_set)
         mir::send_fds(socket_fd, fds);
+
+    auto& totals = counters();
+    mir::trace::count(totals.messages_sent);
+    mir::trace::count(totals.syscalls, 1 + fd_set.size());
+    mir::trace::count(totals.bytes_sent, whole_message.size());
+    mir::trace::count(totals.bytes_copied, length);
+    for (auto const& fds : fd_set)
+        mir::trace::count(totals.fds_sent, fds.size());
 }
 
 void mfd::SocketMessenger::async_receive_msg(
     MirReadHandler const& handler,
     ba::mutable_buffers_1 const& buffer)
 {
+    mir::trace::count(counters().syscalls);
     boost::asio::async_read(
          *socket,
          buffer,
@@ -112,6 +130,7 @@ bs::error_code mfd::SocketMessenger::receive_msg(
 
     while (nread < ba::buffer_size(buffer))
     {
+        mir::trace::count(counters().syscalls);
         nread += boost::asio::read(
              *socket,
              ba::mutable_buffers_1{buffer + nread},
@@ -128,6 +147,9 @@ void mfd::SocketMessenger::receive_fds(std::vector<Fd>& fds)
 {
     static char buffer;
     mir::receive_data(socket_fd, &buffer, 1, fds);
+
+    mir::trace::count(counters().syscalls);
+    mir::trace::count(counters().fds_received, fds.size());
 }
 
 size_t mfd::SocketMessenger::available_bytes()
@@ -137,6 +159,7 @@ size_t mfd::SocketMessenger::available_bytes()
     if (session_creds.pid() == 0)
         update_session_creds();
 
+    mir::trace::count(counters().syscalls);
     boost::asio::socket_base::bytes_readable command{true};
     socket->io_control(command);
     return command.get();
@@ -40,6 +40,7 @@
 #include "mir/frontend/display_changer.h"
 
 #include "mir/executor.h"
+#include "mir/memory/accounting.h"
 
 #include "mir/client/event.h"
 
@@ -167,9 +168,13 @@ GLenum const abgr = GL_INVALID_ENUM;
 
 struct ClientPrivate
 {
-    ClientPrivate(std::shared_ptr<mf::Session> const& session, mf::Shell& shell)
+    ClientPrivate(
+        std::shared_ptr<mf::Session> const& session,
+        mf::Shell& shell,
+        std::shared_ptr<mir::memory::Account> const& account)
         : session{session},
-          shell{&shell}
+          shell{&shell},
+          account{account}
     {
     }
 
@@ -190,6 +195,7 @@ struct ClientPrivate
      * This shell is owned by the ClientSessionConstructor, which outlives all clients.
      */
     mf::Shell* const shell;
+    std::shared_ptr<mir::memory::Account> const account;
 };
 
 static_assert(
@@ -218,16 +224,30 @@ std::shared_ptr<mf::Session> session_for_client(wl_client* client)
     return nullptr;
 }
 
+std::shared_ptr<mir::memory::Account> account_for_client(wl_client* client)
+{
+    auto listener = wl_client_get_destroy_listener(client, &cleanup_private);
+
+    if (listener)
+        return private_from_listener(listener)->account;
+
+    return nullptr;
+}
+
 struct ClientSessionConstructor
 {
-    ClientSessionConstructor(std::shared_ptr<mf::Shell> const& shell)
-        : shell{shell}
+    ClientSessionConstructor(
+        std::shared_ptr<mf::Shell> const& shell,
+        std::shared_ptr<mir::memory::Accounting> const& accounting)
+        : shell{shell},
+          accounting{accounting}
     {
     }
 
     wl_listener construction_listener;
     wl_listener destruction_listener;
     std::shared_ptr<mf::Shell> const shell;
+    std::shared_ptr<mir::memory::Accounting> const accounting;
 };
 
 static_assert(
@@ -251,7 +271,11 @@ void create_client_session(wl_listener* listener, void* data)
         "",
         std::make_shared<WaylandEventSink>([](auto){}));
 
-    auto client_context = new ClientPrivate{session, *construction_context->shell};
+    std::shared_ptr<mir::memory::Account> account;
+    if (construction_context->accounting)
+        account = construction_context->accounting->open_account(session->name(), client_pid);
+
+    auto client_context = new ClientPrivate{session, *construction_context->shell, account};
     client_context->destroy_listener.notify = &cleanup_private;
     wl_client_add_destroy_listener(client, &client_context->destroy_listener);
 }
@@ -264,9 +288,12 @@ void cleanup_client_handler(wl_listener* listener, void*)
     delete construction_context;
 }
 
-void setup_new_client_handler(wl_display* display, std::shared_ptr<mf::Shell> const& shell)
+void setup_new_client_handler(
+    wl_display* display,
+    std::shared_ptr<mf::Shell> const& shell,
+    std::shared_ptr<mir::memory::Accounting> const& accounting)
 {
-    auto context = new ClientSessionConstructor{shell};
+    auto context = new ClientSessionConstructor{shell, accounting};
     context->construction_listener.notify = &create_client_session;
 
     wl_display_add_client_created_listener(display, &context->construction_listener);
@@ -358,6 +385,7 @@ public:
 
     static std::shared_ptr<graphics::Buffer> mir_buffer_from_wl_buffer(
         wl_resource* buffer,
+        std::shared_ptr<mir::memory::Account> const& account,
         std::function<void()>&& on_consumed)
     {
         std::shared_ptr<WlShmBuffer> mir_buffer;
@@ -376,13 +404,13 @@ public:
                  *
                  * Recreate a new WlShmBuffer to track the new compositor lifetime.
                  */
-                mir_buffer = std::shared_ptr<WlShmBuffer>{new WlShmBuffer{buffer, std::move(on_consumed)}};
+                mir_buffer = std::shared_ptr<WlShmBuffer>{new WlShmBuffer{buffer, account, std::move(on_consumed)}};
                 shim->associated_buffer = mir_buffer;
             }
         }
         else
         {
-            mir_buffer = std::shared_ptr<WlShmBuffer>{new WlShmBuffer{buffer, std::move(on_consumed)}};
+            mir_buffer = std::shared_ptr<WlShmBuffer>{new WlShmBuffer{buffer, account, std::move(on_consumed)}};
             shim = new DestructionShim;
             shim->destruction_listener.notify = &on_buffer_destroyed;
             shim->associated_buffer = mir_buffer;
@@ -487,12 +515,14 @@ public:
 private:
     WlShmBuffer(
         wl_resource* buffer,
+        std::shared_ptr<mir::memory::Account> const& account,
         std::function<void()>&& on_consumed)
         : buffer{shm_buffer_from_resource_checked(buffer)},
           resource{buffer},
           size_{wl_shm_buffer_get_width(this->buffer), wl_shm_buffer_get_height(this->buffer)},
           stride_{wl_shm_buffer_get_stride(this->buffer)},
           format_{wl_format_to_mir_format(wl_shm_buffer_get_format(this->buffer))},
+          copy_charge{charge_copy(account, size_, stride_)},
           data{std::make_unique<uint8_t[]>(size_.height.as_int() * stride_.as_int())},
           consumed{false},
           on_consumed{std::move(on_consumed)}
@@ -515,6 +545,19 @@ private:
         wl_shm_buffer_end_access(this->buffer);
     }
 
+    static mir::memory::Charge charge_copy(
+        std::shared_ptr<mir::memory::Account> const& account,
+        geom::Size size,
+        geom::Stride stride)
+    {
+        if (!account)
+            return {};
+
+        return account->charge(
+            mir::memory::Subsystem::wayland_shm_copies,
+            size_t(size.height.as_int()) * stride.as_int());
+    }
+
     static void on_buffer_destroyed(wl_listener* listener, void*)
     {
         static_assert(
@@ -551,6 +594,7 @@ private:
     geom::Stride const stride_;
     MirPixelFormat const format_;
 
+    mir::memory::Charge const copy_charge;
     std::unique_ptr<uint8_t[]> const data;
 
     bool consumed;
@@ -713,9 +757,20 @@ void WlSurface::commit()
 
         if (wl_shm_buffer_get(pending_buffer))
         {
-            mir_buffer = WlShmBuffer::mir_buffer_from_wl_buffer(
-                pending_buffer,
-                std::move(send_frame_notifications));
+            try
+            {
+                mir_buffer = WlShmBuffer::mir_buffer_from_wl_buffer(
+                    pending_buffer,
+                    account_for_client(client),
+                    std::move(send_frame_notifications));
+            }
+            catch (mir::memory::QuotaExceeded const& error)
+            {
+                // wl_surface.commit cannot fail, so a client over its quota is disconnected
+                mir::log_warning("Disconnecting Wayland client: %s", error.what());
+                wl_client_post_no_memory(client);
+                return;
+            }
         }
         else
         {
@@ -2207,6 +2262,7 @@ mf::WaylandConnector::WaylandConnector(
     DisplayChanger& display_config,
     std::shared_ptr<mi::InputDeviceHub> const& input_hub,
     std::shared_ptr<mg::GraphicBufferAllocator> const& allocator,
+    std::shared_ptr<mir::memory::Accounting> const& accounting,
     bool arw_socket)
     : display{wl_display_create(), &cleanup_display},
       pause_signal{eventfd(0, EFD_CLOEXEC | EFD_SEMAPHORE)},
@@ -2282,7 +2338,7 @@ mf::WaylandConnector::WaylandConnector(
 
     auto wayland_loop = wl_display_get_event_loop(display.get());
 
-    setup_new_client_handler(display.get(), shell);
+    setup_new_client_handler(display.get(), shell, accounting);
 
     pause_source = wl_event_loop_add_fd(wayland_loop, pause_signal, WL_EVENT_READABLE, &halt_eventloop, display.get());
 }
@@ -38,6 +38,10 @@ namespace graphics
 class GraphicBufferAllocator;
 class WaylandAllocator;
 }
+namespace memory
+{
+class Accounting;
+}
 
 namespace frontend
 {
@@ -59,6 +63,7 @@ public:
         DisplayChanger& display_config,
         std::shared_ptr<input::InputDeviceHub> const& input_hub,
         std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator,
+        std::shared_ptr<memory::Accounting> const& accounting,
         bool arw_socket);
 
     ~WaylandConnector() override;
@@ -49,6 +49,7 @@
 
 #include <map>
 #include <sstream>
+#include <typeinfo>
 
 namespace mg = mir::graphics;
 namespace ml = mir::logging;
@@ -103,13 +104,10 @@ std::shared_ptr<mg::Platform> mir::DefaultServerConfiguration::the_graphics_plat
                 else
                 {
                     auto const& path = the_options()->get<std::string>(options::platform_path);
-                    auto platforms = mir::libraries_for_path(path, *the_shared_library_prober_report());
-                    if (platforms.empty())
-                    {
-                        auto msg = "Failed to find any platform plugins in: " + path;
-                        throw std::runtime_error(msg.c_str());
-                    }
-                    platform_library = mir::graphics::module_for_device(platforms, dynamic_cast<mir::options::ProgramOption&>(*the_options()));
+                    auto const options = std::dynamic_pointer_cast<mir::options::ProgramOption const>(the_options());
+                    if (!options)
+                        throw std::bad_cast{};
+                    platform_library = mir::graphics::module_for_device(path, options, *the_shared_library_prober_report());
                 }
                 auto create_host_platform = platform_library->load_function<mg::CreateHostPlatform>(
                     "create_host_platform",
@@ -171,6 +171,11 @@ mgn::detail::DisplaySyncGroup::recommended_sleep() const
     return std::chrono::milliseconds::zero();
 }
 
+bool mgn::detail::DisplaySyncGroup::variable_refresh_active() const
+{
+    return false;
+}
+
 geom::Rectangle mgn::detail::DisplaySyncGroup::view_area() const
 {
     return output->view_area();
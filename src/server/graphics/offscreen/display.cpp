@@ -94,6 +94,11 @@ mgo::detail::DisplaySyncGroup::recommended_sleep() const
     return std::chrono::milliseconds::zero();
 }
 
+bool mgo::detail::DisplaySyncGroup::variable_refresh_active() const
+{
+    return false;
+}
+
 mgo::Display::Display(
     EGLNativeDisplayType egl_native_display,
     std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
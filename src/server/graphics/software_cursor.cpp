@@ -24,8 +24,11 @@
 #include "mir/graphics/buffer_properties.h"
 #include "mir/input/scene.h"
 #include "mir/renderer/sw/pixel_source.h"
+#include "mir/geometry/rectangles.h"
+#include "mir/fnv1a_hash.h"
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <stdexcept>
 #include <mutex>
 
@@ -36,6 +39,18 @@ namespace mrs = mir::renderer::software;
 
 namespace
 {
+size_t const max_cached_images = 8;
+
+uint64_t image_key(mg::CursorImage const& image, size_t pixels_size)
+{
+    mir::Fnv1aHash hash;
+    auto const size = image.size();
+    hash.add(size.width.as_uint32_t());
+    hash.add(size.height.as_uint32_t());
+    hash.add(image.as_argb_8888(), pixels_size);
+
+    return hash.value();
+}
 
 MirPixelFormat get_8888_format(std::vector<MirPixelFormat> const& formats)
 {
@@ -177,24 +192,51 @@ void mg::SoftwareCursor::show(CursorImage const& cursor_image)
 std::shared_ptr<mg::detail::CursorRenderable>
 mg::SoftwareCursor::create_renderable_for(CursorImage const& cursor_image, geom::Point position)
 {
-    auto new_renderable = std::make_shared<detail::CursorRenderable>(
-        allocator->alloc_buffer({cursor_image.size(), format, mg::BufferUsage::software}),
+    return std::make_shared<detail::CursorRenderable>(
+        buffer_for(cursor_image),
         position + hotspot - cursor_image.hotspot());
+}
 
+std::shared_ptr<mg::Buffer> mg::SoftwareCursor::buffer_for(CursorImage const& cursor_image)
+{
     size_t const pixels_size =
         cursor_image.size().width.as_uint32_t() *
         cursor_image.size().height.as_uint32_t() *
         MIR_BYTES_PER_PIXEL(format);
 
+    auto const key = image_key(cursor_image, pixels_size);
+    auto const pixels = static_cast<unsigned char const*>(cursor_image.as_argb_8888());
+
+    auto const cached = std::find_if(begin(image_buffers), end(image_buffers),
+        [&](CachedImage const& entry)
+        {
+            return entry.key == key &&
+                   entry.size == cursor_image.size() &&
+                   std::equal(pixels, pixels + pixels_size, entry.pixels.begin(), entry.pixels.end());
+        });
+
+    if (cached != end(image_buffers))
+    {
+        std::rotate(cached, cached + 1, end(image_buffers));
+        return image_buffers.back().buffer;
+    }
+
+    auto const buffer = allocator->alloc_buffer({cursor_image.size(), format, mg::BufferUsage::software});
+
     // TODO: The buffer pixel format may not be argb_8888, leading to
     // incorrect cursor colors. We need to transform the data to match
     // the buffer pixel format.
-    auto pixel_source = dynamic_cast<mrs::PixelSource*>(new_renderable->buffer()->native_buffer_base());
+    auto pixel_source = dynamic_cast<mrs::PixelSource*>(buffer->native_buffer_base());
     if (pixel_source)
-        pixel_source->write(static_cast<unsigned char const*>(cursor_image.as_argb_8888()), pixels_size);
+        pixel_source->write(pixels, pixels_size);
     else
         BOOST_THROW_EXCEPTION(std::logic_error("could not write to buffer for software cursor"));
-    return new_renderable;
+
+    if (image_buffers.size() == max_cached_images)
+        image_buffers.erase(begin(image_buffers));
+    image_buffers.push_back({key, cursor_image.size(), {pixels, pixels + pixels_size}, buffer});
+
+    return buffer;
 }
 
 void mg::SoftwareCursor::hide()
@@ -214,14 +256,21 @@ void mg::SoftwareCursor::hide()
 
 void mg::SoftwareCursor::move_to(geometry::Point position)
 {
+    geom::Rectangles damage;
     {
         std::lock_guard<std::mutex> lg{guard};
 
         if (!renderable)
             return;
 
+        damage.add(renderable->screen_position());
         renderable->move_to(position - hotspot);
+        damage.add(renderable->screen_position());
+
+        if (!visible)
+            return;
     }
 
-    scene->emit_scene_changed();
+    // Only the outputs showing the old or new cursor position need recompositing
+    scene->emit_scene_damaged(damage.bounding_rectangle());
 }
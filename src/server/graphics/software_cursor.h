@@ -22,13 +22,16 @@
 #include "mir/graphics/cursor.h"
 #include "mir_toolkit/client_types.h"
 #include "mir/geometry/displacement.h"
+#include "mir/geometry/size.h"
 #include <mutex>
+#include <vector>
 
 namespace mir
 {
 namespace input { class Scene; }
 namespace graphics
 {
+class Buffer;
 class GraphicBufferAllocator;
 class Renderable;
 
@@ -53,6 +56,7 @@ public:
 private:
     std::shared_ptr<detail::CursorRenderable> create_renderable_for(
         CursorImage const& cursor_image, geometry::Point position);
+    std::shared_ptr<Buffer> buffer_for(CursorImage const& cursor_image);
 
     std::shared_ptr<GraphicBufferAllocator> const allocator;
     std::shared_ptr<input::Scene> const scene;
@@ -61,6 +65,19 @@ private:
     std::shared_ptr<detail::CursorRenderable> renderable;
     bool visible;
     geometry::Displacement hotspot;
+
+    struct CachedImage
+    {
+        uint64_t key;
+        geometry::Size size;
+        std::vector<unsigned char> pixels;  ///< Compared on a key match, so a collision can't show the wrong image
+        std::shared_ptr<Buffer> buffer;
+    };
+
+    // Buffers holding recently shown images, least recently used first. The
+    // content of a buffer never changes, so animated cursors cycling through
+    // their frames neither reallocate nor upload pixels again.
+    std::vector<CachedImage> image_buffers;
 };
 
 }
@@ -18,6 +18,7 @@
  */
 
 #include "basic_seat.h"
+#include "mir/input/input_latency.h"
 #include "mir/input/device.h"
 #include "mir/input/input_sink.h"
 #include "mir/graphics/display_configuration_observer.h"
@@ -150,14 +151,18 @@ mi::BasicSeat::BasicSeat(std::shared_ptr<mi::InputDispatcher> const& dispatcher,
                          std::shared_ptr<Registrar> const& registrar,
                          std::shared_ptr<mi::KeyMapper> const& key_mapper,
                          std::shared_ptr<time::Clock> const& clock,
-                         std::shared_ptr<mi::SeatObserver> const& observer) :
+                         std::shared_ptr<mi::SeatObserver> const& observer,
+                         std::shared_ptr<mi::MotionPredictor> const& motion_predictor,
+                         std::shared_ptr<mi::InputLatency> const& latency) :
       input_state_tracker{dispatcher,
                           touch_visualizer,
                           cursor_listener,
                           key_mapper,
                           clock,
-                          observer},
-      output_tracker{std::make_shared<OutputTracker>(input_state_tracker)}
+                          observer,
+                          motion_predictor},
+      output_tracker{std::make_shared<OutputTracker>(input_state_tracker)},
+      latency{latency}
 {
     registrar->register_interest(output_tracker);
 }
@@ -174,6 +179,11 @@ void mi::BasicSeat::remove_device(input::Device const& device)
 
 void mi::BasicSeat::dispatch_event(std::shared_ptr<MirEvent> const& event)
 {
+    if (latency && mir_event_get_type(event.get()) == mir_event_type_input)
+        latency->event_reached(
+            InputStage::seat,
+            std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(event.get()))});
+
     input_state_tracker.dispatch(event);
 }
 
@@ -44,6 +44,7 @@ class CursorListener;
 class InputDispatcher;
 class KeyMapper;
 class SeatObserver;
+class InputLatency;
 
 class BasicSeat : public Seat
 {
@@ -55,7 +56,9 @@ public:
               std::shared_ptr<Registrar> const& registrar,
               std::shared_ptr<KeyMapper> const& key_mapper,
               std::shared_ptr<time::Clock> const& clock,
-              std::shared_ptr<SeatObserver> const& observer);
+              std::shared_ptr<SeatObserver> const& observer,
+              std::shared_ptr<MotionPredictor> const& motion_predictor = {},
+              std::shared_ptr<InputLatency> const& latency = {});
     // Seat methods:
     void add_device(Device const& device) override;
     void remove_device(Device const& device) override;
@@ -73,6 +76,7 @@ private:
     SeatInputDeviceTracker input_state_tracker;
     struct OutputTracker;
     std::shared_ptr<OutputTracker> const output_tracker;
+    std::shared_ptr<InputLatency> const latency;
 };
 }
 }
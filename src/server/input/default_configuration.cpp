@@ -31,6 +31,9 @@
 #include "default_input_manager.h"
 #include "surface_input_dispatcher.h"
 #include "basic_seat.h"
+#include "motion_predictor.h"
+#include "input_event_recorder.h"
+#include "input_latency_histograms.h"
 #include "seat_observer_multiplexer.h"
 #include "../graphics/nested/input_platform.h"
 
@@ -77,7 +80,8 @@ mir::DefaultServerConfiguration::the_event_filter_chain_dispatcher()
         [this]() -> std::shared_ptr<mi::EventFilterChainDispatcher>
         {
             std::initializer_list<std::shared_ptr<mi::EventFilter> const> filter_list {default_filter};
-            return std::make_shared<mi::EventFilterChainDispatcher>(filter_list, the_surface_input_dispatcher());
+            return std::make_shared<mi::EventFilterChainDispatcher>(
+                filter_list, the_surface_input_dispatcher(), the_input_latency());
         });
 }
 
@@ -101,7 +105,13 @@ mir::DefaultServerConfiguration::the_surface_input_dispatcher()
     return surface_input_dispatcher(
         [this]()
         {
-            return std::make_shared<mi::SurfaceInputDispatcher>(the_input_scene());
+            // Motion is only coalesced for surfaces that opt in, and paced by the
+            // outputs' vblanks; 60Hz until the compositor has timed a frame
+            std::chrono::milliseconds const fallback_frame_period{16};
+
+            return std::make_shared<mi::SurfaceInputDispatcher>(
+                the_input_scene(), the_main_loop(), the_presentation_clock(), fallback_frame_period,
+                the_input_latency());
         });
 }
 
@@ -208,7 +218,12 @@ mir::DefaultServerConfiguration::the_input_manager()
                 // TODO: move this into a nested graphics platform
                 auto platform = std::make_shared<mgn::InputPlatform>(the_host_connection(), device_registry, input_report);
 
-                return std::make_shared<mi::DefaultInputManager>(the_input_reading_multiplexer(), std::move(platform));
+                return std::make_shared<mi::DefaultInputManager>(
+                    the_input_reading_multiplexer(),
+                    std::move(platform),
+                    mir::parse_thread_scheduling(
+                        options->get<std::string>(options::input_thread_scheduling_opt),
+                        options->get<std::string>(options::input_thread_affinity_opt)));
             }
             else
             {
@@ -224,11 +239,16 @@ mir::DefaultServerConfiguration::the_input_manager()
                 // otherwise (usually) we probe for it
                 if (!platform)
                 {
-                    platform = probe_input_platforms(*options, emergency_cleanup, device_registry,
+                    platform = probe_input_platforms(options, emergency_cleanup, device_registry,
                                                      input_report, *the_shared_library_prober_report());
                 }
 
-                return std::make_shared<mi::DefaultInputManager>(the_input_reading_multiplexer(), std::move(platform));
+                return std::make_shared<mi::DefaultInputManager>(
+                    the_input_reading_multiplexer(),
+                    std::move(platform),
+                    mir::parse_thread_scheduling(
+                        options->get<std::string>(options::input_thread_scheduling_opt),
+                        options->get<std::string>(options::input_thread_affinity_opt)));
             }
         }
     );
@@ -250,6 +270,13 @@ std::shared_ptr<mi::Seat> mir::DefaultServerConfiguration::the_seat()
     return seat(
         [this]()
         {
+            // Predicting further ahead than this overshoots more than it helps
+            std::chrono::milliseconds const max_prediction{50};
+
+            std::shared_ptr<mi::MotionPredictor> motion_predictor;
+            if (the_options()->get<bool>(options::input_prediction_opt))
+                motion_predictor = std::make_shared<mi::MotionPredictor>(the_presentation_clock(), max_prediction);
+
             return std::make_shared<mi::BasicSeat>(
                     the_input_dispatcher(),
                     the_touch_visualizer(),
@@ -257,7 +284,22 @@ std::shared_ptr<mi::Seat> mir::DefaultServerConfiguration::the_seat()
                     the_display_configuration_observer_registrar(),
                     the_key_mapper(),
                     the_clock(),
-                    the_seat_observer());
+                    the_seat_observer(),
+                    motion_predictor,
+                    the_input_latency());
+        });
+}
+
+std::shared_ptr<mi::InputLatency> mir::DefaultServerConfiguration::the_input_latency()
+{
+    return input_latency(
+        [this]()
+        {
+            // Often enough to follow trends in the log, rarely enough not to flood it
+            std::chrono::milliseconds const report_period{5000};
+
+            return std::make_shared<mi::InputLatencyHistograms>(
+                the_clock(), the_input_report(), the_main_loop(), report_period);
         });
 }
 
@@ -283,12 +325,20 @@ std::shared_ptr<mi::DefaultInputDeviceHub> mir::DefaultServerConfiguration::the_
        {
            auto input_dispatcher = the_input_dispatcher();
            auto key_repeater = std::dynamic_pointer_cast<mi::KeyRepeatDispatcher>(input_dispatcher);
+           auto const options = the_options();
+           std::shared_ptr<mi::InputEventRecorder> recorder;
+           if (options->is_set(options::record_input_opt))
+               recorder = std::make_shared<mi::InputEventRecorder>(
+                   options->get<std::string>(options::record_input_opt), the_clock());
+
            auto hub = std::make_shared<mi::DefaultInputDeviceHub>(
                the_seat(),
                the_input_reading_multiplexer(),
                the_cookie_authority(),
                the_key_mapper(),
-               the_server_status_listener());
+               the_server_status_listener(),
+               recorder,
+               the_input_latency());
 
            // lp:1675357: KeyRepeatDispatcher must be informed about removed input devices, otherwise
            // pressed keys get repeated indefinitely
@@ -18,8 +18,10 @@
 
 #include "default_input_device_hub.h"
 #include "default_device.h"
+#include "input_event_recorder.h"
 
 #include "mir/input/input_device.h"
+#include "mir/input/input_latency.h"
 #include "mir/input/input_device_observer.h"
 #include "mir/input/mir_pointer_config.h"
 #include "mir/input/mir_touchpad_config.h"
@@ -175,13 +177,17 @@ mi::DefaultInputDeviceHub::DefaultInputDeviceHub(
     std::shared_ptr<dispatch::MultiplexingDispatchable> const& input_multiplexer,
     std::shared_ptr<mir::cookie::Authority> const& cookie_authority,
     std::shared_ptr<mi::KeyMapper> const& key_mapper,
-    std::shared_ptr<mir::ServerStatusListener> const& server_status_listener)
+    std::shared_ptr<mir::ServerStatusListener> const& server_status_listener,
+    std::shared_ptr<mi::InputEventRecorder> const& recorder,
+    std::shared_ptr<mi::InputLatency> const& latency)
     : seat{seat},
       input_dispatchable{input_multiplexer},
       device_queue(std::make_shared<dispatch::ActionQueue>()),
       cookie_authority(cookie_authority),
       key_mapper(key_mapper),
       server_status_listener(server_status_listener),
+      recorder(recorder),
+      latency(latency),
       device_id_generator{0}
 {
     input_dispatchable->add_watch(device_queue);
@@ -205,9 +211,11 @@ void mi::DefaultInputDeviceHub::add_device(std::shared_ptr<InputDevice> const& d
         auto handle = restore_or_create_device(*device, queue);
         // send input device info to observer loop..
         devices.push_back(std::make_unique<RegisteredDevice>(
-            device, handle->id(), queue, cookie_authority, handle));
+            device, handle->id(), queue, cookie_authority, handle, recorder, latency));
 
         auto const& dev = devices.back();
+        if (recorder)
+            recorder->device_added(handle->id(), device->get_device_info());
         add_device_handle(handle);
 
         seat->add_device(*handle);
@@ -240,6 +248,8 @@ void mi::DefaultInputDeviceHub::remove_device(std::shared_ptr<InputDevice> const
                     item->stop(input_dispatchable);
                 }
                 remove_device_handle(item->id());
+                if (recorder)
+                    recorder->device_removed(item->id());
 
                 return true;
             }
@@ -259,12 +269,16 @@ mi::DefaultInputDeviceHub::RegisteredDevice::RegisteredDevice(
     MirInputDeviceId device_id,
     std::shared_ptr<dispatch::ActionQueue> const& queue,
     std::shared_ptr<mir::cookie::Authority> const& cookie_authority,
-    std::shared_ptr<mi::DefaultDevice> const& handle)
+    std::shared_ptr<mi::DefaultDevice> const& handle,
+    std::shared_ptr<mi::InputEventRecorder> const& recorder,
+    std::shared_ptr<mi::InputLatency> const& latency)
     : handle(handle),
       device_id(device_id),
       cookie_authority(cookie_authority),
       device(dev),
-      queue(queue)
+      queue(queue),
+      recorder(recorder),
+      latency(latency)
 {
 }
 
@@ -289,6 +303,14 @@ void mi::DefaultInputDeviceHub::RegisteredDevice::handle_input(std::shared_ptr<M
     if (!seat)
         return;
 
+    if (recorder)
+        recorder->record(device_id, *event);
+
+    if (latency && type == mir_event_type_input)
+        latency->event_reached(
+            InputStage::device,
+            std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(event.get()))});
+
     seat->dispatch_event(event);
 }
 
@@ -59,6 +59,8 @@ class InputDeviceObserver;
 class DefaultDevice;
 class Seat;
 class KeyMapper;
+class InputEventRecorder;
+class InputLatency;
 class DefaultInputDeviceHub;
 
 struct ExternalInputDeviceHub : InputDeviceHub
@@ -87,7 +89,9 @@ public:
                           std::shared_ptr<dispatch::MultiplexingDispatchable> const& input_multiplexer,
                           std::shared_ptr<cookie::Authority> const& cookie_authority,
                           std::shared_ptr<KeyMapper> const& key_mapper,
-                          std::shared_ptr<ServerStatusListener> const& server_status_listener);
+                          std::shared_ptr<ServerStatusListener> const& server_status_listener,
+                          std::shared_ptr<InputEventRecorder> const& recorder = {},
+                          std::shared_ptr<InputLatency> const& latency = {});
 
     // InputDeviceRegistry - calls from mi::Platform
     void add_device(std::shared_ptr<InputDevice> const& device) override;
@@ -116,6 +120,8 @@ private:
     std::shared_ptr<cookie::Authority> const cookie_authority;
     std::shared_ptr<KeyMapper> const key_mapper;
     std::shared_ptr<ServerStatusListener> const server_status_listener;
+    std::shared_ptr<InputEventRecorder> const recorder;
+    std::shared_ptr<InputLatency> const latency;
 
     struct RegisteredDevice : public InputSink
     {
@@ -124,7 +130,9 @@ private:
                          MirInputDeviceId dev_id,
                          std::shared_ptr<dispatch::ActionQueue> const& multiplexer,
                          std::shared_ptr<cookie::Authority> const& cookie_authority,
-                         std::shared_ptr<DefaultDevice> const& handle);
+                         std::shared_ptr<DefaultDevice> const& handle,
+                         std::shared_ptr<InputEventRecorder> const& recorder,
+                         std::shared_ptr<InputLatency> const& latency);
         void handle_input(std::shared_ptr<MirEvent> const& event) override;
         geometry::Rectangle bounding_rectangle() const override;
         input::OutputInfo output_info(uint32_t output_id) const override;
@@ -143,6 +151,8 @@ private:
         std::shared_ptr<cookie::Authority> cookie_authority;
         std::shared_ptr<InputDevice> const device;
         std::shared_ptr<dispatch::ActionQueue> queue;
+        std::shared_ptr<InputEventRecorder> const recorder;
+        std::shared_ptr<InputLatency> const latency;
     };
 
     std::vector<std::shared_ptr<Device>> handles;
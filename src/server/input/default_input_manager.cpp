@@ -34,10 +34,12 @@ namespace mi = mir::input;
 
 mi::DefaultInputManager::DefaultInputManager(
     std::shared_ptr<dispatch::MultiplexingDispatchable> const& multiplexer,
-    std::shared_ptr<Platform> const& platform) :
+    std::shared_ptr<Platform> const& platform,
+    ThreadScheduling const& thread_scheduling) :
     platform{platform},
     multiplexer{multiplexer},
     queue{std::make_shared<mir::dispatch::ActionQueue>()},
+    thread_scheduling{thread_scheduling},
     state{State::stopped}
 {
 }
@@ -82,6 +84,8 @@ void mi::DefaultInputManager::start()
      */
     queue->enqueue([this,promise = std::move(started_promise)]()
                    {
+                        // This is the first thing run on the freshly created input thread
+                        mir::apply_thread_scheduling(thread_scheduling);
                         start_platforms();
                         promise->set_value();
                    });
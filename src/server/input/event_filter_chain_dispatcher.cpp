@@ -17,14 +17,17 @@
  */
 
 #include "event_filter_chain_dispatcher.h"
+#include "mir/input/input_latency.h"
 
 namespace mi = mir::input;
 
 mi::EventFilterChainDispatcher::EventFilterChainDispatcher(
     std::initializer_list<std::shared_ptr<mi::EventFilter> const> const& values,
-    std::shared_ptr<mi::InputDispatcher> const& next_dispatcher)
+    std::shared_ptr<mi::InputDispatcher> const& next_dispatcher,
+    std::shared_ptr<mi::InputLatency> const& latency)
     : filters(values.begin(), values.end()),
-      next_dispatcher(next_dispatcher)
+      next_dispatcher(next_dispatcher),
+      latency(latency)
 {
 }
 
@@ -64,6 +67,11 @@ void mi::EventFilterChainDispatcher::prepend(std::shared_ptr<EventFilter> const&
 
 bool mi::EventFilterChainDispatcher::dispatch(std::shared_ptr<MirEvent const> const& event)
 {
+    if (latency && mir_event_get_type(event.get()) == mir_event_type_input)
+        latency->event_reached(
+            InputStage::filter_chain,
+            std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(event.get()))});
+
     if (!handle(*event))
         return next_dispatcher->dispatch(event);
     return true;
@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_event_recorder.h"
+
+#include "mir/input/input_device_info.h"
+#include "mir/time/clock.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+
+namespace mi = mir::input;
+
+mi::InputEventRecorder::InputEventRecorder(std::string const& filename, std::shared_ptr<time::Clock> const& clock)
+    : clock{clock},
+      file{filename, std::ios::binary | std::ios::trunc},
+      writer{file}
+{
+    if (!file)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open input recording " + filename));
+}
+
+void mi::InputEventRecorder::device_added(uint32_t device, InputDeviceInfo const& info)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    writer.device_added(now(), device, {info.name, info.unique_id, info.capabilities.value()});
+    file.flush();
+}
+
+void mi::InputEventRecorder::device_removed(uint32_t device)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    writer.device_removed(now(), device);
+    file.flush();
+}
+
+void mi::InputEventRecorder::record(uint32_t device, MirEvent const& event)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    writer.event(now(), device, event);
+}
+
+std::chrono::nanoseconds mi::InputEventRecorder::now() const
+{
+    return clock->now().time_since_epoch();
+}
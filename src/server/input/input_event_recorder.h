@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_INPUT_EVENT_RECORDER_H_
+#define MIR_INPUT_INPUT_EVENT_RECORDER_H_
+
+#include "mir/input/input_recording.h"
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mir
+{
+namespace time
+{
+class Clock;
+}
+namespace input
+{
+struct InputDeviceInfo;
+
+/**
+ * Captures what input platforms hand to the device hub - device arrival,
+ * removal and every event a device emits - into an input recording, so the
+ * exact same input can later be fed back through the replay input platform.
+ */
+class InputEventRecorder
+{
+public:
+    /// \throws std::runtime_error if the file cannot be created
+    InputEventRecorder(std::string const& filename, std::shared_ptr<time::Clock> const& clock);
+
+    void device_added(uint32_t device, InputDeviceInfo const& info);
+    void device_removed(uint32_t device);
+    void record(uint32_t device, MirEvent const& event);
+
+private:
+    std::chrono::nanoseconds now() const;
+
+    std::shared_ptr<time::Clock> const clock;
+    std::mutex mutex;
+    std::ofstream file;
+    InputRecordingWriter writer;
+};
+
+}
+}
+
+#endif // MIR_INPUT_INPUT_EVENT_RECORDER_H_
@@ -0,0 +1,88 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_latency_histograms.h"
+
+#include "mir/input/input_report.h"
+#include "mir/time/alarm.h"
+#include "mir/time/alarm_factory.h"
+#include "mir/time/clock.h"
+
+namespace mi = mir::input;
+
+namespace
+{
+char const* name_of(mi::InputStage stage)
+{
+    switch (stage)
+    {
+    case mi::InputStage::device: return "device";
+    case mi::InputStage::seat: return "seat";
+    case mi::InputStage::filter_chain: return "filter_chain";
+    case mi::InputStage::surface_dispatch: return "surface_dispatch";
+    case mi::InputStage::socket_write: return "socket_write";
+    }
+    return "unknown";
+}
+}
+
+mi::InputLatencyHistograms::InputLatencyHistograms(
+    std::shared_ptr<time::Clock> const& clock,
+    std::shared_ptr<InputReport> const& report,
+    std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+    std::chrono::milliseconds report_period)
+    : clock{clock},
+      report{report},
+      report_period{report_period},
+      report_alarm{alarm_factory->create_alarm([this] { report_if_active(); })}
+{
+    report_alarm->reschedule_in(report_period);
+}
+
+void mi::InputLatencyHistograms::event_reached(InputStage stage, std::chrono::nanoseconds event_time)
+{
+    histograms[static_cast<size_t>(stage)].record(clock->now().time_since_epoch() - event_time);
+}
+
+mi::InputLatency::Percentiles mi::InputLatencyHistograms::percentiles(InputStage stage) const
+{
+    auto const& histogram = histograms[static_cast<size_t>(stage)];
+    return {
+        histogram.count(),
+        histogram.value_at_percentile(50.0),
+        histogram.value_at_percentile(99.0),
+        histogram.value_at_percentile(99.9)};
+}
+
+void mi::InputLatencyHistograms::report_if_active()
+{
+    // Only the alarm touches reported_device_events, and it never overlaps itself
+    auto const device_events = histograms[static_cast<size_t>(InputStage::device)].count();
+
+    if (device_events != reported_device_events)
+    {
+        reported_device_events = device_events;
+
+        for (size_t i = 0; i != stage_count; ++i)
+        {
+            auto const stage = static_cast<InputStage>(i);
+            auto const result = percentiles(stage);
+            report->input_stage_latency(name_of(stage), result.count, result.p50.count(), result.p99.count(), result.p999.count());
+        }
+    }
+
+    report_alarm->reschedule_in(report_period);
+}
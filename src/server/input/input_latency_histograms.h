@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_INPUT_LATENCY_HISTOGRAMS_H_
+#define MIR_INPUT_INPUT_LATENCY_HISTOGRAMS_H_
+
+#include "mir/input/input_latency.h"
+#include "mir/time/latency_histogram.h"
+
+#include <array>
+#include <memory>
+
+namespace mir
+{
+namespace time
+{
+class Alarm;
+class AlarmFactory;
+class Clock;
+}
+namespace input
+{
+class InputReport;
+
+/**
+ * Keeps a lock-free latency histogram per input stage and, every
+ * report_period in which events arrived from devices, hands their
+ * percentiles to the input report. Reporting runs on an alarm, so the input
+ * thread only ever records.
+ */
+class InputLatencyHistograms : public InputLatency
+{
+public:
+    InputLatencyHistograms(
+        std::shared_ptr<time::Clock> const& clock,
+        std::shared_ptr<InputReport> const& report,
+        std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+        std::chrono::milliseconds report_period);
+
+    void event_reached(InputStage stage, std::chrono::nanoseconds event_time) override;
+    Percentiles percentiles(InputStage stage) const override;
+
+private:
+    static size_t constexpr stage_count = static_cast<size_t>(InputStage::socket_write) + 1;
+
+    void report_if_active();
+
+    std::shared_ptr<time::Clock> const clock;
+    std::shared_ptr<InputReport> const report;
+    std::chrono::milliseconds const report_period;
+    std::array<time::LatencyHistogram, stage_count> histograms;
+    uint64_t reported_device_events{0};
+    std::unique_ptr<time::Alarm> const report_alarm;
+};
+}
+}
+
+#endif // MIR_INPUT_INPUT_LATENCY_HISTOGRAMS_H_
@@ -27,6 +27,7 @@
 #include "mir/log.h"
 #include "mir/libname.h"
 
+#include <chrono>
 #include <stdexcept>
 
 namespace mi = mir::input;
@@ -53,51 +54,59 @@ mir::UniqueModulePtr<mi::Platform> create_input_platform(
 }
 
 mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
-    mo::Option const& options, std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
+    std::shared_ptr<mo::Option const> const& options, std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
     std::shared_ptr<mi::InputDeviceRegistry> const& device_registry, std::shared_ptr<mi::InputReport> const& input_report,
     mir::SharedLibraryProberReport& prober_report)
 {
     auto reject_platform_priority = mi::PlatformPriority::dummy;
 
     std::shared_ptr<mir::SharedLibrary> platform_module;
-    std::vector<std::string> module_names;
 
-    auto const module_selector = [&](std::shared_ptr<mir::SharedLibrary> const& module)
+    auto const probe = [options](mir::SharedLibrary const& module)
         {
-            try
-            {
-                auto const probe = module->load_function<mi::ProbePlatform>(
-                    "probe_input_platform", MIR_SERVER_INPUT_PLATFORM_VERSION);
-
-                if (probe(options) > reject_platform_priority)
-                {
-                    platform_module = module;
-
-                    return Selection::quit;
-                }
-            }
-            catch (std::runtime_error const&)
-            {
-                // Assume we were handed a SharedLibrary that's not an input module of the correct vintage.
-            }
-
-            return Selection::persist;
+            return static_cast<int>(module.load_function<mi::ProbePlatform>(
+                "probe_input_platform", MIR_SERVER_INPUT_PLATFORM_VERSION)(*options));
         };
 
-    if (options.is_set(mo::platform_input_lib))
+    if (options->is_set(mo::platform_input_lib))
     {
         reject_platform_priority = PlatformPriority::unsupported;
-        module_selector(std::make_shared<mir::SharedLibrary>(options.get<std::string>(mo::platform_input_lib)));
+        try
+        {
+            auto const module = std::make_shared<mir::SharedLibrary>(options->get<std::string>(mo::platform_input_lib));
+            if (probe(*module) > static_cast<int>(reject_platform_priority))
+                platform_module = module;
+        }
+        catch (std::runtime_error const&)
+        {
+            // Assume we were handed a SharedLibrary that's not an input module of the correct vintage.
+        }
     }
     else
     {
-        select_libraries_for_path(options.get<std::string>(mo::platform_path), module_selector, prober_report);
+        // Probing touches udev and the X server, so probe all the modules at once and
+        // then take the first acceptable one in the order select_libraries_for_path() uses.
+        // A probe that times out keeps running, and keeps options alive, after we return.
+        auto const probed = probe_libraries_in_parallel(
+            library_paths_for(options->get<std::string>(mo::platform_path), prober_report),
+            probe,
+            std::chrono::seconds{2},
+            prober_report);
+
+        for (auto const& module : probed)
+        {
+            if (module.priority > static_cast<int>(reject_platform_priority))
+            {
+                platform_module = module.library;
+                break;
+            }
+        }
     }
 
     if (!platform_module)
         BOOST_THROW_EXCEPTION(std::runtime_error{"No appropriate input platform module found"});
 
-    return create_input_platform(*platform_module, options, emergency_cleanup, device_registry, input_report);
+    return create_input_platform(*platform_module, *options, emergency_cleanup, device_registry, input_report);
 }
 
 auto mi::input_platform_from_graphics_module(
@@ -0,0 +1,195 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "motion_coalescer.h"
+#include "../compositor/presentation_clock.h"
+
+#include "mir/input/surface.h"
+#include "mir/events/event_builders.h"
+#include "mir/lockable_callback.h"
+#include "mir/time/alarm.h"
+#include "mir/time/alarm_factory.h"
+
+#include <algorithm>
+#include <time.h>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+
+namespace
+{
+// Runs the frame callback under the coalescer's own lock, so the alarm can
+// safely be rescheduled while that lock is held
+class FrameCallback : public mir::LockableCallback
+{
+public:
+    FrameCallback(std::mutex& mutex, std::function<void()> const& frame_ended)
+        : mutex{mutex},
+          frame_ended{frame_ended}
+    {
+    }
+
+    void operator()() override { frame_ended(); }
+    void lock() override { mutex.lock(); }
+    void unlock() override { mutex.unlock(); }
+
+private:
+    std::mutex& mutex;
+    std::function<void()> const frame_ended;
+};
+
+std::chrono::nanoseconds monotonic_now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return std::chrono::seconds{now.tv_sec} + std::chrono::nanoseconds{now.tv_nsec};
+}
+
+bool is_motion(MirEvent const& event)
+{
+    if (mir_event_get_type(&event) != mir_event_type_input)
+        return false;
+
+    auto const iev = mir_event_get_input_event(&event);
+    return mir_input_event_get_type(iev) == mir_input_event_type_pointer &&
+        mir_pointer_event_action(mir_input_event_get_pointer_event(iev)) == mir_pointer_action_motion;
+}
+
+bool can_accumulate(MirEvent const& earlier, MirEvent const& later)
+{
+    auto const eiev = mir_event_get_input_event(&earlier);
+    auto const liev = mir_event_get_input_event(&later);
+    auto const epev = mir_input_event_get_pointer_event(eiev);
+    auto const lpev = mir_input_event_get_pointer_event(liev);
+
+    return mir_input_event_get_device_id(eiev) == mir_input_event_get_device_id(liev) &&
+        mir_pointer_event_buttons(epev) == mir_pointer_event_buttons(lpev) &&
+        mir_pointer_event_modifiers(epev) == mir_pointer_event_modifiers(lpev);
+}
+}
+
+mi::MotionCoalescer::MotionCoalescer(
+    std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+    std::shared_ptr<compositor::PresentationClock> const& presentation_clock,
+    std::chrono::milliseconds fallback_period)
+    : presentation_clock{presentation_clock},
+      fallback_period{fallback_period},
+      frame_alarm{alarm_factory->create_alarm(
+          std::make_unique<FrameCallback>(mutex, [this] { frame_ended(); }))}
+{
+}
+
+mi::MotionCoalescer::~MotionCoalescer() = default;
+
+void mi::MotionCoalescer::deliver(std::shared_ptr<Surface> const& surface, EventUPtr event)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const mode = surface->motion_coalescing();
+
+    if (mode == MotionCoalescing::none || !is_motion(*event))
+    {
+        flush_locked(lock, surface.get());
+        surface->consume(event.get());
+        return;
+    }
+
+    if (!frame_open)
+    {
+        frame_open = true;
+        schedule_frame_end();
+        surface->consume(event.get());
+        return;
+    }
+
+    auto p = std::find_if(begin(pending), end(pending),
+        [&](Pending const& candidate) { return candidate.surface == surface; });
+
+    if (p == end(pending))
+    {
+        pending.push_back(Pending{surface, {}});
+        p = end(pending) - 1;
+    }
+
+    auto& events = p->events;
+
+    if (mode == MotionCoalescing::per_frame && !events.empty() && can_accumulate(*events.back(), *event))
+        mev::accumulate_motion(*events.back(), *event);
+    else
+        events.push_back(std::move(event));
+}
+
+void mi::MotionCoalescer::flush(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    flush_locked(lock, surface);
+}
+
+void mi::MotionCoalescer::forget(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    pending.erase(
+        std::remove_if(begin(pending), end(pending),
+            [&](Pending const& candidate) { return candidate.surface.get() == surface; }),
+        end(pending));
+}
+
+void mi::MotionCoalescer::frame_ended()
+{
+    // Called with mutex held (see FrameCallback)
+    if (pending.empty())
+    {
+        frame_open = false;
+        return;
+    }
+
+    for (auto const& p : pending)
+    {
+        for (auto const& event : p.events)
+            p.surface->consume(event.get());
+    }
+
+    pending.clear();
+    schedule_frame_end();
+}
+
+void mi::MotionCoalescer::schedule_frame_end()
+{
+    std::chrono::nanoseconds until_frame_end{fallback_period};
+
+    // Asked afresh every frame, so the schedule can't drift from the vblanks
+    auto const now = monotonic_now();
+    if (auto const vblank = presentation_clock->next_presentation(now))
+        until_frame_end = vblank.value() - now;
+
+    // Alarms take whole milliseconds: round up, so the frame ends at the vblank rather than before it
+    auto const rounding = std::chrono::milliseconds{1} - std::chrono::nanoseconds{1};
+    frame_alarm->reschedule_in(std::chrono::duration_cast<std::chrono::milliseconds>(until_frame_end + rounding));
+}
+
+void mi::MotionCoalescer::flush_locked(std::lock_guard<std::mutex> const&, Surface const* surface)
+{
+    auto const p = std::find_if(begin(pending), end(pending),
+        [&](Pending const& candidate) { return candidate.surface.get() == surface; });
+
+    if (p != end(pending))
+    {
+        for (auto const& event : p->events)
+            p->surface->consume(event.get());
+        pending.erase(p);
+    }
+}
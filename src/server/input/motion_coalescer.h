@@ -0,0 +1,108 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_MOTION_COALESCER_H_
+#define MIR_INPUT_MOTION_COALESCER_H_
+
+#include "mir_toolkit/event.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+typedef std::unique_ptr<MirEvent, void(*)(MirEvent*)> EventUPtr;
+
+namespace compositor
+{
+class PresentationClock;
+}
+namespace time
+{
+class Alarm;
+class AlarmFactory;
+}
+namespace input
+{
+class Surface;
+
+/**
+ * Paces pointer motion to surfaces that ask for MotionCoalescing::per_frame
+ * or MotionCoalescing::per_frame_with_history.
+ *
+ * The first motion event after a quiet frame is delivered straight away and
+ * opens a frame; further motion to the same surface within that frame is
+ * held until the frame ends. For per_frame it is accumulated (latest
+ * position, summed relative and scroll axes) into one event; for
+ * per_frame_with_history every event is kept and delivered in order, each
+ * with its own Surface::consume(), so only per_frame saves socket writes.
+ * Anything else - buttons, keys, touches, enter/leave - flushes the surface's
+ * held motion and is delivered immediately, so state changes are never
+ * reordered or delayed.
+ *
+ * Surfaces with MotionCoalescing::none see every event at the device rate.
+ *
+ * A frame ends at the next vblank the compositor's PresentationClock
+ * predicts, so held motion follows the outputs' real refresh rate. Until an
+ * output has reported its timing, frames last \p fallback_period.
+ */
+class MotionCoalescer
+{
+public:
+    MotionCoalescer(
+        std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+        std::shared_ptr<compositor::PresentationClock> const& presentation_clock,
+        std::chrono::milliseconds fallback_period);
+    ~MotionCoalescer();
+
+    void deliver(std::shared_ptr<Surface> const& surface, EventUPtr event);
+
+    /// Delivers anything held for a surface, ahead of an event that bypasses deliver()
+    void flush(Surface const* surface);
+
+    /// Drops anything held for a surface that is going away
+    void forget(Surface const* surface);
+
+private:
+    MotionCoalescer(MotionCoalescer const&) = delete;
+    MotionCoalescer& operator=(MotionCoalescer const&) = delete;
+
+    struct Pending
+    {
+        std::shared_ptr<Surface> surface;
+        std::vector<EventUPtr> events;
+    };
+
+    void frame_ended();
+    void schedule_frame_end();
+    void flush_locked(std::lock_guard<std::mutex> const&, Surface const* surface);
+
+    std::shared_ptr<compositor::PresentationClock> const presentation_clock;
+    std::chrono::milliseconds const fallback_period;
+
+    std::mutex mutex;
+    std::vector<Pending> pending;
+    bool frame_open{false};
+
+    std::unique_ptr<time::Alarm> const frame_alarm;
+};
+
+}
+}
+
+#endif /* MIR_INPUT_MOTION_COALESCER_H_ */
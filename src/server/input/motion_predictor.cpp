@@ -0,0 +1,201 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "motion_predictor.h"
+#include "../compositor/presentation_clock.h"
+
+#include "mir/events/event_builders.h"
+
+#include <algorithm>
+#include <limits>
+#include <time.h>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+// Older samples no longer describe the current motion
+auto const history_window = 50ms;
+std::size_t const min_samples = 3;
+
+// Pointers have a single trajectory per device; touch ids are never negative
+MirTouchId const pointer_trajectory = -1;
+
+std::chrono::nanoseconds monotonic_now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return std::chrono::seconds{now.tv_sec} + std::chrono::nanoseconds{now.tv_nsec};
+}
+}
+
+void mi::MotionPredictor::Trajectory::add(Sample const& sample)
+{
+    if (count > 0 && sample.time < samples[(first + count - 1) % max_samples].time)
+        count = 0;
+
+    while (count > 0 && (count == max_samples || sample.time - samples[first].time > history_window))
+    {
+        first = (first + 1) % max_samples;
+        --count;
+    }
+
+    samples[(first + count) % max_samples] = sample;
+    ++count;
+}
+
+mi::MotionPredictor::Sample mi::MotionPredictor::Trajectory::extrapolate(std::chrono::nanoseconds horizon) const
+{
+    auto const& latest = samples[(first + count - 1) % max_samples];
+
+    if (count < min_samples)
+        return latest;
+
+    using seconds = std::chrono::duration<double>;
+
+    double mean_t{0}, mean_x{0}, mean_y{0};
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        auto const& sample = samples[(first + i) % max_samples];
+        mean_t += seconds{sample.time - latest.time}.count();
+        mean_x += sample.x;
+        mean_y += sample.y;
+    }
+    mean_t /= count;
+    mean_x /= count;
+    mean_y /= count;
+
+    double var_t{0}, cov_tx{0}, cov_ty{0};
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        auto const& sample = samples[(first + i) % max_samples];
+        auto const dt = seconds{sample.time - latest.time}.count() - mean_t;
+        var_t += dt * dt;
+        cov_tx += dt * (sample.x - mean_x);
+        cov_ty += dt * (sample.y - mean_y);
+    }
+
+    // All samples at the same instant say nothing about velocity
+    if (var_t <= 0)
+        return latest;
+
+    auto const ahead = seconds{horizon}.count();
+
+    return {latest.time + horizon,
+            static_cast<float>(latest.x + cov_tx / var_t * ahead),
+            static_cast<float>(latest.y + cov_ty / var_t * ahead)};
+}
+
+mi::MotionPredictor::MotionPredictor(
+    std::shared_ptr<compositor::PresentationClock> const& presentation_clock,
+    std::chrono::nanoseconds max_horizon) :
+    presentation_clock{presentation_clock},
+    max_horizon{max_horizon}
+{
+}
+
+void mi::MotionPredictor::predict(MirEvent& event)
+{
+    if (auto const presentation_time = presentation_clock->next_presentation(monotonic_now()))
+        predict(event, presentation_time.value());
+}
+
+void mi::MotionPredictor::predict(MirEvent& event, std::chrono::nanoseconds presentation_time)
+{
+    if (mir_event_get_type(&event) != mir_event_type_input)
+        return;
+
+    auto const input_event = mir_event_get_input_event(&event);
+    auto const device_id = mir_input_event_get_device_id(input_event);
+    std::chrono::nanoseconds const event_time{mir_input_event_get_event_time(input_event)};
+
+    switch (mir_input_event_get_type(input_event))
+    {
+    case mir_input_event_type_pointer:
+    {
+        auto const pev = mir_input_event_get_pointer_event(input_event);
+        Sample const sample{
+            event_time,
+            mir_pointer_event_axis_value(pev, mir_pointer_axis_x),
+            mir_pointer_event_axis_value(pev, mir_pointer_axis_y)};
+
+        auto const predicted = predict({device_id, pointer_trajectory}, sample, presentation_time);
+        mev::set_predicted_position(event, predicted.x, predicted.y);
+        break;
+    }
+
+    case mir_input_event_type_touch:
+    {
+        auto const tev = mir_input_event_get_touch_event(input_event);
+        for (std::size_t i = 0; i != mir_touch_event_point_count(tev); ++i)
+        {
+            TrajectoryId const id{device_id, mir_touch_event_id(tev, i)};
+            Sample const sample{
+                event_time,
+                mir_touch_event_axis_value(tev, i, mir_touch_axis_x),
+                mir_touch_event_axis_value(tev, i, mir_touch_axis_y)};
+
+            switch (mir_touch_event_action(tev, i))
+            {
+            case mir_touch_action_down:
+                trajectories.erase(id);
+                mev::set_predicted_position(event, i, sample.x, sample.y);
+                trajectories[id].add(sample);
+                break;
+
+            case mir_touch_action_up:
+                trajectories.erase(id);
+                mev::set_predicted_position(event, i, sample.x, sample.y);
+                break;
+
+            default:
+            {
+                auto const predicted = predict(id, sample, presentation_time);
+                mev::set_predicted_position(event, i, predicted.x, predicted.y);
+                break;
+            }
+            }
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void mi::MotionPredictor::forget_device(MirInputDeviceId id)
+{
+    trajectories.erase(
+        trajectories.lower_bound({id, std::numeric_limits<MirTouchId>::min()}),
+        trajectories.upper_bound({id, std::numeric_limits<MirTouchId>::max()}));
+}
+
+mi::MotionPredictor::Sample mi::MotionPredictor::predict(
+    TrajectoryId id,
+    Sample const& sample,
+    std::chrono::nanoseconds presentation_time)
+{
+    auto& trajectory = trajectories[id];
+    trajectory.add(sample);
+
+    auto const horizon = std::min(
+        std::max(presentation_time - sample.time, std::chrono::nanoseconds::zero()),
+        max_horizon);
+    return trajectory.extrapolate(horizon);
+}
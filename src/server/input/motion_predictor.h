@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_MOTION_PREDICTOR_H_
+#define MIR_INPUT_MOTION_PREDICTOR_H_
+
+#include "mir_toolkit/event.h"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace mir
+{
+namespace compositor
+{
+class PresentationClock;
+}
+namespace input
+{
+
+/**
+ * Extrapolates pointer and touch trajectories to when content drawn in
+ * response to an event is expected to reach the screen, and attaches the
+ * result to the event as its predicted position axes.
+ *
+ * The velocity of each trajectory is a least-squares fit over its recent
+ * samples, which rides out the jitter in individual device reports better
+ * than differencing the last two. Too few samples means no prediction.
+ *
+ * Not thread safe: the seat serialises calls to it.
+ */
+class MotionPredictor
+{
+public:
+    MotionPredictor(
+        std::shared_ptr<compositor::PresentationClock> const& presentation_clock,
+        std::chrono::nanoseconds max_horizon);
+
+    /// Predicts to the next presentation the compositor expects to make
+    void predict(MirEvent& event);
+
+    /// Predicts to an explicit presentation time, e.g. when replaying a recorded trace
+    void predict(MirEvent& event, std::chrono::nanoseconds presentation_time);
+
+    /// Drops the trajectories of a device that has gone away
+    void forget_device(MirInputDeviceId id);
+
+private:
+    struct Sample
+    {
+        std::chrono::nanoseconds time;
+        float x;
+        float y;
+    };
+
+    class Trajectory
+    {
+    public:
+        void add(Sample const& sample);
+        Sample extrapolate(std::chrono::nanoseconds horizon) const;
+
+    private:
+        static std::size_t constexpr max_samples = 8;
+        std::array<Sample, max_samples> samples;
+        std::size_t first{0};
+        std::size_t count{0};
+    };
+
+    using TrajectoryId = std::pair<MirInputDeviceId, MirTouchId>;
+
+    Sample predict(TrajectoryId id, Sample const& sample, std::chrono::nanoseconds presentation_time);
+
+    std::shared_ptr<compositor::PresentationClock> const presentation_clock;
+    std::chrono::nanoseconds const max_horizon;
+    std::map<TrajectoryId, Trajectory> trajectories;
+};
+
+}
+}
+
+#endif // MIR_INPUT_MOTION_PREDICTOR_H_
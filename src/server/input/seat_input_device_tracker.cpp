@@ -28,6 +28,7 @@
 #include "mir/time/clock.h"
 
 #include "input_modifier_utils.h"
+#include "motion_predictor.h"
 
 #include <boost/throw_exception.hpp>
 #include <linux/input.h>
@@ -46,17 +47,20 @@ mi::SeatInputDeviceTracker::SeatInputDeviceTracker(std::shared_ptr<InputDispatch
                                                    std::shared_ptr<CursorListener> const& cursor_listener,
                                                    std::shared_ptr<KeyMapper> const& key_mapper,
                                                    std::shared_ptr<time::Clock> const& clock,
-                                                   std::shared_ptr<SeatObserver> const& observer)
+                                                   std::shared_ptr<SeatObserver> const& observer,
+                                                   std::shared_ptr<MotionPredictor> const& motion_predictor)
     : dispatcher{dispatcher}, touch_visualizer{touch_visualizer}, cursor_listener{cursor_listener},
-      key_mapper{key_mapper}, clock{clock}, observer{observer}, buttons{0}
+      key_mapper{key_mapper}, clock{clock}, observer{observer}, motion_predictor{motion_predictor}
 {
 }
 
 void mi::SeatInputDeviceTracker::add_device(MirInputDeviceId id)
 {
     {
-        std::lock_guard<std::mutex> lock(device_state_mutex);
-        device_data[id];
+        std::lock_guard<std::mutex> lock(device_map_mutex);
+        auto& device = device_data[id];
+        if (!device)
+            device = std::make_shared<DeviceData>();
     }
     observer->seat_add_device(id);
 }
@@ -64,46 +68,103 @@ void mi::SeatInputDeviceTracker::add_device(MirInputDeviceId id)
 void mi::SeatInputDeviceTracker::remove_device(MirInputDeviceId id)
 {
     {
-        std::lock_guard<std::mutex> lock(device_state_mutex);
+        std::lock_guard<std::mutex> lock(device_map_mutex);
         auto stored_data = device_data.find(id);
 
         if (stored_data == end(device_data))
             BOOST_THROW_EXCEPTION(std::logic_error("Modifier for unknown device changed"));
 
-        bool state_update_needed = stored_data->second.buttons != 0;
-        bool spot_update_needed = !stored_data->second.spots.empty();
-
         device_data.erase(stored_data);
         key_mapper->clear_keymap_for_device(id);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pointer_mutex);
+        if (device_buttons.erase(id))
+            update_buttons();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(spots_mutex);
+        auto const stored_spots = device_spots.find(id);
+        if (stored_spots != end(device_spots))
+        {
+            bool const spot_update_needed = !stored_spots->second.empty();
+            device_spots.erase(stored_spots);
+            if (spot_update_needed)
+                update_spots();
+        }
+    }
 
-        if (state_update_needed)
-            update_states();
-        if (spot_update_needed)
-            update_spots();
+    if (motion_predictor)
+    {
+        std::lock_guard<std::mutex> lock(prediction_mutex);
+        motion_predictor->forget_device(id);
     }
 
     observer->seat_remove_device(id);
 }
 
+std::shared_ptr<mi::SeatInputDeviceTracker::DeviceData> mi::SeatInputDeviceTracker::find_device(MirInputDeviceId id) const
+{
+    std::lock_guard<std::mutex> lock(device_map_mutex);
+    auto const stored_data = device_data.find(id);
+    if (stored_data == end(device_data))
+        return {};
+    return stored_data->second;
+}
+
 void mi::SeatInputDeviceTracker::dispatch(std::shared_ptr<MirEvent> const& event)
 {
     if (mir_event_get_type(event.get()) == mir_event_type_input)
     {
-        std::lock_guard<std::mutex> lock(device_state_mutex);
-
         auto input_event = mir_event_get_input_event(event.get());
+        auto const id = mir_input_event_get_device_id(input_event);
+        auto const device = find_device(id);
 
-        if (filter_input_event(input_event))
-            return;
+        switch (mir_input_event_get_type(input_event))
+        {
+        case mir_input_event_type_key:
+            {
+                if (!device)
+                    return;
+
+                auto const key = mir_input_event_get_keyboard_event(input_event);
+                std::lock_guard<std::mutex> lock(device->mutex);
+
+                if (!device->allowed_scan_code_action(key))
+                    return;
+
+                device->update_scan_codes(key);
+                key_mapper->map_event(*event);
+                break;
+            }
+        case mir_input_event_type_touch:
+            if (!device)
+                BOOST_THROW_EXCEPTION(std::logic_error("Event of unknown device received"));
+
+            update_touch_spots(id, mir_input_event_get_touch_event(input_event));
+            key_mapper->map_event(*event);
+            break;
+        case mir_input_event_type_pointer:
+            if (!device)
+                BOOST_THROW_EXCEPTION(std::logic_error("Event of unknown device received"));
 
-        update_seat_properties(input_event);
+            update_pointer(id, *event);
+            key_mapper->map_event(*event);
+            break;
+        default:
+            if (!device)
+                BOOST_THROW_EXCEPTION(std::logic_error("Event of unknown device received"));
 
-        key_mapper->map_event(*event);
+            key_mapper->map_event(*event);
+            break;
+        }
 
-        if (mir_input_event_type_pointer == mir_input_event_get_type(input_event))
+        if (motion_predictor)
         {
-            mev::set_cursor_position(*event, cursor_x, cursor_y);
-            mev::set_button_state(*event, buttons);
+            std::lock_guard<std::mutex> lock(prediction_mutex);
+            motion_predictor->predict(*event);
         }
     }
 
@@ -111,103 +172,77 @@ void mi::SeatInputDeviceTracker::dispatch(std::shared_ptr<MirEvent> const& event
     observer->seat_dispatch_event(event);
 }
 
-bool mi::SeatInputDeviceTracker::filter_input_event(MirInputEvent const* event)
+void mi::SeatInputDeviceTracker::update_pointer(MirInputDeviceId id, MirEvent& event)
 {
-    auto device_id = mir_input_event_get_device_id(event);
-    auto type = mir_input_event_get_type(event);
-    if (type == mir_input_event_type_key)
-    {
-        auto stored_data = device_data.find(device_id);
+    auto const* pointer = mir_input_event_get_pointer_event(mir_event_get_input_event(&event));
 
-        if (stored_data == end(device_data))
-            return true;
+    std::lock_guard<std::mutex> lock(pointer_mutex);
 
-        return !stored_data->second.allowed_scan_code_action(mir_input_event_get_keyboard_event(event));;
-    }
-    return false;
-}
+    auto position = cursor.load();
+    position.x += mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_x);
+    position.y += mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_y);
 
-void mi::SeatInputDeviceTracker::update_seat_properties(MirInputEvent const* event)
-{
-    auto id = mir_input_event_get_device_id(event);
+    confine_pointer(position);
+    cursor.store(position);
 
-    auto stored_data = device_data.find(id);
+    cursor_listener->cursor_moved_to(position.x, position.y);
 
-    if (stored_data == end(device_data))
-        BOOST_THROW_EXCEPTION(std::logic_error("Event of unknown device received"));
-
-    switch(mir_input_event_get_type(event))
+    auto& device_state = device_buttons[id];
+    auto const pressed = mir_pointer_event_buttons(pointer);
+    if (device_state != pressed)
     {
-    case mir_input_event_type_key:
-        stored_data->second.update_scan_codes(mir_input_event_get_keyboard_event(event));
-        break;
-    case mir_input_event_type_touch:
-        if (stored_data->second.update_spots(mir_input_event_get_touch_event(event)))
-            update_spots();
-        break;
-    case mir_input_event_type_pointer:
-        {
-            auto const* pointer = mir_input_event_get_pointer_event(event);
-            update_cursor(pointer);
-            if(stored_data->second.update_button_state(mir_pointer_event_buttons(pointer)))
-                update_states();
-            break;
-        }
-    default:
-        break;
+        device_state = pressed;
+        update_buttons();
     }
-}
-
-bool mi::SeatInputDeviceTracker::DeviceData::update_button_state(MirPointerButtons button_state)
-{
-    if (buttons == button_state)
-        return false;
-    buttons = button_state;
 
-    return true;
+    mev::set_cursor_position(event, position.x, position.y);
+    mev::set_button_state(event, buttons.load());
 }
 
-bool mi::SeatInputDeviceTracker::DeviceData::update_spots(MirTouchEvent const* event)
+void mi::SeatInputDeviceTracker::update_touch_spots(MirInputDeviceId id, MirTouchEvent const* event)
 {
+    std::lock_guard<std::mutex> lock(spots_mutex);
+
+    auto& device_state = device_spots[id];
     auto count = mir_touch_event_point_count(event);
-    spots.clear();
+    device_state.clear();
     for (decltype(count) i = 0; i != count; ++i)
     {
         if (mir_touch_event_action(event, i) == mir_touch_action_up)
             continue;
-        spots.push_back({{mir_touch_event_axis_value(event, i, mir_touch_axis_x),
-                          mir_touch_event_axis_value(event, i, mir_touch_axis_y)},
-                         mir_touch_event_axis_value(event, i, mir_touch_axis_pressure)});
+        device_state.push_back({{mir_touch_event_axis_value(event, i, mir_touch_axis_x),
+                                 mir_touch_event_axis_value(event, i, mir_touch_axis_y)},
+                                mir_touch_event_axis_value(event, i, mir_touch_axis_pressure)});
     }
-    return true;
+
+    update_spots();
 }
 
 void mi::SeatInputDeviceTracker::update_spots()
 {
     spots.clear();
-    for (auto const& dev : device_data)
-        spots.insert(end(spots), begin(dev.second.spots), end(dev.second.spots));
+    for (auto const& dev : device_spots)
+        spots.insert(end(spots), begin(dev.second), end(dev.second));
 
     touch_visualizer->visualize_touches(spots);
 }
 
-void mi::SeatInputDeviceTracker::update_states()
+void mi::SeatInputDeviceTracker::update_buttons()
 {
-    buttons = std::accumulate(begin(device_data),
-                              end(device_data),
+    buttons = std::accumulate(begin(device_buttons),
+                              end(device_buttons),
                               MirPointerButtons{0},
-                              [](auto const& acc, auto const& item) { return acc | item.second.buttons; });
+                              [](auto const& acc, auto const& item) { return acc | item.second; });
 }
 
 mir::geometry::Point mi::SeatInputDeviceTracker::cursor_position() const
 {
-    std::lock_guard<std::mutex> lock(device_state_mutex);
-    return {cursor_x, cursor_y};
+    auto const position = cursor.load();
+    return {position.x, position.y};
 }
 
 MirPointerButtons mi::SeatInputDeviceTracker::button_state() const
 {
-    std::lock_guard<std::mutex> lock(device_state_mutex);
     return buttons;
 }
 
@@ -242,33 +277,32 @@ void mi::SeatInputDeviceTracker::confine_function(mir::geometry::Point& p) const
     confined_region.confine(p);
 }
 
-void mi::SeatInputDeviceTracker::confine_pointer()
+void mi::SeatInputDeviceTracker::confine_pointer(CursorPosition& position) const
 {
-    mir::geometry::Point const old{cursor_x, cursor_y};
+    mir::geometry::Point const old{position.x, position.y};
     auto confined = old;
     confine_function(confined);
-    if (confined.x != old.x) cursor_x = confined.x.as_int();
-    if (confined.y != old.y) cursor_y = confined.y.as_int();
-}
-
-void mi::SeatInputDeviceTracker::update_cursor(MirPointerEvent const* event)
-{
-    cursor_x += mir_pointer_event_axis_value(event, mir_pointer_axis_relative_x);
-    cursor_y += mir_pointer_event_axis_value(event, mir_pointer_axis_relative_y);
-
-    confine_pointer();
-
-    cursor_listener->cursor_moved_to(cursor_x, cursor_y);
+    if (confined.x != old.x) position.x = confined.x.as_int();
+    if (confined.y != old.y) position.y = confined.y.as_int();
 }
 
 mir::EventUPtr mi::SeatInputDeviceTracker::create_device_state() const
 {
-    std::lock_guard<std::mutex> lock(device_state_mutex);
+    decltype(device_buttons) pointer_state;
+    {
+        std::lock_guard<std::mutex> lock(pointer_mutex);
+        pointer_state = device_buttons;
+    }
+
+    std::lock_guard<std::mutex> lock(device_map_mutex);
     std::vector<mev::InputDeviceState> devices;
     devices.reserve(device_data.size());
     for (auto const& item : device_data)
     {
-        devices.push_back({item.first, item.second.scan_codes, item.second.buttons});
+        {
+            std::lock_guard<std::mutex> device_lock(item.second->mutex);
+            devices.push_back({item.first, item.second->scan_codes, pointer_state[item.first]});
+        }
         auto lock_state = key_mapper->device_modifiers(item.first);
 
         bool caps_lock_active = (lock_state & mir_input_event_modifier_caps_lock);
@@ -279,7 +313,7 @@ mir::EventUPtr mi::SeatInputDeviceTracker::create_device_state() const
         bool contains_scroll_lock_pressed = false;
         bool contains_num_lock_pressed = false;
 
-        for (uint32_t scan_code : item.second.scan_codes)
+        for (uint32_t scan_code : devices.back().pressed_keys)
         {
             if (scan_code == KEY_CAPSLOCK)
                 contains_caps_lock_pressed = true;
@@ -305,12 +339,13 @@ mir::EventUPtr mi::SeatInputDeviceTracker::create_device_state() const
             devices.back().pressed_keys.push_back(KEY_SCROLLLOCK);
         }
     }
+    auto const position = cursor.load();
     auto out_ev = mev::make_event(
         clock->now().time_since_epoch(),
-        buttons,
+        buttons.load(),
         key_mapper->modifiers(),
-        cursor_x,
-        cursor_y,
+        position.x,
+        position.y,
         std::move(devices));
 
     return out_ev;
@@ -328,14 +363,15 @@ void mi::SeatInputDeviceTracker::DeviceData::update_scan_codes(MirKeyboardEvent
 
 void mi::SeatInputDeviceTracker::set_key_state(MirInputDeviceId id, std::vector<uint32_t> const& scan_codes)
 {
+    if (auto const device = find_device(id))
+    {
+        std::lock_guard<std::mutex> lock(device->mutex);
+        key_mapper->set_key_state(id, scan_codes);
+        device->scan_codes = scan_codes;
+    }
+    else
     {
-        std::lock_guard<std::mutex> lock(device_state_mutex);
         key_mapper->set_key_state(id, scan_codes);
-
-        auto device = device_data.find(id);
-
-        if (device != end(device_data))
-            device->second.scan_codes = scan_codes;
     }
 
     observer->seat_set_key_state(id, scan_codes);
@@ -343,12 +379,10 @@ void mi::SeatInputDeviceTracker::set_key_state(MirInputDeviceId id, std::vector<
 
 void mi::SeatInputDeviceTracker::set_pointer_state(MirInputDeviceId id, MirPointerButtons buttons)
 {
+    if (find_device(id))
     {
-        std::lock_guard<std::mutex> lock(device_state_mutex);
-        auto device = device_data.find(id);
-
-        if (device != end(device_data))
-            device->second.update_button_state(buttons);
+        std::lock_guard<std::mutex> lock(pointer_mutex);
+        device_buttons[id] = buttons;
     }
 
     observer->seat_set_pointer_state(id, buttons);
@@ -357,9 +391,8 @@ void mi::SeatInputDeviceTracker::set_pointer_state(MirInputDeviceId id, MirPoint
 void mi::SeatInputDeviceTracker::set_cursor_position(float x, float y)
 {
     {
-        std::lock_guard<std::mutex> lock(device_state_mutex);
-        cursor_x = x;
-        cursor_y = y;
+        std::lock_guard<std::mutex> lock(pointer_mutex);
+        cursor = CursorPosition{x, y};
     }
 
     observer->seat_set_cursor_position(x, y);
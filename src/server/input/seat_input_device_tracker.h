@@ -27,6 +27,7 @@
 #include "mir/optional_value.h"
 #include "mir_toolkit/event.h"
 
+#include <atomic>
 #include <unordered_map>
 #include <memory>
 #include <mutex>
@@ -44,6 +45,7 @@ class CursorListener;
 class InputDispatcher;
 class KeyMapper;
 class SeatObserver;
+class MotionPredictor;
 
 /*
  * The SeatInputDeviceTracker bundles the input device properties of a group of devices defined by a seat:
@@ -51,6 +53,11 @@ class SeatObserver;
  *  - modifier key states (i.e alt, ctrl ..)
  *  - a single mouse button state for all pointing devices
  *  - visible touch spots
+ *
+ * State that belongs to a single device is kept in a per-device shard with its own lock, so events
+ * of different devices only serialise on the state they really share: the cursor and button state
+ * of all pointing devices, and the touch spots of all touchscreens. The cursor position and button
+ * state can be read without locking.
  */
 class SeatInputDeviceTracker
 {
@@ -60,7 +67,8 @@ public:
                            std::shared_ptr<CursorListener> const& cursor_listener,
                            std::shared_ptr<KeyMapper> const& key_mapper,
                            std::shared_ptr<time::Clock> const& clock,
-                           std::shared_ptr<SeatObserver> const& observer);
+                           std::shared_ptr<SeatObserver> const& observer,
+                           std::shared_ptr<MotionPredictor> const& motion_predictor = {});
     void add_device(MirInputDeviceId);
     void remove_device(MirInputDeviceId);
 
@@ -78,13 +86,22 @@ public:
 
     void update_outputs(geometry::Rectangles const& outputs);
 private:
-    void update_seat_properties(MirInputEvent const* event);
-    void update_cursor(MirPointerEvent const* event);
+    struct DeviceData;
+    struct CursorPosition
+    {
+        // Libinput's acceleration curve means the cursor moves by non-integer
+        // increments, and often less than 1.0, so float is required...
+        float x;
+        float y;
+    };
+
+    std::shared_ptr<DeviceData> find_device(MirInputDeviceId id) const;
+    void update_pointer(MirInputDeviceId id, MirEvent& event);
+    void update_touch_spots(MirInputDeviceId id, MirTouchEvent const* event);
     void update_spots();
-    void update_states();
-    bool filter_input_event(MirInputEvent const* event);
+    void update_buttons();
     void confine_function(mir::geometry::Point& p) const;
-    void confine_pointer();
+    void confine_pointer(CursorPosition& position) const;
 
     std::shared_ptr<InputDispatcher> const dispatcher;
     std::shared_ptr<TouchVisualizer> const touch_visualizer;
@@ -92,34 +109,37 @@ private:
     std::shared_ptr<KeyMapper> const key_mapper;
     std::shared_ptr<time::Clock> const clock;
     std::shared_ptr<SeatObserver> const observer;
+    std::shared_ptr<MotionPredictor> const motion_predictor;
 
     struct DeviceData
     {
-        DeviceData() {}
-        bool update_button_state(MirPointerButtons button_state);
-        bool update_spots(MirTouchEvent const* event);
         void update_scan_codes(MirKeyboardEvent const* event);
         bool allowed_scan_code_action(MirKeyboardEvent const* event) const;
 
-        MirPointerButtons buttons{0};
-        std::vector<TouchVisualizer::Spot> spots;
+        std::mutex mutex;
         std::vector<uint32_t> scan_codes;
 
         MirTouchscreenMappingMode mapping_mode{mir_touchscreen_mapping_mode_to_output};
         mir::optional_value<uint32_t> output_id;
     };
 
-    // Libinput's acceleration curve means the cursor moves by non-integer
-    // increments, and often less than 1.0, so float is required...
-    float cursor_x = 0.0f, cursor_y = 0.0f;
+    std::mutex mutable device_map_mutex;
+    std::unordered_map<MirInputDeviceId, std::shared_ptr<DeviceData>> device_data;
 
-    MirPointerButtons buttons;
-    std::unordered_map<MirInputDeviceId, DeviceData> device_data;
+    /// Serialises updates of the seat wide pointer state, the atomics allow reading it without locking
+    std::mutex mutable pointer_mutex;
+    std::unordered_map<MirInputDeviceId, MirPointerButtons> device_buttons;
+    std::atomic<CursorPosition> cursor{CursorPosition{0.0f, 0.0f}};
+    std::atomic<MirPointerButtons> buttons{0};
+
+    std::mutex mutable spots_mutex;
+    std::unordered_map<MirInputDeviceId, std::vector<TouchVisualizer::Spot>> device_spots;
     std::vector<TouchVisualizer::Spot> spots;
-    mir::geometry::Rectangles confined_region;
 
-    std::mutex mutable device_state_mutex;
+    std::mutex mutable prediction_mutex;
+
     std::mutex mutable region_mutex;
+    mir::geometry::Rectangles confined_region;
 
     std::mutex mutable output_mutex;
     geometry::Rectangles input_region;
@@ -17,13 +17,15 @@
  */
 
 #include "surface_input_dispatcher.h"
+#include "motion_coalescer.h"
 
+#include "mir/input/input_latency.h"
 #include "mir/input/scene.h"
 #include "mir/input/surface.h"
 #include "mir/scene/observer.h"
 #include "mir/scene/surface.h"
 #include "mir/events/event_builders.h"
-#include "mir_toolkit/mir_cookie.h"
+#include "mir/trace/allocation_profile.h"
 
 #include <string.h>
 
@@ -70,43 +72,7 @@ struct InputDispatcherSceneObserver : public ms::Observer
     std::function<void(ms::Surface*)> const on_removed;
 };
 
-void deliver_without_relative_motion(
-    std::shared_ptr<mi::Surface> const& surface,
-    MirEvent const* ev,
-    std::vector<uint8_t> const& drag_and_drop_handle)
-{
-    auto const* input_ev = mir_event_get_input_event(ev);
-    auto const* pev = mir_input_event_get_pointer_event(input_ev);
-    std::vector<uint8_t> cookie_data;
-    if (mir_input_event_has_cookie(input_ev))
-    {
-        auto cookie = mir_input_event_get_cookie(input_ev);
-        cookie_data.resize(mir_cookie_buffer_size(cookie));
-        mir_cookie_to_buffer(cookie, cookie_data.data(), mir_cookie_buffer_size(cookie));
-        mir_cookie_release(cookie);
-    }
-    auto const& bounds = surface->input_bounds();
-
-    auto to_deliver = mev::make_event(mir_input_event_get_device_id(input_ev),
-                                      std::chrono::nanoseconds{mir_input_event_get_event_time(input_ev)},
-                                      cookie_data,
-                                      mir_pointer_event_modifiers(pev),
-                                      mir_pointer_event_action(pev),
-                                      mir_pointer_event_buttons(pev),
-                                      mir_pointer_event_axis_value(pev, mir_pointer_axis_x),
-                                      mir_pointer_event_axis_value(pev, mir_pointer_axis_y),
-                                      0.0f,
-                                      0.0f,
-                                      0.0f,
-                                      0.0f);
-
-    mev::transform_positions(*to_deliver, geom::Displacement{bounds.top_left.x.as_int(), bounds.top_left.y.as_int()});
-    if (!drag_and_drop_handle.empty())
-        mev::set_drag_and_drop_handle(*to_deliver, drag_and_drop_handle);
-    surface->consume(to_deliver.get());
-}
-
-void deliver(
+mir::EventUPtr translated_for(
     std::shared_ptr<mi::Surface> const& surface,
     MirEvent const* ev,
     std::vector<uint8_t> const& drag_and_drop_handle)
@@ -118,9 +84,8 @@ void deliver(
 
     auto const& bounds = surface->input_bounds();
     mev::transform_positions(*to_deliver, geom::Displacement{bounds.top_left.x.as_int(), bounds.top_left.y.as_int()});
-    surface->consume(to_deliver.get());
+    return to_deliver;
 }
-
 }
 
 mi::SurfaceInputDispatcher::SurfaceInputDispatcher(std::shared_ptr<mi::Scene> const& scene)
@@ -131,6 +96,18 @@ mi::SurfaceInputDispatcher::SurfaceInputDispatcher(std::shared_ptr<mi::Scene> co
     scene->add_observer(scene_observer);
 }
 
+mi::SurfaceInputDispatcher::SurfaceInputDispatcher(
+    std::shared_ptr<mi::Scene> const& scene,
+    std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+    std::shared_ptr<compositor::PresentationClock> const& presentation_clock,
+    std::chrono::milliseconds fallback_frame_period,
+    std::shared_ptr<mi::InputLatency> const& latency)
+    : SurfaceInputDispatcher(scene)
+{
+    coalescer = std::make_unique<MotionCoalescer>(alarm_factory, presentation_clock, fallback_frame_period);
+    this->latency = latency;
+}
+
 mi::SurfaceInputDispatcher::~SurfaceInputDispatcher()
 {
     scene->remove_observer(scene_observer);
@@ -148,6 +125,9 @@ void mi::SurfaceInputDispatcher::surface_removed(ms::Surface *surface)
 {
     std::lock_guard<std::mutex> lg(dispatcher_mutex);
 
+    if (coalescer)
+        coalescer->forget(surface);
+
     auto strong_focus = focus_surface.lock();
     if (strong_focus && compare_surfaces(strong_focus, surface))
     {
@@ -198,6 +178,9 @@ bool mi::SurfaceInputDispatcher::dispatch_key(MirEvent const* kev)
     if (!strong_focus)
         return false;
 
+    note_delivery(*kev);
+    if (coalescer)
+        coalescer->flush(strong_focus.get());
     strong_focus->consume(kev);
 
     return true;
@@ -228,12 +211,7 @@ bool is_gesture_terminator(MirPointerEvent const* pev)
 
 std::shared_ptr<mi::Surface> mi::SurfaceInputDispatcher::find_target_surface(geom::Point const& point)
 {
-    std::shared_ptr<mi::Surface> top_target = nullptr;
-    scene->for_each([&top_target, &point](std::shared_ptr<mi::Surface> const& target) {
-            if (target->input_area_contains(point))
-                top_target = target;
-    });
-    return top_target;
+    return scene->input_surface_at(point);
 }
 
 void mi::SurfaceInputDispatcher::send_enter_exit_event(std::shared_ptr<mi::Surface> const& surface,
@@ -257,18 +235,48 @@ void mi::SurfaceInputDispatcher::send_enter_exit_event(std::shared_ptr<mi::Surfa
 
     if (!drag_and_drop_handle.empty())
         mev::set_drag_and_drop_handle(*event, drag_and_drop_handle);
-    surface->consume(event.get());
+    consume(surface, std::move(event));
+}
+
+void mi::SurfaceInputDispatcher::deliver(std::shared_ptr<mi::Surface> const& surface, MirEvent const* ev)
+{
+    consume(surface, translated_for(surface, ev, drag_and_drop_handle));
+}
+
+void mi::SurfaceInputDispatcher::deliver_without_relative_motion(
+    std::shared_ptr<mi::Surface> const& surface,
+    MirEvent const* ev)
+{
+    auto to_deliver = translated_for(surface, ev, drag_and_drop_handle);
+    mev::clear_relative_motion(*to_deliver);
+    consume(surface, std::move(to_deliver));
+}
+
+void mi::SurfaceInputDispatcher::consume(std::shared_ptr<mi::Surface> const& surface, EventUPtr event)
+{
+    note_delivery(*event);
+    if (coalescer)
+        coalescer->deliver(surface, std::move(event));
+    else
+        surface->consume(event.get());
+}
+
+void mi::SurfaceInputDispatcher::note_delivery(MirEvent const& event)
+{
+    if (latency)
+        latency->event_reached(
+            InputStage::surface_dispatch,
+            std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(&event))});
 }
 
 mi::SurfaceInputDispatcher::PointerInputState& mi::SurfaceInputDispatcher::ensure_pointer_state(MirInputDeviceId id)
 {
-    pointer_state_by_id.insert(std::make_pair(id, PointerInputState()));
+    // operator[] only builds (and allocates) a node for a new device
     return pointer_state_by_id[id];
 }
 
 mi::SurfaceInputDispatcher::TouchInputState& mi::SurfaceInputDispatcher::ensure_touch_state(MirInputDeviceId id)
 {
-    touch_state_by_id.insert(std::make_pair(id, TouchInputState()));
     return touch_state_by_id[id];
 }
 
@@ -284,7 +292,7 @@ bool mi::SurfaceInputDispatcher::dispatch_pointer(MirInputDeviceId id, MirEvent
 
     if (pointer_state.gesture_owner)
     {
-        deliver(pointer_state.gesture_owner, ev, drag_and_drop_handle);
+        deliver(pointer_state.gesture_owner, ev);
 
         auto const gesture_terminated = is_gesture_terminator(pev);
 
@@ -345,11 +353,11 @@ bool mi::SurfaceInputDispatcher::dispatch_pointer(MirInputDeviceId id, MirEvent
         if (sent_ev)
         {
             if (action != mir_pointer_action_motion)
-                deliver_without_relative_motion(target, ev, drag_and_drop_handle);
+                deliver_without_relative_motion(target, ev);
         }
         else
         {
-            deliver(target, ev, drag_and_drop_handle);
+            deliver(target, ev);
         }
         return true;
     }
@@ -405,7 +413,7 @@ bool mi::SurfaceInputDispatcher::dispatch_touch(MirInputDeviceId id, MirEvent co
 
     if (gesture_owner)
     {
-        deliver(gesture_owner, ev, drag_and_drop_handle);
+        deliver(gesture_owner, ev);
 
         if (is_gesture_end(tev))
             gesture_owner.reset();
@@ -418,6 +426,8 @@ bool mi::SurfaceInputDispatcher::dispatch_touch(MirInputDeviceId id, MirEvent co
 
 bool mi::SurfaceInputDispatcher::dispatch(std::shared_ptr<MirEvent const> const& event)
 {
+    MIR_ALLOC_PROFILING_SCOPE("input.dispatch");
+
     if (mir_event_get_type(event.get()) != mir_event_type_input)
         BOOST_THROW_EXCEPTION(std::logic_error("InputDispatcher got an unexpected event type"));
     
@@ -23,6 +23,7 @@
 #include "mir/shell/input_targeter.h"
 #include "mir/geometry/point.h"
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -30,20 +31,39 @@
 
 namespace mir
 {
+typedef std::unique_ptr<MirEvent, void(*)(MirEvent*)> EventUPtr;
+
+namespace compositor
+{
+class PresentationClock;
+}
 namespace scene
 {
 class Observer;
 class Surface;
 }
+namespace time
+{
+class AlarmFactory;
+}
 namespace input
 {
 class Surface;
 class Scene;
+class MotionCoalescer;
+class InputLatency;
 
 class SurfaceInputDispatcher : public mir::input::InputDispatcher, public shell::InputTargeter
 {
 public:
     SurfaceInputDispatcher(std::shared_ptr<input::Scene> const& scene);
+    /// Also paces motion to surfaces that ask for per-frame MotionCoalescing
+    SurfaceInputDispatcher(
+        std::shared_ptr<input::Scene> const& scene,
+        std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+        std::shared_ptr<compositor::PresentationClock> const& presentation_clock,
+        std::chrono::milliseconds fallback_frame_period,
+        std::shared_ptr<InputLatency> const& latency = {});
     ~SurfaceInputDispatcher();
 
     // mir::input::InputDispatcher
@@ -67,6 +87,11 @@ private:
     void send_enter_exit_event(std::shared_ptr<input::Surface> const& surface,
         MirPointerEvent const* triggering_ev, MirPointerAction action);
 
+    void deliver(std::shared_ptr<input::Surface> const& surface, MirEvent const* ev);
+    void deliver_without_relative_motion(std::shared_ptr<input::Surface> const& surface, MirEvent const* ev);
+    void consume(std::shared_ptr<input::Surface> const& surface, EventUPtr event);
+    void note_delivery(MirEvent const& event);
+
     std::shared_ptr<input::Surface> find_target_surface(geometry::Point const& target);
 
     void set_focus_locked(std::lock_guard<std::mutex> const&, std::shared_ptr<input::Surface> const&);
@@ -97,6 +122,9 @@ private:
     std::weak_ptr<input::Surface> focus_surface;
     std::vector<uint8_t> drag_and_drop_handle;
     bool started;
+
+    std::unique_ptr<MotionCoalescer> coalescer;
+    std::shared_ptr<InputLatency> latency;
 };
 
 }
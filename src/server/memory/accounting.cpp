@@ -0,0 +1,241 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/memory/accounting.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace mm = mir::memory;
+
+char const* mm::name_of(Subsystem subsystem)
+{
+    switch (subsystem)
+    {
+    case Subsystem::shm_buffers: return "shm_buffers";
+    case Subsystem::hardware_buffers: return "hardware_buffers";
+    case Subsystem::wayland_shm_copies: return "wayland_shm_copies";
+    case Subsystem::textures: return "textures";
+    case Subsystem::ipc_resources: return "ipc_resources";
+    }
+    return "unknown";
+}
+
+mm::Charge::Charge(std::shared_ptr<Account> const& account, Subsystem subsystem, size_t bytes) :
+    account{account},
+    subsystem{subsystem},
+    bytes_{bytes}
+{
+}
+
+mm::Charge::Charge(Charge&& other) noexcept :
+    account{std::move(other.account)},
+    subsystem{other.subsystem},
+    bytes_{other.bytes_}
+{
+    other.bytes_ = 0;
+}
+
+auto mm::Charge::operator=(Charge&& other) noexcept -> Charge&
+{
+    if (this != &other)
+    {
+        release();
+        account = std::move(other.account);
+        subsystem = other.subsystem;
+        bytes_ = other.bytes_;
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+mm::Charge::~Charge() noexcept
+{
+    release();
+}
+
+void mm::Charge::release() noexcept
+{
+    if (account)
+    {
+        account->release(subsystem, bytes_);
+        account.reset();
+        bytes_ = 0;
+    }
+}
+
+void mm::Charge::adjust(size_t bytes)
+{
+    if (account)
+        account->adjust(subsystem, bytes_, bytes);
+    bytes_ = bytes;
+}
+
+mm::Account::Account(std::string const& name, pid_t pid, size_t quota_bytes) :
+    name_{name},
+    pid_{pid},
+    quota_bytes_{quota_bytes}
+{
+}
+
+auto mm::Account::charge(Subsystem subsystem, size_t bytes) -> Charge
+{
+    reserve(subsystem, bytes);
+    counters[static_cast<unsigned>(subsystem)].allocations.fetch_add(1, std::memory_order_relaxed);
+
+    return Charge{shared_from_this(), subsystem, bytes};
+}
+
+void mm::Account::reserve(Subsystem subsystem, size_t bytes)
+{
+    auto current = total.load(std::memory_order_relaxed);
+    do
+    {
+        if (quota_bytes_ && current + bytes > quota_bytes_)
+        {
+            std::ostringstream message;
+            message << "Memory quota exceeded for \"" << name_ << "\" (pid " << pid_ << "): "
+                    << bytes << " bytes of " << name_of(subsystem) << " requested, "
+                    << current << " of " << quota_bytes_ << " bytes in use";
+            BOOST_THROW_EXCEPTION(QuotaExceeded(message.str()));
+        }
+    }
+    while (!total.compare_exchange_weak(current, current + bytes, std::memory_order_relaxed));
+
+    counters[static_cast<unsigned>(subsystem)].bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void mm::Account::release(Subsystem subsystem, size_t bytes) noexcept
+{
+    auto& counter = counters[static_cast<unsigned>(subsystem)];
+    counter.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counter.allocations.fetch_sub(1, std::memory_order_relaxed);
+    total.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void mm::Account::adjust(Subsystem subsystem, size_t from_bytes, size_t to_bytes)
+{
+    if (to_bytes > from_bytes)
+    {
+        reserve(subsystem, to_bytes - from_bytes);
+    }
+    else
+    {
+        counters[static_cast<unsigned>(subsystem)].bytes.fetch_sub(from_bytes - to_bytes, std::memory_order_relaxed);
+        total.fetch_sub(from_bytes - to_bytes, std::memory_order_relaxed);
+    }
+}
+
+auto mm::Account::usage(Subsystem subsystem) const -> Usage
+{
+    auto const& counter = counters[static_cast<unsigned>(subsystem)];
+    return {counter.bytes.load(std::memory_order_relaxed), counter.allocations.load(std::memory_order_relaxed)};
+}
+
+size_t mm::Account::total_bytes() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+mm::Accounting::Accounting(size_t session_quota_bytes, QuotaAction quota_action) :
+    session_quota_bytes{session_quota_bytes},
+    quota_action_{quota_action},
+    server{std::make_shared<Account>("mirserver", getpid(), 0)}
+{
+}
+
+mm::Accounting::~Accounting() = default;
+
+auto mm::Accounting::open_account(std::string const& name, pid_t pid) -> std::shared_ptr<Account>
+{
+    auto const account = std::make_shared<Account>(name, pid, session_quota_bytes);
+
+    std::lock_guard<std::mutex> lock{mutex};
+    accounts.erase(
+        std::remove_if(accounts.begin(), accounts.end(), [](auto const& a) { return a.expired(); }),
+        accounts.end());
+    accounts.push_back(account);
+
+    return account;
+}
+
+auto mm::Accounting::snapshot() const -> std::vector<AccountUsage>
+{
+    std::vector<std::shared_ptr<Account>> live{server};
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        for (auto const& weak : accounts)
+        {
+            if (auto const account = weak.lock())
+                live.push_back(account);
+        }
+    }
+
+    std::vector<AccountUsage> result;
+    result.reserve(live.size());
+    for (auto const& account : live)
+    {
+        AccountUsage entry{account->name(), account->pid(), {}, account->total_bytes()};
+        for (unsigned i = 0; i != subsystem_count; ++i)
+            entry.usage[i] = account->usage(static_cast<Subsystem>(i));
+        result.push_back(std::move(entry));
+    }
+    return result;
+}
+
+void mm::Accounting::write_report(std::ostream& out) const
+{
+    auto const usage = snapshot();
+
+    out << std::left << std::setw(24) << "account" << std::right << std::setw(8) << "pid";
+    for (unsigned i = 0; i != subsystem_count; ++i)
+        out << std::setw(20) << name_of(static_cast<Subsystem>(i));
+    out << std::setw(14) << "total" << '\n';
+
+    std::array<size_t, subsystem_count> subsystem_totals{};
+    size_t grand_total = 0;
+    for (auto const& account : usage)
+    {
+        out << std::left << std::setw(24) << (account.name.empty() ? "<unnamed>" : account.name)
+            << std::right << std::setw(8) << account.pid;
+        for (unsigned i = 0; i != subsystem_count; ++i)
+        {
+            std::ostringstream cell;
+            cell << account.usage[i].bytes << "/" << account.usage[i].allocations;
+            out << std::setw(20) << cell.str();
+            subsystem_totals[i] += account.usage[i].bytes;
+        }
+        out << std::setw(14) << account.total_bytes << '\n';
+        grand_total += account.total_bytes;
+    }
+
+    out << std::left << std::setw(32) << "total" << std::right;
+    for (auto const bytes : subsystem_totals)
+        out << std::setw(20) << bytes;
+    out << std::setw(14) << grand_total << '\n';
+
+    if (session_quota_bytes)
+    {
+        out << "session quota: " << session_quota_bytes << " bytes ("
+            << (quota_action_ == QuotaAction::reject ? "reject" : "disconnect") << ")\n";
+    }
+}
@@ -20,11 +20,9 @@
 #include "mir/options/configuration.h"
 
 #include "reports.h"
-#include "lttng_report_factory.h"
-#include "logging_report_factory.h"
-#include "null_report_factory.h"
+#include "report_factory.h"
 
-#include "mir/abnormal_exit.h"
+#include "mir/metrics/registry.h"
 
 namespace mg = mir::graphics;
 namespace mf = mir::frontend;
@@ -34,26 +32,16 @@ namespace ms = mir::scene;
 
 std::unique_ptr<mir::report::ReportFactory> mir::DefaultServerConfiguration::report_factory(char const* report_opt)
 {
-    auto opt = the_options()->get<std::string>(report_opt);
-
-    if (opt == options::log_opt_value)
-    {
-        return std::make_unique<report::LoggingReportFactory>(the_logger(), the_clock());
-    }
-    else if (opt == options::lttng_opt_value)
-    {
-        return std::make_unique<report::LttngReportFactory>();
-    }
-    else if (opt == options::off_opt_value)
-    {
-        return std::make_unique<report::NullReportFactory>();
-    }
-    else
-    {
-        throw AbnormalExit(std::string("Invalid ") + report_opt + " option: " + opt + " (valid options are: \"" +
-            options::off_opt_value + "\" and \"" + options::log_opt_value +
-                           "\" and \"" + options::lttng_opt_value + "\")");
-    }
+    return report::report_factory_for(*this, report_opt, the_options()->get<std::string>(report_opt));
+}
+
+auto mir::DefaultServerConfiguration::the_metrics_registry() -> std::shared_ptr<metrics::Registry>
+{
+    return metrics_registry(
+        []
+        {
+            return std::make_shared<metrics::Registry>();
+        });
 }
 
 std::shared_ptr<mir::report::Reports> mir::DefaultServerConfiguration::initialise_reports()
@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define MIR_LOG_COMPONENT "frame-trace"
+
+#include "frame_timeline_dump.h"
+
+#include "mir/trace/frame_timeline.h"
+#include "mir/log.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace mr = mir::report;
+
+mr::FrameTimelineDump::FrameTimelineDump(
+    std::shared_ptr<trace::FrameTimeline> const& timeline,
+    std::string const& path) :
+    timeline{timeline},
+    path{path}
+{
+}
+
+void mr::FrameTimelineDump::dump() const
+{
+    // Write to the side and rename, so a reader never sees a partial timeline
+    auto const partial_path = path + ".partial";
+    {
+        std::ofstream out{partial_path, std::ios::trunc};
+        timeline->write_chrome_json(out);
+
+        if (!out)
+        {
+            mir::log_error("Failed to write frame timeline to %s", partial_path.c_str());
+            return;
+        }
+    }
+
+    if (rename(partial_path.c_str(), path.c_str()) != 0)
+    {
+        mir::log_error("Failed to write frame timeline to %s: %s", path.c_str(), strerror(errno));
+        return;
+    }
+
+    mir::log_info("Wrote frame timeline to %s", path.c_str());
+}
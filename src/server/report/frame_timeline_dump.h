@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_FRAME_TIMELINE_DUMP_H_
+#define MIR_REPORT_FRAME_TIMELINE_DUMP_H_
+
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace trace
+{
+class FrameTimeline;
+}
+namespace report
+{
+/**
+ * Writes the frame timeline to a file in Chrome trace event JSON format.
+ *
+ * The server calls dump() from its main loop whenever it receives SIGUSR2.
+ */
+class FrameTimelineDump
+{
+public:
+    FrameTimelineDump(std::shared_ptr<trace::FrameTimeline> const& timeline, std::string const& path);
+
+    void dump() const;
+
+private:
+    FrameTimelineDump(FrameTimelineDump const&) = delete;
+    FrameTimelineDump& operator=(FrameTimelineDump const&) = delete;
+
+    std::shared_ptr<trace::FrameTimeline> const timeline;
+    std::string const path;
+};
+}
+}
+
+#endif // MIR_REPORT_FRAME_TIMELINE_DUMP_H_
@@ -0,0 +1,66 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_pacing_report.h"
+
+#include "mir/logging/logger.h"
+
+#include <cstdio>
+
+namespace
+{
+char const* const component = "compositor::FramePacing";
+}
+
+namespace ml = mir::logging;
+namespace mrl = mir::report::logging;
+namespace mg = mir::graphics;
+namespace mc = mir::compositor;
+
+mrl::FramePacingReport::FramePacingReport(std::shared_ptr<ml::Logger> const& log) :
+    log(log)
+{
+}
+
+void mrl::FramePacingReport::missed_deadline(mg::DisplayConfigurationOutputId output, unsigned vblanks_missed)
+{
+    log->log(
+        ml::Severity::informational,
+        "output " + std::to_string(output.as_value()) + " missed " + std::to_string(vblanks_missed) + " vblank(s)",
+        component);
+}
+
+void mrl::FramePacingReport::repeated_frame(mg::DisplayConfigurationOutputId output)
+{
+    log->log(
+        ml::Severity::informational,
+        "output " + std::to_string(output.as_value()) + " was posted a frame before showing the last",
+        component);
+}
+
+void mrl::FramePacingReport::client_frame_dropped(mc::BufferStream const* stream)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof buffer, "stream %p dropped a frame", static_cast<void const*>(stream));
+    log->log(ml::Severity::debug, buffer, component);
+}
+
+void mrl::FramePacingReport::client_frame_rate(mc::BufferStream const* stream, float frames_per_second)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof buffer, "stream %p at %.1f FPS", static_cast<void const*>(stream), frames_per_second);
+    log->log(ml::Severity::debug, buffer, component);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_LOGGING_FRAME_PACING_REPORT_H_
+#define MIR_REPORT_LOGGING_FRAME_PACING_REPORT_H_
+
+#include "mir/compositor/frame_pacing_observer.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace logging
+{
+class Logger;
+}
+namespace report
+{
+namespace logging
+{
+
+class FramePacingReport : public compositor::FramePacingObserver
+{
+public:
+    FramePacingReport(std::shared_ptr<mir::logging::Logger> const& log);
+
+    void missed_deadline(graphics::DisplayConfigurationOutputId output, unsigned vblanks_missed) override;
+    void repeated_frame(graphics::DisplayConfigurationOutputId output) override;
+    void client_frame_dropped(compositor::BufferStream const* stream) override;
+    void client_frame_rate(compositor::BufferStream const* stream, float frames_per_second) override;
+
+private:
+    std::shared_ptr<mir::logging::Logger> const log;
+};
+
+}
+}
+}
+
+#endif /* MIR_REPORT_LOGGING_FRAME_PACING_REPORT_H_ */
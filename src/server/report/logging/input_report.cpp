@@ -19,13 +19,13 @@
 #include "input_report.h"
 
 #include "mir/logging/logger.h"
-#include "mir/logging/input_timestamp.h"
 
 #include <linux/input.h>
 
-#include <sstream>
+#include <chrono>
+#include <cinttypes>
 #include <cstring>
-#include <mutex>
+#include <sstream>
 
 namespace mrl = mir::report::logging;
 namespace ml = mir::logging;
@@ -43,6 +43,23 @@ const char* mrl::InputReport::component()
 
 namespace
 {
+// ml::input_timestamp()'s format, split up so the logger can format it later
+struct EventTime
+{
+    explicit EventTime(int64_t when) :
+        when_ns{when},
+        age_ns{std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count() - when}
+    {
+    }
+
+    long long const when_ns;
+    long long const age_ns;
+};
+
+#define EVENT_TIME_FORMAT "%lld (%lld.%06lldms ago)"
+#define EVENT_TIME_ARGS(time) (time).when_ns, (time).age_ns / 1000000LL, (time).age_ns % 1000000LL
+
 #define PRINT_EV_ENUM(value, name) if (value == name) { return # name; }
 
 std::string print_evdev_type(int type)
@@ -117,59 +134,63 @@ std::string print_evdev_code(int type, int code)
 
 void mrl::InputReport::received_event_from_kernel(int64_t when, int type, int code, int value)
 {
-    std::stringstream ss;
-
-    ss << "Received event"
-       << " time=" << ml::input_timestamp(std::chrono::nanoseconds(when))
-       << " type=" << print_evdev_type(type)
-       << " code=" << print_evdev_code(type, code)
-       << " value=" << value;
-
-    logger->log(ml::Severity::informational, ss.str(), component());
+    auto const time = EventTime{when};
+    logger->log(component(), ml::Severity::informational,
+                "Received event time=" EVENT_TIME_FORMAT " type=%s code=%s value=%d",
+                EVENT_TIME_ARGS(time),
+                print_evdev_type(type).c_str(),
+                print_evdev_code(type, code).c_str(),
+                value);
 }
 
 void mrl::InputReport::published_key_event(int dest_fd, uint32_t seq_id, int64_t event_time)
 {
-    std::stringstream ss;
-
-    ss << "Published key event"
-       << " seq_id=" << seq_id
-       << " time=" << ml::input_timestamp(std::chrono::nanoseconds(event_time))
-       << " dest_fd=" << dest_fd;
-
-    logger->log(ml::Severity::informational, ss.str(), component());
+    auto const time = EventTime{event_time};
+    logger->log(component(), ml::Severity::informational,
+                "Published key event seq_id=%" PRIu32 " time=" EVENT_TIME_FORMAT " dest_fd=%d",
+                seq_id, EVENT_TIME_ARGS(time), dest_fd);
 }
 
 void mrl::InputReport::published_motion_event(int dest_fd, uint32_t seq_id, int64_t event_time)
 {
-    std::stringstream ss;
-
-    ss << "Published motion event"
-       << " seq_id=" << seq_id
-       << " time=" << ml::input_timestamp(std::chrono::nanoseconds(event_time))
-       << " dest_fd=" << dest_fd;
-
-    logger->log(ml::Severity::informational, ss.str(), component());
+    auto const time = EventTime{event_time};
+    logger->log(component(), ml::Severity::informational,
+                "Published motion event seq_id=%" PRIu32 " time=" EVENT_TIME_FORMAT " dest_fd=%d",
+                seq_id, EVENT_TIME_ARGS(time), dest_fd);
 }
 
 void mrl::InputReport::opened_input_device(char const* device_name, char const* input_platform)
 {
-    std::stringstream ss;
-
-    ss << "Input device opened "
-       << " name=" << device_name
-       << " platform=" << input_platform;
-
-    logger->log(ml::Severity::informational, ss.str(), component());
+    logger->log(component(), ml::Severity::informational,
+                "Input device opened  name=%s platform=%s", device_name, input_platform);
 }
 
 void mrl::InputReport::failed_to_open_input_device(char const* device_name, char const* input_platform)
 {
-    std::stringstream ss;
+    logger->log(component(), ml::Severity::informational,
+                "Failure opening input device  name=%s platform=%s", device_name, input_platform);
+}
 
-    ss << "Failure opening input device "
-       << " name=" << device_name
-       << " platform=" << input_platform;
+void mrl::InputReport::missed_input_deadline(int64_t event_time, int64_t lateness, uint64_t missed_count)
+{
+    auto const time = EventTime{event_time};
+    logger->log(component(), ml::Severity::warning,
+                "Missed input deadline time=" EVENT_TIME_FORMAT " late_by=%lldus missed_count=%" PRIu64,
+                EVENT_TIME_ARGS(time),
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::nanoseconds(lateness)).count()),
+                missed_count);
+}
 
-    logger->log(ml::Severity::informational, ss.str(), component());
+void mrl::InputReport::input_stage_latency(char const* stage, uint64_t count, int64_t p50, int64_t p99, int64_t p999)
+{
+    auto const us = [](int64_t ns)
+        {
+            return static_cast<long long>(
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(ns)).count());
+        };
+
+    logger->log(component(), ml::Severity::informational,
+                "Input latency stage=%s events=%" PRIu64 " p50=%lldus p99=%lldus p999=%lldus",
+                stage, count, us(p50), us(p99), us(p999));
 }
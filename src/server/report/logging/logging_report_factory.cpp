@@ -27,6 +27,7 @@
 #include "shell_report.h"
 #include "input_report.h"
 #include "seat_report.h"
+#include "frame_pacing_report.h"
 #include "mir/logging/shared_library_prober_report.h"
 
 #include "mir/default_server_configuration.h"
@@ -89,3 +90,8 @@ std::shared_ptr<mir::shell::ShellReport> mir::report::LoggingReportFactory::crea
 {
     return std::make_shared<mir::logging::ShellReport>(logger);
 }
+
+std::shared_ptr<mir::compositor::FramePacingObserver> mr::LoggingReportFactory::create_frame_pacing_report()
+{
+    return std::make_shared<logging::FramePacingReport>(logger);
+}
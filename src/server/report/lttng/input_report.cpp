@@ -48,3 +48,13 @@ void mir::report::lttng::InputReport::failed_to_open_input_device(char const* na
 {
     mir_tracepoint(mir_server_input, failed_to_open_input_device, name, platform);
 }
+
+void mir::report::lttng::InputReport::missed_input_deadline(int64_t event_time, int64_t lateness, uint64_t missed_count)
+{
+    mir_tracepoint(mir_server_input, missed_input_deadline, event_time, lateness, missed_count);
+}
+
+void mir::report::lttng::InputReport::input_stage_latency(char const* stage, uint64_t count, int64_t p50, int64_t p99, int64_t p999)
+{
+    mir_tracepoint(mir_server_input, input_stage_latency, stage, count, p50, p99, p999);
+}
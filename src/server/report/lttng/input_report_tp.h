@@ -81,6 +81,30 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    mir_server_input,
+    missed_input_deadline,
+    TP_ARGS(int64_t, event_time, int64_t, lateness, uint64_t, missed_count),
+    TP_FIELDS(
+        ctf_integer(int64_t, event_time, event_time)
+        ctf_integer(int64_t, lateness, lateness)
+        ctf_integer(uint64_t, missed_count, missed_count)
+     )
+)
+
+TRACEPOINT_EVENT(
+    mir_server_input,
+    input_stage_latency,
+    TP_ARGS(const char*, stage, uint64_t, count, int64_t, p50, int64_t, p99, int64_t, p999),
+    TP_FIELDS(
+        ctf_string(stage, stage)
+        ctf_integer(uint64_t, count, count)
+        ctf_integer(int64_t, p50, p50)
+        ctf_integer(int64_t, p99, p99)
+        ctf_integer(int64_t, p999, p999)
+     )
+)
+
 #endif /* MIR_LTTNG_DISPLAY_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
@@ -76,3 +76,8 @@ std::shared_ptr<mir::shell::ShellReport> mir::report::LttngReportFactory::create
 {
     BOOST_THROW_EXCEPTION(std::logic_error("Not implemented"));
 }
+
+std::shared_ptr<mir::compositor::FramePacingObserver> mir::report::LttngReportFactory::create_frame_pacing_report()
+{
+    BOOST_THROW_EXCEPTION(std::logic_error("Not implemented"));
+}
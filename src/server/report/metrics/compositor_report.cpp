@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compositor_report.h"
+
+#include "mir/metrics/registry.h"
+
+#include <string>
+
+namespace mrm = mir::report::metrics;
+
+mrm::CompositorReport::CompositorReport(
+    std::shared_ptr<mir::metrics::Registry> const& registry,
+    std::shared_ptr<time::Clock> const& clock,
+    std::shared_ptr<mir::compositor::CompositorReport> const& next) :
+    registry{registry},
+    clock{clock},
+    next{next},
+    running{registry->gauge("mir_compositor_running", "Whether the compositor is running")},
+    schedules{registry->counter("mir_compositor_schedules", "Times compositing was scheduled")}
+{
+}
+
+auto mrm::CompositorReport::display_for(SubCompositorId id) -> Display&
+{
+    for (auto display = first_display.load(std::memory_order_acquire); display; display = display->next)
+    {
+        if (display->id == id)
+            return *display;
+    }
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    // Another thread may have added it since we looked
+    for (auto display = first_display.load(std::memory_order_relaxed); display; display = display->next)
+    {
+        if (display->id == id)
+            return *display;
+    }
+
+    // Displays are numbered in the order the compositor first reports them
+    mir::metrics::Labels const labels{{"display", std::to_string(displays.size())}};
+
+    displays.push_back(std::unique_ptr<Display>{new Display{
+        id,
+        first_display.load(std::memory_order_relaxed),
+        registry->counter("mir_compositor_frames", "Frames composited", labels),
+        registry->gauge("mir_compositor_renderables", "Renderables in the last frame", labels),
+        registry->histogram("mir_compositor_render_time_seconds", "Time taken to render a frame", labels),
+        registry->histogram(
+            "mir_compositor_frame_time_seconds", "Time taken to render and post a frame", labels),
+        clock->now()}});
+
+    first_display.store(displays.back().get(), std::memory_order_release);
+    return *displays.back();
+}
+
+void mrm::CompositorReport::added_display(int width, int height, int x, int y, SubCompositorId id)
+{
+    display_for(id);
+    next->added_display(width, height, x, y, id);
+}
+
+void mrm::CompositorReport::began_frame(SubCompositorId id)
+{
+    display_for(id).start_of_frame = clock->now();
+    next->began_frame(id);
+}
+
+void mrm::CompositorReport::renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables)
+{
+    display_for(id).renderables.set(renderables.size());
+    next->renderables_in_frame(id, renderables);
+}
+
+void mrm::CompositorReport::rendered_frame(SubCompositorId id)
+{
+    auto& display = display_for(id);
+    display.render_time.record(clock->now() - display.start_of_frame);
+    next->rendered_frame(id);
+}
+
+void mrm::CompositorReport::finished_frame(SubCompositorId id)
+{
+    auto& display = display_for(id);
+    display.frame_time.record(clock->now() - display.start_of_frame);
+    display.frames.increment();
+    next->finished_frame(id);
+}
+
+void mrm::CompositorReport::started()
+{
+    running.set(1);
+    next->started();
+}
+
+void mrm::CompositorReport::stopped()
+{
+    running.set(0);
+    next->stopped();
+}
+
+void mrm::CompositorReport::scheduled()
+{
+    schedules.increment();
+    next->scheduled();
+}
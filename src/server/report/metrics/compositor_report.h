@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_
+#define MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_
+
+#include "mir/compositor/compositor_report.h"
+#include "mir/time/clock.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Gauge;
+}
+namespace time
+{
+class LatencyHistogram;
+}
+namespace report
+{
+namespace metrics
+{
+
+class CompositorReport : public mir::compositor::CompositorReport
+{
+public:
+    /// Everything reported is also passed on to \a next
+    CompositorReport(std::shared_ptr<mir::metrics::Registry> const& registry,
+                     std::shared_ptr<time::Clock> const& clock,
+                     std::shared_ptr<mir::compositor::CompositorReport> const& next);
+    void added_display(int width, int height, int x, int y, SubCompositorId id) override;
+    void began_frame(SubCompositorId id) override;
+    void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) override;
+    void rendered_frame(SubCompositorId id) override;
+    void finished_frame(SubCompositorId id) override;
+    void started() override;
+    void stopped() override;
+    void scheduled() override;
+
+private:
+    struct Display
+    {
+        SubCompositorId const id;
+        Display* const next;
+        mir::metrics::Counter& frames;
+        mir::metrics::Gauge& renderables;
+        time::LatencyHistogram& render_time;
+        time::LatencyHistogram& frame_time;
+        /// Only touched by the thread compositing the display
+        time::Timestamp start_of_frame;
+    };
+
+    Display& display_for(SubCompositorId id);
+
+    std::shared_ptr<mir::metrics::Registry> const registry;
+    std::shared_ptr<time::Clock> const clock;
+    std::shared_ptr<mir::compositor::CompositorReport> const next;
+    mir::metrics::Gauge& running;
+    mir::metrics::Counter& schedules;
+
+    // Displays are only ever added, to the front of the list, so reporting a
+    // frame walks it without locking
+    std::atomic<Display*> first_display{nullptr};
+
+    std::mutex mutex; // Serialises adding displays
+    std::vector<std::unique_ptr<Display>> displays;
+};
+
+}
+}
+}
+
+#endif // MIR_REPORT_METRICS_COMPOSITOR_REPORT_H_
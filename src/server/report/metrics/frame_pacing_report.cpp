@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_pacing_report.h"
+
+#include "mir/metrics/registry.h"
+#include "mir/time/latency_histogram.h"
+
+#include <string>
+
+namespace mrm = mir::report::metrics;
+namespace mg = mir::graphics;
+namespace mc = mir::compositor;
+
+namespace
+{
+mir::metrics::Labels labels_for(mg::DisplayConfigurationOutputId output)
+{
+    return {{"output", std::to_string(output.as_value())}};
+}
+}
+
+mrm::FramePacingReport::FramePacingReport(
+    std::shared_ptr<mir::metrics::Registry> const& registry,
+    std::shared_ptr<compositor::FramePacingObserver> const& next) :
+    registry{registry},
+    next{next},
+    dropped_frames{registry->counter(
+        "mir_client_dropped_frames", "Client frames replaced before they were composited")},
+    frame_interval{registry->histogram(
+        "mir_client_frame_interval_seconds", "Average time between client frames, measured each second")}
+{
+}
+
+void mrm::FramePacingReport::missed_deadline(mg::DisplayConfigurationOutputId output, unsigned vblanks_missed)
+{
+    auto const labels = labels_for(output);
+    registry->counter(
+        "mir_compositor_missed_deadlines", "Frames that reached the output later than intended", labels).increment();
+    registry->counter(
+        "mir_compositor_missed_vblanks", "Refreshes by which frames were late", labels).increment(vblanks_missed);
+    next->missed_deadline(output, vblanks_missed);
+}
+
+void mrm::FramePacingReport::repeated_frame(mg::DisplayConfigurationOutputId output)
+{
+    registry->counter(
+        "mir_compositor_repeated_frames",
+        "Frames posted before the output had shown the previous one",
+        labels_for(output)).increment();
+    next->repeated_frame(output);
+}
+
+void mrm::FramePacingReport::client_frame_dropped(mc::BufferStream const* stream)
+{
+    dropped_frames.increment();
+    next->client_frame_dropped(stream);
+}
+
+void mrm::FramePacingReport::client_frame_rate(mc::BufferStream const* stream, float frames_per_second)
+{
+    if (frames_per_second > 0)
+        frame_interval.record(std::chrono::nanoseconds{static_cast<long long>(1e9 / frames_per_second)});
+    next->client_frame_rate(stream, frames_per_second);
+}
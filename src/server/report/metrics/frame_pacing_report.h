@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_FRAME_PACING_REPORT_H_
+#define MIR_REPORT_METRICS_FRAME_PACING_REPORT_H_
+
+#include "mir/compositor/frame_pacing_observer.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+}
+namespace time
+{
+class LatencyHistogram;
+}
+namespace report
+{
+namespace metrics
+{
+
+class FramePacingReport : public compositor::FramePacingObserver
+{
+public:
+    /// Everything reported is also passed on to \a next
+    FramePacingReport(std::shared_ptr<mir::metrics::Registry> const& registry,
+                      std::shared_ptr<compositor::FramePacingObserver> const& next);
+
+    void missed_deadline(graphics::DisplayConfigurationOutputId output, unsigned vblanks_missed) override;
+    void repeated_frame(graphics::DisplayConfigurationOutputId output) override;
+    void client_frame_dropped(compositor::BufferStream const* stream) override;
+    void client_frame_rate(compositor::BufferStream const* stream, float frames_per_second) override;
+
+private:
+    std::shared_ptr<mir::metrics::Registry> const registry;
+    std::shared_ptr<compositor::FramePacingObserver> const next;
+    mir::metrics::Counter& dropped_frames;
+    time::LatencyHistogram& frame_interval;
+};
+
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_FRAME_PACING_REPORT_H_ */
@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_report.h"
+
+#include "mir/metrics/registry.h"
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+char const* const published_events = "mir_input_published_events";
+char const* const published_events_help = "Input events sent to clients";
+}
+
+mrm::InputReport::InputReport(
+    std::shared_ptr<mir::metrics::Registry> const& registry,
+    std::shared_ptr<input::InputReport> const& next) :
+    registry{registry},
+    next{next},
+    kernel_events{registry->counter("mir_input_kernel_events", "Events read from input devices")},
+    published_key_events{registry->counter(published_events, published_events_help, {{"type", "key"}})},
+    published_motion_events{registry->counter(published_events, published_events_help, {{"type", "motion"}})},
+    opened_devices{registry->counter("mir_input_devices_opened", "Input devices opened")},
+    failed_devices{registry->counter("mir_input_device_open_failures", "Input devices that failed to open")},
+    missed_deadlines{registry->counter(
+        "mir_input_missed_deadlines", "Input events handled later than their deadline")}
+{
+}
+
+void mrm::InputReport::received_event_from_kernel(int64_t when, int type, int code, int value)
+{
+    kernel_events.increment();
+    next->received_event_from_kernel(when, type, code, value);
+}
+
+void mrm::InputReport::published_key_event(int dest_fd, uint32_t seq_id, int64_t event_time)
+{
+    published_key_events.increment();
+    next->published_key_event(dest_fd, seq_id, event_time);
+}
+
+void mrm::InputReport::published_motion_event(int dest_fd, uint32_t seq_id, int64_t event_time)
+{
+    published_motion_events.increment();
+    next->published_motion_event(dest_fd, seq_id, event_time);
+}
+
+void mrm::InputReport::opened_input_device(char const* device_name, char const* input_platform)
+{
+    opened_devices.increment();
+    next->opened_input_device(device_name, input_platform);
+}
+
+void mrm::InputReport::failed_to_open_input_device(char const* device_name, char const* input_platform)
+{
+    failed_devices.increment();
+    next->failed_to_open_input_device(device_name, input_platform);
+}
+
+void mrm::InputReport::missed_input_deadline(int64_t event_time, int64_t lateness, uint64_t missed_count)
+{
+    missed_deadlines.increment();
+    next->missed_input_deadline(event_time, lateness, missed_count);
+}
+
+void mrm::InputReport::input_stage_latency(
+    char const* stage, uint64_t count, int64_t p50, int64_t p99, int64_t p999)
+{
+    next->input_stage_latency(stage, count, p50, p99, p999);
+
+    // Only reported every thousand events, so looking the gauges up each time is cheap enough
+    auto const set = [&](char const* percentile, int64_t value)
+        {
+            registry->duration_gauge(
+                "mir_input_stage_latency_seconds",
+                "Latency percentiles of input events reaching each stage of the input path",
+                {{"stage", stage}, {"percentile", percentile}}).set(value);
+        };
+
+    set("50", p50);
+    set("99", p99);
+    set("99.9", p999);
+}
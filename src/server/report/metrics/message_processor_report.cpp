@@ -0,0 +1,146 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "message_processor_report.h"
+
+#include "mir/metrics/registry.h"
+#include "mir/fnv1a_hash.h"
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+/// Never 0, which marks a free slot
+uint64_t invocation_key(void const* mediator, int id)
+{
+    mir::Fnv1aHash hash;
+    hash.add(mediator);
+    hash.add(id);
+    return hash.value() | 1;
+}
+}
+
+mrm::MessageProcessorReport::MessageProcessorReport(
+    std::shared_ptr<mir::metrics::Registry> const& registry,
+    std::shared_ptr<time::Clock> const& clock,
+    std::shared_ptr<frontend::MessageProcessorReport> const& next) :
+    registry{registry},
+    clock{clock},
+    next{next},
+    in_progress{registry->gauge("mir_ipc_invocations_in_progress", "Client requests being processed")},
+    failed{registry->counter("mir_ipc_failed_invocations", "Client requests that did not complete successfully")},
+    unknown_methods{registry->counter("mir_ipc_unknown_methods", "Client requests for unknown methods")},
+    exceptions{registry->counter("mir_ipc_exceptions", "Exceptions raised handling client requests")},
+    duration{registry->histogram(
+        "mir_ipc_invocation_duration_seconds", "Time from receiving a client request to completing it")}
+{
+}
+
+auto mrm::MessageProcessorReport::invocations_of(std::string const& method) -> mir::metrics::Counter&
+{
+    mir::Fnv1aHash hash;
+    hash.add(method);
+    auto const first_slot = hash.value() % table_size;
+
+    auto const find = [&](std::memory_order order) -> decltype(methods[0].method.load())
+        {
+            for (auto slot = first_slot; ; slot = (slot + 1) % table_size)
+            {
+                auto const entry = methods[slot].method.load(order);
+                if (!entry || entry->first == method)
+                    return entry;
+                if ((slot + 1) % table_size == first_slot)
+                    return nullptr;
+            }
+        };
+
+    if (auto const entry = find(std::memory_order_acquire))
+        return *entry->second;
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    // Another thread may have added it since we looked
+    if (auto const entry = find(std::memory_order_relaxed))
+        return *entry->second;
+
+    auto& counter = registry->counter("mir_ipc_invocations", "Client requests received", {{"method", method}});
+
+    for (auto slot = first_slot; ; slot = (slot + 1) % table_size)
+    {
+        if (!methods[slot].method.load(std::memory_order_relaxed))
+        {
+            known_methods.emplace_back(new std::pair<std::string, mir::metrics::Counter*>{method, &counter});
+            methods[slot].method.store(known_methods.back().get(), std::memory_order_release);
+            break;
+        }
+        // The protocol has far fewer methods than slots; past that, they are just not cached
+        if ((slot + 1) % table_size == first_slot)
+            break;
+    }
+
+    return counter;
+}
+
+void mrm::MessageProcessorReport::received_invocation(void const* mediator, int id, std::string const& method)
+{
+    invocations_of(method).increment();
+    in_progress.add(1);
+
+    auto const key = invocation_key(mediator, id);
+    auto& slot = invocations[key % table_size];
+    uint64_t free{0};
+    if (slot.invocation.compare_exchange_strong(free, key, std::memory_order_acquire, std::memory_order_relaxed))
+        slot.started.store(clock->now().time_since_epoch().count(), std::memory_order_relaxed);
+
+    next->received_invocation(mediator, id, method);
+}
+
+void mrm::MessageProcessorReport::completed_invocation(void const* mediator, int id, bool result)
+{
+    if (!result)
+        failed.increment();
+
+    in_progress.add(-1);
+
+    auto const key = invocation_key(mediator, id);
+    auto& slot = invocations[key % table_size];
+    if (slot.invocation.load(std::memory_order_relaxed) == key)
+    {
+        time::Timestamp const started{time::Timestamp::duration{slot.started.load(std::memory_order_relaxed)}};
+        slot.invocation.store(0, std::memory_order_release);
+        duration.record(clock->now() - started);
+    }
+
+    next->completed_invocation(mediator, id, result);
+}
+
+void mrm::MessageProcessorReport::unknown_method(void const* mediator, int id, std::string const& method)
+{
+    unknown_methods.increment();
+    next->unknown_method(mediator, id, method);
+}
+
+void mrm::MessageProcessorReport::exception_handled(void const* mediator, int id, std::exception const& error)
+{
+    exceptions.increment();
+    next->exception_handled(mediator, id, error);
+}
+
+void mrm::MessageProcessorReport::exception_handled(void const* mediator, std::exception const& error)
+{
+    exceptions.increment();
+    next->exception_handled(mediator, error);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_
+#define MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_
+
+#include "mir/frontend/message_processor_report.h"
+#include "mir/time/clock.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Gauge;
+}
+namespace time
+{
+class LatencyHistogram;
+}
+namespace report
+{
+namespace metrics
+{
+
+class MessageProcessorReport : public mir::frontend::MessageProcessorReport
+{
+public:
+    /// Everything reported is also passed on to \a next
+    MessageProcessorReport(
+        std::shared_ptr<mir::metrics::Registry> const& registry,
+        std::shared_ptr<time::Clock> const& clock,
+        std::shared_ptr<frontend::MessageProcessorReport> const& next);
+
+    void received_invocation(void const* mediator, int id, std::string const& method) override;
+
+    void completed_invocation(void const* mediator, int id, bool result) override;
+
+    void unknown_method(void const* mediator, int id, std::string const& method) override;
+
+    void exception_handled(void const* mediator, int id, std::exception const& error) override;
+
+    void exception_handled(void const* mediator, std::exception const& error) override;
+
+private:
+    std::shared_ptr<mir::metrics::Registry> const registry;
+    std::shared_ptr<time::Clock> const clock;
+    std::shared_ptr<frontend::MessageProcessorReport> const next;
+    mir::metrics::Gauge& in_progress;
+    mir::metrics::Counter& failed;
+    mir::metrics::Counter& unknown_methods;
+    mir::metrics::Counter& exceptions;
+    time::LatencyHistogram& duration;
+
+    mir::metrics::Counter& invocations_of(std::string const& method);
+
+    static size_t constexpr table_size = 256;
+
+    /// Open addressed by the hash of the method name; entries are only ever added
+    struct MethodSlot
+    {
+        std::atomic<std::pair<std::string, mir::metrics::Counter*> const*> method{nullptr};
+    };
+
+    /// The start of an invocation still being processed, found by the hash of its
+    /// mediator and id. An invocation whose slot is taken goes untimed.
+    struct InvocationSlot
+    {
+        std::atomic<uint64_t> invocation{0};
+        std::atomic<time::Timestamp::rep> started{0};
+    };
+
+    std::array<MethodSlot, table_size> methods;
+    std::array<InvocationSlot, table_size> invocations;
+
+    std::mutex mutex; // Serialises adding methods
+    std::vector<std::unique_ptr<std::pair<std::string, mir::metrics::Counter*>>> known_methods;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_ */
@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../metrics_report_factory.h"
+
+#include "compositor_report.h"
+#include "frame_pacing_report.h"
+#include "input_report.h"
+#include "message_processor_report.h"
+#include "scene_report.h"
+#include "session_mediator_report.h"
+
+mir::report::MetricsReportFactory::MetricsReportFactory(
+    std::shared_ptr<mir::metrics::Registry> const& registry,
+    std::shared_ptr<time::Clock> const& clock,
+    std::unique_ptr<ReportFactory> combined_with) :
+    registry{registry},
+    clock{clock},
+    combined_with{std::move(combined_with)}
+{
+}
+
+std::shared_ptr<mir::compositor::CompositorReport> mir::report::MetricsReportFactory::create_compositor_report()
+{
+    return std::make_shared<metrics::CompositorReport>(
+        registry, clock, combined_with->create_compositor_report());
+}
+
+std::shared_ptr<mir::graphics::DisplayReport> mir::report::MetricsReportFactory::create_display_report()
+{
+    return combined_with->create_display_report();
+}
+
+std::shared_ptr<mir::scene::SceneReport> mir::report::MetricsReportFactory::create_scene_report()
+{
+    return std::make_shared<metrics::SceneReport>(registry, combined_with->create_scene_report());
+}
+
+std::shared_ptr<mir::frontend::ConnectorReport> mir::report::MetricsReportFactory::create_connector_report()
+{
+    return combined_with->create_connector_report();
+}
+
+std::shared_ptr<mir::frontend::SessionMediatorObserver> mir::report::MetricsReportFactory::create_session_mediator_report()
+{
+    return std::make_shared<metrics::SessionMediatorReport>(
+        registry, combined_with->create_session_mediator_report());
+}
+
+std::shared_ptr<mir::frontend::MessageProcessorReport> mir::report::MetricsReportFactory::create_message_processor_report()
+{
+    return std::make_shared<metrics::MessageProcessorReport>(
+        registry, clock, combined_with->create_message_processor_report());
+}
+
+std::shared_ptr<mir::input::InputReport> mir::report::MetricsReportFactory::create_input_report()
+{
+    return std::make_shared<metrics::InputReport>(registry, combined_with->create_input_report());
+}
+
+std::shared_ptr<mir::input::SeatObserver> mir::report::MetricsReportFactory::create_seat_report()
+{
+    return combined_with->create_seat_report();
+}
+
+std::shared_ptr<mir::SharedLibraryProberReport> mir::report::MetricsReportFactory::create_shared_library_prober_report()
+{
+    return combined_with->create_shared_library_prober_report();
+}
+
+std::shared_ptr<mir::shell::ShellReport> mir::report::MetricsReportFactory::create_shell_report()
+{
+    return combined_with->create_shell_report();
+}
+
+std::shared_ptr<mir::compositor::FramePacingObserver> mir::report::MetricsReportFactory::create_frame_pacing_report()
+{
+    return std::make_shared<metrics::FramePacingReport>(
+        registry, combined_with->create_frame_pacing_report());
+}
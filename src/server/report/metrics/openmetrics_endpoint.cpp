@@ -0,0 +1,31 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "openmetrics_endpoint.h"
+
+#include "mir/metrics/registry.h"
+
+namespace mrm = mir::report::metrics;
+
+mrm::OpenMetricsEndpoint::OpenMetricsEndpoint(
+    std::string const& socket_path,
+    std::shared_ptr<mir::metrics::Registry> const& registry) :
+    SnapshotEndpoint{
+        socket_path,
+        "Mir/Metrics",
+        [registry](std::ostream& out) { registry->write_openmetrics(out); }}
+{
+}
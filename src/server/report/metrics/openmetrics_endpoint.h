@@ -0,0 +1,50 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_OPENMETRICS_ENDPOINT_H_
+#define MIR_REPORT_METRICS_OPENMETRICS_ENDPOINT_H_
+
+#include "../snapshot_endpoint.h"
+
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace metrics
+{
+class Registry;
+}
+namespace report
+{
+namespace metrics
+{
+/**
+ * Serves the metrics registry on a Unix socket.
+ *
+ * Each client that connects is sent the current metrics in the OpenMetrics
+ * text format and disconnected, so e.g. "socat - UNIX-CONNECT:<path>" prints them.
+ */
+class OpenMetricsEndpoint : public SnapshotEndpoint
+{
+public:
+    OpenMetricsEndpoint(std::string const& socket_path, std::shared_ptr<mir::metrics::Registry> const& registry);
+};
+}
+}
+}
+
+#endif // MIR_REPORT_METRICS_OPENMETRICS_ENDPOINT_H_
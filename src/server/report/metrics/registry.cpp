@@ -0,0 +1,249 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/metrics/registry.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <locale>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace mm = mir::metrics;
+
+enum class mm::Registry::Type
+{
+    counter,
+    gauge,
+    duration_gauge,
+    summary
+};
+
+struct mm::Registry::Series
+{
+    std::string const labels;
+    std::unique_ptr<Counter> const counter;
+    std::unique_ptr<Gauge> const gauge;
+    std::unique_ptr<time::LatencyHistogram> const histogram;
+};
+
+struct mm::Registry::Family
+{
+    std::string const name;
+    std::string const help;
+    Type const type;
+    std::vector<std::unique_ptr<Series>> series;
+};
+
+namespace
+{
+bool is_valid_name(std::string const& name)
+{
+    auto const valid_first = [](char c)
+        { return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_' || c == ':'; };
+    auto const valid_rest = [&](char c) { return valid_first(c) || ('0' <= c && c <= '9'); };
+
+    return !name.empty() && valid_first(name.front()) && std::all_of(name.begin() + 1, name.end(), valid_rest);
+}
+
+std::string escaped(std::string const& text, bool escape_quotes)
+{
+    std::string result;
+    for (auto c : text)
+    {
+        switch (c)
+        {
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '"':  result += escape_quotes ? "\\\"" : "\""; break;
+        default:   result += c;
+        }
+    }
+    return result;
+}
+
+// Label sets are formatted once, when a series is created, as `a="x",b="y"`
+std::string format_labels(mm::Labels const& labels)
+{
+    std::string result;
+    for (auto const& label : labels)
+    {
+        if (!is_valid_name(label.first) || label.first == "quantile")
+            BOOST_THROW_EXCEPTION(std::invalid_argument("Invalid metric label name: " + label.first));
+
+        if (!result.empty())
+            result += ',';
+        result += label.first + "=\"" + escaped(label.second, true) + '"';
+    }
+    return result;
+}
+
+std::string with(std::string const& labels, std::string const& extra)
+{
+    if (labels.empty())
+        return extra;
+    if (extra.empty())
+        return labels;
+    return labels + ',' + extra;
+}
+
+void write_sample(std::ostream& out, std::string const& name, std::string const& labels, std::string const& value)
+{
+    out << name;
+    if (!labels.empty())
+        out << '{' << labels << '}';
+    out << ' ' << value << '\n';
+}
+
+std::string seconds(std::chrono::nanoseconds duration)
+{
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out << std::setprecision(9) << std::chrono::duration<double>{duration}.count();
+    return out.str();
+}
+
+struct Quantile
+{
+    char const* label;
+    double percentile;
+};
+
+Quantile const exported_quantiles[] = {{"0.5", 50.0}, {"0.9", 90.0}, {"0.99", 99.0}, {"0.999", 99.9}};
+}
+
+char const* mm::Registry::type_name(Type type)
+{
+    switch (type)
+    {
+    case Type::counter: return "counter";
+    case Type::gauge:   return "gauge";
+    case Type::duration_gauge: return "gauge";
+    case Type::summary: return "summary";
+    }
+    return "unknown";
+}
+
+mm::Registry::Registry() = default;
+mm::Registry::~Registry() = default;
+
+auto mm::Registry::series_for(std::string const& name, std::string const& help, Type type, Labels const& labels)
+-> Series&
+{
+    auto const label_text = format_labels(labels);
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto family = std::find_if(families.begin(), families.end(),
+        [&name](auto const& candidate) { return candidate->name == name; });
+
+    if (family == families.end())
+    {
+        if (!is_valid_name(name))
+            BOOST_THROW_EXCEPTION(std::invalid_argument("Invalid metric name: " + name));
+
+        families.push_back(std::unique_ptr<Family>{new Family{name, help, type, {}}});
+        family = families.end() - 1;
+    }
+    else if ((*family)->type != type)
+    {
+        BOOST_THROW_EXCEPTION(std::logic_error("Metric " + name + " is already registered with another type"));
+    }
+
+    auto& series = (*family)->series;
+    auto existing = std::find_if(series.begin(), series.end(),
+        [&label_text](auto const& candidate) { return candidate->labels == label_text; });
+
+    if (existing != series.end())
+        return **existing;
+
+    series.push_back(std::unique_ptr<Series>{new Series{
+        label_text,
+        type == Type::counter ? std::make_unique<Counter>() : nullptr,
+        type == Type::gauge || type == Type::duration_gauge ? std::make_unique<Gauge>() : nullptr,
+        type == Type::summary ? std::make_unique<time::LatencyHistogram>() : nullptr}});
+
+    return *series.back();
+}
+
+auto mm::Registry::counter(std::string const& name, std::string const& help, Labels const& labels) -> Counter&
+{
+    return *series_for(name, help, Type::counter, labels).counter;
+}
+
+auto mm::Registry::gauge(std::string const& name, std::string const& help, Labels const& labels) -> Gauge&
+{
+    return *series_for(name, help, Type::gauge, labels).gauge;
+}
+
+auto mm::Registry::duration_gauge(std::string const& name, std::string const& help, Labels const& labels)
+-> Gauge&
+{
+    return *series_for(name, help, Type::duration_gauge, labels).gauge;
+}
+
+auto mm::Registry::histogram(std::string const& name, std::string const& help, Labels const& labels)
+-> time::LatencyHistogram&
+{
+    return *series_for(name, help, Type::summary, labels).histogram;
+}
+
+void mm::Registry::write_openmetrics(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    for (auto const& family : families)
+    {
+        out << "# TYPE " << family->name << ' ' << type_name(family->type) << '\n';
+        out << "# HELP " << family->name << ' ' << escaped(family->help, false) << '\n';
+
+        for (auto const& series : family->series)
+        {
+            switch (family->type)
+            {
+            case Type::counter:
+                write_sample(out, family->name + "_total", series->labels, std::to_string(series->counter->value()));
+                break;
+
+            case Type::gauge:
+                write_sample(out, family->name, series->labels, std::to_string(series->gauge->value()));
+                break;
+
+            case Type::duration_gauge:
+                write_sample(
+                    out, family->name, series->labels, seconds(std::chrono::nanoseconds{series->gauge->value()}));
+                break;
+
+            case Type::summary:
+                for (auto const& quantile : exported_quantiles)
+                {
+                    write_sample(
+                        out,
+                        family->name,
+                        with(series->labels, std::string{"quantile=\""} + quantile.label + '"'),
+                        seconds(series->histogram->value_at_percentile(quantile.percentile)));
+                }
+                write_sample(out, family->name + "_count", series->labels, std::to_string(series->histogram->count()));
+                break;
+            }
+        }
+    }
+
+    out << "# EOF\n";
+}
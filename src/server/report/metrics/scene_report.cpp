@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scene_report.h"
+
+#include "mir/metrics/registry.h"
+
+namespace mrm = mir::report::metrics;
+
+mrm::SceneReport::SceneReport(
+    std::shared_ptr<mir::metrics::Registry> const& registry,
+    std::shared_ptr<scene::SceneReport> const& next) :
+    registry{registry},
+    next{next},
+    created{registry->counter("mir_scene_surfaces_created", "Surfaces created")},
+    existing{registry->gauge("mir_scene_surfaces", "Surfaces that exist")},
+    in_scene{registry->gauge("mir_scene_surfaces_in_scene", "Surfaces added to the scene")}
+{
+}
+
+void mrm::SceneReport::surface_created(BasicSurfaceId id, std::string const& name)
+{
+    created.increment();
+    existing.add(1);
+    next->surface_created(id, name);
+}
+
+void mrm::SceneReport::surface_added(BasicSurfaceId id, std::string const& name)
+{
+    in_scene.add(1);
+    next->surface_added(id, name);
+}
+
+void mrm::SceneReport::surface_removed(BasicSurfaceId id, std::string const& name)
+{
+    in_scene.add(-1);
+    next->surface_removed(id, name);
+}
+
+void mrm::SceneReport::surface_deleted(BasicSurfaceId id, std::string const& name)
+{
+    existing.add(-1);
+    next->surface_deleted(id, name);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_SCENE_REPORT_H_
+#define MIR_REPORT_METRICS_SCENE_REPORT_H_
+
+#include "mir/scene/scene_report.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Gauge;
+}
+namespace report
+{
+namespace metrics
+{
+
+class SceneReport : public scene::SceneReport
+{
+public:
+    /// Everything reported is also passed on to \a next
+    SceneReport(std::shared_ptr<mir::metrics::Registry> const& registry,
+                std::shared_ptr<scene::SceneReport> const& next);
+
+    void surface_created(BasicSurfaceId id, std::string const& name) override;
+    void surface_added(BasicSurfaceId id, std::string const& name) override;
+    void surface_removed(BasicSurfaceId id, std::string const& name) override;
+    void surface_deleted(BasicSurfaceId id, std::string const& name) override;
+
+private:
+    std::shared_ptr<mir::metrics::Registry> const registry;
+    std::shared_ptr<scene::SceneReport> const next;
+    mir::metrics::Counter& created;
+    mir::metrics::Gauge& existing;
+    mir::metrics::Gauge& in_scene;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_SCENE_REPORT_H_ */
@@ -0,0 +1,146 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "session_mediator_report.h"
+
+#include "mir/metrics/registry.h"
+
+namespace mrm = mir::report::metrics;
+
+mrm::SessionMediatorReport::SessionMediatorReport(
+    std::shared_ptr<mir::metrics::Registry> const& registry,
+    std::shared_ptr<frontend::SessionMediatorObserver> const& next) :
+    registry{registry},
+    next{next},
+    connects{registry->counter("mir_session_connects", "Client connections")},
+    sessions{registry->gauge("mir_sessions", "Connected clients")},
+    surfaces{registry->gauge("mir_session_surfaces", "Surfaces created by clients and not yet released")},
+    buffer_streams{registry->gauge(
+        "mir_session_buffer_streams", "Buffer streams created by clients and not yet released")},
+    submitted_buffers{registry->counter("mir_session_submitted_buffers", "Buffers submitted by clients")},
+    allocated_buffers{registry->counter("mir_session_allocated_buffers", "Buffer allocation requests")},
+    released_buffers{registry->counter("mir_session_released_buffers", "Buffer release requests")},
+    display_configurations{registry->counter(
+        "mir_session_display_configurations", "Display configuration requests by clients")}
+{
+}
+
+void mrm::SessionMediatorReport::session_connect_called(std::string const& app_name)
+{
+    connects.increment();
+    sessions.add(1);
+    next->session_connect_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_create_surface_called(std::string const& app_name)
+{
+    surfaces.add(1);
+    next->session_create_surface_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_submit_buffer_called(std::string const& app_name)
+{
+    submitted_buffers.increment();
+    next->session_submit_buffer_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_allocate_buffers_called(std::string const& app_name)
+{
+    allocated_buffers.increment();
+    next->session_allocate_buffers_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_release_buffers_called(std::string const& app_name)
+{
+    released_buffers.increment();
+    next->session_release_buffers_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_release_surface_called(std::string const& app_name)
+{
+    surfaces.add(-1);
+    next->session_release_surface_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_disconnect_called(std::string const& app_name)
+{
+    sessions.add(-1);
+    next->session_disconnect_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_configure_surface_called(std::string const& app_name)
+{
+    next->session_configure_surface_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_configure_surface_cursor_called(std::string const& app_name)
+{
+    next->session_configure_surface_cursor_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_configure_display_called(std::string const& app_name)
+{
+    display_configurations.increment();
+    next->session_configure_display_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_set_base_display_configuration_called(std::string const& app_name)
+{
+    display_configurations.increment();
+    next->session_set_base_display_configuration_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_preview_base_display_configuration_called(std::string const& app_name)
+{
+    display_configurations.increment();
+    next->session_preview_base_display_configuration_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_confirm_base_display_configuration_called(std::string const& app_name)
+{
+    next->session_confirm_base_display_configuration_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_start_prompt_session_called(
+    std::string const& app_name, pid_t application_process)
+{
+    next->session_start_prompt_session_called(app_name, application_process);
+}
+
+void mrm::SessionMediatorReport::session_stop_prompt_session_called(std::string const& app_name)
+{
+    next->session_stop_prompt_session_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_create_buffer_stream_called(std::string const& app_name)
+{
+    buffer_streams.add(1);
+    next->session_create_buffer_stream_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_release_buffer_stream_called(std::string const& app_name)
+{
+    buffer_streams.add(-1);
+    next->session_release_buffer_stream_called(app_name);
+}
+
+void mrm::SessionMediatorReport::session_error(
+    std::string const& app_name, char const* method, std::string const& what)
+{
+    // Errors are rare, so looking the counter up each time is fine
+    registry->counter("mir_session_errors", "Client requests that failed", {{"method", method}}).increment();
+    next->session_error(app_name, method, what);
+}
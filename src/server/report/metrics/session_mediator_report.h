@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_SESSION_MEDIATOR_REPORT_H_
+#define MIR_REPORT_METRICS_SESSION_MEDIATOR_REPORT_H_
+
+#include "mir/frontend/session_mediator_observer.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Gauge;
+}
+namespace report
+{
+namespace metrics
+{
+class SessionMediatorReport : public frontend::SessionMediatorObserver
+{
+public:
+    /// Everything reported is also passed on to \a next
+    SessionMediatorReport(std::shared_ptr<mir::metrics::Registry> const& registry,
+                          std::shared_ptr<frontend::SessionMediatorObserver> const& next);
+
+    void session_connect_called(std::string const& app_name) override;
+    void session_create_surface_called(std::string const& app_name) override;
+    void session_submit_buffer_called(std::string const& app_name) override;
+    void session_allocate_buffers_called(std::string const& app_name) override;
+    void session_release_buffers_called(std::string const& app_name) override;
+    void session_release_surface_called(std::string const& app_name) override;
+    void session_disconnect_called(std::string const& app_name) override;
+    void session_configure_surface_called(std::string const& app_name) override;
+    void session_configure_surface_cursor_called(std::string const& app_name) override;
+    void session_configure_display_called(std::string const& app_name) override;
+    void session_set_base_display_configuration_called(std::string const& app_name) override;
+    void session_preview_base_display_configuration_called(std::string const& app_name) override;
+    void session_confirm_base_display_configuration_called(std::string const& app_name) override;
+    void session_start_prompt_session_called(std::string const& app_name, pid_t application_process) override;
+    void session_stop_prompt_session_called(std::string const& app_name) override;
+    void session_create_buffer_stream_called(std::string const& app_name) override;
+    void session_release_buffer_stream_called(std::string const& app_name) override;
+
+    void session_error(std::string const& app_name, char const* method, std::string const& what) override;
+
+private:
+    std::shared_ptr<mir::metrics::Registry> const registry;
+    std::shared_ptr<frontend::SessionMediatorObserver> const next;
+    mir::metrics::Counter& connects;
+    mir::metrics::Gauge& sessions;
+    mir::metrics::Gauge& surfaces;
+    mir::metrics::Gauge& buffer_streams;
+    mir::metrics::Counter& submitted_buffers;
+    mir::metrics::Counter& allocated_buffers;
+    mir::metrics::Counter& released_buffers;
+    mir::metrics::Counter& display_configurations;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_SESSION_MEDIATOR_REPORT_H_ */
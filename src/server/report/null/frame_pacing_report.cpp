@@ -0,0 +1,37 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_pacing_report.h"
+
+namespace mrn = mir::report::null;
+namespace mg = mir::graphics;
+namespace mc = mir::compositor;
+
+void mrn::FramePacingReport::missed_deadline(mg::DisplayConfigurationOutputId /*output*/, unsigned /*vblanks_missed*/)
+{
+}
+
+void mrn::FramePacingReport::repeated_frame(mg::DisplayConfigurationOutputId /*output*/)
+{
+}
+
+void mrn::FramePacingReport::client_frame_dropped(mc::BufferStream const* /*stream*/)
+{
+}
+
+void mrn::FramePacingReport::client_frame_rate(mc::BufferStream const* /*stream*/, float /*frames_per_second*/)
+{
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_NULL_FRAME_PACING_REPORT_H_
+#define MIR_REPORT_NULL_FRAME_PACING_REPORT_H_
+
+#include "mir/compositor/frame_pacing_observer.h"
+
+namespace mir
+{
+namespace report
+{
+namespace null
+{
+
+class FramePacingReport : public compositor::FramePacingObserver
+{
+public:
+    void missed_deadline(graphics::DisplayConfigurationOutputId output, unsigned vblanks_missed) override;
+    void repeated_frame(graphics::DisplayConfigurationOutputId output) override;
+    void client_frame_dropped(compositor::BufferStream const* stream) override;
+    void client_frame_rate(compositor::BufferStream const* stream, float frames_per_second) override;
+};
+
+}
+}
+}
+
+#endif /* MIR_REPORT_NULL_FRAME_PACING_REPORT_H_ */
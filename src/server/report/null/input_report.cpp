@@ -39,3 +39,12 @@ void mrn::InputReport::opened_input_device(char const* /* name */, char const* /
 void mrn::InputReport::failed_to_open_input_device(char const* /* name */, char const* /* platform */)
 {
 }
+
+void mrn::InputReport::missed_input_deadline(int64_t /* event_time */, int64_t /* lateness */, uint64_t /* missed_count */)
+{
+}
+
+void mrn::InputReport::input_stage_latency(
+    char const* /* stage */, uint64_t /* count */, int64_t /* p50 */, int64_t /* p99 */, int64_t /* p999 */)
+{
+}
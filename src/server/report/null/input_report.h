@@ -42,6 +42,8 @@ public:
 
     void opened_input_device(char const* device_name, char const* input_platform) override;
     void failed_to_open_input_device(char const* device_name, char const* input_platform) override;
+    void missed_input_deadline(int64_t event_time, int64_t lateness, uint64_t missed_count) override;
+    void input_stage_latency(char const* stage, uint64_t count, int64_t p50, int64_t p99, int64_t p999) override;
 };
 
 }
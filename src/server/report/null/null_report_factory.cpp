@@ -25,6 +25,7 @@
 #include "display_report.h"
 #include "input_report.h"
 #include "seat_report.h"
+#include "frame_pacing_report.h"
 #include "shell_report.h"
 #include "scene_report.h"
 #include "mir/logging/null_shared_library_prober_report.h"
@@ -79,6 +80,11 @@ std::shared_ptr<mir::shell::ShellReport> mir::report::NullReportFactory::create_
     return std::make_shared<null::ShellReport>();
 }
 
+std::shared_ptr<mir::compositor::FramePacingObserver> mir::report::NullReportFactory::create_frame_pacing_report()
+{
+    return std::make_shared<null::FramePacingReport>();
+}
+
 std::shared_ptr<mir::compositor::CompositorReport> mir::report::null_compositor_report()
 {
     return NullReportFactory{}.create_compositor_report();
@@ -38,6 +38,7 @@ public:
     std::shared_ptr<input::SeatObserver> create_seat_report() override;
     std::shared_ptr<mir::SharedLibraryProberReport> create_shared_library_prober_report() override;
     std::shared_ptr<shell::ShellReport> create_shell_report() override;
+    std::shared_ptr<compositor::FramePacingObserver> create_frame_pacing_report() override;
 };
 
 std::shared_ptr<compositor::CompositorReport> null_compositor_report();
@@ -27,6 +27,7 @@ class SharedLibraryProberReport;
 namespace compositor
 {
 class CompositorReport;
+class FramePacingObserver;
 }
 namespace frontend
 {
@@ -65,6 +66,7 @@ public:
     virtual std::shared_ptr<input::SeatObserver> create_seat_report() = 0;
     virtual std::shared_ptr<SharedLibraryProberReport> create_shared_library_prober_report() = 0;
     virtual std::shared_ptr<shell::ShellReport> create_shell_report() = 0;
+    virtual std::shared_ptr<compositor::FramePacingObserver> create_frame_pacing_report() = 0;
 
 protected:
     ReportFactory() = default;
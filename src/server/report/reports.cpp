@@ -28,100 +28,177 @@
 #include "report_factory.h"
 #include "lttng_report_factory.h"
 #include "logging_report_factory.h"
+#include "metrics_report_factory.h"
 #include "null_report_factory.h"
+#include "metrics/openmetrics_endpoint.h"
+#include "frame_timeline_dump.h"
+#include "snapshot_endpoint.h"
+#include "mir/trace/frame_timeline.h"
+#include "mir/memory/accounting.h"
+#include "mir/compositor/frame_pacing_observer.h"
+#include "mir/main_loop.h"
 
+#include <sstream>
 #include <string>
 
+#include <csignal>
+
 namespace mo = mir::options;
 namespace mr = mir::report;
 
-namespace
+auto mr::report_factory_for(DefaultServerConfiguration& config, char const* report_opt, std::string const& outputs)
+    -> std::unique_ptr<ReportFactory>
 {
-enum class ReportOutput
-{
-    Discarded,
-    Log,
-    LTTNG
-};
+    auto const invalid = [&]
+        {
+            return AbnormalExit(
+                std::string("Invalid ") + report_opt + " option: " + outputs + " (valid options are: \"" +
+                mo::off_opt_value + "\" and \"" + mo::log_opt_value + "\" and \"" + mo::lttng_opt_value +
+                "\", any of them combined with \"" + mo::metrics_opt_value + "\" as in \"" +
+                mo::log_opt_value + "," + mo::metrics_opt_value + "\", or \"" + mo::metrics_opt_value + "\")");
+        };
 
-std::unique_ptr<mr::ReportFactory> factory_for_type(
-    mir::DefaultServerConfiguration& config,
-    ReportOutput type)
-{
-    switch (type)
+    std::unique_ptr<ReportFactory> factory;
+    bool metrics{false};
+
+    std::istringstream list{outputs};
+    for (std::string output; std::getline(list, output, ',');)
     {
-    case ReportOutput::Discarded:
-        return std::make_unique<mr::NullReportFactory>();
-    case ReportOutput::Log:
-        return std::make_unique<mr::LoggingReportFactory>(config.the_logger(), config.the_clock());
-    case ReportOutput::LTTNG:
-        return std::make_unique<mr::LttngReportFactory>();
+        if (output == mo::metrics_opt_value && !metrics)
+            metrics = true;
+        else if (factory)
+            throw invalid();
+        else if (output == mo::log_opt_value)
+            factory = std::make_unique<LoggingReportFactory>(config.the_logger(), config.the_clock());
+        else if (output == mo::lttng_opt_value)
+            factory = std::make_unique<LttngReportFactory>();
+        else if (output == mo::off_opt_value)
+            factory = std::make_unique<NullReportFactory>();
+        else
+            throw invalid();
     }
-#ifndef __clang__
-    /*
-     * Clang understands that the above switch is exhaustive, so only throw here to satisfy g++'s
-     * control-reaches-end-of-non-void-function diagnostic.
-     *
-     * This way if the above switch *becomes* non-exhaustive clang will fail to build for us.
-     */
 
-    using namespace std::string_literals;
-    throw std::logic_error{"Requested unknown ReportOutput type:"s + std::to_string(static_cast<int>(type))};
-#endif
+    if (!factory && !metrics)
+        throw invalid();
+
+    if (!factory)
+        factory = std::make_unique<NullReportFactory>();
+
+    if (metrics)
+        factory = std::make_unique<MetricsReportFactory>(
+            config.the_metrics_registry(), config.the_clock(), std::move(factory));
+
+    return factory;
 }
 
-ReportOutput parse_report_option(std::string const& opt)
+namespace
 {
-    if (opt == mo::log_opt_value)
-    {
-        return ReportOutput::Log;
-    }
-    else if (opt == mo::lttng_opt_value)
-    {
-        return ReportOutput::LTTNG;
-    }
-    else if (opt == mo::off_opt_value)
+std::shared_ptr<mir::input::SeatObserver> create_seat_reports(
+    mir::DefaultServerConfiguration& config,
+    std::string const& opt)
+{
+    using namespace std::string_literals;
+    try
     {
-        return ReportOutput::Discarded;
+        return mr::report_factory_for(config, mo::seat_report_opt, opt)->create_seat_report();
     }
-    else
+    catch (...)
     {
-        throw mir::AbnormalExit(
-            std::string("Invalid report option: ") + opt + " (valid options are: \"" +
-            mo::off_opt_value + "\" and \"" + mo::log_opt_value +
-            "\" and \"" + mo::lttng_opt_value + "\")");
+        std::throw_with_nested(mir::AbnormalExit("Failed to create report for "s + mo::seat_report_opt));
     }
 }
 
-std::shared_ptr<mir::input::SeatObserver> create_seat_reports(
+std::shared_ptr<mir::frontend::SessionMediatorObserver> create_session_mediator_reports(
     mir::DefaultServerConfiguration& config,
     std::string const& opt)
 {
     using namespace std::string_literals;
     try
     {
-        return factory_for_type(config, parse_report_option(opt))->create_seat_report();
+        return mr::report_factory_for(config, mo::session_mediator_report_opt, opt)->create_session_mediator_report();
     }
     catch (...)
     {
-        std::throw_with_nested(mir::AbnormalExit("Failed to create report for "s + mo::seat_report_opt));
+        std::throw_with_nested(mir::AbnormalExit("Failed to create report for "s + mo::session_mediator_report_opt));
     }
 }
 
-std::shared_ptr<mir::frontend::SessionMediatorObserver> create_session_mediator_reports(
+std::shared_ptr<mir::compositor::FramePacingObserver> create_frame_pacing_reports(
     mir::DefaultServerConfiguration& config,
     std::string const& opt)
 {
     using namespace std::string_literals;
     try
     {
-        return factory_for_type(config, parse_report_option(opt))->create_session_mediator_report();
+        return mr::report_factory_for(config, mo::frame_pacing_report_opt, opt)->create_frame_pacing_report();
     }
     catch (...)
     {
-        std::throw_with_nested(mir::AbnormalExit("Failed to create report for "s + mo::session_mediator_report_opt));
+        std::throw_with_nested(mir::AbnormalExit("Failed to create report for "s + mo::frame_pacing_report_opt));
     }
 }
+
+std::unique_ptr<mr::metrics::OpenMetricsEndpoint> create_metrics_endpoint(
+    mir::DefaultServerConfiguration& config,
+    mo::Option const& options)
+{
+    if (!options.is_set(mo::metrics_socket_opt))
+        return {};
+
+    return std::make_unique<mr::metrics::OpenMetricsEndpoint>(
+        options.get<std::string>(mo::metrics_socket_opt),
+        config.the_metrics_registry());
+}
+
+std::shared_ptr<mir::trace::FrameTimeline> create_frame_timeline(mo::Option const& options)
+{
+    if (!options.is_set(mo::frame_trace_opt) && !options.is_set(mo::frame_trace_socket_opt))
+        return {};
+
+    auto const timeline = std::make_shared<mir::trace::FrameTimeline>(mir::trace::FrameTimeline::default_capacity);
+    mir::trace::set_frame_timeline(timeline);
+    return timeline;
+}
+
+std::shared_ptr<mr::FrameTimelineDump> create_frame_timeline_dump(
+    mir::DefaultServerConfiguration& config,
+    std::shared_ptr<mir::trace::FrameTimeline> const& timeline,
+    mo::Option const& options)
+{
+    if (!options.is_set(mo::frame_trace_opt))
+        return {};
+
+    auto const dump = std::make_shared<mr::FrameTimelineDump>(timeline, options.get<std::string>(mo::frame_trace_opt));
+    config.the_main_loop()->register_signal_handler({SIGUSR2}, [dump](int) { dump->dump(); });
+    return dump;
+}
+
+std::unique_ptr<mr::SnapshotEndpoint> create_frame_timeline_endpoint(
+    std::shared_ptr<mir::trace::FrameTimeline> const& timeline,
+    mo::Option const& options)
+{
+    if (!options.is_set(mo::frame_trace_socket_opt))
+        return {};
+
+    return std::make_unique<mr::SnapshotEndpoint>(
+        options.get<std::string>(mo::frame_trace_socket_opt),
+        "Mir/FrameTrace",
+        [timeline](std::ostream& out) { timeline->write_chrome_json(out); });
+}
+
+std::unique_ptr<mr::SnapshotEndpoint> create_memory_accounting_endpoint(
+    mir::DefaultServerConfiguration& config,
+    mo::Option const& options)
+{
+    if (!options.is_set(mo::memory_accounting_socket_opt))
+        return {};
+
+    auto const accounting = config.the_memory_accounting();
+    return std::make_unique<mr::SnapshotEndpoint>(
+        options.get<std::string>(mo::memory_accounting_socket_opt),
+        "Mir/MemAccount",
+        [accounting](std::ostream& out) { accounting->write_report(out); });
+}
 }
 
 mir::report::Reports::Reports(
@@ -135,9 +212,26 @@ mir::report::Reports::Reports(
           create_session_mediator_reports(
               server,
               options.get<std::string>(mo::session_mediator_report_opt))},
-      session_mediator_observer_multiplexer{server.the_session_mediator_observer_registrar()}
+      session_mediator_observer_multiplexer{server.the_session_mediator_observer_registrar()},
+      frame_pacing_report{
+          create_frame_pacing_reports(
+              server,
+              options.get<std::string>(mo::frame_pacing_report_opt))},
+      frame_pacing_observer_multiplexer{server.the_frame_pacing_observer_registrar()},
+      metrics_endpoint{create_metrics_endpoint(server, options)},
+      frame_timeline{create_frame_timeline(options)},
+      frame_timeline_dump{create_frame_timeline_dump(server, frame_timeline, options)},
+      frame_timeline_endpoint{create_frame_timeline_endpoint(frame_timeline, options)},
+      memory_accounting_endpoint{create_memory_accounting_endpoint(server, options)}
 {
     display_configuration_multiplexer->register_interest(display_configuration_report);
     seat_observer_multiplexer->register_interest(seat_report);
     session_mediator_observer_multiplexer->register_interest(session_mediator_report);
+    frame_pacing_observer_multiplexer->register_interest(frame_pacing_report);
+}
+
+mir::report::Reports::~Reports()
+{
+    if (frame_timeline)
+        mir::trace::set_frame_timeline(nullptr);
 }
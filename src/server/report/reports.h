@@ -20,6 +20,7 @@
 #define MIR_REPORT_REPORTS_H_
 
 #include <memory>
+#include <string>
 
 namespace mir
 {
@@ -45,6 +46,15 @@ namespace frontend
 {
 class SessionMediatorObserver;
 }
+namespace compositor
+{
+class FramePacingObserver;
+}
+
+namespace trace
+{
+class FrameTimeline;
+}
 
 namespace report
 {
@@ -52,13 +62,28 @@ namespace logging
 {
 class DisplayConfigurationReport;
 }
+namespace metrics
+{
+class OpenMetricsEndpoint;
+}
 
 class ReportFactory;
+class FrameTimelineDump;
+class SnapshotEndpoint;
+
+/**
+ * Creates the factory for the outputs a report option lists: one of "log",
+ * "lttng" or "off", optionally combined with "metrics" (e.g. "log,metrics").
+ * \throws AbnormalExit if the value of \a report_opt lists anything else
+ */
+auto report_factory_for(DefaultServerConfiguration& config, char const* report_opt, std::string const& outputs)
+    -> std::unique_ptr<ReportFactory>;
 
 class Reports
 {
 public:
     Reports(DefaultServerConfiguration& server, options::Option const& options);
+    ~Reports();
 
 private:
     std::shared_ptr<logging::DisplayConfigurationReport> const display_configuration_report;
@@ -68,6 +93,13 @@ private:
     std::shared_ptr<frontend::SessionMediatorObserver> const session_mediator_report;
     std::shared_ptr<ObserverRegistrar<frontend::SessionMediatorObserver>> const
         session_mediator_observer_multiplexer;
+    std::shared_ptr<compositor::FramePacingObserver> const frame_pacing_report;
+    std::shared_ptr<ObserverRegistrar<compositor::FramePacingObserver>> const frame_pacing_observer_multiplexer;
+    std::unique_ptr<metrics::OpenMetricsEndpoint> const metrics_endpoint;
+    std::shared_ptr<trace::FrameTimeline> const frame_timeline;
+    std::shared_ptr<FrameTimelineDump> const frame_timeline_dump;
+    std::unique_ptr<SnapshotEndpoint> const frame_timeline_endpoint;
+    std::unique_ptr<SnapshotEndpoint> const memory_accounting_endpoint;
 };
 }
 }
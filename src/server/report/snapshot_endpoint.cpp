@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "snapshot_endpoint.h"
+
+#include "mir/dispatch/readable_fd.h"
+#include "mir/dispatch/threaded_dispatcher.h"
+
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace mr = mir::report;
+namespace md = mir::dispatch;
+
+namespace
+{
+mir::Fd make_socket()
+{
+    mir::Fd socket{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (socket < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            boost::enable_error_info(
+                std::runtime_error("Failed to create socket")) << boost::errinfo_errno(errno));
+    }
+    return socket;
+}
+
+/// A socket left behind by an earlier server would make bind() fail. Anything
+/// else at the path, including a socket something still listens on, is left
+/// for bind() to report.
+void remove_if_stale(std::string const& socket_path, sockaddr_un const& address)
+{
+    struct stat info;
+    if (lstat(socket_path.c_str(), &info) != 0 || !S_ISSOCK(info.st_mode))
+        return;
+
+    auto const probe = make_socket();
+    if (connect(probe, reinterpret_cast<sockaddr const*>(&address), sizeof address) != 0 &&
+        errno == ECONNREFUSED)
+    {
+        unlink(socket_path.c_str());
+    }
+}
+
+mir::Fd listen_on(std::string const& socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof address.sun_path)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("Socket path is too long: " + socket_path));
+    strncpy(address.sun_path, socket_path.c_str(), sizeof address.sun_path - 1);
+
+    auto const socket = make_socket();
+    remove_if_stale(socket_path, address);
+
+    if (bind(socket, reinterpret_cast<sockaddr const*>(&address), sizeof address) != 0 ||
+        listen(socket, SOMAXCONN) != 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            boost::enable_error_info(
+                std::runtime_error("Failed to listen on socket " + socket_path)) << boost::errinfo_errno(errno));
+    }
+
+    return socket;
+}
+}
+
+mr::SnapshotEndpoint::SnapshotEndpoint(
+    std::string const& socket_path,
+    std::string const& thread_name,
+    std::function<void(std::ostream&)> const& write_snapshot) :
+    socket_path{socket_path},
+    write_snapshot{write_snapshot},
+    listener{listen_on(socket_path)},
+    dispatcher{std::make_unique<md::ThreadedDispatcher>(
+        thread_name,
+        std::make_shared<md::ReadableFd>(listener, [this] { serve_client(); }))}
+{
+}
+
+mr::SnapshotEndpoint::~SnapshotEndpoint() noexcept
+{
+    unlink(socket_path.c_str());
+}
+
+void mr::SnapshotEndpoint::serve_client()
+{
+    Fd const client{accept4(listener, nullptr, nullptr, SOCK_CLOEXEC)};
+    if (client < 0)
+        return;
+
+    // Don't let a client that stops reading hold up the clients behind it
+    timeval const timeout{1, 0};
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+
+    std::ostringstream snapshot;
+    write_snapshot(snapshot);
+    auto const text = snapshot.str();
+
+    for (size_t written = 0; written < text.size();)
+    {
+        auto const result = send(client, text.data() + written, text.size() - written, MSG_NOSIGNAL);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        written += result;
+    }
+}
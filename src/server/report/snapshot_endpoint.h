@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_SNAPSHOT_ENDPOINT_H_
+#define MIR_REPORT_SNAPSHOT_ENDPOINT_H_
+
+#include "mir/fd.h"
+
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace dispatch
+{
+class ThreadedDispatcher;
+}
+namespace report
+{
+/**
+ * Serves snapshots of diagnostic state on a Unix socket.
+ *
+ * Each client that connects is sent what write_snapshot writes at that moment,
+ * then disconnected, so e.g. "socat - UNIX-CONNECT:<path>" prints it.
+ */
+class SnapshotEndpoint
+{
+public:
+    SnapshotEndpoint(
+        std::string const& socket_path,
+        std::string const& thread_name,
+        std::function<void(std::ostream&)> const& write_snapshot);
+    ~SnapshotEndpoint() noexcept;
+
+private:
+    SnapshotEndpoint(SnapshotEndpoint const&) = delete;
+    SnapshotEndpoint& operator=(SnapshotEndpoint const&) = delete;
+
+    void serve_client();
+
+    std::string const socket_path;
+    std::function<void(std::ostream&)> const write_snapshot;
+    Fd const listener;
+    std::unique_ptr<dispatch::ThreadedDispatcher> const dispatcher;
+};
+}
+}
+
+#endif // MIR_REPORT_SNAPSHOT_ENDPOINT_H_
@@ -364,13 +364,13 @@ bool ms::BasicSurface::input_area_contains(geom::Point const& point) const
 {
     std::unique_lock<std::mutex> lock(guard);
 
-    if (!visible(lock))
+    // The input region is clipped to the surface, so input_bounds() bounds it
+    if (!visible(lock) || !surface_rect.contains(point))
         return false;
 
     if (custom_input_rectangles.empty())
     {
-        // no custom input, restrict to bounding rectangle
-        return surface_rect.contains(point);
+        return true;
     }
     else
     {
@@ -435,6 +435,18 @@ void ms::BasicSurface::set_reception_mode(mi::InputReceptionMode mode)
     observers.reception_mode_set_to(mode);
 }
 
+mi::MotionCoalescing ms::BasicSurface::motion_coalescing() const
+{
+    std::lock_guard<std::mutex> lk(guard);
+    return coalescing;
+}
+
+void ms::BasicSurface::set_motion_coalescing(mi::MotionCoalescing mode)
+{
+    std::lock_guard<std::mutex> lk(guard);
+    coalescing = mode;
+}
+
 MirWindowType ms::BasicSurface::type() const
 {
     std::unique_lock<std::mutex> lg(guard);
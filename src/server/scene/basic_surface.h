@@ -90,6 +90,8 @@ public:
 
     input::InputReceptionMode reception_mode() const override;
     void set_reception_mode(input::InputReceptionMode mode) override;
+    input::MotionCoalescing motion_coalescing() const override;
+    void set_motion_coalescing(input::MotionCoalescing mode) override;
 
     void set_input_region(std::vector<geometry::Rectangle> const& input_rectangles) override;
 
@@ -159,6 +161,7 @@ private:
     float surface_alpha;
     bool hidden;
     input::InputReceptionMode input_mode;
+    input::MotionCoalescing coalescing{input::MotionCoalescing::none};
     std::vector<geometry::Rectangle> custom_input_rectangles;
     std::shared_ptr<compositor::BufferStream> const surface_buffer_stream;
     std::shared_ptr<graphics::CursorImage> cursor_image_;
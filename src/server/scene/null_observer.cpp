@@ -23,5 +23,6 @@ namespace ms = mir::scene;
 void ms::NullObserver::surface_added(ms::Surface* /* surface */) {}
 void ms::NullObserver::surface_removed(ms::Surface* /* surface */) {}
 void ms::NullObserver::surfaces_reordered() {}
+void ms::NullObserver::scene_damaged(mir::geometry::Rectangle const& /* damage */) {}
 void ms::NullObserver::surface_exists(ms::Surface* /* surface */) {}
 void ms::NullObserver::end_observation() {}
@@ -0,0 +1,174 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "surface_spatial_index.h"
+
+#include <algorithm>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+
+namespace
+{
+// A surface covering more cells than this (e.g. a fullscreen one with a
+// small cell size) is cheaper to test directly on every query
+int const max_cells_per_surface = 256;
+
+int floor_div(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value - 1) / divisor) - 1;
+}
+}
+
+std::size_t constexpr ms::SurfaceSpatialIndex::npos;
+
+ms::SurfaceSpatialIndex::SurfaceSpatialIndex(int cell_size) :
+    cell_size{cell_size}
+{
+}
+
+void ms::SurfaceSpatialIndex::clear()
+{
+    cells.clear();
+    oversized.clear();
+    indexed.clear();
+}
+
+void ms::SurfaceSpatialIndex::insert(
+    Surface const* surface, std::size_t position, geom::Rectangle const& bounds)
+{
+    Candidate const candidate{position, bounds};
+
+    auto const existing = indexed.find(surface);
+    if (existing != indexed.end())
+    {
+        remove(existing->second);
+        existing->second = candidate;
+    }
+    else
+    {
+        indexed.emplace(surface, candidate);
+    }
+
+    add(candidate);
+}
+
+void ms::SurfaceSpatialIndex::update(Surface const* surface, geom::Rectangle const& bounds)
+{
+    auto const existing = indexed.find(surface);
+    if (existing == indexed.end() || existing->second.bounds == bounds)
+        return;
+
+    remove(existing->second);
+    existing->second.bounds = bounds;
+    add(existing->second);
+}
+
+auto ms::SurfaceSpatialIndex::cells_covering(geom::Rectangle const& bounds) const -> Span
+{
+    auto const bottom_right = bounds.bottom_right();
+    return Span{
+        floor_div(bounds.top_left.x.as_int(), cell_size),
+        floor_div(bounds.top_left.y.as_int(), cell_size),
+        floor_div(bottom_right.x.as_int() - 1, cell_size),
+        floor_div(bottom_right.y.as_int() - 1, cell_size)};
+}
+
+bool ms::SurfaceSpatialIndex::is_oversized(Span const& span) const
+{
+    auto const columns = static_cast<long long>(span.last_x) - span.first_x + 1;
+    auto const rows = static_cast<long long>(span.last_y) - span.first_y + 1;
+    return columns * rows > max_cells_per_surface;
+}
+
+auto ms::SurfaceSpatialIndex::cell_at(geom::Point const& point) const -> Candidates const&
+{
+    static Candidates const none;
+
+    auto const cell = cells.find(key(
+        floor_div(point.x.as_int(), cell_size),
+        floor_div(point.y.as_int(), cell_size)));
+
+    return cell != cells.end() ? cell->second : none;
+}
+
+void ms::SurfaceSpatialIndex::add(Candidate const& candidate)
+{
+    auto const by_position = [](Candidate const& lhs, Candidate const& rhs)
+        { return lhs.position < rhs.position; };
+
+    auto const span = cells_covering(candidate.bounds);
+    if (span.empty())
+        return;
+
+    if (is_oversized(span))
+    {
+        oversized.insert(
+            std::upper_bound(oversized.begin(), oversized.end(), candidate, by_position),
+            candidate);
+        return;
+    }
+
+    for (auto y = span.first_y; y <= span.last_y; ++y)
+    {
+        for (auto x = span.first_x; x <= span.last_x; ++x)
+        {
+            auto& cell = cells[key(x, y)];
+            cell.insert(std::upper_bound(cell.begin(), cell.end(), candidate, by_position), candidate);
+        }
+    }
+}
+
+void ms::SurfaceSpatialIndex::remove(Candidate const& candidate)
+{
+    auto const erase_from = [&](Candidates& candidates)
+        {
+            candidates.erase(
+                std::remove_if(candidates.begin(), candidates.end(),
+                    [&](Candidate const& c) { return c.position == candidate.position; }),
+                candidates.end());
+        };
+
+    auto const span = cells_covering(candidate.bounds);
+    if (span.empty())
+        return;
+
+    if (is_oversized(span))
+    {
+        erase_from(oversized);
+        return;
+    }
+
+    for (auto y = span.first_y; y <= span.last_y; ++y)
+    {
+        for (auto x = span.first_x; x <= span.last_x; ++x)
+        {
+            auto const cell = cells.find(key(x, y));
+            if (cell == cells.end())
+                continue;
+
+            erase_from(cell->second);
+            if (cell->second.empty())
+                cells.erase(cell);
+        }
+    }
+}
+
+std::uint64_t ms::SurfaceSpatialIndex::key(int cell_x, int cell_y)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell_x)) << 32) |
+        static_cast<std::uint32_t>(cell_y);
+}
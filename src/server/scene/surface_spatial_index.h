@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_SURFACE_SPATIAL_INDEX_H_
+#define MIR_SCENE_SURFACE_SPATIAL_INDEX_H_
+
+#include "mir/geometry/rectangle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace scene
+{
+class Surface;
+
+/**
+ * A uniform grid over the input bounds of the surfaces in a stack, used to
+ * find the surfaces that might be under a point without visiting them all.
+ *
+ * Surfaces are identified by their position in the stack (zero being the
+ * bottom) and queries visit candidates from the top down. The index does
+ * no locking of its own.
+ */
+class SurfaceSpatialIndex
+{
+public:
+    static std::size_t constexpr npos = std::numeric_limits<std::size_t>::max();
+
+    explicit SurfaceSpatialIndex(int cell_size = 128);
+
+    void clear();
+    void insert(Surface const* surface, std::size_t position, geometry::Rectangle const& bounds);
+    /// Moves an indexed surface to new bounds, keeping its place in the stack
+    void update(Surface const* surface, geometry::Rectangle const& bounds);
+
+    /**
+     * Offers the position of each surface whose bounds contain point to
+     * accept(), topmost first, until accept() returns true.
+     * \returns the accepted position, or npos if none was
+     */
+    template<typename Accept>
+    std::size_t topmost_at(geometry::Point const& point, Accept&& accept) const;
+
+private:
+    struct Candidate
+    {
+        std::size_t position;
+        geometry::Rectangle bounds;
+    };
+    /// Ordered bottom to top
+    using Candidates = std::vector<Candidate>;
+
+    struct Span
+    {
+        int first_x, first_y, last_x, last_y;
+        bool empty() const { return last_x < first_x || last_y < first_y; }
+    };
+
+    Span cells_covering(geometry::Rectangle const& bounds) const;
+    bool is_oversized(Span const& span) const;
+    Candidates const& cell_at(geometry::Point const& point) const;
+    void add(Candidate const& candidate);
+    void remove(Candidate const& candidate);
+
+    static std::uint64_t key(int cell_x, int cell_y);
+
+    int const cell_size;
+    std::unordered_map<std::uint64_t, Candidates> cells;
+    /// Surfaces spanning too many cells to be worth gridding
+    Candidates oversized;
+    std::unordered_map<Surface const*, Candidate> indexed;
+};
+
+template<typename Accept>
+std::size_t SurfaceSpatialIndex::topmost_at(geometry::Point const& point, Accept&& accept) const
+{
+    auto const& local = cell_at(point);
+
+    auto l = local.rbegin();
+    auto o = oversized.rbegin();
+    while (l != local.rend() || o != oversized.rend())
+    {
+        auto const& candidate =
+            (o == oversized.rend() || (l != local.rend() && l->position > o->position)) ? *l++ : *o++;
+
+        if (candidate.bounds.contains(point) && accept(candidate.position))
+            return candidate.position;
+    }
+
+    return npos;
+}
+}
+}
+
+#endif /* MIR_SCENE_SURFACE_SPATIAL_INDEX_H_ */
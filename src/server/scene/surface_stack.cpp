@@ -20,7 +20,9 @@
 
 #include "surface_stack.h"
 #include "rendering_tracker.h"
+#include "surface_spatial_index.h"
 #include "mir/scene/surface.h"
+#include "mir/scene/null_surface_observer.h"
 #include "mir/scene/scene_report.h"
 #include "mir/compositor/scene_element.h"
 #include "mir/graphics/renderable.h"
@@ -39,6 +41,50 @@ namespace mg = mir::graphics;
 namespace mi = mir::input;
 namespace geom = mir::geometry;
 
+struct ms::SurfaceStack::InputIndex
+{
+    std::mutex mutex;
+    SurfaceSpatialIndex index;
+    bool stale{true};
+
+    void invalidate()
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        stale = true;
+        index.clear();
+    }
+};
+
+class ms::SurfaceStack::InputBoundsTracker : public ms::NullSurfaceObserver
+{
+public:
+    InputBoundsTracker(
+        std::weak_ptr<InputIndex> const& input_index,
+        ms::Surface const* surface) :
+        input_index{input_index},
+        surface{surface}
+    {
+    }
+
+    void moved_to(geom::Point const&) override { update(); }
+    void resized_to(geom::Size const&) override { update(); }
+
+private:
+    void update()
+    {
+        if (auto const locked = input_index.lock())
+        {
+            // Read the bounds under the index lock so updates can't be reordered
+            std::lock_guard<decltype(locked->mutex)> lock{locked->mutex};
+            if (!locked->stale)
+                locked->index.update(surface, surface->input_bounds());
+        }
+    }
+
+    std::weak_ptr<InputIndex> const input_index;
+    ms::Surface const* const surface;
+};
+
 namespace
 {
 
@@ -111,7 +157,8 @@ private:
 ms::SurfaceStack::SurfaceStack(
     std::shared_ptr<SceneReport> const& report) :
     report{report},
-    scene_changed{false}
+    scene_changed{false},
+    input_index{std::make_shared<InputIndex>()}
 {
 }
 
@@ -221,14 +268,26 @@ void ms::SurfaceStack::emit_scene_changed()
     observers.scene_changed();
 }
 
+void ms::SurfaceStack::emit_scene_damaged(geometry::Rectangle const& damage)
+{
+    observers.scene_damaged(damage);
+}
+
 void ms::SurfaceStack::add_surface(
     std::shared_ptr<Surface> const& surface,
     mi::InputReceptionMode input_mode)
 {
+    // Track the surface's input bounds before it is published, so a move or
+    // resize between publishing it and attaching the tracker can't leave the
+    // index stale
+    auto const input_bounds_tracker = std::make_shared<InputBoundsTracker>(input_index, surface.get());
+    surface->add_observer(input_bounds_tracker);
     {
         RecursiveWriteLock lg(guard);
         surfaces.push_back(surface);
         create_rendering_tracker_for(surface);
+        input_bounds_trackers[surface.get()] = input_bounds_tracker;
+        input_index->invalidate();
     }
     surface->set_reception_mode(input_mode);
     observers.surface_added(surface.get());
@@ -241,6 +300,7 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
     auto const keep_alive = surface.lock();
 
     bool found_surface = false;
+    std::shared_ptr<SurfaceObserver> input_bounds_tracker;
     {
         RecursiveWriteLock lg(guard);
 
@@ -250,10 +310,20 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
         {
             surfaces.erase(surface);
             rendering_trackers.erase(keep_alive.get());
+            auto const tracker = input_bounds_trackers.find(keep_alive.get());
+            if (tracker != input_bounds_trackers.end())
+            {
+                input_bounds_tracker = tracker->second;
+                input_bounds_trackers.erase(tracker);
+            }
+            input_index->invalidate();
             found_surface = true;
         }
     }
 
+    if (input_bounds_tracker)
+        keep_alive->remove_observer(input_bounds_tracker);
+
     if (found_surface)
     {
         observers.surface_removed(keep_alive.get());
@@ -263,34 +333,39 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
     // TODO: error logging when surface not found
 }
 
-namespace
+auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
+-> std::shared_ptr<Surface>
 {
-template <typename Container>
-struct InReverse {
-    Container& container;
-    auto begin() -> decltype(container.rbegin()) { return container.rbegin(); }
-    auto end() -> decltype(container.rend()) { return container.rend(); }
-};
-
-template <typename Container>
-InReverse<Container> in_reverse(Container& container) { return InReverse<Container>{container}; }
+    // TODO There's a lack of clarity about how the input area will
+    // TODO be maintained and whether this test will detect clicks on
+    // TODO decorations (it should) as these may be outside the area
+    // TODO known to the client.  But it works for now.
+    return topmost_surface_containing(cursor);
 }
 
-auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
+auto ms::SurfaceStack::topmost_surface_containing(geometry::Point const& point) const
 -> std::shared_ptr<Surface>
 {
     RecursiveReadLock lg(guard);
-    for (auto const& surface : in_reverse(surfaces))
+    std::lock_guard<decltype(input_index->mutex)> lock{input_index->mutex};
+
+    if (input_index->stale)
     {
-        // TODO There's a lack of clarity about how the input area will
-        // TODO be maintained and whether this test will detect clicks on
-        // TODO decorations (it should) as these may be outside the area
-        // TODO known to the client.  But it works for now.
-        if (surface->input_area_contains(cursor))
-                return surface;
+        for (std::size_t position = 0; position != surfaces.size(); ++position)
+        {
+            auto const& surface = surfaces[position];
+            input_index->index.insert(surface.get(), position, surface->input_bounds());
+        }
+        input_index->stale = false;
     }
 
-    return {};
+    auto const position = input_index->index.topmost_at(point,
+        [&](std::size_t position) { return surfaces[position]->input_area_contains(point); });
+
+    if (position == SurfaceSpatialIndex::npos)
+        return {};
+
+    return surfaces[position];
 }
 
 void ms::SurfaceStack::for_each(std::function<void(std::shared_ptr<mi::Surface> const&)> const& callback)
@@ -302,6 +377,11 @@ void ms::SurfaceStack::for_each(std::function<void(std::shared_ptr<mi::Surface>
     }
 }
 
+std::shared_ptr<mi::Surface> ms::SurfaceStack::input_surface_at(geom::Point const& point)
+{
+    return topmost_surface_containing(point);
+}
+
 void ms::SurfaceStack::raise(std::weak_ptr<Surface> const& s)
 {
     bool surfaces_reordered{false};
@@ -316,6 +396,7 @@ void ms::SurfaceStack::raise(std::weak_ptr<Surface> const& s)
         {
             surfaces.erase(p);
             surfaces.push_back(surface);
+            input_index->invalidate();
             surfaces_reordered = true;
         }
     }
@@ -339,7 +420,10 @@ void ms::SurfaceStack::raise(SurfaceSet const& ss)
             [&](std::weak_ptr<Surface> const& s) { return !ss.count(s); });
 
         if (old_surfaces != surfaces)
+        {
+            input_index->invalidate();
             surfaces_reordered = true;
+        }
     }
 
     if (surfaces_reordered)
@@ -410,6 +494,12 @@ void ms::Observers::scene_changed()
         { observer->scene_changed(); });
 }
 
+void ms::Observers::scene_damaged(geometry::Rectangle const& damage)
+{
+   for_each([&](std::shared_ptr<Observer> const& observer)
+        { observer->scene_damaged(damage); });
+}
+
 void ms::Observers::surface_exists(ms::Surface* surface)
 {
     for_each([&](std::shared_ptr<Observer> const& observer)
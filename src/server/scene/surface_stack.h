@@ -46,6 +46,7 @@ class Renderable;
 namespace scene
 {
 class BasicSurface;
+class SurfaceObserver;
 class SceneReport;
 class RenderingTracker;
 
@@ -57,6 +58,7 @@ public:
    void surface_removed(Surface* surface) override;
    void surfaces_reordered() override;
    void scene_changed() override;
+   void scene_damaged(geometry::Rectangle const& damage) override;
    void surface_exists(Surface* surface) override;
    void end_observation() override;
 
@@ -79,6 +81,7 @@ public:
 
     // From Scene
     void for_each(std::function<void(std::shared_ptr<input::Surface> const&)> const& callback) override;
+    std::shared_ptr<input::Surface> input_surface_at(geometry::Point const& point) override;
 
     virtual void remove_surface(std::weak_ptr<Surface> const& surface) override;
 
@@ -100,12 +103,14 @@ public:
     void remove_input_visualization(std::weak_ptr<graphics::Renderable> const& overlay) override;
     
     void emit_scene_changed() override;
+    void emit_scene_damaged(geometry::Rectangle const& damage) override;
 
 private:
     SurfaceStack(const SurfaceStack&) = delete;
     SurfaceStack& operator=(const SurfaceStack&) = delete;
     void create_rendering_tracker_for(std::shared_ptr<Surface> const&);
     void update_rendering_tracker_compositors();
+    auto topmost_surface_containing(geometry::Point const& point) const -> std::shared_ptr<Surface>;
 
     RecursiveReadWriteMutex mutable guard;
 
@@ -119,6 +124,13 @@ private:
 
     Observers observers;
     std::atomic<bool> scene_changed;
+
+    /// Spatial index over surface input bounds, rebuilt after restacking
+    /// and updated in place as surfaces move or resize
+    struct InputIndex;
+    class InputBoundsTracker;
+    std::shared_ptr<InputIndex> const input_index;
+    std::map<Surface*, std::shared_ptr<SurfaceObserver>> input_bounds_trackers;
 };
 
 }
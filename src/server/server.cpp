@@ -135,7 +135,9 @@ struct TemporaryCompositeEventFilter : public mi::CompositeEventFilter
     MACRO(the_persistent_surface_store)\
     MACRO(the_display_configuration_observer_registrar)\
     MACRO(the_seat_observer_registrar)\
-    MACRO(the_session_mediator_observer_registrar)
+    MACRO(the_input_latency)\
+    MACRO(the_session_mediator_observer_registrar)\
+    MACRO(the_frame_pacing_observer_registrar)
 
 #define MIR_SERVER_BUILDER(name)\
     std::function<std::result_of<decltype(&mir::DefaultServerConfiguration::the_##name)(mir::DefaultServerConfiguration*)>::type()> name##_builder;
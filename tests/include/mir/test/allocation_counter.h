@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_ALLOCATION_COUNTER_H_
+#define MIR_TEST_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace mir
+{
+namespace test
+{
+/**
+ * @brief Counts the heap allocations made by the calling thread
+ *
+ * The mir-test-allocation-counter objects interpose malloc() and friends,
+ * including the aligned allocators, for the binary they are linked into (they
+ * are deliberately not part of mir-test-static), so allocations made through
+ * operator new and by C libraries (capnproto segments, for instance) are all
+ * seen. Only the constructing thread is counted, from construction onwards.
+ * Under valgrind its allocator takes precedence and nothing is counted.
+ */
+class AllocationCounter
+{
+public:
+    AllocationCounter();
+
+    std::size_t count() const;
+
+private:
+    std::size_t const start;
+};
+}
+}
+
+#endif /* MIR_TEST_ALLOCATION_COUNTER_H_ */
@@ -80,6 +80,8 @@ struct MockBufferStream : public compositor::BufferStream
     MOCK_METHOD1(disassociate_buffer, void(graphics::BufferID));
     MOCK_METHOD1(associate_buffer, void(graphics::BufferID));
     MOCK_METHOD1(set_scale, void(float));
+    MOCK_METHOD1(set_queue_depth, void(unsigned int));
+    MOCK_CONST_METHOD0(queue_depth, unsigned int());
 
 };
 }
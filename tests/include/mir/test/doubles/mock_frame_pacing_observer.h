@@ -0,0 +1,43 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_DOUBLES_MOCK_FRAME_PACING_OBSERVER_H_
+#define MIR_TEST_DOUBLES_MOCK_FRAME_PACING_OBSERVER_H_
+
+#include "mir/compositor/frame_pacing_observer.h"
+#include <gmock/gmock.h>
+
+namespace mir
+{
+namespace test
+{
+namespace doubles
+{
+
+class MockFramePacingObserver : public compositor::FramePacingObserver
+{
+public:
+    MOCK_METHOD2(missed_deadline, void(graphics::DisplayConfigurationOutputId, unsigned));
+    MOCK_METHOD1(repeated_frame, void(graphics::DisplayConfigurationOutputId));
+    MOCK_METHOD1(client_frame_dropped, void(compositor::BufferStream const*));
+    MOCK_METHOD2(client_frame_rate, void(compositor::BufferStream const*, float));
+};
+
+} // namespace doubles
+} // namespace test
+} // namespace mir
+
+#endif
@@ -19,6 +19,8 @@
 #define MIR_TEST_DOUBLES_MOCK_RENDERER_H_
 
 #include "mir/renderer/renderer.h"
+#include "mir/renderer/fence.h"
+#include "mir/test/gmock_fixes.h"
 
 #include <gmock/gmock.h>
 
@@ -35,6 +37,7 @@ struct MockRenderer : public renderer::Renderer
     MOCK_METHOD1(set_output_transform, void(glm::mat2 const&));
     MOCK_CONST_METHOD1(render, void(graphics::RenderableList const&));
     MOCK_METHOD0(suspend, void());
+    MOCK_CONST_METHOD0(fence_frame, std::unique_ptr<renderer::Fence>());
 
     ~MockRenderer() noexcept {}
 };
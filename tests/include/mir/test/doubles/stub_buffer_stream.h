@@ -80,6 +80,8 @@ public:
     void remove_observer(std::weak_ptr<scene::SurfaceObserver> const&) override {}
     bool has_submitted_buffer() const override { return true; }
     void set_scale(float) override {}
+    void set_queue_depth(unsigned int) override {}
+    unsigned int queue_depth() const override { return 0; }
 
     std::shared_ptr<graphics::Buffer> stub_compositor_buffer;
     int nready = 0;
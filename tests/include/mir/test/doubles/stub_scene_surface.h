@@ -36,12 +36,18 @@ class StubSceneSurface :
 {
 public:
     mir::input::InputReceptionMode input_mode{mir::input::InputReceptionMode::normal};
+    mir::input::MotionCoalescing coalescing{mir::input::MotionCoalescing::none};
 
     mir::input::InputReceptionMode reception_mode() const override
     {
         return input_mode;
     }
 
+    mir::input::MotionCoalescing motion_coalescing() const override
+    {
+        return coalescing;
+    }
+
     std::string name() const override { return {}; }
     geometry::Point top_left() const override { return {}; }
     geometry::Size client_size() const override { return {};}
@@ -70,6 +76,7 @@ public:
     void remove_observer(std::weak_ptr<scene::SurfaceObserver> const&) override {}
 
     void set_reception_mode(input::InputReceptionMode mode) override { input_mode = mode; }
+    void set_motion_coalescing(input::MotionCoalescing mode) override { coalescing = mode; }
     void consume(MirEvent const*) override {}
 
     void set_cursor_image(std::shared_ptr<graphics::CursorImage> const& /* image */) override {}
@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_EXPECT_NO_ALLOCATIONS_H_
+#define MIR_TEST_EXPECT_NO_ALLOCATIONS_H_
+
+#include "mir/test/allocation_counter.h"
+#include "mir/trace/allocation_profile.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace mir
+{
+namespace test
+{
+/// The MIR_ALLOC_PROFILING_SCOPE() site named \p name, once its path has run
+inline mir::trace::AllocationSite const* marked_allocation_site(char const* name)
+{
+    for (auto site = mir::trace::allocation_sites(); site; site = site->next)
+    {
+        if (strcmp(site->name, name) == 0)
+            return site;
+    }
+
+    return nullptr;
+}
+
+/// Allocations charged to every marked hot path so far, on any thread
+inline uint64_t allocations_in_marked_paths()
+{
+    uint64_t total{0};
+    for (auto site = mir::trace::allocation_sites(); site; site = site->next)
+        total += site->allocations.load();
+
+    return total;
+}
+}
+}
+
+/**
+ * Expects the statements to run without touching the heap.
+ *
+ * Allocations by the calling thread are counted in any build. In a
+ * MIR_ALLOC_PROFILING build, allocations that other threads (a compositor,
+ * say) charge to marked hot paths while the statements run count too.
+ *
+ * Run the statements once beforehand when they warm pools or caches: only
+ * steady-state behaviour is worth enforcing.
+ */
+#define EXPECT_NO_ALLOCATIONS_IN(...) \
+    do \
+    { \
+        auto const mir_test_marked_before = ::mir::test::allocations_in_marked_paths(); \
+        ::mir::test::AllocationCounter const mir_test_allocations; \
+        __VA_ARGS__; \
+        auto const mir_test_allocation_count = mir_test_allocations.count(); \
+        auto const mir_test_marked_count = ::mir::test::allocations_in_marked_paths() - mir_test_marked_before; \
+        EXPECT_EQ(0u, mir_test_allocation_count) << "heap allocations in: " #__VA_ARGS__; \
+        EXPECT_EQ(0u, mir_test_marked_count) << "heap allocations in marked hot paths during: " #__VA_ARGS__; \
+    } while (false)
+
+#endif /* MIR_TEST_EXPECT_NO_ALLOCATIONS_H_ */
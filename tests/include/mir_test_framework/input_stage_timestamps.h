@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_FRAMEWORK_INPUT_STAGE_TIMESTAMPS_H_
+#define MIR_TEST_FRAMEWORK_INPUT_STAGE_TIMESTAMPS_H_
+
+#include "mir_toolkit/event.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace input
+{
+class EventFilter;
+}
+namespace scene
+{
+class SurfaceObserver;
+}
+}
+
+namespace mir_test_framework
+{
+/**
+ * Collects how long after its event time an input event reached each stage of
+ * the input path. With the replay input platform the event time is when the
+ * device emitted the event, so each stage measures device -> stage latency:
+ *  - dispatcher: the event left the seat and entered the dispatcher chain
+ *                (the seat itself has no synchronous observation point)
+ *  - sent: the event was handed to the client's connection
+ *  - client_received: reported by the test client via mark()
+ */
+class InputStageTimestamps
+{
+public:
+    enum class Stage
+    {
+        dispatcher,
+        sent,
+        client_received
+    };
+
+    struct Summary
+    {
+        size_t count;
+        std::chrono::nanoseconds min;
+        std::chrono::nanoseconds median;
+        std::chrono::nanoseconds p99;
+        std::chrono::nanoseconds max;
+    };
+
+    void mark(Stage stage, MirInputEvent const* event);
+    Summary summary(Stage stage) const;
+
+    /// To be prepended to the server's composite event filter
+    std::shared_ptr<mir::input::EventFilter> dispatcher_probe();
+    /// To be added as an observer of the surface receiving the input
+    std::shared_ptr<mir::scene::SurfaceObserver> sent_probe();
+
+private:
+    static size_t constexpr stage_count = 3;
+
+    std::mutex mutable mutex;
+    std::array<std::vector<std::chrono::nanoseconds>, stage_count> latencies;
+};
+}
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_FRAMEWORK_REPLAY_INPUT_PLATFORM_H_
+#define MIR_TEST_FRAMEWORK_REPLAY_INPUT_PLATFORM_H_
+
+#include "mir/input/platform.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace mir
+{
+namespace dispatch
+{
+class ActionQueue;
+class MultiplexingDispatchable;
+}
+namespace input
+{
+struct InputRecord;
+}
+}
+namespace mir_test_framework
+{
+/**
+ * Feeds an input recording (see mir::input::InputRecordingWriter) back
+ * through the device hub, with the devices and timing it was recorded with.
+ *
+ * Events are rebuilt by each device's EventBuilder so that they carry the
+ * replay time as their event time: the latency of every later stage can be
+ * measured against that. A speed of 2 replays twice as fast as recorded and a
+ * speed of 0 replays without any pauses, for throughput measurements.
+ */
+class ReplayInputPlatform : public mir::input::Platform
+{
+public:
+    ReplayInputPlatform(std::shared_ptr<mir::input::InputDeviceRegistry> const& input_device_registry,
+                        std::string const& recording,
+                        double speed);
+    ~ReplayInputPlatform();
+
+    std::shared_ptr<mir::dispatch::Dispatchable> dispatchable() override;
+    void start() override;
+    void stop() override;
+    void pause_for_config() override;
+    void continue_after_config() override;
+
+private:
+    class Device;
+
+    void replay(unsigned run);
+    void replay(mir::input::InputRecord const& record);
+    bool replaying(unsigned run);
+
+    std::shared_ptr<mir::dispatch::MultiplexingDispatchable> const platform_dispatchable;
+    std::shared_ptr<mir::dispatch::ActionQueue> const platform_queue;
+    std::shared_ptr<mir::input::InputDeviceRegistry> const registry;
+    std::string const recording;
+    double const speed;
+
+    /// Only touched on the input thread
+    std::unordered_map<uint32_t, std::shared_ptr<Device>> devices;
+
+    std::mutex mutex;
+    std::condition_variable stop_requested;
+    bool stopping{false};
+    /// Identifies the current start()..stop() run, so actions it left queued are dropped
+    unsigned current_run{0};
+    std::thread replay_thread;
+};
+
+}
+
+#endif
@@ -0,0 +1,254 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/memory/accounting.h"
+#include "mir_toolkit/mir_client_library.h"
+#include "mir_toolkit/mir_buffer.h"
+
+#include "mir_test_framework/any_surface.h"
+#include "mir_test_framework/in_process_server.h"
+#include "mir_test_framework/testing_server_configuration.h"
+#include "mir_test_framework/temporary_environment_value.h"
+#include "mir/test/signal.h"
+#include "mir/test/spin_wait.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+namespace mm = mir::memory;
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+namespace geom = mir::geometry;
+
+using namespace testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+geom::Size const window_size{320, 240};
+size_t const buffer_bytes = 320 * 240 * 4;
+// The client library's default buffer count for a stream
+unsigned const buffers_per_stream = 3;
+
+struct Client
+{
+    Client(std::string const& connect_string, std::string const& name) :
+        connection{mir_connect_sync(connect_string.c_str(), name.c_str())},
+        window{mtf::make_surface(connection, window_size, mir_pixel_format_abgr_8888)}
+    {
+    }
+
+    ~Client()
+    {
+        mir_window_release_sync(window);
+        mir_connection_release(connection);
+    }
+
+    void swap_buffers()
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        mir_buffer_stream_swap_buffers_sync(mir_window_get_buffer_stream(window));
+#pragma GCC diagnostic pop
+    }
+
+    MirConnection* const connection;
+    MirWindow* const window;
+};
+
+struct MemoryAccounting : mtf::InProcessServer
+{
+    MemoryAccounting() = default;
+
+    explicit MemoryAccounting(std::vector<std::unique_ptr<mtf::TemporaryEnvironmentValue>>&& environment) :
+        server_configuration{{{{0, 0}, {1920, 1080}}}, std::move(environment)}
+    {
+    }
+
+    mir::DefaultServerConfiguration& server_config() override
+    {
+        return server_configuration;
+    }
+
+    std::vector<mm::Accounting::AccountUsage> client_accounts()
+    {
+        auto accounts = server_configuration.the_memory_accounting()->snapshot();
+        accounts.erase(accounts.begin());
+        return accounts;
+    }
+
+    mm::Accounting::AccountUsage server_account()
+    {
+        return server_configuration.the_memory_accounting()->snapshot().front();
+    }
+
+    static size_t retained_ipc_resources(mm::Accounting::AccountUsage const& account)
+    {
+        return account.usage[static_cast<unsigned>(mm::Subsystem::ipc_resources)].allocations;
+    }
+
+    void run_clients(unsigned client_count, unsigned frames)
+    {
+        {
+            std::vector<std::unique_ptr<Client>> clients;
+            for (unsigned i = 0; i != client_count; ++i)
+                clients.push_back(std::make_unique<Client>(new_connection(), "client-" + std::to_string(i)));
+
+            for (unsigned frame = 0; frame != frames; ++frame)
+                for (auto const& client : clients)
+                    client->swap_buffers();
+
+            auto const accounts = client_accounts();
+            ASSERT_THAT(accounts.size(), Eq(client_count));
+            for (auto const& account : accounts)
+            {
+                auto const& shm = account.usage[static_cast<unsigned>(mm::Subsystem::shm_buffers)];
+                auto const& hardware = account.usage[static_cast<unsigned>(mm::Subsystem::hardware_buffers)];
+
+                EXPECT_THAT(shm.allocations + hardware.allocations, Eq(buffers_per_stream)) << account.name;
+                EXPECT_THAT(account.total_bytes, Eq(buffers_per_stream * buffer_bytes)) << account.name;
+            }
+        }
+
+        EXPECT_TRUE(mt::spin_wait_for_condition_or_timeout(
+            [this] { return client_accounts().empty(); },
+            std::chrono::seconds{3}));
+
+        EXPECT_TRUE(mt::spin_wait_for_condition_or_timeout(
+            [this] { return retained_ipc_resources(server_account()) == 0; },
+            std::chrono::seconds{3}));
+    }
+
+    mtf::TestingServerConfiguration server_configuration;
+};
+
+std::vector<std::unique_ptr<mtf::TemporaryEnvironmentValue>> one_mib_quota(char const* action)
+{
+    std::vector<std::unique_ptr<mtf::TemporaryEnvironmentValue>> environment;
+    environment.push_back(std::make_unique<mtf::TemporaryEnvironmentValue>("MIR_SERVER_MEMORY_QUOTA", "1"));
+    environment.push_back(std::make_unique<mtf::TemporaryEnvironmentValue>("MIR_SERVER_MEMORY_QUOTA_ACTION", action));
+    return environment;
+}
+
+struct MemoryQuota : MemoryAccounting
+{
+    explicit MemoryQuota(char const* action) :
+        MemoryAccounting{one_mib_quota(action)}
+    {
+    }
+
+    MirBuffer* allocate_buffer_sync(MirConnection* connection, geom::Size size)
+    {
+        return mir_connection_allocate_buffer_sync(
+            connection, size.width.as_int(), size.height.as_int(), mir_pixel_format_abgr_8888);
+    }
+
+    // Well within the quota, and well over it
+    geom::Size const small_buffer{256, 256};
+    geom::Size const large_buffer{1024, 1024};
+};
+
+struct RejectingMemoryQuota : MemoryQuota
+{
+    RejectingMemoryQuota() : MemoryQuota{"reject"} {}
+};
+
+struct DisconnectingMemoryQuota : MemoryQuota
+{
+    DisconnectingMemoryQuota() : MemoryQuota{"disconnect"} {}
+};
+}
+
+// The heap profiles of a real server and clients are still taken by the
+// massif runs in benchmarks/memory; these check that, with the same client
+// counts and frames, the accounting attributes exactly the stream buffers.
+TEST_F(MemoryAccounting, one_client_holds_only_its_stream_buffers)
+{
+    run_clients(1, 100);
+}
+
+TEST_F(MemoryAccounting, multiple_clients_each_hold_only_their_stream_buffers)
+{
+    run_clients(10, 100);
+}
+
+TEST_F(MemoryAccounting, heavy_load_of_clients_each_hold_only_their_stream_buffers)
+{
+    run_clients(20, 100);
+}
+
+TEST_F(MemoryAccounting, nothing_is_held_for_clients_after_they_disconnect)
+{
+    for (int i = 0; i != 5; ++i)
+        run_clients(2, 10);
+
+    EXPECT_THAT(client_accounts(), IsEmpty());
+    EXPECT_THAT(retained_ipc_resources(server_account()), Eq(0u));
+}
+
+TEST_F(RejectingMemoryQuota, a_client_over_its_quota_is_sent_an_error_buffer)
+{
+    auto const connection = mir_connect_sync(new_connection().c_str(), "greedy");
+    ASSERT_TRUE(mir_connection_is_valid(connection));
+
+    auto const within_quota = allocate_buffer_sync(connection, small_buffer);
+    auto const over_quota = allocate_buffer_sync(connection, large_buffer);
+
+    EXPECT_TRUE(mir_buffer_is_valid(within_quota));
+    EXPECT_FALSE(mir_buffer_is_valid(over_quota));
+    EXPECT_TRUE(mir_connection_is_valid(connection));
+
+    auto const accounts = client_accounts();
+    ASSERT_THAT(accounts.size(), Eq(1u));
+    EXPECT_THAT(accounts.front().total_bytes, Eq(size_t{256 * 256 * 4}));
+
+    mir_buffer_release(over_quota);
+    mir_buffer_release(within_quota);
+    mir_connection_release(connection);
+}
+
+TEST_F(DisconnectingMemoryQuota, a_client_over_its_quota_is_disconnected)
+{
+    auto const connection = mir_connect_sync(new_connection().c_str(), "greedy");
+    ASSERT_TRUE(mir_connection_is_valid(connection));
+
+    mt::Signal connection_lost;
+    mir_connection_set_lifecycle_event_callback(
+        connection,
+        [](MirConnection*, MirLifecycleState state, void* context)
+        {
+            if (state == mir_lifecycle_connection_lost)
+                static_cast<mt::Signal*>(context)->raise();
+        },
+        &connection_lost);
+
+    auto const within_quota = allocate_buffer_sync(connection, small_buffer);
+    EXPECT_TRUE(mir_buffer_is_valid(within_quota));
+
+    mir_connection_allocate_buffer(
+        connection, large_buffer.width.as_int(), large_buffer.height.as_int(), mir_pixel_format_abgr_8888,
+        [](MirBuffer*, void*) {}, nullptr);
+
+    EXPECT_TRUE(connection_lost.wait_for(10s));
+    EXPECT_TRUE(mt::spin_wait_for_condition_or_timeout(
+        [this] { return client_accounts().empty(); },
+        std::chrono::seconds{3}));
+
+    mir_buffer_release(within_quota);
+    mir_connection_release(connection);
+}
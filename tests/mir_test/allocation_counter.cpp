@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/test/allocation_counter.h"
+
+#include <cerrno>
+#include <cstdlib>
+
+namespace mt = mir::test;
+
+namespace
+{
+// Plain thread-local data: reading it must not itself allocate
+thread_local std::size_t allocations{0};
+}
+
+extern "C"
+{
+// glibc's own entry points, so the wrappers below needn't look them up
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+
+void* malloc(std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_realloc(ptr, size);
+}
+
+// glibc's aligned allocators don't go through malloc(), so are counted here too
+void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    ++allocations;
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** memptr, std::size_t alignment, std::size_t size) noexcept
+{
+    // The checks __libc_memalign() doesn't make
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    ++allocations;
+    auto const result = __libc_memalign(alignment, size);
+    if (!result)
+        return ENOMEM;
+
+    *memptr = result;
+    return 0;
+}
+}
+
+mt::AllocationCounter::AllocationCounter()
+    : start{allocations}
+{
+}
+
+std::size_t mt::AllocationCounter::count() const
+{
+    return allocations - start;
+}
@@ -550,6 +550,12 @@ int drmModeConnectorSetProperty(int fd, uint32_t connector_id, uint32_t property
     return global_mock->drmModeConnectorSetProperty(fd, connector_id, property_id, value);
 }
 
+int drmModeObjectSetProperty(int fd, uint32_t object_id, uint32_t object_type,
+                             uint32_t property_id, uint64_t value)
+{
+    return global_mock->drmModeObjectSetProperty(fd, object_id, object_type, property_id, value);
+}
+
 void drmModeFreeConnector(drmModeConnectorPtr ptr)
 {
     global_mock->drmModeFreeConnector(ptr);
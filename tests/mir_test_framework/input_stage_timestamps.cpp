@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_test_framework/input_stage_timestamps.h"
+
+#include "mir/input/event_filter.h"
+#include "mir/scene/null_surface_observer.h"
+
+#include <algorithm>
+
+namespace mtf = mir_test_framework;
+namespace mi = mir::input;
+namespace ms = mir::scene;
+
+namespace
+{
+using Stage = mtf::InputStageTimestamps::Stage;
+
+struct DispatcherProbe : mi::EventFilter
+{
+    explicit DispatcherProbe(mtf::InputStageTimestamps& timestamps)
+        : timestamps(timestamps)
+    {
+    }
+
+    bool handle(MirEvent const& event) override
+    {
+        if (mir_event_get_type(&event) == mir_event_type_input)
+            timestamps.mark(Stage::dispatcher, mir_event_get_input_event(&event));
+        return false;
+    }
+
+    mtf::InputStageTimestamps& timestamps;
+};
+
+struct SentProbe : ms::NullSurfaceObserver
+{
+    explicit SentProbe(mtf::InputStageTimestamps& timestamps)
+        : timestamps(timestamps)
+    {
+    }
+
+    void input_consumed(MirEvent const* event) override
+    {
+        if (mir_event_get_type(event) == mir_event_type_input)
+            timestamps.mark(Stage::sent, mir_event_get_input_event(event));
+    }
+
+    mtf::InputStageTimestamps& timestamps;
+};
+
+std::chrono::nanoseconds percentile(std::vector<std::chrono::nanoseconds> const& sorted, double fraction)
+{
+    return sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+}
+}
+
+void mtf::InputStageTimestamps::mark(Stage stage, MirInputEvent const* event)
+{
+    // Event times are CLOCK_MONOTONIC, as is steady_clock
+    auto const now = std::chrono::steady_clock::now().time_since_epoch();
+    std::chrono::nanoseconds const event_time{mir_input_event_get_event_time(event)};
+
+    std::lock_guard<std::mutex> lock{mutex};
+    latencies[static_cast<size_t>(stage)].push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now) - event_time);
+}
+
+mtf::InputStageTimestamps::Summary mtf::InputStageTimestamps::summary(Stage stage) const
+{
+    std::vector<std::chrono::nanoseconds> sorted;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        sorted = latencies[static_cast<size_t>(stage)];
+    }
+
+    if (sorted.empty())
+        return {0, {}, {}, {}, {}};
+
+    std::sort(begin(sorted), end(sorted));
+    return {sorted.size(), sorted.front(), percentile(sorted, 0.5), percentile(sorted, 0.99), sorted.back()};
+}
+
+std::shared_ptr<mi::EventFilter> mtf::InputStageTimestamps::dispatcher_probe()
+{
+    return std::make_shared<DispatcherProbe>(*this);
+}
+
+std::shared_ptr<ms::SurfaceObserver> mtf::InputStageTimestamps::sent_probe()
+{
+    return std::make_shared<SentProbe>(*this);
+}
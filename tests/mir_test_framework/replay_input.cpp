@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_test_framework/replay_input_platform.h"
+#include "mir/module_properties.h"
+#include "mir/assert_module_entry_point.h"
+#include "mir/libname.h"
+#include "mir/options/option.h"
+
+#include <boost/program_options/options_description.hpp>
+
+namespace mtf = mir_test_framework;
+namespace mo = mir::options;
+namespace mi = mir::input;
+namespace po = boost::program_options;
+
+namespace
+{
+char const* const replay_input_opt = "replay-input";
+char const* const replay_input_speed_opt = "replay-input-speed";
+}
+
+mir::UniqueModulePtr<mi::Platform> create_input_platform(
+    mo::Option const& options,
+    std::shared_ptr<mir::EmergencyCleanupRegistry> const& /*emergency_cleanup_registry*/,
+    std::shared_ptr<mi::InputDeviceRegistry> const& input_device_registry,
+    std::shared_ptr<mi::InputReport> const& /*report*/)
+{
+    mir::assert_entry_point_signature<mi::CreatePlatform>(&create_input_platform);
+    return mir::make_module_ptr<mtf::ReplayInputPlatform>(
+        input_device_registry,
+        options.get<std::string>(replay_input_opt),
+        options.get<double>(replay_input_speed_opt));
+}
+
+void add_input_platform_options(
+    boost::program_options::options_description& config)
+{
+    mir::assert_entry_point_signature<mi::AddPlatformOptions>(&add_input_platform_options);
+    config.add_options()
+        (replay_input_opt, po::value<std::string>(),
+            "[platform-specific] Input recording to replay")
+        (replay_input_speed_opt, po::value<double>()->default_value(1.0),
+            "[platform-specific] Replay speed relative to the recording, 0 for as fast as possible");
+}
+
+mi::PlatformPriority probe_input_platform(
+    mo::Option const& options)
+{
+    mir::assert_entry_point_signature<mi::ProbePlatform>(&probe_input_platform);
+    if (options.is_set(replay_input_opt))
+        return mi::PlatformPriority::best;
+    return mi::PlatformPriority::unsupported;
+}
+
+namespace
+{
+mir::ModuleProperties const description = {
+    "mir:replay-input",
+    MIR_VERSION_MAJOR,
+    MIR_VERSION_MINOR,
+    MIR_VERSION_MICRO,
+    mir::libname()
+};
+}
+
+mir::ModuleProperties const* describe_input_module()
+{
+    mir::assert_entry_point_signature<mi::DescribeModule>(&describe_input_module);
+    return &description;
+}
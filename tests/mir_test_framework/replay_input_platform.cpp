@@ -0,0 +1,317 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_test_framework/replay_input_platform.h"
+
+#include "mir/input/input_device.h"
+#include "mir/input/input_device_info.h"
+#include "mir/input/input_device_registry.h"
+#include "mir/input/input_recording.h"
+#include "mir/input/input_sink.h"
+#include "mir/input/event_builder.h"
+#include "mir/input/pointer_settings.h"
+#include "mir/input/touchpad_settings.h"
+#include "mir/input/touchscreen_settings.h"
+#include "mir/events/event.h"
+#include "mir/events/touch_event.h"
+#include "mir/dispatch/action_queue.h"
+#include "mir/dispatch/multiplexing_dispatchable.h"
+#define MIR_LOG_COMPONENT "replay-input"
+#include "mir/log.h"
+
+#include <boost/exception/diagnostic_information.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+namespace mtf = mir_test_framework;
+namespace mi = mir::input;
+
+class mtf::ReplayInputPlatform::Device : public mi::InputDevice
+{
+public:
+    explicit Device(mi::InputDeviceInfo const& info)
+        : info(info)
+    {
+    }
+
+    void start(mi::InputSink* destination, mi::EventBuilder* event_builder) override
+    {
+        sink = destination;
+        builder = event_builder;
+    }
+
+    void stop() override
+    {
+        sink = nullptr;
+        builder = nullptr;
+    }
+
+    mi::InputDeviceInfo get_device_info() override
+    {
+        return info;
+    }
+
+    mir::optional_value<mi::PointerSettings> get_pointer_settings() const override
+    {
+        mir::optional_value<mi::PointerSettings> ret;
+        if (contains(info.capabilities, mi::DeviceCapability::pointer))
+            ret = mi::PointerSettings();
+        return ret;
+    }
+
+    mir::optional_value<mi::TouchpadSettings> get_touchpad_settings() const override
+    {
+        mir::optional_value<mi::TouchpadSettings> ret;
+        if (contains(info.capabilities, mi::DeviceCapability::touchpad))
+            ret = mi::TouchpadSettings();
+        return ret;
+    }
+
+    mir::optional_value<mi::TouchscreenSettings> get_touchscreen_settings() const override
+    {
+        mir::optional_value<mi::TouchscreenSettings> ret;
+        if (contains(info.capabilities, mi::DeviceCapability::touchscreen))
+            ret = mi::TouchscreenSettings();
+        return ret;
+    }
+
+    // Recorded events were already interpreted by the device they came from
+    void apply_settings(mi::PointerSettings const&) override {}
+    void apply_settings(mi::TouchpadSettings const&) override {}
+    void apply_settings(mi::TouchscreenSettings const&) override {}
+
+    void replay(MirEvent const& recorded)
+    {
+        if (!sink || mir_event_get_type(&recorded) != mir_event_type_input)
+            return;
+
+        auto const now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+        auto const input_event = mir_event_get_input_event(&recorded);
+
+        switch (mir_input_event_get_type(input_event))
+        {
+        case mir_input_event_type_key:
+        {
+            auto const key = mir_input_event_get_keyboard_event(input_event);
+            sink->handle_input(builder->key_event(
+                now,
+                mir_keyboard_event_action(key),
+                mir_keyboard_event_key_code(key),
+                mir_keyboard_event_scan_code(key)));
+            break;
+        }
+        case mir_input_event_type_pointer:
+        {
+            auto const pointer = mir_input_event_get_pointer_event(input_event);
+            sink->handle_input(builder->pointer_event(
+                now,
+                mir_pointer_event_action(pointer),
+                mir_pointer_event_buttons(pointer),
+                mir_pointer_event_axis_value(pointer, mir_pointer_axis_hscroll),
+                mir_pointer_event_axis_value(pointer, mir_pointer_axis_vscroll),
+                mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_x),
+                mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_y)));
+            break;
+        }
+        case mir_input_event_type_touch:
+        {
+            auto const touch = recorded.to_input()->to_touch();
+            std::vector<mir::events::ContactState> contacts;
+            for (size_t i = 0; i != touch->pointer_count(); ++i)
+            {
+                contacts.push_back({
+                    touch->id(i),
+                    touch->action(i),
+                    touch->tool_type(i),
+                    touch->x(i),
+                    touch->y(i),
+                    touch->pressure(i),
+                    touch->touch_major(i),
+                    touch->touch_minor(i),
+                    touch->orientation(i)});
+            }
+            sink->handle_input(builder->touch_event(now, contacts));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+private:
+    mi::InputDeviceInfo const info;
+    mi::InputSink* sink{nullptr};
+    mi::EventBuilder* builder{nullptr};
+};
+
+mtf::ReplayInputPlatform::ReplayInputPlatform(
+    std::shared_ptr<mi::InputDeviceRegistry> const& input_device_registry,
+    std::string const& recording,
+    double speed)
+    : platform_dispatchable{std::make_shared<mir::dispatch::MultiplexingDispatchable>()},
+      platform_queue{std::make_shared<mir::dispatch::ActionQueue>()},
+      registry{input_device_registry},
+      recording{recording},
+      speed{speed}
+{
+    platform_dispatchable->add_watch(platform_queue);
+}
+
+mtf::ReplayInputPlatform::~ReplayInputPlatform()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    stop_requested.notify_all();
+
+    if (replay_thread.joinable())
+        replay_thread.join();
+}
+
+std::shared_ptr<mir::dispatch::Dispatchable> mtf::ReplayInputPlatform::dispatchable()
+{
+    return platform_dispatchable;
+}
+
+void mtf::ReplayInputPlatform::start()
+{
+    if (replay_thread.joinable())
+        return;
+
+    unsigned run;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = false;
+        run = ++current_run;
+    }
+    replay_thread = std::thread{[this, run] { replay(run); }};
+}
+
+void mtf::ReplayInputPlatform::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    stop_requested.notify_all();
+
+    if (replay_thread.joinable())
+        replay_thread.join();
+
+    // Records still on platform_queue check replaying() and are dropped, so
+    // they cannot bring back devices removed here
+    for (auto const& device : devices)
+        registry->remove_device(device.second);
+    devices.clear();
+}
+
+void mtf::ReplayInputPlatform::pause_for_config()
+{
+}
+
+void mtf::ReplayInputPlatform::continue_after_config()
+{
+}
+
+bool mtf::ReplayInputPlatform::replaying(unsigned run)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return !stopping && run == current_run;
+}
+
+void mtf::ReplayInputPlatform::replay(unsigned run)
+{
+    try
+    {
+        std::ifstream file{recording, std::ios::binary};
+        if (!file)
+            BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open input recording " + recording));
+
+        mi::InputRecordingReader reader{file};
+        mi::InputRecord record;
+        std::chrono::nanoseconds first_timestamp{-1};
+        auto const replay_start = std::chrono::steady_clock::now();
+        size_t records{0};
+
+        while (reader.next(record))
+        {
+            if (first_timestamp.count() < 0)
+                first_timestamp = record.timestamp;
+
+            std::unique_lock<std::mutex> lock{mutex};
+            if (speed > 0)
+            {
+                auto const offset = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    (record.timestamp - first_timestamp) / speed);
+                stop_requested.wait_until(lock, replay_start + offset, [this] { return stopping; });
+            }
+            if (stopping)
+                return;
+            lock.unlock();
+
+            platform_queue->enqueue([this, record, run]
+                {
+                    if (replaying(run))
+                        replay(record);
+                });
+            ++records;
+        }
+
+        mir::log_info("Replayed %zu records from %s", records, recording.c_str());
+    }
+    catch (...)
+    {
+        mir::log_error("Input replay failed: %s", boost::current_exception_diagnostic_information().c_str());
+    }
+}
+
+void mtf::ReplayInputPlatform::replay(mi::InputRecord const& record)
+{
+    switch (record.type)
+    {
+    case mi::InputRecord::Type::device_added:
+    {
+        auto const device = std::make_shared<Device>(mi::InputDeviceInfo{
+            record.info.name,
+            record.info.unique_id,
+            mi::DeviceCapabilities{record.info.capabilities}});
+        devices[record.device] = device;
+        registry->add_device(device);
+        break;
+    }
+    case mi::InputRecord::Type::device_removed:
+    {
+        auto const device = devices.find(record.device);
+        if (device != end(devices))
+        {
+            registry->remove_device(device->second);
+            devices.erase(device);
+        }
+        break;
+    }
+    case mi::InputRecord::Type::event:
+    {
+        auto const device = devices.find(record.device);
+        if (device != end(devices))
+            device->second->replay(*record.event);
+        break;
+    }
+    }
+}
@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cstdio>
 
 namespace mtf = mir_test_framework;
 
@@ -119,3 +120,26 @@ TEST_F(ClientStartupPerformance, create_surface_and_swap)
     mir_connection_release(conn);
 }
 
+
+TEST_F(ClientStartupPerformance, reports_connect_and_first_frame_times)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    auto conn = create_connection();
+    auto const connected = std::chrono::steady_clock::now();
+
+    auto window = make_surface(conn);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    mir_buffer_stream_swap_buffers_sync(mir_window_get_buffer_stream(window));
+#pragma GCC diagnostic pop
+    auto const first_frame = std::chrono::steady_clock::now();
+
+    auto const connect_time = std::chrono::duration<double, std::milli>(connected - start);
+    auto const first_frame_time = std::chrono::duration<double, std::milli>(first_frame - start);
+    // MIR_CLIENT_STARTUP_REPORT=log breaks these down further
+    printf("Connected after %.1fms, first frame after %.1fms\n", connect_time.count(), first_frame_time.count());
+
+    mir_window_release_sync(window);
+    mir_connection_release(conn);
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_device_info.h"
+#include "mir/input/input_dispatcher.h"
+
+#include "mir_test_framework/headless_in_process_server.h"
+#include "mir_test_framework/input_device_faker.h"
+#include "mir_test_framework/fake_input_device.h"
+#include "mir/test/event_factory.h"
+#include "mir/test/fake_shared.h"
+#include "mir/test/signal.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <linux/input.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace mi = mir::input;
+namespace mis = mir::input::synthesis;
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+int const events_per_device = 20000;
+
+struct CountingInputDispatcher : mi::InputDispatcher
+{
+    bool dispatch(std::shared_ptr<MirEvent const> const&) override
+    {
+        if (++received == expected)
+            all_received.raise();
+        return true;
+    }
+
+    void start() override {}
+    void stop() override {}
+
+    int expected{0};
+    std::atomic<int> received{0};
+    mt::Signal all_received;
+};
+
+struct InputThroughput : mtf::HeadlessInProcessServer, mtf::InputDeviceFaker
+{
+    void SetUp() override
+    {
+        server.override_the_input_dispatcher([this] { return mt::fake_shared(dispatcher); });
+        HeadlessInProcessServer::SetUp();
+        wait_for_input_devices_added_to(server);
+    }
+
+    mir::UniqueModulePtr<mtf::FakeInputDevice> add_device(char const* name, mi::DeviceCapabilities caps)
+    {
+        return add_fake_input_device(mi::InputDeviceInfo{name, std::string{name} + "-uid", caps});
+    }
+
+    /// Each device emits its events from its own thread, as fast as it can
+    void emit_from_all(std::vector<std::function<void(int)>> const& emitters)
+    {
+        dispatcher.expected = events_per_device * emitters.size();
+
+        auto const start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (auto const& emit : emitters)
+            threads.emplace_back([emit] { for (int i = 0; i != events_per_device; ++i) emit(i); });
+        for (auto& thread : threads)
+            thread.join();
+
+        auto const received_all = dispatcher.all_received.wait_for(60s);
+        auto const duration = std::chrono::steady_clock::now() - start;
+
+        ASSERT_TRUE(received_all) << "only " << dispatcher.received.load() << " of " << dispatcher.expected << " events arrived";
+        EXPECT_THAT(dispatcher.received, Eq(dispatcher.expected));
+
+        auto const seconds = std::chrono::duration<double>(duration).count();
+        printf("%d events from %zu devices in %.3f s: %.0f events/s\n",
+               dispatcher.received.load(), emitters.size(), seconds, dispatcher.received / seconds);
+    }
+
+    CountingInputDispatcher dispatcher;
+
+    mir::UniqueModulePtr<mtf::FakeInputDevice> const pointers[2]{
+        add_device("pointer-1", mi::DeviceCapability::pointer),
+        add_device("pointer-2", mi::DeviceCapability::pointer)};
+    mir::UniqueModulePtr<mtf::FakeInputDevice> const keyboards[2]{
+        add_device("keyboard-1", mi::DeviceCapability::keyboard | mi::DeviceCapability::alpha_numeric),
+        add_device("keyboard-2", mi::DeviceCapability::keyboard | mi::DeviceCapability::alpha_numeric)};
+    mir::UniqueModulePtr<mtf::FakeInputDevice> const touchscreens[2]{
+        add_device("touchscreen-1", mi::DeviceCapability::touchscreen | mi::DeviceCapability::multitouch),
+        add_device("touchscreen-2", mi::DeviceCapability::touchscreen | mi::DeviceCapability::multitouch)};
+};
+
+std::function<void(int)> pointer_motion(mtf::FakeInputDevice& device)
+{
+    return [&device](int i)
+        {
+            auto const step = i % 2 ? -1 : 1;
+            device.emit_event(mis::a_pointer_event().with_movement(step, step));
+        };
+}
+
+std::function<void(int)> key_presses(mtf::FakeInputDevice& device, int scan_code)
+{
+    return [&device, scan_code](int i)
+        {
+            if (i % 2)
+                device.emit_event(mis::a_key_up_event().of_scancode(scan_code));
+            else
+                device.emit_event(mis::a_key_down_event().of_scancode(scan_code));
+        };
+}
+
+std::function<void(int)> touch_drag(mtf::FakeInputDevice& device)
+{
+    return [&device](int i)
+        {
+            auto const action =
+                i == 0 ? mis::TouchParameters::Action::Tap :
+                i == events_per_device - 1 ? mis::TouchParameters::Action::Release :
+                mis::TouchParameters::Action::Move;
+            device.emit_event(mis::a_touch_event().with_action(action).at_position({100 + i % 100, 100}));
+        };
+}
+}
+
+TEST_F(InputThroughput, pointers_keyboards_and_touchscreens_in_parallel)
+{
+    emit_from_all({
+        pointer_motion(*pointers[0]),
+        pointer_motion(*pointers[1]),
+        key_presses(*keyboards[0], KEY_A),
+        key_presses(*keyboards[1], KEY_B),
+        touch_drag(*touchscreens[0]),
+        touch_drag(*touchscreens[1])});
+}
+
+TEST_F(InputThroughput, several_keyboards_in_parallel)
+{
+    emit_from_all({
+        key_presses(*keyboards[0], KEY_A),
+        key_presses(*keyboards[1], KEY_B)});
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+#include "mir/logging/dumb_console_logger.h"
+#include "mir/logging/logger.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ml = mir::logging;
+
+using namespace testing;
+
+namespace
+{
+int const messages_per_thread = 20000;
+// Comfortably more than a record of the messages logged here needs: the header,
+// the component, the format string and the captured arguments
+size_t const max_record_size = 256;
+
+/// Counts the lines written to fd() until every copy of it is closed
+class LineCounter
+{
+public:
+    LineCounter()
+    {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0)
+            throw std::system_error{errno, std::system_category(), "Failed to create pipe"};
+
+        read_end = fds[0];
+        write_end = fds[1];
+
+        reader = std::thread{[this]
+            {
+                char buffer[64 * 1024];
+                ssize_t got;
+                while ((got = read(read_end, buffer, sizeof buffer)) > 0 || (got < 0 && errno == EINTR))
+                {
+                    for (ssize_t i = 0; i < got; ++i)
+                        if (buffer[i] == '\n')
+                            ++lines;
+                }
+            }};
+    }
+
+    ~LineCounter()
+    {
+        if (reader.joinable())
+            count();
+        close(read_end);
+    }
+
+    int fd() const
+    {
+        return write_end;
+    }
+
+    /// Closes our copy of fd() and waits for the writers' copies to be closed too
+    uint64_t count()
+    {
+        close(write_end);
+        reader.join();
+        return lines;
+    }
+
+private:
+    int read_end;
+    int write_end;
+    uint64_t lines{0};
+    std::thread reader;
+};
+
+/// Sends stdout to \a fd and stderr to /dev/null for the lifetime of the object
+struct RedirectConsoleOutput
+{
+    RedirectConsoleOutput(int fd)
+    {
+        fflush(stdout);
+        auto const null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        dup2(fd, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        close(null);
+    }
+
+    ~RedirectConsoleOutput()
+    {
+        fflush(stdout);
+        dup2(saved_stdout, STDOUT_FILENO);
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stdout);
+        close(saved_stderr);
+    }
+
+    int const saved_stdout{dup(STDOUT_FILENO)};
+    int const saved_stderr{dup(STDERR_FILENO)};
+};
+
+/// Returns the mean time a call to log() took, with every thread calling it as fast as it can
+template<typename Log>
+std::chrono::duration<double, std::nano> time_logging(unsigned threads, Log const& log)
+{
+    std::chrono::steady_clock::duration total{0};
+    std::vector<std::chrono::steady_clock::duration> per_thread(threads);
+
+    std::vector<std::thread> loggers;
+    for (unsigned t = 0; t != threads; ++t)
+    {
+        loggers.emplace_back([&log, &per_thread, t]
+            {
+                auto const start = std::chrono::steady_clock::now();
+                for (int i = 0; i != messages_per_thread; ++i)
+                    log(t, i);
+                per_thread[t] = std::chrono::steady_clock::now() - start;
+            });
+    }
+    for (auto& thread : loggers)
+        thread.join();
+
+    for (auto const& duration : per_thread)
+        total += duration;
+
+    return total / (threads * double(messages_per_thread));
+}
+
+std::chrono::duration<double, std::nano> time_logging(ml::Logger& logger, unsigned threads)
+{
+    return time_logging(threads, [&logger](unsigned t, int i)
+        {
+            logger.log("contention", ml::Severity::informational,
+                "thread %u: message %d of %d (%s)", t, i, messages_per_thread, "benchmark");
+        });
+}
+
+int null_output()
+{
+    static int const null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    return null;
+}
+
+unsigned contending_threads()
+{
+    return std::max(4u, std::thread::hardware_concurrency());
+}
+}
+
+TEST(LoggerContention, async_logger_against_dumb_console_logger)
+{
+    auto const threads = contending_threads();
+    uint64_t const messages = threads * messages_per_thread;
+
+    LineCounter dumb_output;
+    ml::DumbConsoleLogger dumb;
+    std::chrono::duration<double, std::nano> dumb_time;
+    {
+        RedirectConsoleOutput const redirect{dumb_output.fd()};
+        dumb_time = time_logging(dumb, threads);
+    }
+
+    LineCounter async_output;
+    std::chrono::duration<double, std::nano> async_time;
+    uint64_t async_dropped;
+    {
+        // Big enough rings that nothing is dropped: dropping a message is much cheaper
+        // than writing it, so a comparison with drops would flatter AsyncLogger
+        ml::AsyncLogger async{async_output.fd(), null_output(), messages_per_thread * max_record_size};
+        async_time = time_logging(async, threads);
+        async.flush();
+        async_dropped = async.dropped_messages();
+    }
+
+    printf("%u threads logging %d messages each:\n", threads, messages_per_thread);
+    printf("  DumbConsoleLogger: %8.1f ns/message\n", dumb_time.count());
+    printf("  AsyncLogger:       %8.1f ns/message (%llu dropped)\n",
+           async_time.count(), static_cast<unsigned long long>(async_dropped));
+
+    EXPECT_THAT(dumb_output.count(), Eq(messages));
+    EXPECT_THAT(async_dropped, Eq(0u));
+    EXPECT_THAT(async_output.count(), Eq(messages));
+    EXPECT_THAT(async_time.count(), Lt(dumb_time.count()));
+}
+
+TEST(LoggerContention, global_log_delivers_everything_while_the_logger_is_replaced)
+{
+    auto const threads = contending_threads();
+    uint64_t const messages = threads * messages_per_thread;
+
+    LineCounter first_output;
+    LineCounter second_output;
+    std::chrono::duration<double, std::nano> log_time;
+    uint64_t dropped;
+    {
+        auto const first = std::make_shared<ml::AsyncLogger>(
+            first_output.fd(), null_output(), ml::AsyncLogger::default_ring_size);
+        auto const second = std::make_shared<ml::AsyncLogger>(
+            second_output.fd(), null_output(), ml::AsyncLogger::default_ring_size);
+        ml::set_logger(first);
+
+        std::atomic<bool> replaced{false};
+        log_time = time_logging(threads, [&](unsigned t, int i)
+            {
+                if (t == 0 && i == messages_per_thread / 2)
+                {
+                    ml::set_logger(second);
+                    replaced = true;
+                }
+                ml::log(ml::Severity::informational, "message from the contention test", "contention");
+            });
+
+        // Leave the default logger in place and flush what the threads queued
+        ml::set_logger(std::make_shared<ml::DumbConsoleLogger>());
+        first->flush();
+        second->flush();
+        dropped = first->dropped_messages() + second->dropped_messages();
+        ASSERT_TRUE(replaced);
+    }
+
+    printf("%u threads logging %d messages each through mir::logging::log(): %8.1f ns/message (%llu dropped)\n",
+           threads, messages_per_thread, log_time.count(), static_cast<unsigned long long>(dropped));
+
+    auto const second_lines = second_output.count();
+    EXPECT_THAT(first_output.count() + second_lines, Eq(messages - dropped));
+    EXPECT_THAT(second_lines, Gt(0u));
+}
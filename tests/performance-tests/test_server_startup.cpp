@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/platform_probe.h"
+#include "mir/options/program_option.h"
+#include "mir/logging/null_shared_library_prober_report.h"
+
+#include "mir_test_framework/executable_path.h"
+#include "mir_test_framework/temporary_environment_value.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+namespace mtf = mir_test_framework;
+
+using namespace testing;
+
+namespace
+{
+struct ServerStartupPerformance : testing::Test
+{
+    ServerStartupPerformance()
+    {
+        char tmp_name[] = "/tmp/mir_probe_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == nullptr)
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        directory = tmp_name;
+        cache_file = directory + "/platform-probe-cache";
+    }
+
+    ~ServerStartupPerformance()
+    {
+        unlink(cache_file.c_str());
+        rmdir(directory.c_str());
+    }
+
+    std::chrono::duration<double, std::milli> time_probe(std::shared_ptr<mir::SharedLibrary>& chosen)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        chosen = mir::graphics::module_for_device(mtf::server_platform_path(), options, report);
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    std::string directory;
+    std::string cache_file;
+    std::shared_ptr<mir::options::ProgramOption const> const options{std::make_shared<mir::options::ProgramOption>()};
+    mir::logging::NullSharedLibraryProberReport report;
+};
+}
+
+TEST_F(ServerStartupPerformance, warm_start_probes_faster_than_cold_start)
+{
+    mtf::TemporaryEnvironmentValue cache_env{"MIR_PLATFORM_PROBE_CACHE", cache_file.c_str()};
+
+    std::shared_ptr<mir::SharedLibrary> cold_choice;
+    std::shared_ptr<mir::SharedLibrary> warm_choice;
+
+    auto const cold = time_probe(cold_choice);
+    EXPECT_THAT(cold_choice, NotNull());
+
+    // Unload the module, so the warm start has to load it afresh as a new server would
+    cold_choice.reset();
+
+    auto const warm = time_probe(warm_choice);
+    EXPECT_THAT(warm_choice, NotNull());
+
+    printf("Graphics platform probing: cold start %.1fms, warm start %.1fms\n", cold.count(), warm.count());
+
+    EXPECT_THAT(access(cache_file.c_str(), F_OK), Eq(0));
+    // The warm start only has to load and probe the module that won last time
+    EXPECT_THAT(warm.count(), Lt(cold.count()));
+}
+
+TEST_F(ServerStartupPerformance, disabled_cache_probes_every_time)
+{
+    mtf::TemporaryEnvironmentValue cache_env{"MIR_PLATFORM_PROBE_CACHE", "off"};
+
+    std::shared_ptr<mir::SharedLibrary> choice;
+    auto const first = time_probe(choice);
+    choice.reset();
+    auto const second = time_probe(choice);
+
+    printf("Graphics platform probing without cache: %.1fms, %.1fms\n", first.count(), second.count());
+
+    EXPECT_THAT(access(cache_file.c_str(), F_OK), Ne(0));
+}
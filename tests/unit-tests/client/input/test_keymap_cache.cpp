@@ -0,0 +1,116 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/keymap_cache.h"
+#include "mir/input/keymap.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdlib>
+#include <system_error>
+
+namespace mi = mir::input;
+
+using namespace ::testing;
+
+namespace
+{
+struct KeymapCache : Test
+{
+    KeymapCache()
+    {
+        char tmp_name[] = "/tmp/mir_keymap_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == nullptr)
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        persist_dir = std::string{tmp_name} + "/mir/keymaps";
+    }
+
+    ~KeymapCache()
+    {
+        boost::system::error_code ignored;
+        boost::filesystem::remove_all(boost::filesystem::path{persist_dir}.parent_path().parent_path(), ignored);
+    }
+
+    std::string persist_dir;
+    mi::Keymap const us{"pc105", "us", "", ""};
+    mi::Keymap const de{"pc105", "de", "", ""};
+};
+}
+
+TEST_F(KeymapCache, compiles_each_keymap_once)
+{
+    mi::KeymapCache cache{""};
+
+    auto const first = cache.keymap(us);
+
+    EXPECT_THAT(cache.keymap(us), Eq(first));
+    EXPECT_THAT(cache.keymap(de), Ne(first));
+}
+
+TEST_F(KeymapCache, shares_keymaps_compiled_from_the_same_buffer)
+{
+    mi::KeymapCache cache{""};
+    auto const text = cache.keymap_string(us);
+
+    auto const first = cache.keymap(text.c_str(), text.size());
+
+    EXPECT_THAT(first, NotNull());
+    EXPECT_THAT(cache.keymap(text.c_str(), text.size()), Eq(first));
+}
+
+TEST_F(KeymapCache, throws_for_unknown_names)
+{
+    mi::KeymapCache cache{""};
+
+    EXPECT_THROW(cache.keymap(mi::Keymap{"pc105", "no-such-layout", "", ""}), std::invalid_argument);
+}
+
+TEST_F(KeymapCache, later_caches_load_persisted_keymaps)
+{
+    std::string compiled;
+    {
+        mi::KeymapCache cache{persist_dir};
+        compiled = cache.keymap_string(us);
+    }
+
+    EXPECT_FALSE(boost::filesystem::is_empty(persist_dir));
+
+    mi::KeymapCache cache{persist_dir};
+    EXPECT_THAT(cache.keymap_string(us), Eq(compiled));
+    EXPECT_THAT(cache.keymap(us), NotNull());
+}
+
+TEST_F(KeymapCache, ignores_persisted_keymaps_of_other_names)
+{
+    {
+        mi::KeymapCache cache{persist_dir};
+        cache.keymap_string(us);
+    }
+
+    mi::KeymapCache cache{persist_dir};
+    EXPECT_THAT(cache.keymap_string(de), Ne(cache.keymap_string(us)));
+}
+
+TEST_F(KeymapCache, creates_compose_states_for_locale)
+{
+    mi::KeymapCache cache{""};
+
+    EXPECT_THAT(cache.make_compose_state("en_US.UTF-8"), NotNull());
+    EXPECT_THAT(cache.make_compose_state("en_US.UTF-8"), NotNull());
+}
@@ -32,6 +32,7 @@
 #include "mir/dispatch/dispatchable.h"
 #include "mir/events/event_builders.h"
 #include "mir/geometry/rectangle.h"
+#include "mir/input/keymap_cache.h"
 #include "mir_toolkit/mir_presentation_chain.h"
 #include "mir_toolkit/rs/mir_render_surface.h"
 
@@ -54,6 +55,7 @@ namespace mclr = mir::client::rpc;
 namespace mf = mir::frontend;
 namespace mp = mir::protobuf;
 namespace mev = mir::events;
+namespace mi = mir::input;
 namespace md = mir::dispatch;
 namespace geom = mir::geometry;
 namespace mtd = mir::test::doubles;
@@ -235,10 +237,12 @@ struct StubClientPlatformFactory : public mcl::ClientPlatformFactory
 
     std::shared_ptr<mcl::ClientPlatform> create_client_platform(mcl::ClientContext*)
     {
+        ++platforms_created;
         return platform;
     }
 
     std::shared_ptr<mcl::ClientPlatform> platform;
+    int platforms_created{0};
 };
 
 void connected_callback(MirConnection* /*connection*/, void * /*client_context*/)
@@ -254,7 +258,7 @@ public:
         std::shared_ptr<mcl::AsyncBufferFactory> const& factory)
         : DefaultConnectionConfiguration(""),
           disp_config(std::make_shared<mcl::DisplayConfiguration>()),
-          platform{platform},
+          platform_factory{std::make_shared<StubClientPlatformFactory>(platform)},
           channel{channel},
           factory{factory}
     {
@@ -267,7 +271,7 @@ public:
 
     std::shared_ptr<mcl::ClientPlatformFactory> the_client_platform_factory() override
     {
-        return std::make_shared<StubClientPlatformFactory>(platform);
+        return platform_factory;
     }
 
     std::shared_ptr<mcl::DisplayConfiguration> the_display_configuration() override
@@ -279,9 +283,14 @@ public:
     {
         return factory;
     }
+
+    int client_platforms_created() const
+    {
+        return platform_factory->platforms_created;
+    }
 private:
     std::shared_ptr<mcl::DisplayConfiguration> disp_config;
-    std::shared_ptr<mcl::ClientPlatform> const platform;
+    std::shared_ptr<StubClientPlatformFactory> const platform_factory;
     std::shared_ptr<mclr::MirBasicRpcChannel> const channel;
     std::shared_ptr<mcl::AsyncBufferFactory> const factory;
 };
@@ -921,3 +930,44 @@ TEST_F(MirConnectionTest, release_surface_releases_resources_before_invoking_cal
 
     connection->release_surface(callback.result, release_cb, nullptr);
 }
+
+TEST_F(MirConnectionTest, creates_the_client_platform_for_the_first_window_not_on_connect)
+{
+    using WindowCallback = Callback<MirWindow>;
+
+    connection->connect("MirClientSurfaceTest", connected_callback, nullptr)->wait_for_all();
+
+    EXPECT_THAT(conf.client_platforms_created(), Eq(0));
+
+    MirWindowSpec spec(connection.get(), 640, 480, mir_pixel_format_abgr_8888);
+    WindowCallback callback;
+    connection->create_surface(spec, &WindowCallback::created, &callback);
+
+    ASSERT_THAT(callback.result, NotNull());
+    EXPECT_TRUE(MirWindow::is_valid(callback.result));
+    EXPECT_THAT(conf.client_platforms_created(), Eq(1));
+
+    connection->release_surface(callback.result, [](MirWindow*, void*) {}, nullptr);
+}
+
+TEST_F(MirConnectionTest, window_xkb_state_waits_for_the_first_keymap)
+{
+    using WindowCallback = Callback<MirWindow>;
+
+    connection->connect("MirClientSurfaceTest", connected_callback, nullptr)->wait_for_all();
+
+    auto const cache_users_before_window = mi::KeymapCache::instance().use_count();
+
+    MirWindowSpec spec(connection.get(), 640, 480, mir_pixel_format_abgr_8888);
+    WindowCallback callback;
+    connection->create_surface(spec, &WindowCallback::created, &callback);
+    ASSERT_THAT(callback.result, NotNull());
+
+    EXPECT_THAT(mi::KeymapCache::instance().use_count(), Eq(cache_users_before_window));
+
+    callback.result->get_keymapper()->set_keymap_for_all_devices(mi::Keymap{});
+
+    EXPECT_THAT(mi::KeymapCache::instance().use_count(), Gt(cache_users_before_window));
+
+    connection->release_surface(callback.result, [](MirWindow*, void*) {}, nullptr);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/client/startup_timeline.h"
+#include "src/client/perf_report.h"
+#include "mir/logging/logger.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mcl = mir::client;
+namespace ml = mir::logging;
+
+using namespace testing;
+
+namespace
+{
+class MockLogger : public ml::Logger
+{
+public:
+    MOCK_METHOD3(log, void(ml::Severity severity, std::string const& message, std::string const& component));
+    ~MockLogger() noexcept(true) {}
+};
+
+class MockPerfReport : public mcl::PerfReport
+{
+public:
+    MOCK_METHOD1(name_surface, void(char const*));
+    MOCK_METHOD1(begin_frame, void(int));
+    MOCK_METHOD1(end_frame, void(int));
+};
+
+using Stage = mcl::StartupTimeline::Stage;
+
+struct StartupTimeline : Test
+{
+    std::shared_ptr<MockLogger> const logger{std::make_shared<NiceMock<MockLogger>>()};
+    std::shared_ptr<mcl::StartupTimeline> const timeline{std::make_shared<mcl::StartupTimeline>(logger)};
+};
+}
+
+TEST_F(StartupTimeline, logs_nothing_before_first_frame)
+{
+    EXPECT_CALL(*logger, log(_, _, _)).Times(0);
+
+    timeline->reached(Stage::connected);
+    timeline->reached(Stage::client_platform);
+    timeline->reached(Stage::first_window);
+}
+
+TEST_F(StartupTimeline, logs_every_stage_once_first_frame_is_reached)
+{
+    EXPECT_CALL(*logger, log(ml::Severity::informational,
+        AllOf(HasSubstr("connected"), HasSubstr("client platform"), HasSubstr("first window"), HasSubstr("first frame")),
+        "startup"));
+
+    timeline->reached(Stage::connected);
+    timeline->reached(Stage::client_platform);
+    timeline->reached(Stage::first_window);
+    timeline->reached(Stage::first_frame);
+}
+
+TEST_F(StartupTimeline, logs_only_the_first_frame)
+{
+    EXPECT_CALL(*logger, log(_, _, _)).Times(1);
+
+    timeline->reached(Stage::first_frame);
+    timeline->reached(Stage::first_frame);
+}
+
+TEST_F(StartupTimeline, marks_stages_that_were_not_needed)
+{
+    EXPECT_CALL(*logger, log(_, HasSubstr("client platform (not needed)"), _));
+
+    timeline->reached(Stage::connected);
+    timeline->reached(Stage::first_frame);
+}
+
+TEST_F(StartupTimeline, without_logger_first_frame_report_is_passed_through)
+{
+    auto const disabled = std::make_shared<mcl::StartupTimeline>(nullptr);
+    auto const report = std::make_shared<NiceMock<MockPerfReport>>();
+
+    EXPECT_THAT(mcl::first_frame_report(disabled, report), Eq(report));
+}
+
+TEST_F(StartupTimeline, first_frame_report_forwards_frames_and_records_first_frame)
+{
+    auto const report = std::make_shared<NiceMock<MockPerfReport>>();
+    auto const wrapped = mcl::first_frame_report(timeline, report);
+
+    EXPECT_CALL(*report, begin_frame(7));
+    EXPECT_CALL(*report, end_frame(7));
+    EXPECT_CALL(*logger, log(_, HasSubstr("first frame"), _));
+
+    wrapped->begin_frame(7);
+    wrapped->end_frame(7);
+}
@@ -35,10 +35,14 @@
 #include "mir/test/doubles/mock_scene.h"
 #include "mir/test/doubles/stub_scene.h"
 #include "mir/test/doubles/stub_scene_element.h"
+#include "mir/test/signal.h"
+#include "mir/renderer/fence.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 namespace mg = mir::graphics;
 namespace mc = mir::compositor;
 namespace geom = mir::geometry;
@@ -388,3 +392,62 @@ TEST_F(DefaultDisplayBufferCompositor, marks_occluded_scene_elements)
     compositor.composite({element0_occluded, element1_rendered, element2_occluded});
 }
 
+
+TEST_F(DefaultDisplayBufferCompositor, releases_renderables_after_render_without_fence)
+{
+    using namespace testing;
+    auto const unreferenced = small.use_count();
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({small}));
+
+    EXPECT_THAT(small.use_count(), Eq(unreferenced));
+}
+
+TEST_F(DefaultDisplayBufferCompositor, holds_renderables_until_their_fence_signals)
+{
+    using namespace testing;
+
+    struct BlockingFence : mir::renderer::Fence
+    {
+        BlockingFence(mt::Signal& gpu_done, mt::Signal& frame_released) :
+            gpu_done(gpu_done),
+            frame_released(frame_released)
+        {
+        }
+
+        // The release thread drops a frame's renderables before its fence
+        ~BlockingFence() { frame_released.raise(); }
+
+        void wait() override { gpu_done.wait(); }
+
+        mt::Signal& gpu_done;
+        mt::Signal& frame_released;
+    };
+
+    mt::Signal gpu_done;
+    mt::Signal frame_released;
+    EXPECT_CALL(mock_renderer, fence_frame())
+        .WillOnce(Invoke([&]
+            { return std::unique_ptr<mir::renderer::Fence>{new BlockingFence{gpu_done, frame_released}}; }));
+
+    auto const unreferenced = small.use_count();
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({small}));
+
+    EXPECT_THAT(small.use_count(), Gt(unreferenced));
+
+    gpu_done.raise();
+
+    ASSERT_TRUE(frame_released.wait_for(std::chrono::seconds{5}));
+    EXPECT_THAT(small.use_count(), Eq(unreferenced));
+}
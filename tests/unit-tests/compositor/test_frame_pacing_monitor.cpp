@@ -0,0 +1,186 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/frame_pacing_monitor.h"
+#include "mir/test/doubles/mock_frame_pacing_observer.h"
+#include "mir/test/doubles/advanceable_clock.h"
+#include "mir/test/doubles/stub_buffer_stream.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+using namespace std::literals::chrono_literals;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+
+namespace
+{
+struct FramePacingMonitor : Test
+{
+    std::chrono::nanoseconds const period{16ms};
+    mc::FramePacingMonitor::Timestamp const start{CLOCK_MONOTONIC, 1000s};
+    mg::DisplayConfigurationOutputId const output{1};
+
+    std::shared_ptr<NiceMock<mtd::MockFramePacingObserver>> const observer{
+        std::make_shared<NiceMock<mtd::MockFramePacingObserver>>()};
+    std::shared_ptr<mtd::AdvanceableClock> const clock{std::make_shared<mtd::AdvanceableClock>()};
+    mc::FramePacingMonitor monitor{observer, clock};
+    mc::FramePacingMonitor::OutputPacing output_pacing;
+    mc::FramePacingMonitor::StreamPacing stream_pacing;
+
+    mtd::StubBufferStream stub_stream;
+    mc::BufferStream const* const stream{&stub_stream};
+
+    mg::Frame frame_at(int64_t msc)
+    {
+        mg::Frame frame;
+        frame.msc = msc;
+        frame.ust = start + period * msc;
+        return frame;
+    }
+
+    mir::optional_value<mc::FramePacingMonitor::Timestamp> vblank(int64_t msc)
+    {
+        return start + period * msc;
+    }
+};
+}
+
+TEST_F(FramePacingMonitor, frames_on_time_are_not_reported)
+{
+    EXPECT_CALL(*observer, missed_deadline(_, _)).Times(0);
+    EXPECT_CALL(*observer, repeated_frame(_)).Times(0);
+
+    for (int64_t msc = 1; msc != 10; ++msc)
+        monitor.frame_posted(output_pacing, output, vblank(msc), period, frame_at(msc));
+}
+
+TEST_F(FramePacingMonitor, reports_how_many_vblanks_a_late_frame_missed)
+{
+    monitor.frame_posted(output_pacing, output, vblank(1), period, frame_at(1));
+
+    EXPECT_CALL(*observer, missed_deadline(output, 1));
+    monitor.frame_posted(output_pacing, output, vblank(2), period, frame_at(3));
+
+    EXPECT_CALL(*observer, missed_deadline(output, 3));
+    monitor.frame_posted(output_pacing, output, vblank(4), period, frame_at(7));
+}
+
+TEST_F(FramePacingMonitor, tolerates_jitter_in_reported_vblank_times)
+{
+    auto jittery = frame_at(2);
+    jittery.ust = jittery.ust + 2ms;
+
+    EXPECT_CALL(*observer, missed_deadline(_, _)).Times(0);
+
+    monitor.frame_posted(output_pacing, output, vblank(2), period, jittery);
+}
+
+TEST_F(FramePacingMonitor, reports_frame_posted_before_the_last_was_shown)
+{
+    monitor.frame_posted(output_pacing, output, vblank(1), period, frame_at(1));
+
+    EXPECT_CALL(*observer, repeated_frame(output));
+    EXPECT_CALL(*observer, missed_deadline(_, _)).Times(0);
+
+    monitor.frame_posted(output_pacing, output, vblank(2), period, frame_at(1));
+}
+
+TEST_F(FramePacingMonitor, outputs_are_tracked_separately)
+{
+    mg::DisplayConfigurationOutputId const other_output{2};
+    mc::FramePacingMonitor::OutputPacing other_output_pacing;
+
+    EXPECT_CALL(*observer, repeated_frame(_)).Times(0);
+
+    monitor.frame_posted(output_pacing, output, vblank(1), period, frame_at(1));
+    monitor.frame_posted(other_output_pacing, other_output, vblank(1), period, frame_at(1));
+}
+
+TEST_F(FramePacingMonitor, ignores_platforms_without_frame_timing)
+{
+    EXPECT_CALL(*observer, missed_deadline(_, _)).Times(0);
+    EXPECT_CALL(*observer, repeated_frame(_)).Times(0);
+
+    monitor.frame_posted(output_pacing, output, vblank(1), period, mg::Frame{});
+    monitor.frame_posted(output_pacing, output, vblank(2), period, mg::Frame{});
+}
+
+TEST_F(FramePacingMonitor, no_missed_deadline_without_a_target_vblank)
+{
+    EXPECT_CALL(*observer, missed_deadline(_, _)).Times(0);
+
+    monitor.frame_posted(output_pacing, output, {}, period, frame_at(5));
+}
+
+TEST_F(FramePacingMonitor, reports_client_frame_rate_each_second)
+{
+    EXPECT_CALL(*observer, client_frame_rate(stream, FloatNear(50.0f, 0.1f)));
+
+    for (uint32_t frame = 0; frame != 51; ++frame)
+    {
+        monitor.client_frame_composited(stream, stream_pacing, mg::BufferID{frame % 3});
+        clock->advance_by(20ms);
+    }
+}
+
+TEST_F(FramePacingMonitor, counts_a_frame_taken_by_several_compositors_once)
+{
+    EXPECT_CALL(*observer, client_frame_rate(stream, FloatNear(25.0f, 0.1f)));
+
+    for (uint32_t frame = 0; frame != 26; ++frame)
+    {
+        for (int compositor = 0; compositor != 2; ++compositor)
+        {
+            monitor.client_frame_composited(stream, stream_pacing, mg::BufferID{frame % 3});
+            clock->advance_by(20ms);
+        }
+    }
+}
+
+TEST_F(FramePacingMonitor, restarts_frame_rate_measurement_after_client_is_idle)
+{
+    EXPECT_CALL(*observer, client_frame_rate(_, _)).Times(0);
+
+    monitor.client_frame_composited(stream, stream_pacing, mg::BufferID{1});
+    clock->advance_by(10s);
+    monitor.client_frame_composited(stream, stream_pacing, mg::BufferID{2});
+}
+
+TEST_F(FramePacingMonitor, streams_are_tracked_separately)
+{
+    mtd::StubBufferStream other_stub_stream;
+    mc::FramePacingMonitor::StreamPacing other_stream_pacing;
+
+    EXPECT_CALL(*observer, client_frame_rate(stream, _));
+    EXPECT_CALL(*observer, client_frame_rate(&other_stub_stream, _)).Times(0);
+
+    monitor.client_frame_composited(&other_stub_stream, other_stream_pacing, mg::BufferID{1});
+    for (uint32_t frame = 0; frame != 51; ++frame)
+    {
+        monitor.client_frame_composited(stream, stream_pacing, mg::BufferID{frame % 3});
+        clock->advance_by(20ms);
+    }
+}
+
+TEST_F(FramePacingMonitor, passes_on_dropped_client_frames)
+{
+    EXPECT_CALL(*observer, client_frame_dropped(stream));
+
+    monitor.client_frame_dropped(stream);
+}
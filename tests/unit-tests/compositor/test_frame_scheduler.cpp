@@ -0,0 +1,142 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/frame_scheduler.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+using namespace std::literals::chrono_literals;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+namespace
+{
+struct FrameScheduler : Test
+{
+    std::chrono::nanoseconds const period{16ms};
+    std::chrono::nanoseconds const margin{2ms};
+    mc::FrameScheduler::Timestamp const start{CLOCK_MONOTONIC, 1000s};
+
+    mg::Frame frame_at(int64_t msc, std::chrono::nanoseconds offset)
+    {
+        mg::Frame frame;
+        frame.msc = msc;
+        frame.ust = start + offset;
+        return frame;
+    }
+};
+}
+
+TEST_F(FrameScheduler, no_deadline_until_a_frame_is_displayed)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    EXPECT_FALSE(scheduler.next_deadline(start));
+}
+
+TEST_F(FrameScheduler, no_deadline_for_platforms_without_frame_timing)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    scheduler.frame_displayed(mg::Frame{});
+
+    EXPECT_FALSE(scheduler.next_deadline(start));
+}
+
+TEST_F(FrameScheduler, deadline_is_render_budget_before_next_vblank)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    scheduler.frame_rendered(3ms);
+    scheduler.frame_displayed(frame_at(1, 0ms));
+
+    auto const deadline = scheduler.next_deadline(start + 1ms);
+
+    ASSERT_TRUE(deadline);
+    EXPECT_THAT(deadline.value() - start, Eq(period - 3ms - margin));
+}
+
+TEST_F(FrameScheduler, targets_following_vblank_when_next_is_too_close)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    scheduler.frame_rendered(3ms);
+    scheduler.frame_displayed(frame_at(1, 0ms));
+
+    auto const deadline = scheduler.next_deadline(start + 14ms);
+
+    ASSERT_TRUE(deadline);
+    EXPECT_THAT(deadline.value() - start, Eq(2*period - 3ms - margin));
+}
+
+TEST_F(FrameScheduler, budget_covers_slowest_recent_render)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    scheduler.frame_rendered(1ms);
+    scheduler.frame_rendered(7ms);
+    scheduler.frame_rendered(2ms);
+
+    EXPECT_THAT(scheduler.render_budget(), Eq(7ms + margin));
+}
+
+TEST_F(FrameScheduler, measures_period_from_displayed_frames)
+{
+    mc::FrameScheduler scheduler{std::chrono::nanoseconds::zero(), margin};
+
+    scheduler.frame_displayed(frame_at(10, 0ms));
+    EXPECT_FALSE(scheduler.next_deadline(start));
+
+    scheduler.frame_displayed(frame_at(12, 20ms));
+
+    EXPECT_THAT(scheduler.frame_period(), Eq(10ms));
+    EXPECT_TRUE(scheduler.next_deadline(start + 21ms));
+}
+
+TEST_F(FrameScheduler, no_deadline_when_rendering_takes_longer_than_a_frame)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    scheduler.frame_rendered(period);
+    scheduler.frame_displayed(frame_at(1, 0ms));
+
+    EXPECT_FALSE(scheduler.next_deadline(start + 1ms));
+}
+
+TEST_F(FrameScheduler, stops_predicting_from_stale_frames)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    scheduler.frame_displayed(frame_at(1, 0ms));
+
+    EXPECT_TRUE(scheduler.next_deadline(start + 10*period));
+    EXPECT_FALSE(scheduler.next_deadline(start + 100*period));
+}
+
+TEST_F(FrameScheduler, predicts_vblank_even_when_rendering_takes_longer_than_a_frame)
+{
+    mc::FrameScheduler scheduler{period, margin};
+
+    scheduler.frame_rendered(period);
+    scheduler.frame_displayed(frame_at(1, 0ms));
+
+    auto const vblank = scheduler.next_vblank(start + 1ms);
+
+    ASSERT_TRUE(vblank);
+    EXPECT_THAT(vblank.value() - start, Eq(2*period));
+}
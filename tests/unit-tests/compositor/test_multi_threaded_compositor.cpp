@@ -27,6 +27,7 @@
 #include "mir/raii.h"
 
 #include "mir/test/current_thread_name.h"
+#include "mir/test/expect_no_allocations.h"
 #include "mir/test/doubles/null_display.h"
 #include "mir/test/doubles/null_display_buffer.h"
 #include "mir/test/doubles/mock_display_buffer.h"
@@ -87,6 +88,10 @@ private:
         {
             return std::chrono::milliseconds::zero();
         }
+        bool variable_refresh_active() const override
+        {
+            return false;
+        }
         testing::NiceMock<mtd::MockDisplayBuffer> buffer; 
     };
 
@@ -345,6 +350,32 @@ public:
     std::vector<std::string> thread_names;
 };
 
+// Counts frames without touching the heap, so any allocation seen while
+// compositing belongs to the compositor loop itself
+class CountingDisplayBufferCompositorFactory : public mc::DisplayBufferCompositorFactory
+{
+public:
+    std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(mg::DisplayBuffer&) override
+    {
+        return std::make_unique<CountingDisplayBufferCompositor>(frames);
+    }
+
+    std::atomic<int> frames{0};
+
+private:
+    struct CountingDisplayBufferCompositor : mc::DisplayBufferCompositor
+    {
+        CountingDisplayBufferCompositor(std::atomic<int>& frames) : frames(frames) {}
+
+        void composite(mc::SceneElementSequence&&) override
+        {
+            ++frames;
+        }
+
+        std::atomic<int>& frames;
+    };
+};
+
 namespace
 {
 struct StubDisplayListener : mc::DisplayListener
@@ -843,6 +874,36 @@ TEST(MultiThreadedCompositor, names_compositor_threads)
         EXPECT_THAT(thread_names[i], Eq("Mir/Comp")) << "i=" << i;
 }
 
+TEST(MultiThreadedCompositor, steady_state_frames_do_not_allocate)
+{
+    int const nbuffers{3};
+    int const frames_to_check{30};
+
+    auto display = std::make_shared<mtd::StubDisplay>(nbuffers);
+    auto scene = std::make_shared<StubScene>();
+    auto db_compositor_factory = std::make_shared<CountingDisplayBufferCompositorFactory>();
+    mc::MultiThreadedCompositor compositor{display, scene, db_compositor_factory, null_display_listener, null_report, default_delay, true};
+
+    compositor.start();
+
+    // Let the first frames, which set up per-thread state, get out of the way
+    while (db_compositor_factory->frames < nbuffers)
+        std::this_thread::yield();
+
+    // Outside profiling builds only the scheduling side is checked; profiling
+    // builds also charge the compositor threads through "compositor.frame"
+    EXPECT_NO_ALLOCATIONS_IN(
+        for (int i = 0; i != frames_to_check; ++i)
+        {
+            auto const target = db_compositor_factory->frames + nbuffers;
+            scene->emit_change_event();
+            while (db_compositor_factory->frames < target)
+                std::this_thread::yield();
+        });
+
+    compositor.stop();
+}
+
 TEST(MultiThreadedCompositor, registers_and_unregisters_with_scene)
 {
     using namespace testing;
@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/presentation_clock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+using namespace std::literals::chrono_literals;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+namespace
+{
+struct PresentationClock : Test
+{
+    std::chrono::nanoseconds const period{16ms};
+    std::chrono::nanoseconds const margin{2ms};
+    std::chrono::nanoseconds const start{1000s};
+
+    mc::PresentationClock clock;
+};
+}
+
+TEST_F(PresentationClock, knows_nothing_until_a_frame_is_scheduled)
+{
+    EXPECT_FALSE(clock.next_presentation(start));
+}
+
+TEST_F(PresentationClock, assumes_a_frame_away_without_vblank_timing)
+{
+    clock.frame_scheduled(mc::FrameScheduler{period, margin});
+
+    auto const presentation = clock.next_presentation(start);
+
+    ASSERT_TRUE(presentation);
+    EXPECT_THAT(presentation.value(), Eq(start + period));
+}
+
+TEST_F(PresentationClock, follows_the_vblank_schedule)
+{
+    mc::FrameScheduler scheduler{period, margin};
+    mg::Frame frame;
+    frame.msc = 1;
+    frame.ust = mc::FrameScheduler::Timestamp{CLOCK_MONOTONIC, start};
+    scheduler.frame_displayed(frame);
+
+    clock.frame_scheduled(scheduler);
+
+    auto const presentation = clock.next_presentation(start + 1ms);
+
+    ASSERT_TRUE(presentation);
+    EXPECT_THAT(presentation.value(), Eq(start + period));
+}
@@ -84,3 +84,28 @@ TEST_F(QueueingSchedule, queuing_the_same_buffer_moves_it_to_front_of_queue)
     EXPECT_THAT(drain_queue(),
         ElementsAre(buffers[1], buffers[2], buffers[3], buffers[4], buffers[0]));
 }
+
+TEST_F(QueueingSchedule, bounded_queue_drops_oldest_buffer)
+{
+    mc::QueueingSchedule bounded{2};
+    for(auto i = 0u; i < num_buffers; i++)
+        bounded.schedule(buffers[i]);
+
+    EXPECT_THAT(bounded.num_scheduled(), Eq(2u));
+    for(auto i = 0u; i < num_buffers - 2; i++)
+        EXPECT_TRUE(buffers[i].unique());
+
+    EXPECT_THAT(bounded.next_buffer(), Eq(buffers[3]));
+    EXPECT_THAT(bounded.next_buffer(), Eq(buffers[4]));
+}
+
+TEST_F(QueueingSchedule, rescheduling_queued_buffer_in_bounded_queue_does_not_drop)
+{
+    mc::QueueingSchedule bounded{2};
+    bounded.schedule(buffers[0]);
+    bounded.schedule(buffers[1]);
+    bounded.schedule(buffers[0]);
+
+    EXPECT_THAT(bounded.next_buffer(), Eq(buffers[1]));
+    EXPECT_THAT(bounded.next_buffer(), Eq(buffers[0]));
+}
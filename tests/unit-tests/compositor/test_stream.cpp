@@ -20,8 +20,14 @@
 #include "mir/test/doubles/stub_buffer_allocator.h"
 #include "mir/test/doubles/mock_event_sink.h"
 #include "mir/test/fake_shared.h"
+#include "mir/test/doubles/mock_frame_pacing_observer.h"
+#include "mir/test/doubles/advanceable_clock.h"
 #include "src/server/compositor/stream.h"
+#include "src/server/compositor/buffer_stream_factory.h"
+#include "mir/graphics/buffer_properties.h"
+#include "src/server/compositor/frame_pacing_monitor.h"
 #include "mir/scene/null_surface_observer.h"
+#include "mir/metrics/registry.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -234,3 +240,138 @@ TEST_F(Stream, returns_buffers_to_client_when_told_to_bring_queue_up_to_date)
     EXPECT_THAT(buffers[1].use_count(), Eq(1));
     EXPECT_THAT(buffers[2].use_count(), Eq(2));
 }
+
+TEST_F(Stream, bounded_queue_returns_superseded_buffers_to_client)
+{
+    stream.set_queue_depth(2);
+
+    for(auto& buffer : buffers)
+        stream.submit_buffer(buffer);
+
+    EXPECT_TRUE(buffers[0].unique());
+
+    std::vector<std::shared_ptr<mg::Buffer>> cbuffers;
+    while(stream.buffers_ready_for_compositor(this))
+        cbuffers.push_back(stream.lock_compositor_buffer(this));
+    EXPECT_THAT(cbuffers, ElementsAre(buffers[1], buffers[2]));
+}
+
+TEST_F(Stream, reducing_queue_depth_trims_queued_buffers)
+{
+    for(auto& buffer : buffers)
+        stream.submit_buffer(buffer);
+
+    stream.set_queue_depth(1);
+
+    EXPECT_THAT(stream.queue_depth(), Eq(1u));
+    EXPECT_TRUE(buffers[0].unique());
+    EXPECT_TRUE(buffers[1].unique());
+    EXPECT_THAT(stream.lock_compositor_buffer(this), Eq(buffers[2]));
+}
+
+TEST_F(Stream, factory_creates_streams_with_the_configured_queue_depth)
+{
+    mc::BufferStreamFactory factory{nullptr, 2};
+
+    auto const stream = factory.create_buffer_stream(
+        mf::BufferStreamId{}, mg::BufferProperties{initial_size, mir_pixel_format_abgr_8888, mg::BufferUsage::hardware});
+
+    EXPECT_THAT(stream->queue_depth(), Eq(2u));
+}
+
+TEST_F(Stream, counts_buffers_waiting_for_the_compositor)
+{
+    auto const queued_buffers = std::make_shared<mir::metrics::Gauge>();
+    mc::BufferStreamFactory factory{nullptr, 0, queued_buffers};
+    auto const properties = mg::BufferProperties{initial_size, mir_pixel_format_abgr_8888, mg::BufferUsage::hardware};
+    auto const first = factory.create_buffer_stream(mf::BufferStreamId{}, properties);
+    auto second = factory.create_buffer_stream(mf::BufferStreamId{}, properties);
+
+    for(auto& buffer : buffers)
+        first->submit_buffer(buffer);
+    second->submit_buffer(std::make_shared<mtd::StubBuffer>(initial_size));
+    EXPECT_THAT(queued_buffers->value(), Eq(4));
+
+    first->lock_compositor_buffer(this);
+    EXPECT_THAT(queued_buffers->value(), Eq(3));
+
+    first->allow_framedropping(true);
+    EXPECT_THAT(queued_buffers->value(), Eq(2));
+
+    second.reset();
+    EXPECT_THAT(queued_buffers->value(), Eq(1));
+}
+
+TEST_F(Stream, framedropping_overrides_queue_depth_until_disabled)
+{
+    stream.set_queue_depth(2);
+    stream.allow_framedropping(true);
+    EXPECT_THAT(stream.queue_depth(), Eq(1u));
+
+    stream.allow_framedropping(false);
+    EXPECT_THAT(stream.queue_depth(), Eq(2u));
+}
+
+TEST_F(Stream, reports_frames_superseded_while_framedropping)
+{
+    auto const observer = std::make_shared<NiceMock<mtd::MockFramePacingObserver>>();
+    auto const pacing = std::make_shared<mc::FramePacingMonitor>(observer, std::make_shared<mtd::AdvanceableClock>());
+    mc::Stream paced_stream{initial_size, construction_format, pacing};
+    paced_stream.allow_framedropping(true);
+
+    EXPECT_CALL(*observer, client_frame_dropped(&paced_stream)).Times(buffers.size() - 1);
+
+    for (auto& buffer : buffers)
+        paced_stream.submit_buffer(buffer);
+}
+
+TEST_F(Stream, does_not_report_dropped_frames_when_queueing)
+{
+    auto const observer = std::make_shared<NiceMock<mtd::MockFramePacingObserver>>();
+    auto const pacing = std::make_shared<mc::FramePacingMonitor>(observer, std::make_shared<mtd::AdvanceableClock>());
+    mc::Stream paced_stream{initial_size, construction_format, pacing};
+
+    EXPECT_CALL(*observer, client_frame_dropped(_)).Times(0);
+
+    for (auto& buffer : buffers)
+        paced_stream.submit_buffer(buffer);
+}
+
+TEST_F(Stream, does_not_report_frames_the_compositor_took_as_dropped)
+{
+    auto const observer = std::make_shared<NiceMock<mtd::MockFramePacingObserver>>();
+    auto const pacing = std::make_shared<mc::FramePacingMonitor>(observer, std::make_shared<mtd::AdvanceableClock>());
+    mc::Stream paced_stream{initial_size, construction_format, pacing};
+    paced_stream.allow_framedropping(true);
+
+    EXPECT_CALL(*observer, client_frame_dropped(_)).Times(0);
+
+    for (auto& buffer : buffers)
+    {
+        paced_stream.submit_buffer(buffer);
+        paced_stream.lock_compositor_buffer(this);
+    }
+}
+
+TEST_F(Stream, frame_rate_counts_frames_the_compositor_takes_not_those_submitted)
+{
+    auto const observer = std::make_shared<NiceMock<mtd::MockFramePacingObserver>>();
+    auto const clock = std::make_shared<mtd::AdvanceableClock>();
+    auto const pacing = std::make_shared<mc::FramePacingMonitor>(observer, clock);
+    mc::Stream paced_stream{initial_size, construction_format, pacing};
+    paced_stream.allow_framedropping(true);
+    int const other_compositor{0};
+
+    // Each frame is shown on two outputs, and half the submitted frames are
+    // replaced before the compositor gets to them
+    EXPECT_CALL(*observer, client_frame_rate(&paced_stream, FloatNear(25.0f, 0.1f)));
+
+    for (int frame = 0; frame != 26; ++frame)
+    {
+        paced_stream.submit_buffer(buffers[(2 * frame) % buffers.size()]);
+        paced_stream.submit_buffer(buffers[(2 * frame + 1) % buffers.size()]);
+        paced_stream.lock_compositor_buffer(this);
+        paced_stream.lock_compositor_buffer(&other_compositor);
+        clock->advance_by(40ms);
+    }
+}
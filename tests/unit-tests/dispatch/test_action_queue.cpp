@@ -18,14 +18,23 @@
 
 #include "mir/dispatch/action_queue.h"
 
+#include "mir/test/allocation_counter.h"
 #include "mir/test/fd_utils.h"
+#include "mir/test/signal.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 namespace mt = mir::test;
 namespace md = mir::dispatch;
 using namespace ::testing;
+using namespace std::literals::chrono_literals;
 
 TEST(ActionQueue, watch_fd_becomes_readable_on_enqueue)
 {
@@ -78,4 +87,169 @@ TEST(ActionQueue, executes_action_only_once)
     EXPECT_THAT(count_executed, Eq(1));
 }
 
+TEST(ActionQueue, executes_all_pending_actions_in_one_dispatch)
+{
+    md::ActionQueue queue;
+
+    auto count_executed = 0;
+
+    queue.enqueue([&](){++count_executed;});
+    queue.enqueue([&](){++count_executed;});
+    queue.enqueue([&](){++count_executed;});
+
+    queue.dispatch(md::FdEvent::readable);
+
+    EXPECT_THAT(count_executed, Eq(3));
+    EXPECT_FALSE(mt::fd_is_readable(queue.watch_fd()));
+}
+
+TEST(ActionQueue, executes_actions_in_order)
+{
+    md::ActionQueue queue;
+
+    std::vector<int> executed;
+
+    for (auto i = 0; i != 5; ++i)
+        queue.enqueue([&executed, i](){ executed.push_back(i); });
+
+    queue.dispatch(md::FdEvent::readable);
+
+    EXPECT_THAT(executed, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(ActionQueue, action_enqueued_by_action_runs_on_next_dispatch)
+{
+    md::ActionQueue queue;
+
+    auto inner_executed = false;
+
+    queue.enqueue([&](){ queue.enqueue([&](){ inner_executed = true; }); });
+
+    queue.dispatch(md::FdEvent::readable);
+    EXPECT_FALSE(inner_executed);
+    ASSERT_TRUE(mt::fd_is_readable(queue.watch_fd()));
+
+    queue.dispatch(md::FdEvent::readable);
+    EXPECT_TRUE(inner_executed);
+}
+
+TEST(ActionQueue, accepts_move_only_and_oversized_actions)
+{
+    md::ActionQueue queue;
+
+    auto value = std::make_unique<int>(7);
+    std::array<char, 2*md::ActionQueue::inline_capacity> padding{};
+    auto result = 0;
+
+    queue.enqueue([&result, value = std::move(value)](){ result += *value; });
+    queue.enqueue([&result, padding](){ result += padding[0] + 1; });
+
+    queue.dispatch(md::FdEvent::readable);
+
+    EXPECT_THAT(result, Eq(8));
+}
+
+TEST(ActionQueue, destroys_undispatched_actions)
+{
+    auto const tracker = std::make_shared<int>();
 
+    {
+        md::ActionQueue queue;
+        queue.enqueue([tracker](){});
+        EXPECT_THAT(tracker.use_count(), Gt(1));
+    }
+
+    EXPECT_THAT(tracker.use_count(), Eq(1));
+}
+
+TEST(ActionQueue, actions_after_a_throwing_action_are_still_dispatched)
+{
+    md::ActionQueue queue;
+
+    auto later_executed = false;
+
+    queue.enqueue([](){ throw std::runtime_error{"Eep!"}; });
+    queue.enqueue([&](){ later_executed = true; });
+
+    EXPECT_THROW(queue.dispatch(md::FdEvent::readable), std::runtime_error);
+    ASSERT_TRUE(mt::fd_is_readable(queue.watch_fd()));
+
+    queue.dispatch(md::FdEvent::readable);
+    EXPECT_TRUE(later_executed);
+}
+
+TEST(ActionQueue, steady_state_enqueue_and_dispatch_do_not_allocate)
+{
+    md::ActionQueue queue;
+
+    auto count_executed = 0;
+
+    mt::AllocationCounter const allocations;
+    for (auto i = 0; i != 1000; ++i)
+    {
+        queue.enqueue([&](){++count_executed;});
+        queue.enqueue([&](){++count_executed;});
+        queue.dispatch(md::FdEvent::readable);
+    }
+    auto const count = allocations.count();
+
+    EXPECT_THAT(count, Eq(0u));
+    EXPECT_THAT(count_executed, Eq(2000));
+}
+
+TEST(ActionQueue, executes_more_pending_actions_than_the_pool_holds)
+{
+    md::ActionQueue queue;
+
+    auto const action_count = 3 * md::ActionQueue::pool_size + 1;
+    std::size_t count_executed = 0;
+
+    for (auto i = 0u; i != action_count; ++i)
+        queue.enqueue([&](){++count_executed;});
+
+    queue.dispatch(md::FdEvent::readable);
+    EXPECT_THAT(count_executed, Eq(action_count));
+
+    for (auto i = 0u; i != action_count; ++i)
+        queue.enqueue([&](){++count_executed;});
+
+    queue.dispatch(md::FdEvent::readable);
+    EXPECT_THAT(count_executed, Eq(2 * action_count));
+}
+
+TEST(ActionQueue, concurrent_dispatch_waits_for_the_running_one_and_consumes_its_wakeup)
+{
+    md::ActionQueue queue;
+
+    mt::Signal first_running;
+    mt::Signal first_may_finish;
+    auto second_executed = false;
+
+    queue.enqueue([&]
+        {
+            first_running.raise();
+            first_may_finish.wait_for(30s);
+        });
+
+    std::thread first_dispatcher{[&] { queue.dispatch(md::FdEvent::readable); }};
+    ASSERT_TRUE(first_running.wait_for(30s));
+
+    queue.enqueue([&]{ second_executed = true; });
+    ASSERT_TRUE(mt::fd_is_readable(queue.watch_fd()));
+
+    mt::Signal second_returned;
+    std::thread second_dispatcher{[&]
+        {
+            queue.dispatch(md::FdEvent::readable);
+            second_returned.raise();
+        }};
+
+    EXPECT_FALSE(second_returned.wait_for(100ms));
+
+    first_may_finish.raise();
+    first_dispatcher.join();
+    second_dispatcher.join();
+
+    EXPECT_TRUE(second_executed);
+    EXPECT_FALSE(mt::fd_is_readable(queue.watch_fd()));
+}
@@ -20,6 +20,8 @@
 #include "mir/frontend/message_processor_report.h"
 #include "src/server/frontend/display_server.h"
 #include "src/server/frontend/protobuf_message_processor.h"
+#include "mir/memory/accounting.h"
+#include "mir/test/expect_no_allocations.h"
 #include "mir/test/fake_shared.h"
 #include "mir/test/doubles/stub_display_server.h"
 #include "mir_protobuf_wire.pb.h"
@@ -40,7 +42,10 @@ struct StubProtobufMessageSender : mfd::ProtobufMessageSender
 {
     void send_response(gp::uint32, gp::MessageLite*, mf::FdSets const&) override
     {
+        ++responses_sent;
     }
+
+    int responses_sent{0};
 };
 
 struct StubMessageProcessorReport : mf::MessageProcessorReport
@@ -90,6 +95,28 @@ struct StubDisplayServer : mtd::StubDisplayServer
     bool changed_during_create_surface_closure;
     bool changed_during_create_bstream_closure;
 };
+
+template<typename Exception>
+struct ThrowingDisplayServer : mtd::StubDisplayServer
+{
+    void allocate_buffers(
+        mp::BufferAllocation const*,
+        mp::Void*,
+        google::protobuf::Closure*) override
+    {
+        throw Exception{"over quota"};
+    }
+};
+
+mfd::Invocation allocate_buffers_invocation(mpw::Invocation& raw_invocation)
+{
+    mp::BufferAllocation request;
+    std::string str_parameters;
+    request.SerializeToString(&str_parameters);
+    raw_invocation.set_parameters(str_parameters);
+    raw_invocation.set_method_name("allocate_buffers");
+    return mfd::Invocation{raw_invocation};
+}
 }
 
 TEST(ProtobufMessageProcessor, doesnt_inject_buffers_when_creating_surface)
@@ -151,3 +178,67 @@ TEST(ProtobufMessageProcessor, doesnt_inject_buffers_when_creating_bstream)
     mp->dispatch(invocation, fds);
     EXPECT_FALSE(stub_display_server.changed_during_create_bstream_closure);
 }
+
+// A client is disconnected by its connection when dispatch() fails
+TEST(ProtobufMessageProcessor, a_request_over_the_memory_quota_fails_dispatch)
+{
+    StubProtobufMessageSender stub_msg_sender;
+    StubMessageProcessorReport stub_report;
+    ThrowingDisplayServer<mir::memory::QuotaExceeded> display_server;
+    auto const mp = std::make_shared<mfd::ProtobufMessageProcessor>(
+        mt::fake_shared(stub_msg_sender),
+        mt::fake_shared(display_server),
+        mt::fake_shared(stub_report));
+
+    mpw::Invocation raw_invocation;
+    std::vector<mir::Fd> fds;
+
+    EXPECT_FALSE(mp->dispatch(allocate_buffers_invocation(raw_invocation), fds));
+    EXPECT_THAT(stub_msg_sender.responses_sent, testing::Eq(0));
+}
+
+TEST(ProtobufMessageProcessor, other_request_errors_are_sent_to_the_client)
+{
+    StubProtobufMessageSender stub_msg_sender;
+    StubMessageProcessorReport stub_report;
+    ThrowingDisplayServer<std::runtime_error> display_server;
+    auto const mp = std::make_shared<mfd::ProtobufMessageProcessor>(
+        mt::fake_shared(stub_msg_sender),
+        mt::fake_shared(display_server),
+        mt::fake_shared(stub_report));
+
+    mpw::Invocation raw_invocation;
+    std::vector<mir::Fd> fds;
+
+    EXPECT_TRUE(mp->dispatch(allocate_buffers_invocation(raw_invocation), fds));
+    EXPECT_THAT(stub_msg_sender.responses_sent, testing::Eq(1));
+}
+
+#ifdef MIR_ALLOC_PROFILING
+// Every request builds its result message and completion closure on the heap,
+// so this path is profiled rather than held to zero allocations
+TEST(ProtobufMessageProcessor, charges_dispatch_allocations_to_the_rpc_path)
+{
+    StubProtobufMessageSender stub_msg_sender;
+    StubMessageProcessorReport stub_report;
+    mtd::StubDisplayServer display_server;
+    auto const mp = std::make_shared<mfd::ProtobufMessageProcessor>(
+        mt::fake_shared(stub_msg_sender),
+        mt::fake_shared(display_server),
+        mt::fake_shared(stub_report));
+
+    mpw::Invocation raw_invocation;
+    std::vector<mir::Fd> fds;
+    auto const invocation = allocate_buffers_invocation(raw_invocation);
+
+    EXPECT_TRUE(mp->dispatch(invocation, fds));
+
+    auto const dispatch_site = mt::marked_allocation_site("rpc.dispatch");
+    ASSERT_THAT(dispatch_site, testing::NotNull());
+    auto const allocations_before = dispatch_site->allocations.load();
+
+    EXPECT_TRUE(mp->dispatch(invocation, fds));
+
+    EXPECT_THAT(dispatch_site->allocations.load(), testing::Gt(allocations_before));
+}
+#endif
@@ -70,6 +70,7 @@
 #include "mir/frontend/connector.h"
 #include "mir/frontend/event_sink.h"
 #include "mir/cookie/authority.h"
+#include "mir/memory/accounting.h"
 #include "mir/input/mir_input_config.h"
 #include "mir/input/mir_input_config_serialization.h"
 #include "mir_protobuf.pb.h"
@@ -300,6 +301,7 @@ struct SessionMediator : public ::testing::Test
           stubbed_session{std::make_shared<NiceMock<StubbedSession>>()},
           null_callback{google::protobuf::NewPermanentCallback(google::protobuf::DoNothing)},
           allocator{std::make_shared<RecordingBufferAllocator>()},
+          accounting{std::make_shared<mir::memory::Accounting>(0, mir::memory::QuotaAction::reject)},
           mediator{
             shell, mt::fake_shared(mock_ipc_operations), graphics_changer,
             surface_pixel_formats, report,
@@ -313,7 +315,8 @@ struct SessionMediator : public ::testing::Test
             mt::fake_shared(mock_input_config_changer),
             {},
             allocator,
-            executor}
+            executor,
+            accounting}
     {
         using namespace ::testing;
 
@@ -345,7 +348,8 @@ struct SessionMediator : public ::testing::Test
             mir::cookie::Authority::create(),
             mt::fake_shared(mock_input_config_changer), std::vector<mir::ExtensionDescription>{},
             allocator,
-            executor);
+            executor,
+            accounting);
     }
 
     std::shared_ptr<mf::SessionMediator> create_session_mediator_with_screencast(
@@ -362,7 +366,8 @@ struct SessionMediator : public ::testing::Test
             mir::cookie::Authority::create(),
             mt::fake_shared(mock_input_config_changer), std::vector<mir::ExtensionDescription>{},
             allocator,
-            executor);
+            executor,
+            accounting);
     }
 
     std::shared_ptr<mf::SessionMediator> create_session_mediator_with_event_sink(
@@ -467,7 +472,8 @@ struct SessionMediator : public ::testing::Test
             mt::fake_shared(mock_input_config_changer),
             std::vector<mir::ExtensionDescription>{},
             allocator,
-            executor);
+            executor,
+            accounting);
     }
 
     MockConnector connector;
@@ -483,6 +489,7 @@ struct SessionMediator : public ::testing::Test
     std::unique_ptr<google::protobuf::Closure> null_callback;
     std::shared_ptr<RecordingBufferAllocator> const allocator;
     NiceMock<MockExecutor> executor;
+    std::shared_ptr<mir::memory::Accounting> accounting;
     mf::SessionMediator mediator;
 
     mp::ConnectParameters connect_parameters;
@@ -529,7 +536,8 @@ TEST_F(SessionMediator, connect_calls_connect_handler)
         mir::cookie::Authority::create(),
         mt::fake_shared(mock_input_config_changer), {},
         allocator,
-        executor};
+        executor,
+        accounting};
 
     EXPECT_THAT(connects_handled_count, Eq(0));
 
@@ -1020,7 +1028,8 @@ TEST_F(SessionMediator, events_sent_before_surface_creation_reply_are_buffered)
         mir::cookie::Authority::create(),
         mt::fake_shared(mock_input_config_changer), {},
         allocator,
-        executor};
+        executor,
+        accounting};
 
     ON_CALL(*shell, create_surface( _, _, _))
         .WillByDefault(
@@ -1590,3 +1599,94 @@ TEST_F(SessionMediator, release_buffer_stream_releases_associated_buffers)
         allocator->allocated_buffers,
         Each(Property(&std::weak_ptr<mg::Buffer>::expired, Eq(true))));
 }
+
+TEST_F(SessionMediator, charges_buffers_to_the_client_account_until_released)
+{
+    mp::BufferStreamId stream_id;
+    mp::BufferAllocation allocate_buffer;
+    mp::Void null;
+
+    stream_id.set_value(42);
+    stubbed_session->create_mock_stream(mf::BufferStreamId{stream_id.value()});
+
+    *allocate_buffer.mutable_id() = stream_id;
+    add_software_buffer_request(allocate_buffer, 640, 480, mir_pixel_format_argb_8888);
+    add_software_buffer_request(allocate_buffer, 640, 480, mir_pixel_format_argb_8888);
+
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+    mediator.allocate_buffers(&allocate_buffer, &null, null_callback.get());
+
+    auto const client = accounting->snapshot().back();
+    auto const& shm = client.usage[static_cast<unsigned>(mir::memory::Subsystem::shm_buffers)];
+    EXPECT_THAT(shm.allocations, Eq(2u));
+    EXPECT_THAT(shm.bytes, Eq(2u * 640 * 480 * 4));
+    EXPECT_THAT(client.total_bytes, Eq(shm.bytes));
+
+    mediator.release_buffer_stream(&stream_id, &null, null_callback.get());
+
+    EXPECT_THAT(accounting->snapshot().back().total_bytes, Eq(0u));
+}
+
+TEST_F(SessionMediator, buffers_over_quota_are_sent_as_error_buffers_when_quota_action_is_reject)
+{
+    using namespace testing;
+    size_t const buffer_size = 640 * 480 * 4;
+    accounting = std::make_shared<mir::memory::Accounting>(2 * buffer_size, mir::memory::QuotaAction::reject);
+
+    auto sink = std::make_shared<NiceMock<mtd::MockEventSink>>();
+    auto mediator = create_session_mediator_with_event_sink(sink);
+    mediator->connect(&connect_parameters, &connection, null_callback.get());
+
+    mp::Void null;
+    mp::BufferAllocation request;
+    for (auto i = 0; i < 3; i++)
+        add_software_buffer_request(request, 640, 480, mir_pixel_format_argb_8888);
+
+    EXPECT_CALL(*sink, add_buffer(_)).Times(2);
+    EXPECT_CALL(*sink, error_buffer(_,_,_)).Times(1);
+    mediator->allocate_buffers(&request, &null, null_callback.get());
+
+    EXPECT_THAT(accounting->snapshot().back().total_bytes, Eq(2 * buffer_size));
+}
+
+TEST_F(SessionMediator, buffers_over_quota_throw_when_quota_action_is_disconnect)
+{
+    using namespace testing;
+    size_t const buffer_size = 640 * 480 * 4;
+    accounting = std::make_shared<mir::memory::Accounting>(buffer_size, mir::memory::QuotaAction::disconnect);
+
+    auto sink = std::make_shared<NiceMock<mtd::MockEventSink>>();
+    auto mediator = create_session_mediator_with_event_sink(sink);
+    mediator->connect(&connect_parameters, &connection, null_callback.get());
+
+    mp::Void null;
+    mp::BufferAllocation request;
+    for (auto i = 0; i < 2; i++)
+        add_software_buffer_request(request, 640, 480, mir_pixel_format_argb_8888);
+
+    EXPECT_CALL(*sink, error_buffer(_,_,_)).Times(0);
+    EXPECT_THROW(
+        mediator->allocate_buffers(&request, &null, null_callback.get()),
+        mir::memory::QuotaExceeded);
+}
+
+TEST_F(SessionMediator, buffers_over_quota_are_not_allocated)
+{
+    using namespace testing;
+    size_t const buffer_size = 640 * 480 * 4;
+    accounting = std::make_shared<mir::memory::Accounting>(buffer_size, mir::memory::QuotaAction::reject);
+
+    auto sink = std::make_shared<NiceMock<mtd::MockEventSink>>();
+    auto mediator = create_session_mediator_with_event_sink(sink);
+    mediator->connect(&connect_parameters, &connection, null_callback.get());
+
+    mp::Void null;
+    mp::BufferAllocation request;
+    add_software_buffer_request(request, 640, 480, mir_pixel_format_argb_8888);
+    add_software_buffer_request(request, 1920, 1080, mir_pixel_format_argb_8888);
+
+    mediator->allocate_buffers(&request, &null, null_callback.get());
+
+    EXPECT_THAT(allocator->allocated_buffers, SizeIs(1));
+    EXPECT_THAT(accounting->snapshot().back().total_bytes, Eq(buffer_size));
+}
@@ -140,3 +140,23 @@ TEST_F(RecentlyUsedCache, invalidated_buffers_are_reloaded)
     cache.invalidate();
     cache.load(*renderable);
 }
+
+TEST_F(RecentlyUsedCache, charges_textures_to_the_account_until_dropped)
+{
+    using namespace testing;
+    ON_CALL(*mock_buffer, size())
+        .WillByDefault(Return(mir::geometry::Size{64, 32}));
+    ON_CALL(*mock_buffer, pixel_format())
+        .WillByDefault(Return(mir_pixel_format_abgr_8888));
+
+    auto const account = std::make_shared<mir::memory::Account>("textures", 0, 0);
+    mgl::RecentlyUsedCache cache{account};
+
+    cache.load(*renderable);
+    EXPECT_THAT(account->usage(mir::memory::Subsystem::textures).bytes, Eq(64u * 32 * 4));
+    EXPECT_THAT(account->usage(mir::memory::Subsystem::textures).allocations, Eq(1u));
+
+    cache.drop_unused();
+    cache.drop_unused();
+    EXPECT_THAT(account->usage(mir::memory::Subsystem::textures).allocations, Eq(0u));
+}
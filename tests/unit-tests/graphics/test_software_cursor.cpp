@@ -19,6 +19,7 @@
 #include "src/server/graphics/software_cursor.h"
 #include "mir/graphics/cursor_image.h"
 #include "mir/graphics/renderable.h"
+#include "mir/geometry/rectangles.h"
 
 #include "mir/test/doubles/stub_buffer_allocator.h"
 #include "mir/test/doubles/stub_input_scene.h"
@@ -45,15 +46,16 @@ struct MockInputScene : mtd::StubInputScene
                  void(std::weak_ptr<mg::Renderable> const&));
 
     MOCK_METHOD0(emit_scene_changed, void());
+    MOCK_METHOD1(emit_scene_damaged, void(geom::Rectangle const&));
 };
 
 struct StubCursorImage : mg::CursorImage
 {
-    StubCursorImage(geom::Displacement const& hotspot)
+    StubCursorImage(geom::Displacement const& hotspot, unsigned char fill = 0x55)
         : hotspot_{hotspot},
           pixels(
             size().width.as_uint32_t() * size().height.as_uint32_t() * bytes_per_pixel,
-            0x55)
+            fill)
     {
     }
 
@@ -78,10 +80,19 @@ private:
     std::vector<unsigned char> pixels;
 };
 
+struct MockBufferAllocator : public mg::GraphicBufferAllocator
+{
+    MOCK_METHOD1(alloc_buffer, std::shared_ptr<mg::Buffer>(mg::BufferProperties const&));
+    MOCK_METHOD2(alloc_software_buffer, std::shared_ptr<mg::Buffer>(geom::Size, MirPixelFormat));
+    MOCK_METHOD3(alloc_buffer, std::shared_ptr<mg::Buffer>(geom::Size, uint32_t, uint32_t));
+    std::vector<MirPixelFormat> supported_pixel_formats() { return {mir_pixel_format_abgr_8888}; }
+};
+
 struct SoftwareCursor : testing::Test
 {
     StubCursorImage stub_cursor_image{{3,4}};
     StubCursorImage another_stub_cursor_image{{10,9}};
+    StubCursorImage differently_filled_cursor_image{{3,4}, 0xaa};
     mtd::StubBufferAllocator stub_buffer_allocator;
     testing::NiceMock<MockInputScene> mock_input_scene;
 
@@ -189,14 +200,22 @@ TEST_F(SoftwareCursor, moves_scene_renderable_offset_by_hotspot_when_moved)
                 Eq(new_position - stub_cursor_image.hotspot()));
 }
 
-TEST_F(SoftwareCursor, notifies_scene_when_moving)
+TEST_F(SoftwareCursor, damages_old_and_new_position_when_moving)
 {
     using namespace testing;
 
-    EXPECT_CALL(mock_input_scene, emit_scene_changed());
-
     cursor.show(stub_cursor_image);
-    cursor.move_to({22,23});
+    cursor.move_to({100,100});
+
+    auto const size = stub_cursor_image.size();
+    geom::Rectangles expected_damage;
+    expected_damage.add({geom::Point{100,100} - stub_cursor_image.hotspot(), size});
+    expected_damage.add({geom::Point{122,123} - stub_cursor_image.hotspot(), size});
+
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(expected_damage.bounding_rectangle()));
+    EXPECT_CALL(mock_input_scene, emit_scene_changed()).Times(0);
+
+    cursor.move_to({122,123});
 }
 
 TEST_F(SoftwareCursor, multiple_shows_just_show)
@@ -246,6 +265,7 @@ TEST_F(SoftwareCursor, does_not_hide_or_move_when_already_hidden)
 
     EXPECT_CALL(mock_input_scene, remove_input_visualization(_)).Times(0);
     EXPECT_CALL(mock_input_scene, emit_scene_changed()).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_)).Times(0);
 
     // Already hidden, nothing should happen
     cursor.hide();
@@ -295,25 +315,44 @@ TEST_F(SoftwareCursor, places_new_cursor_renderable_at_correct_position)
 }
 
 //lp: #1413211
-TEST_F(SoftwareCursor, new_buffer_on_each_show)
+TEST_F(SoftwareCursor, new_buffer_for_each_new_image)
 {
-    struct MockBufferAllocator : public mg::GraphicBufferAllocator
-    {
-        MOCK_METHOD1(alloc_buffer, std::shared_ptr<mg::Buffer>(mg::BufferProperties const&));
-        MOCK_METHOD2(alloc_software_buffer, std::shared_ptr<mg::Buffer>(geom::Size, MirPixelFormat));
-        MOCK_METHOD3(alloc_buffer, std::shared_ptr<mg::Buffer>(geom::Size, uint32_t, uint32_t));
-        std::vector<MirPixelFormat> supported_pixel_formats() { return {mir_pixel_format_abgr_8888}; } 
-    } mock_allocator;
+    MockBufferAllocator mock_allocator;
 
     EXPECT_CALL(mock_allocator, alloc_buffer(testing::_))
-        .Times(3)
-        .WillRepeatedly(testing::Return(std::make_shared<mtd::StubBuffer>()));;
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([](auto) { return std::make_shared<mtd::StubBuffer>(); }));
     mg::SoftwareCursor cursor{
         mt::fake_shared(mock_allocator),
         mt::fake_shared(mock_input_scene)};
-    cursor.show(another_stub_cursor_image);
-    cursor.show(another_stub_cursor_image);
     cursor.show(stub_cursor_image);
+    cursor.show(differently_filled_cursor_image);
+}
+
+TEST_F(SoftwareCursor, reuses_buffers_of_recently_shown_images)
+{
+    using namespace testing;
+    MockBufferAllocator mock_allocator;
+
+    EXPECT_CALL(mock_allocator, alloc_buffer(_))
+        .Times(2)
+        .WillRepeatedly(Invoke([](auto) { return std::make_shared<mtd::StubBuffer>(); }));
+    mg::SoftwareCursor cursor{
+        mt::fake_shared(mock_allocator),
+        mt::fake_shared(mock_input_scene)};
+
+    std::vector<std::shared_ptr<mg::Renderable>> renderables;
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_))
+        .WillRepeatedly(Invoke([&](auto const& renderable) { renderables.push_back(renderable); }));
+
+    cursor.show(stub_cursor_image);
+    cursor.show(differently_filled_cursor_image);
+    cursor.show(stub_cursor_image);
+    cursor.show(differently_filled_cursor_image);
+
+    ASSERT_THAT(renderables.size(), Eq(4u));
+    EXPECT_THAT(renderables[2]->buffer(), Eq(renderables[0]->buffer()));
+    EXPECT_THAT(renderables[3]->buffer(), Eq(renderables[1]->buffer()));
 }
 
 //lp: 1483779
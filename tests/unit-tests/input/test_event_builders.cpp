@@ -18,6 +18,8 @@
 
 #include "mir/events/event_builders.h"
 #include "mir/events/event_private.h" // only needed to validate motion_up/down mapping
+#include "mir/events/shared_event.h"
+#include "mir/test/expect_no_allocations.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -25,6 +27,7 @@
 #include <linux/input.h>
 
 namespace mev = mir::events;
+namespace mt = mir::test;
 using namespace ::testing;
 
 namespace
@@ -283,3 +286,57 @@ TEST_F(InputEventBuilder, when_deserialized_input_device_state_event_has_supplie
         EXPECT_THAT(mir_input_device_state_event_device_pressed_keys_for_index(ids_event, 2, i), Eq(pressed_keys[i]));
     }
 }
+
+TEST_F(InputEventBuilder, clearing_relative_motion_keeps_absolute_position)
+{
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers, mir_pointer_action_motion, 0,
+                              11.0f, 13.0f, 1.0f, 2.0f, 3.0f, 4.0f);
+
+    mev::clear_relative_motion(*ev);
+
+    auto const pev = mir_input_event_get_pointer_event(mir_event_get_input_event(ev.get()));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_x), Eq(11.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_y), Eq(13.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_x), Eq(0.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_y), Eq(0.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_hscroll), Eq(0.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_vscroll), Eq(0.0f));
+}
+
+TEST_F(InputEventBuilder, steady_state_pointer_motion_does_not_allocate)
+{
+    auto const deliver_motion = [this]
+        {
+            auto const shared = mev::share_event(
+                mev::make_event(device_id, timestamp, cookie, modifiers, mir_pointer_action_motion, 0,
+                                11.0f, 13.0f, 0.0f, 0.0f, 1.0f, 2.0f));
+
+            auto const to_deliver = mev::clone_event(*shared);
+            mev::clear_relative_motion(*to_deliver);
+            mev::transform_positions(*to_deliver, mir::geometry::Displacement{5, 7});
+        };
+
+    // The first event primes the event and control block pools
+    deliver_motion();
+
+    EXPECT_NO_ALLOCATIONS_IN(
+        for (auto i = 0; i != 100; ++i)
+            deliver_motion());
+}
+
+TEST_F(InputEventBuilder, predicted_position_defaults_to_actual_position)
+{
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers, mir_pointer_action_motion, 0,
+                              11.0f, 13.0f, 0.0f, 0.0f, 1.0f, 2.0f);
+
+    auto const pev = mir_input_event_get_pointer_event(mir_event_get_input_event(ev.get()));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_predicted_x), Eq(11.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_predicted_y), Eq(13.0f));
+
+    mev::set_predicted_position(*ev, 21.0f, 23.0f);
+    mev::transform_positions(*ev, mir::geometry::Displacement{5, 7});
+
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_x), Eq(6.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_predicted_x), Eq(16.0f));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_predicted_y), Eq(16.0f));
+}
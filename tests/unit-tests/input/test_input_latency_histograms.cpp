@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/input_latency_histograms.h"
+#include "mir/input/input_report.h"
+#include "mir/test/doubles/advanceable_clock.h"
+#include "mir/test/doubles/fake_alarm_factory.h"
+#include "mir/test/fake_shared.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mi = mir::input;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+struct MockInputReport : mi::InputReport
+{
+    MOCK_METHOD4(received_event_from_kernel, void(int64_t, int, int, int));
+    MOCK_METHOD3(published_key_event, void(int, uint32_t, int64_t));
+    MOCK_METHOD3(published_motion_event, void(int, uint32_t, int64_t));
+    MOCK_METHOD2(opened_input_device, void(char const*, char const*));
+    MOCK_METHOD2(failed_to_open_input_device, void(char const*, char const*));
+    MOCK_METHOD3(missed_input_deadline, void(int64_t, int64_t, uint64_t));
+    MOCK_METHOD5(input_stage_latency, void(char const*, uint64_t, int64_t, int64_t, int64_t));
+};
+
+struct InputLatencyHistograms : Test
+{
+    std::shared_ptr<mtd::AdvanceableClock> const clock{std::make_shared<mtd::AdvanceableClock>()};
+    std::shared_ptr<NiceMock<MockInputReport>> const report{std::make_shared<NiceMock<MockInputReport>>()};
+    mtd::FakeAlarmFactory alarm_factory;
+    std::chrono::milliseconds const report_period{1000};
+    mi::InputLatencyHistograms latency{clock, report, mt::fake_shared(alarm_factory), report_period};
+
+    std::chrono::nanoseconds now() const
+    {
+        return clock->now().time_since_epoch();
+    }
+};
+}
+
+TEST_F(InputLatencyHistograms, measures_from_the_event_time)
+{
+    auto const event_time = now();
+    clock->advance_by(2ms);
+
+    latency.event_reached(mi::InputStage::seat, event_time);
+
+    auto const seat = latency.percentiles(mi::InputStage::seat);
+    EXPECT_THAT(seat.count, Eq(1u));
+    EXPECT_THAT(seat.p50, AllOf(Ge(2ms), Le(2ms + 50us)));
+}
+
+TEST_F(InputLatencyHistograms, keeps_stages_apart)
+{
+    auto const event_time = now();
+    latency.event_reached(mi::InputStage::device, event_time);
+    clock->advance_by(5ms);
+    latency.event_reached(mi::InputStage::socket_write, event_time);
+
+    EXPECT_THAT(latency.percentiles(mi::InputStage::device).p99, Lt(1ms));
+    EXPECT_THAT(latency.percentiles(mi::InputStage::socket_write).p99, Ge(5ms));
+    EXPECT_THAT(latency.percentiles(mi::InputStage::filter_chain).count, Eq(0u));
+}
+
+TEST_F(InputLatencyHistograms, does_not_report_from_the_recording_thread)
+{
+    EXPECT_CALL(*report, input_stage_latency(_, _, _, _, _)).Times(0);
+
+    for (auto i = 0; i != 10000; ++i)
+        latency.event_reached(mi::InputStage::device, now());
+}
+
+TEST_F(InputLatencyHistograms, reports_every_stage_once_per_period_with_device_events)
+{
+    uint64_t const events{4};
+
+    for (uint64_t i = 0; i != events; ++i)
+    {
+        latency.event_reached(mi::InputStage::device, now());
+        latency.event_reached(mi::InputStage::seat, now());
+    }
+
+    EXPECT_CALL(*report, input_stage_latency(StrEq("device"), events, _, _, _));
+    EXPECT_CALL(*report, input_stage_latency(Not(StrEq("device")), _, _, _, _)).Times(4);
+
+    alarm_factory.advance_by(report_period + 1ms);
+}
+
+TEST_F(InputLatencyHistograms, stays_quiet_through_periods_without_device_events)
+{
+    latency.event_reached(mi::InputStage::device, now());
+    alarm_factory.advance_by(report_period + 1ms);
+
+    EXPECT_CALL(*report, input_stage_latency(_, _, _, _, _)).Times(0);
+
+    alarm_factory.advance_by(report_period + 1ms);
+    alarm_factory.advance_by(report_period + 1ms);
+}
@@ -59,17 +59,17 @@ struct InputPlatformProbe : ::testing::Test
 {
     InputPlatformProbe()
     {
-        ON_CALL(mock_options, is_set(StrEq(platform_input_lib))).WillByDefault(Return(false));
-        ON_CALL(mock_options, is_set(StrEq(platform_path))).WillByDefault(Return(true));
-        ON_CALL(mock_options, get(StrEq(platform_path),Matcher<char const*>(_)))
+        ON_CALL(*mock_options, is_set(StrEq(platform_input_lib))).WillByDefault(Return(false));
+        ON_CALL(*mock_options, is_set(StrEq(platform_path))).WillByDefault(Return(true));
+        ON_CALL(*mock_options, get(StrEq(platform_path),Matcher<char const*>(_)))
             .WillByDefault(Return(platform_path_value));
-        ON_CALL(mock_options, get(StrEq(platform_path)))
+        ON_CALL(*mock_options, get(StrEq(platform_path)))
             .WillByDefault(Invoke(
                     [this](char const*) -> boost::any const&
                     {
                         return platform_path_value_as_any;
                     }));
-        ON_CALL(mock_options, get(StrEq(platform_input_lib)))
+        ON_CALL(*mock_options, get(StrEq(platform_input_lib)))
             .WillByDefault(Invoke(
                     [this](char const*) -> boost::any const&
                     {
@@ -92,7 +92,8 @@ struct InputPlatformProbe : ::testing::Test
     NiceMock<mtd::MockX11> mock_x11;
 #endif
     NiceMock<mtd::MockLibInput> mock_libinput;
-    NiceMock<mtd::MockOption> mock_options;
+    // Shared, as probes that time out may outlive the test
+    std::shared_ptr<NiceMock<mtd::MockOption>> const mock_options{std::make_shared<NiceMock<mtd::MockOption>>()};
     mtd::MockInputDeviceRegistry mock_registry;
     StubEmergencyCleanupRegistry stub_emergency;
     std::shared_ptr<mir::SharedLibraryProberReport> stub_prober_report{mr::null_shared_library_prober_report()};
@@ -169,7 +170,7 @@ TEST_F(InputPlatformProbe, when_multiple_x11_platforms_are_eligible_only_one_is_
 
 TEST_F(InputPlatformProbe, x11_input_platform_not_used_when_vt_specified)
 {
-    ON_CALL(mock_options, is_set(StrEq(vt))).WillByDefault(Return(true));
+    ON_CALL(*mock_options, is_set(StrEq(vt))).WillByDefault(Return(true));
     auto platform =
         mi::probe_input_platforms(mock_options, mt::fake_shared(stub_emergency), mt::fake_shared(mock_registry),
                                   mr::null_input_report(), *stub_prober_report);
@@ -181,7 +182,7 @@ TEST_F(InputPlatformProbe, x11_input_platform_not_used_when_vt_specified)
 
 TEST_F(InputPlatformProbe, allows_forcing_stub_input_platform)
 {
-    ON_CALL(mock_options, is_set(StrEq(platform_input_lib))).WillByDefault(Return(true));
+    ON_CALL(*mock_options, is_set(StrEq(platform_input_lib))).WillByDefault(Return(true));
     platform_input_lib_value = mtf::server_input_platform("input-stub.so");
     platform_input_lib_value_as_any = platform_input_lib_value;
     auto platform =
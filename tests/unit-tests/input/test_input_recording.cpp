@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_recording.h"
+#include "mir/events/event_builders.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <xkbcommon/xkbcommon-keysyms.h>
+#include <linux/input.h>
+#include <sstream>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+struct InputRecording : Test
+{
+    std::stringstream stream;
+    mi::RecordedInputDevice const keyboard{"keyboard", "keyboard-uid", 4};
+    uint32_t const device{7};
+};
+}
+
+TEST_F(InputRecording, replays_devices_and_events_in_recorded_order)
+{
+    auto const key = mev::make_event(MirInputDeviceId{device}, 5ms, std::vector<uint8_t>{},
+                                     mir_keyboard_action_down, XKB_KEY_a, KEY_A, mir_input_event_modifier_none);
+    {
+        mi::InputRecordingWriter writer{stream};
+        writer.device_added(1ms, device, keyboard);
+        writer.event(6ms, device, *key);
+        writer.device_removed(9ms, device);
+    }
+
+    mi::InputRecordingReader reader{stream};
+    mi::InputRecord record;
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_THAT(record.type, Eq(mi::InputRecord::Type::device_added));
+    EXPECT_THAT(record.timestamp, Eq(1ms));
+    EXPECT_THAT(record.device, Eq(device));
+    EXPECT_THAT(record.info.name, Eq(keyboard.name));
+    EXPECT_THAT(record.info.unique_id, Eq(keyboard.unique_id));
+    EXPECT_THAT(record.info.capabilities, Eq(keyboard.capabilities));
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_THAT(record.type, Eq(mi::InputRecord::Type::event));
+    EXPECT_THAT(record.timestamp, Eq(6ms));
+    ASSERT_THAT(record.event, NotNull());
+    auto const keyboard_event = mir_input_event_get_keyboard_event(mir_event_get_input_event(record.event.get()));
+    EXPECT_THAT(mir_keyboard_event_action(keyboard_event), Eq(mir_keyboard_action_down));
+    EXPECT_THAT(mir_keyboard_event_key_code(keyboard_event), Eq(XKB_KEY_a));
+    EXPECT_THAT(mir_keyboard_event_scan_code(keyboard_event), Eq(KEY_A));
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_THAT(record.type, Eq(mi::InputRecord::Type::device_removed));
+    EXPECT_THAT(record.timestamp, Eq(9ms));
+
+    EXPECT_FALSE(reader.next(record));
+}
+
+TEST_F(InputRecording, rejects_streams_that_are_not_recordings)
+{
+    stream << "not an input recording";
+
+    EXPECT_THROW(mi::InputRecordingReader{stream}, std::runtime_error);
+}
+
+TEST_F(InputRecording, throws_on_truncated_record)
+{
+    {
+        mi::InputRecordingWriter writer{stream};
+        writer.device_added(1ms, device, keyboard);
+    }
+    auto const bytes = stream.str();
+    std::stringstream truncated{bytes.substr(0, bytes.size() - 3)};
+
+    mi::InputRecordingReader reader{truncated};
+    mi::InputRecord record;
+
+    EXPECT_THROW(reader.next(record), std::runtime_error);
+}
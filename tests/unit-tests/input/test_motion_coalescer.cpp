@@ -0,0 +1,211 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/motion_coalescer.h"
+#include "src/server/compositor/presentation_clock.h"
+
+#include "mir/events/event_builders.h"
+
+#include "mir/test/fake_shared.h"
+#include "mir/test/doubles/fake_alarm_factory.h"
+#include "mir/test/doubles/stub_scene_surface.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mc = mir::compositor;
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace mt = mir::test;
+namespace mtd = mt::doubles;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+struct Delivered
+{
+    MirPointerAction action;
+    float x;
+    float dx;
+    float vscroll;
+};
+
+struct RecordingSurface : mtd::StubSceneSurface
+{
+    void consume(MirEvent const* event) override
+    {
+        auto const pev = mir_input_event_get_pointer_event(mir_event_get_input_event(event));
+        delivered.push_back(Delivered{
+            mir_pointer_event_action(pev),
+            mir_pointer_event_axis_value(pev, mir_pointer_axis_x),
+            mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_x),
+            mir_pointer_event_axis_value(pev, mir_pointer_axis_vscroll)});
+    }
+
+    std::vector<Delivered> delivered;
+};
+
+struct MotionCoalescer : Test
+{
+    MotionCoalescer()
+    {
+        surface->set_motion_coalescing(mi::MotionCoalescing::per_frame);
+    }
+
+    mir::EventUPtr motion(float x, float dx, float vscroll = 0.0f)
+    {
+        return mev::make_event(device_id, 0ns, std::vector<uint8_t>{}, mir_input_event_modifier_none,
+                               mir_pointer_action_motion, 0, x, 0.0f, 0.0f, vscroll, dx, 0.0f);
+    }
+
+    mir::EventUPtr button_down(float x)
+    {
+        return mev::make_event(device_id, 0ns, std::vector<uint8_t>{}, mir_input_event_modifier_none,
+                               mir_pointer_action_button_down, mir_pointer_button_primary,
+                               x, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    MirInputDeviceId const device_id{3};
+    std::chrono::milliseconds const frame_period{16};
+    mtd::FakeAlarmFactory alarm_factory;
+    // Knows no output timing until a test schedules a frame on it
+    std::shared_ptr<mc::PresentationClock> const clock{std::make_shared<mc::PresentationClock>()};
+    std::shared_ptr<RecordingSurface> const surface{std::make_shared<RecordingSurface>()};
+    mi::MotionCoalescer coalescer{mt::fake_shared(alarm_factory), clock, frame_period};
+};
+}
+
+TEST_F(MotionCoalescer, delivers_every_event_to_surfaces_that_do_not_coalesce)
+{
+    surface->set_motion_coalescing(mi::MotionCoalescing::none);
+
+    coalescer.deliver(surface, motion(1, 1));
+    coalescer.deliver(surface, motion(2, 1));
+    coalescer.deliver(surface, motion(3, 1));
+
+    EXPECT_THAT(surface->delivered.size(), Eq(3u));
+}
+
+TEST_F(MotionCoalescer, delivers_first_motion_of_a_frame_immediately)
+{
+    coalescer.deliver(surface, motion(1, 1));
+
+    ASSERT_THAT(surface->delivered.size(), Eq(1u));
+    EXPECT_THAT(surface->delivered[0].x, Eq(1.0f));
+}
+
+TEST_F(MotionCoalescer, accumulates_motion_within_a_frame_into_one_event)
+{
+    coalescer.deliver(surface, motion(1, 1));
+    coalescer.deliver(surface, motion(3, 2, 1.0f));
+    coalescer.deliver(surface, motion(6, 3, 1.0f));
+
+    EXPECT_THAT(surface->delivered.size(), Eq(1u));
+
+    alarm_factory.advance_by(frame_period + 1ms);
+
+    ASSERT_THAT(surface->delivered.size(), Eq(2u));
+    EXPECT_THAT(surface->delivered[1].action, Eq(mir_pointer_action_motion));
+    EXPECT_THAT(surface->delivered[1].x, Eq(6.0f));
+    EXPECT_THAT(surface->delivered[1].dx, Eq(5.0f));
+    EXPECT_THAT(surface->delivered[1].vscroll, Eq(2.0f));
+}
+
+TEST_F(MotionCoalescer, frames_follow_the_output_refresh_rate)
+{
+    std::chrono::milliseconds const refresh_period{7};
+    clock->frame_scheduled(mc::FrameScheduler{refresh_period, 0ns});
+
+    coalescer.deliver(surface, motion(1, 1));
+    coalescer.deliver(surface, motion(3, 2));
+
+    alarm_factory.advance_by(refresh_period - 1ms);
+    EXPECT_THAT(surface->delivered.size(), Eq(1u));
+
+    alarm_factory.advance_by(2ms);
+    EXPECT_THAT(surface->delivered.size(), Eq(2u));
+}
+
+TEST_F(MotionCoalescer, button_change_flushes_accumulated_motion_first)
+{
+    coalescer.deliver(surface, motion(1, 1));
+    coalescer.deliver(surface, motion(3, 2));
+    coalescer.deliver(surface, button_down(3));
+
+    ASSERT_THAT(surface->delivered.size(), Eq(3u));
+    EXPECT_THAT(surface->delivered[1].action, Eq(mir_pointer_action_motion));
+    EXPECT_THAT(surface->delivered[1].x, Eq(3.0f));
+    EXPECT_THAT(surface->delivered[2].action, Eq(mir_pointer_action_button_down));
+
+    alarm_factory.advance_by(frame_period + 1ms);
+    EXPECT_THAT(surface->delivered.size(), Eq(3u));
+}
+
+TEST_F(MotionCoalescer, motion_after_a_quiet_frame_is_delivered_immediately)
+{
+    coalescer.deliver(surface, motion(1, 1));
+    alarm_factory.advance_by(frame_period + 1ms);
+
+    coalescer.deliver(surface, motion(2, 1));
+
+    EXPECT_THAT(surface->delivered.size(), Eq(2u));
+}
+
+TEST_F(MotionCoalescer, forgotten_surface_receives_nothing_further)
+{
+    coalescer.deliver(surface, motion(1, 1));
+    coalescer.deliver(surface, motion(2, 1));
+
+    coalescer.forget(surface.get());
+    alarm_factory.advance_by(frame_period + 1ms);
+
+    EXPECT_THAT(surface->delivered.size(), Eq(1u));
+}
+
+TEST_F(MotionCoalescer, keeps_every_event_for_surfaces_that_want_the_history)
+{
+    surface->set_motion_coalescing(mi::MotionCoalescing::per_frame_with_history);
+
+    coalescer.deliver(surface, motion(1, 1));
+    coalescer.deliver(surface, motion(3, 2));
+    coalescer.deliver(surface, motion(6, 3));
+
+    EXPECT_THAT(surface->delivered.size(), Eq(1u));
+
+    alarm_factory.advance_by(frame_period + 1ms);
+
+    ASSERT_THAT(surface->delivered.size(), Eq(3u));
+    EXPECT_THAT(surface->delivered[1].x, Eq(3.0f));
+    EXPECT_THAT(surface->delivered[1].dx, Eq(2.0f));
+    EXPECT_THAT(surface->delivered[2].x, Eq(6.0f));
+    EXPECT_THAT(surface->delivered[2].dx, Eq(3.0f));
+}
+
+TEST_F(MotionCoalescer, flush_delivers_held_motion_straight_away)
+{
+    coalescer.deliver(surface, motion(1, 1));
+    coalescer.deliver(surface, motion(3, 2));
+
+    coalescer.flush(surface.get());
+
+    ASSERT_THAT(surface->delivered.size(), Eq(2u));
+    EXPECT_THAT(surface->delivered[1].x, Eq(3.0f));
+
+    alarm_factory.advance_by(frame_period + 1ms);
+    EXPECT_THAT(surface->delivered.size(), Eq(2u));
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/motion_predictor.h"
+#include "src/server/compositor/presentation_clock.h"
+#include "mir/events/event_builders.h"
+
+#include "benchmarks/frame-uniformity/touch_samples.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <sstream>
+
+namespace mi = mir::input;
+namespace mc = mir::compositor;
+namespace mev = mir::events;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+struct MotionPredictor : Test
+{
+    MirInputDeviceId const device_id{3};
+    std::chrono::nanoseconds const start{1000s};
+    std::chrono::nanoseconds const max_horizon{50ms};
+
+    std::shared_ptr<mc::PresentationClock> const clock{std::make_shared<mc::PresentationClock>()};
+    mi::MotionPredictor predictor{clock, max_horizon};
+
+    mir::EventUPtr pointer_at(std::chrono::nanoseconds time, float x, float y)
+    {
+        return mev::make_event(device_id, time, std::vector<uint8_t>{}, mir_input_event_modifier_none,
+                               mir_pointer_action_motion, 0, x, y, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    mir::EventUPtr touch_at(std::chrono::nanoseconds time, MirTouchAction action, float x, float y)
+    {
+        auto ev = mev::make_event(device_id, time, std::vector<uint8_t>{}, mir_input_event_modifier_none);
+        mev::add_touch(*ev, 0, action, mir_touch_tooltype_finger, x, y, 1.0f, 1.0f, 1.0f, 1.0f);
+        return ev;
+    }
+
+    static MirPointerEvent const* pointer(mir::EventUPtr const& ev)
+    {
+        return mir_input_event_get_pointer_event(mir_event_get_input_event(ev.get()));
+    }
+
+    static MirTouchEvent const* touch(mir::EventUPtr const& ev)
+    {
+        return mir_input_event_get_touch_event(mir_event_get_input_event(ev.get()));
+    }
+};
+}
+
+TEST_F(MotionPredictor, needs_several_samples_before_predicting)
+{
+    auto first = pointer_at(start, 0, 0);
+    auto second = pointer_at(start + 8ms, 10, 0);
+
+    predictor.predict(*first, start + 24ms);
+    predictor.predict(*second, start + 24ms);
+
+    EXPECT_THAT(mir_pointer_event_axis_value(pointer(second), mir_pointer_axis_predicted_x), Eq(10.0f));
+}
+
+TEST_F(MotionPredictor, extrapolates_constant_velocity_to_presentation_time)
+{
+    for (int i = 0; i != 4; ++i)
+    {
+        auto ev = pointer_at(start + i * 8ms, 10.0f * i, 5.0f * i);
+        predictor.predict(*ev, start + 40ms);
+
+        if (i == 3)
+        {
+            EXPECT_THAT(mir_pointer_event_axis_value(pointer(ev), mir_pointer_axis_predicted_x), FloatNear(50.0f, 0.01f));
+            EXPECT_THAT(mir_pointer_event_axis_value(pointer(ev), mir_pointer_axis_predicted_y), FloatNear(25.0f, 0.01f));
+        }
+    }
+}
+
+TEST_F(MotionPredictor, limits_how_far_ahead_it_predicts)
+{
+    for (int i = 0; i != 4; ++i)
+    {
+        auto ev = pointer_at(start + i * 10ms, 10.0f * i, 0);
+        predictor.predict(*ev, start + 1s);
+
+        if (i == 3)
+        {
+            auto const limit = 30.0f + 10.0f * (max_horizon / 10ms);
+            EXPECT_THAT(mir_pointer_event_axis_value(pointer(ev), mir_pointer_axis_predicted_x), FloatNear(limit, 0.01f));
+        }
+    }
+}
+
+TEST_F(MotionPredictor, ignores_samples_from_before_a_pause)
+{
+    for (int i = 0; i != 4; ++i)
+    {
+        auto ev = pointer_at(start + i * 8ms, 10.0f * i, 0);
+        predictor.predict(*ev, start + 32ms);
+    }
+
+    auto after_pause = pointer_at(start + 1s, 30, 0);
+    predictor.predict(*after_pause, start + 1s + 16ms);
+
+    EXPECT_THAT(mir_pointer_event_axis_value(pointer(after_pause), mir_pointer_axis_predicted_x), Eq(30.0f));
+}
+
+TEST_F(MotionPredictor, touch_down_and_up_are_not_extrapolated)
+{
+    for (int i = 0; i != 4; ++i)
+    {
+        auto ev = touch_at(start + i * 8ms, i ? mir_touch_action_change : mir_touch_action_down, 10.0f * i, 0);
+        predictor.predict(*ev, start + 40ms);
+    }
+
+    auto up = touch_at(start + 32ms, mir_touch_action_up, 40, 0);
+    predictor.predict(*up, start + 48ms);
+    EXPECT_THAT(mir_touch_event_axis_value(touch(up), 0, mir_touch_axis_predicted_x), Eq(40.0f));
+
+    auto down = touch_at(start + 100ms, mir_touch_action_down, 200, 0);
+    predictor.predict(*down, start + 116ms);
+    EXPECT_THAT(mir_touch_event_axis_value(touch(down), 0, mir_touch_axis_predicted_x), Eq(200.0f));
+}
+
+TEST_F(MotionPredictor, reduces_lag_when_replaying_a_touch_samples_trace)
+{
+    using time_point = std::chrono::high_resolution_clock::time_point;
+    auto const since_start = [this](time_point t) { return t.time_since_epoch() - start; };
+    auto const at = [this](std::chrono::nanoseconds t)
+        { return time_point{std::chrono::duration_cast<time_point::duration>(start + t)}; };
+
+    // A drag across 1024px in a second, as the frame uniformity benchmark
+    // synthesizes it: events every 8ms, received with up to 1ms of jitter,
+    // and a frame every 16ms
+    auto const position_at = [](std::chrono::nanoseconds t) { return 1024.0f * t.count() / 1e9f; };
+    auto const jitter = [](int i) { return std::chrono::microseconds{((i * 7919) % 5 - 2) * 500}; };
+    auto const frame = 16ms;
+
+    // Record it with the benchmark client's TouchSamples and go through a
+    // trace, exactly as a trace saved from a benchmark run would be replayed
+    TouchSamples recording;
+    for (int i = 0; i != 125; ++i)
+    {
+        auto const received = i * 8ms + jitter(i);
+        auto ev = touch_at(start + received, mir_touch_action_change, position_at(received), position_at(received));
+        recording.record_pointer_coordinates(at(received), *ev);
+
+        if (i % 2)
+            recording.record_frame_time(at((i / 2 + 1) * frame));
+    }
+
+    std::stringstream trace;
+    TouchSamples::write_trace(trace, recording.get());
+    auto const samples = TouchSamples::read_trace(trace);
+    ASSERT_THAT(samples.size(), Eq(124u));
+
+    double lag{0}, predicted_lag{0};
+    int measured{0};
+
+    for (auto i = 0u; i != samples.size(); ++i)
+    {
+        auto const& sample = samples[i];
+        auto const event_time = since_start(sample.event_time);
+        auto const frame_time = since_start(sample.frame_time);
+
+        auto ev = touch_at(start + event_time, i ? mir_touch_action_change : mir_touch_action_down, sample.x, sample.y);
+        predictor.predict(*ev, start + frame_time);
+
+        if (i < 4)
+            continue;
+
+        auto const on_screen = position_at(frame_time);
+        lag += std::abs(on_screen - mir_touch_event_axis_value(touch(ev), 0, mir_touch_axis_x));
+        predicted_lag += std::abs(on_screen - mir_touch_event_axis_value(touch(ev), 0, mir_touch_axis_predicted_x));
+        ++measured;
+    }
+
+    EXPECT_THAT(predicted_lag / measured, Lt(lag / measured / 2));
+}
+
+TEST_F(MotionPredictor, forgets_the_trajectories_of_removed_devices)
+{
+    for (int i = 0; i != 4; ++i)
+    {
+        auto ev = pointer_at(start + i * 8ms, 10.0f * i, 0);
+        predictor.predict(*ev, start + 40ms);
+    }
+
+    predictor.forget_device(device_id);
+
+    auto after_removal = pointer_at(start + 32ms, 40, 0);
+    predictor.predict(*after_removal, start + 48ms);
+
+    EXPECT_THAT(mir_pointer_event_axis_value(pointer(after_removal), mir_pointer_axis_predicted_x), Eq(40.0f));
+}
+
+TEST_F(MotionPredictor, makes_no_prediction_without_presentation_timing)
+{
+    for (int i = 0; i != 4; ++i)
+    {
+        auto ev = pointer_at(start + i * 8ms, 10.0f * i, 0);
+        predictor.predict(*ev);
+
+        EXPECT_THAT(mir_pointer_event_axis_value(pointer(ev), mir_pointer_axis_predicted_x), Eq(10.0f * i));
+    }
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir_test_framework/replay_input_platform.h"
+#include "mir_test_framework/input_stage_timestamps.h"
+#include "src/server/input/default_event_builder.h"
+
+#include "mir/input/input_device.h"
+#include "mir/input/input_device_info.h"
+#include "mir/input/input_recording.h"
+#include "mir/input/event_filter.h"
+#include "mir/scene/surface_observer.h"
+#include "mir/events/event_builders.h"
+#include "mir/dispatch/dispatchable.h"
+#include "mir/cookie/authority.h"
+
+#include "mir/test/fake_shared.h"
+#include "mir/test/doubles/mock_input_device_registry.h"
+#include "mir/test/doubles/mock_input_sink.h"
+#include "mir/test/doubles/mock_input_seat.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <xkbcommon/xkbcommon-keysyms.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <system_error>
+
+namespace mtf = mir_test_framework;
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace md = mir::dispatch;
+namespace mt = mir::test;
+namespace mtd = mt::doubles;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+struct ReplayInputPlatform : Test
+{
+    ReplayInputPlatform()
+    {
+        char tmp_name[] = "/tmp/mir_input_recording_XXXXXX";
+        auto const fd = mkstemp(tmp_name);
+        if (fd < 0)
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary file"};
+        close(fd);
+
+        recording = tmp_name;
+    }
+
+    ~ReplayInputPlatform()
+    {
+        unlink(recording.c_str());
+    }
+
+    void record_keystroke()
+    {
+        std::ofstream file{recording, std::ios::binary};
+        mi::InputRecordingWriter writer{file};
+
+        writer.device_added(1ms, device, keyboard);
+        writer.event(2ms, device, *mev::make_event(MirInputDeviceId{device}, 2ms, std::vector<uint8_t>{},
+            mir_keyboard_action_down, XKB_KEY_a, KEY_A, mir_input_event_modifier_none));
+        writer.event(3ms, device, *mev::make_event(MirInputDeviceId{device}, 3ms, std::vector<uint8_t>{},
+            mir_keyboard_action_up, XKB_KEY_a, KEY_A, mir_input_event_modifier_none));
+        writer.device_removed(4ms, device);
+    }
+
+    // Runs what the platform queued, as the input thread would
+    bool dispatch_queued(std::chrono::milliseconds timeout)
+    {
+        auto const dispatchable = platform.dispatchable();
+        pollfd readable{dispatchable->watch_fd(), POLLIN, 0};
+
+        if (poll(&readable, 1, timeout.count()) <= 0)
+            return false;
+
+        dispatchable->dispatch(md::FdEvent::readable);
+        return true;
+    }
+
+    void start_devices_when_added()
+    {
+        ON_CALL(registry, add_device(_)).WillByDefault(Invoke(
+            [this](std::shared_ptr<mi::InputDevice> const& device)
+            {
+                device->start(&sink, &builder);
+            }));
+    }
+
+    uint32_t const device{7};
+    mi::RecordedInputDevice const keyboard{
+        "keyboard", "keyboard-uid", mi::DeviceCapabilities{mi::DeviceCapability::keyboard}.value()};
+    std::string recording;
+
+    NiceMock<mtd::MockInputSink> sink;
+    NiceMock<mtd::MockInputSeat> seat;
+    mi::DefaultEventBuilder builder{MirInputDeviceId{device}, mir::cookie::Authority::create(), mt::fake_shared(seat)};
+    NiceMock<mtd::MockInputDeviceRegistry> registry;
+
+    // Without pauses, so the whole recording is queued straight away
+    double const as_fast_as_possible{0};
+    mtf::ReplayInputPlatform platform{mt::fake_shared(registry), recording, as_fast_as_possible};
+};
+
+MATCHER_P(HasDeviceName, name, "")
+{
+    return arg->get_device_info().name == name;
+}
+}
+
+TEST_F(ReplayInputPlatform, replays_recorded_devices_and_events_through_the_device_event_builder)
+{
+    record_keystroke();
+    start_devices_when_added();
+
+    std::vector<std::shared_ptr<MirEvent>> replayed;
+    bool removed{false};
+
+    InSequence seq;
+    EXPECT_CALL(registry, add_device(HasDeviceName(keyboard.name)));
+    EXPECT_CALL(sink, handle_input(_)).Times(2).WillRepeatedly(Invoke(
+        [&](std::shared_ptr<MirEvent> const& event) { replayed.push_back(event); }));
+    EXPECT_CALL(registry, remove_device(HasDeviceName(keyboard.name))).WillOnce(Assign(&removed, true));
+
+    auto const replay_start = std::chrono::steady_clock::now().time_since_epoch();
+    platform.start();
+
+    while (!removed && dispatch_queued(5000ms))
+        ;
+
+    ASSERT_THAT(replayed.size(), Eq(2u));
+
+    auto const actions = {mir_keyboard_action_down, mir_keyboard_action_up};
+    auto event = begin(replayed);
+    for (auto const action : actions)
+    {
+        auto const input_event = mir_event_get_input_event(event->get());
+        auto const key = mir_input_event_get_keyboard_event(input_event);
+        EXPECT_THAT(mir_keyboard_event_action(key), Eq(action));
+        EXPECT_THAT(mir_keyboard_event_scan_code(key), Eq(KEY_A));
+        // Replayed events carry the replay time, not the recorded one
+        EXPECT_THAT(std::chrono::nanoseconds{mir_input_event_get_event_time(input_event)}, Ge(replay_start));
+        ++event;
+    }
+
+    platform.stop();
+}
+
+TEST_F(ReplayInputPlatform, stage_timestamps_measure_latency_from_the_replayed_event_time)
+{
+    record_keystroke();
+    start_devices_when_added();
+
+    mtf::InputStageTimestamps timestamps;
+    auto const dispatcher_probe = timestamps.dispatcher_probe();
+    auto const sent_probe = timestamps.sent_probe();
+    bool removed{false};
+
+    ON_CALL(sink, handle_input(_)).WillByDefault(Invoke(
+        [&](std::shared_ptr<MirEvent> const& event)
+        {
+            dispatcher_probe->handle(*event);
+            sent_probe->input_consumed(event.get());
+        }));
+    ON_CALL(registry, remove_device(_)).WillByDefault(Assign(&removed, true));
+
+    auto const replay_start = std::chrono::steady_clock::now();
+    platform.start();
+
+    while (!removed && dispatch_queued(5000ms))
+        ;
+
+    auto const elapsed = std::chrono::steady_clock::now() - replay_start;
+
+    for (auto const stage : {mtf::InputStageTimestamps::Stage::dispatcher, mtf::InputStageTimestamps::Stage::sent})
+    {
+        auto const summary = timestamps.summary(stage);
+        EXPECT_THAT(summary.count, Eq(2u));
+        EXPECT_THAT(summary.min.count(), Ge(0));
+        EXPECT_THAT(summary.max, Le(elapsed));
+    }
+    EXPECT_THAT(timestamps.summary(mtf::InputStageTimestamps::Stage::client_received).count, Eq(0u));
+
+    platform.stop();
+}
+
+TEST_F(ReplayInputPlatform, records_still_queued_at_stop_are_dropped)
+{
+    record_keystroke();
+    start_devices_when_added();
+
+    EXPECT_CALL(registry, add_device(_)).Times(0);
+    EXPECT_CALL(sink, handle_input(_)).Times(0);
+
+    platform.start();
+
+    // Let the replay thread queue the recording without running any of it
+    auto const dispatchable = platform.dispatchable();
+    pollfd readable{dispatchable->watch_fd(), POLLIN, 0};
+    ASSERT_THAT(poll(&readable, 1, 5000), Gt(0));
+
+    platform.stop();
+
+    while (dispatch_queued(0ms))
+        ;
+}
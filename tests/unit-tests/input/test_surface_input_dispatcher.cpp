@@ -17,16 +17,27 @@
  */
 
 #include "src/server/input/surface_input_dispatcher.h"
+#include "src/server/input/seat_input_device_tracker.h"
+#include "src/server/input/default_event_builder.h"
+#include "src/server/report/null/seat_report.h"
 
 #include "mir/events/event_builders.h"
 #include "mir/events/event_private.h"
+#include "mir/events/shared_event.h"
+#include "mir/input/xkb_mapper.h"
+#include "mir/cookie/authority.h"
 #include "mir/scene/observer.h"
 #include "mir/thread_safe_list.h"
 
 #include "mir/test/event_matchers.h"
+#include "mir/test/expect_no_allocations.h"
 #include "mir/test/fake_shared.h"
 #include "mir/test/doubles/stub_input_scene.h"
 #include "mir/test/doubles/mock_surface.h"
+#include "mir/test/doubles/mock_input_seat.h"
+#include "mir/test/doubles/stub_cursor_listener.h"
+#include "mir/test/doubles/stub_touch_visualizer.h"
+#include "mir/test/doubles/advanceable_clock.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -66,6 +77,19 @@ struct MockSurfaceWithGeometry : public mtd::MockSurface
     geom::Rectangle const geom;
 };
 
+// gmock allocates while matching calls, so consume() is counted by hand
+struct ConsumeCountingSurface : MockSurfaceWithGeometry
+{
+    using MockSurfaceWithGeometry::MockSurfaceWithGeometry;
+
+    void consume(MirEvent const*) override
+    {
+        ++consumed;
+    }
+
+    int consumed{0};
+};
+
 struct StubInputScene : public mtd::StubInputScene
 {
     std::shared_ptr<mtd::MockSurface> add_surface(geom::Rectangle const& geometry)
@@ -547,3 +571,52 @@ TEST_F(SurfaceInputDispatcher, touch_gesture_target_may_vanish_but_things_contin
     EXPECT_FALSE(dispatcher.dispatch(toucher.release_at({0, 0})));
     EXPECT_TRUE(dispatcher.dispatch(toucher.touch_at({0, 0})));
 }
+
+TEST_F(SurfaceInputDispatcher, steady_state_pointer_motion_through_the_seat_allocates_nothing)
+{
+    auto const surface = std::make_shared<ConsumeCountingSurface>(geom::Rectangle{{0, 0}, {100, 100}});
+    scene.surfaces.add(surface);
+    scene.observer->surface_added(surface.get());
+
+    MirInputDeviceId const device_id{3};
+    NiceMock<mtd::MockInputSeat> seat;
+    mi::DefaultEventBuilder builder{device_id, mir::cookie::Authority::create(), mt::fake_shared(seat)};
+    mtd::StubTouchVisualizer touch_visualizer;
+    mtd::StubCursorListener cursor_listener;
+    mi::receiver::XKBMapper key_mapper;
+    mtd::AdvanceableClock clock;
+    mir::report::null::SeatReport seat_report;
+    mi::SeatInputDeviceTracker tracker{
+        mt::fake_shared(dispatcher), mt::fake_shared(touch_visualizer), mt::fake_shared(cursor_listener),
+        mt::fake_shared(key_mapper), mt::fake_shared(clock), mt::fake_shared(seat_report)};
+
+    tracker.add_device(device_id);
+    dispatcher.start();
+
+    auto const move_by = [&](float dx)
+        {
+            tracker.dispatch(mev::share_event(
+                builder.pointer_event(std::chrono::nanoseconds{0}, mir_pointer_action_motion, 0, 0.0f, 0.0f, dx, 0.0f)));
+        };
+
+    // Entering the surface, and the first motion inside it, prime the event
+    // pools and the per-device state of the seat and the dispatcher
+    move_by(10.0f);
+    move_by(1.0f);
+
+#ifdef MIR_ALLOC_PROFILING
+    auto const dispatch_site = mt::marked_allocation_site("input.dispatch");
+    ASSERT_THAT(dispatch_site, NotNull());
+    auto const entries_before = dispatch_site->entries.load();
+#endif
+
+    EXPECT_NO_ALLOCATIONS_IN(
+        for (auto i = 0; i != 100; ++i)
+            move_by(i % 2 ? 1.0f : -1.0f));
+
+    EXPECT_THAT(surface->consumed, Eq(102));
+#ifdef MIR_ALLOC_PROFILING
+    // The motion went through the marked path, so it was checked there too
+    EXPECT_THAT(dispatch_site->entries.load() - entries_before, Ge(100u));
+#endif
+}
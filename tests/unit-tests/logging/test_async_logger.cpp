@@ -0,0 +1,233 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+#include "mir/logging/dumb_console_logger.h"
+#include "mir/log.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ml = mir::logging;
+
+using namespace testing;
+
+namespace
+{
+struct TemporaryFile
+{
+    TemporaryFile() : file{tmpfile()} {}
+    ~TemporaryFile() { fclose(file); }
+
+    int fd() const { return fileno(file); }
+
+    std::string contents() const
+    {
+        std::string result;
+        char buffer[4096];
+        ssize_t size;
+        for (off_t offset = 0; (size = pread(fd(), buffer, sizeof buffer, offset)) > 0; offset += size)
+            result.append(buffer, size);
+        return result;
+    }
+
+    FILE* const file;
+};
+
+struct AsyncLogger : Test
+{
+    TemporaryFile out;
+    TemporaryFile err;
+};
+
+std::string formatted(char const* format, ...) __attribute__ ((format (printf, 1, 2)));
+
+std::string formatted(char const* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof buffer, format, args);
+    va_end(args);
+    return buffer;
+}
+}
+
+TEST_F(AsyncLogger, writes_messages_in_console_logger_format)
+{
+    ml::AsyncLogger logger{out.fd(), err.fd(), ml::AsyncLogger::default_ring_size};
+
+    logger.log(ml::Severity::informational, "Hello", "greeter");
+    logger.log(ml::Severity::error, "Oops", "greeter");
+    logger.flush();
+
+    EXPECT_THAT(out.contents(), MatchesRegex(R"(\[[0-9-]+ [0-9:]+\.[0-9]{6}\] greeter: Hello
+)"));
+    EXPECT_THAT(err.contents(), MatchesRegex(R"(\[[0-9-]+ [0-9:]+\.[0-9]{6}\] <ERROR> greeter: Oops
+)"));
+}
+
+TEST_F(AsyncLogger, formats_captured_printf_arguments_like_printf)
+{
+    ml::AsyncLogger logger{out.fd(), err.fd(), ml::AsyncLogger::default_ring_size};
+    ml::Logger& base = logger;
+
+    char const* const format = "%d|%5.2f|%-6s|%.3s|%x|%c|%lld|%zu|%hhd|%*d|%.*s|%Le|100%%";
+
+    base.log("test", ml::Severity::informational, format,
+        -42, 3.14159, "left", "truncated", 255u, 'z', -1234567890123LL, size_t{7}, 300, 4, 9, 2, "abc", 1.5L);
+    logger.flush();
+
+    auto const expected = formatted(format,
+        -42, 3.14159, "left", "truncated", 255u, 'z', -1234567890123LL, size_t{7}, 300, 4, 9, 2, "abc", 1.5L);
+
+    EXPECT_THAT(out.contents(), EndsWith("test: " + expected + "\n"));
+}
+
+TEST_F(AsyncLogger, receives_mir_log_messages_unformatted)
+{
+    auto const logger = std::make_shared<ml::AsyncLogger>(out.fd(), err.fd(), size_t{ml::AsyncLogger::default_ring_size});
+    ml::set_logger(logger);
+
+    char name[] = "before";
+    mir::log(ml::Severity::informational, "test", "%s %d", name, 42);
+    // Arguments must be captured when logging, even though formatting is left to later
+    name[0] = 'B';
+    logger->flush();
+    ml::set_logger(std::make_shared<ml::DumbConsoleLogger>());
+
+    EXPECT_THAT(out.contents(), EndsWith("test: before 42\n"));
+}
+
+TEST_F(AsyncLogger, copies_string_arguments_when_logging)
+{
+    ml::AsyncLogger logger{out.fd(), err.fd(), ml::AsyncLogger::default_ring_size};
+
+    char name[] = "before";
+    logger.log("test", ml::Severity::informational, "name=%s", name);
+    name[0] = 'B';
+    logger.flush();
+
+    EXPECT_THAT(out.contents(), EndsWith("test: name=before\n"));
+}
+
+TEST_F(AsyncLogger, formats_unsupported_conversions_immediately)
+{
+    ml::AsyncLogger logger{out.fd(), err.fd(), ml::AsyncLogger::default_ring_size};
+
+    logger.log("test", ml::Severity::informational, "%s %ls", "hello", L"world");
+    logger.flush();
+
+    EXPECT_THAT(out.contents(), EndsWith("test: hello world\n"));
+}
+
+TEST_F(AsyncLogger, writes_critical_messages_before_returning)
+{
+    ml::AsyncLogger logger{out.fd(), err.fd(), ml::AsyncLogger::default_ring_size};
+
+    logger.log(ml::Severity::critical, "Goodbye", "test");
+
+    EXPECT_THAT(err.contents(), EndsWith("<CRITICAL> test: Goodbye\n"));
+}
+
+TEST_F(AsyncLogger, writes_outstanding_messages_on_destruction)
+{
+    {
+        ml::AsyncLogger logger{out.fd(), err.fd(), ml::AsyncLogger::default_ring_size};
+        logger.log(ml::Severity::informational, "Last words", "test");
+    }
+
+    EXPECT_THAT(out.contents(), EndsWith("test: Last words\n"));
+}
+
+TEST_F(AsyncLogger, writes_every_message_from_every_thread)
+{
+    int const threads = 4;
+    int const messages_per_thread = 200;
+
+    ml::AsyncLogger logger{out.fd(), err.fd(), ml::AsyncLogger::default_ring_size};
+
+    std::vector<std::thread> loggers;
+    for (int t = 0; t != threads; ++t)
+    {
+        loggers.emplace_back([&logger, t]
+            {
+                for (int i = 0; i != messages_per_thread; ++i)
+                {
+                    logger.log("test", ml::Severity::informational, "thread %d message %d", t, i);
+                    if (i % 50 == 0)
+                        logger.flush();
+                }
+            });
+    }
+    for (auto& thread : loggers)
+        thread.join();
+    logger.flush();
+
+    auto const contents = out.contents();
+    EXPECT_THAT(std::count(contents.begin(), contents.end(), '\n'), Eq(threads * messages_per_thread));
+    EXPECT_THAT(logger.dropped_messages(), Eq(0u));
+}
+
+TEST_F(AsyncLogger, drops_and_reports_messages_that_do_not_fit)
+{
+    int pipe_fds[2];
+    ASSERT_THAT(pipe2(pipe_fds, O_CLOEXEC), Eq(0));
+
+    // Fill the pipe, so the writer blocks on its first write and the ring can't drain
+    fcntl(pipe_fds[1], F_SETFL, O_NONBLOCK);
+    char const junk[1024]{};
+    while (write(pipe_fds[1], junk, sizeof junk) > 0)
+        ;
+    fcntl(pipe_fds[1], F_SETFL, 0);
+
+    std::string output;
+    {
+        ml::AsyncLogger logger{pipe_fds[1], err.fd(), 1024};
+
+        for (int i = 0; i != 100; ++i)
+            logger.log(ml::Severity::informational, std::string(100, 'x'), "test");
+
+        EXPECT_THAT(logger.dropped_messages(), Gt(50u));
+
+        std::thread reader{[&]
+            {
+                char buffer[4096];
+                ssize_t size;
+                while ((size = read(pipe_fds[0], buffer, sizeof buffer)) > 0)
+                    output.append(buffer, size);
+            }};
+
+        logger.flush();
+        close(pipe_fds[1]);
+        reader.join();
+        close(pipe_fds[0]);
+
+        auto const dropped = logger.dropped_messages();
+        EXPECT_THAT(std::count(output.begin(), output.end(), '\n'), Eq(100 - static_cast<long>(dropped)));
+        EXPECT_THAT(err.contents(), HasSubstr(std::to_string(dropped) + " messages dropped"));
+    }
+}
@@ -43,6 +43,8 @@ struct MockKMSOutput : public graphics::mesa::KMSOutput
     MOCK_METHOD2(configure, void(geometry::Displacement, size_t));
     MOCK_CONST_METHOD0(size, geometry::Size());
     MOCK_CONST_METHOD0(max_refresh_rate, int());
+    MOCK_CONST_METHOD0(has_variable_refresh, bool());
+    MOCK_METHOD1(set_variable_refresh, bool(bool));
 
     bool set_crtc(graphics::mesa::FBHandle const& fb) override
     {
@@ -442,6 +442,20 @@ TEST_F(MesaCursorTest, show_cursor_pads_missing_data)
     cursor.show(SinglePixelCursorImage());
 }
 
+TEST_F(MesaCursorTest, does_not_rewrite_bo_when_switching_back_to_recent_image)
+{
+    using namespace testing;
+
+    cursor.show(stub_image);
+    cursor.show(SinglePixelCursorImage());
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(0);
+    EXPECT_CALL(*output_container.outputs[0], set_cursor(_)).Times(2);
+
+    cursor.show(stub_image);
+    cursor.show(SinglePixelCursorImage());
+}
+
 TEST_F(MesaCursorTest, pads_missing_data_when_buffer_size_differs)
 {
     using namespace ::testing;
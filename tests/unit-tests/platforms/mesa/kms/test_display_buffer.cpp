@@ -231,6 +231,59 @@ TEST_F(MesaDisplayBufferTest, frames_requiring_gl_are_not_throttled)
     }
 }
 
+TEST_F(MesaDisplayBufferTest, variable_refresh_is_enabled_only_for_bypass)
+{
+    ON_CALL(*mock_kms_output, has_variable_refresh())
+        .WillByDefault(Return(true));
+    ON_CALL(*mock_kms_output, set_variable_refresh(_))
+        .WillByDefault(Return(true));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        {});
+
+    EXPECT_CALL(*mock_kms_output, set_variable_refresh(true));
+    ASSERT_TRUE(db.overlay(bypassable_list));
+    db.post();
+
+    EXPECT_TRUE(db.variable_refresh_active());
+    EXPECT_EQ(0, db.recommended_sleep().count());
+    Mock::VerifyAndClearExpectations(mock_kms_output.get());
+
+    EXPECT_CALL(*mock_kms_output, set_variable_refresh(false))
+        .WillOnce(Return(true));
+    db.make_current();
+    db.swap_buffers();
+    db.post();
+
+    EXPECT_FALSE(db.variable_refresh_active());
+}
+
+TEST_F(MesaDisplayBufferTest, variable_refresh_is_not_used_without_hardware_support)
+{
+    ON_CALL(*mock_kms_output, has_variable_refresh())
+        .WillByDefault(Return(false));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        {});
+
+    EXPECT_CALL(*mock_kms_output, set_variable_refresh(_)).Times(0);
+
+    ASSERT_TRUE(db.overlay(bypassable_list));
+    db.post();
+
+    EXPECT_FALSE(db.variable_refresh_active());
+}
+
 TEST_F(MesaDisplayBufferTest, bypass_buffer_only_referenced_once_by_db)
 {
     graphics::mesa::DisplayBuffer db(
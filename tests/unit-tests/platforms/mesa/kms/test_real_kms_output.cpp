@@ -25,7 +25,9 @@
 #include "mir/test/doubles/mock_drm.h"
 #include "mir/test/doubles/mock_gbm.h"
 
+#include <cerrno>
 #include <stdexcept>
+#include <string.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -522,3 +524,137 @@ TEST_F(RealKMSOutputTest, drm_set_gamma_failure_does_not_throw)
 
     EXPECT_NO_THROW(output.set_gamma(gamma););
 }
+
+namespace
+{
+struct FakeProperty
+{
+    FakeProperty(uint32_t id, char const* name)
+    {
+        memset(&property, 0, sizeof property);
+        property.prop_id = id;
+        strncpy(property.name, name, sizeof property.name - 1);
+    }
+
+    drmModePropertyRes property;
+};
+
+struct FakeObjectProperties
+{
+    FakeObjectProperties(std::vector<uint32_t> ids, std::vector<uint64_t> values)
+        : ids{std::move(ids)}, values{std::move(values)}
+    {
+        properties.count_props = this->ids.size();
+        properties.props = this->ids.data();
+        properties.prop_values = this->values.data();
+    }
+
+    std::vector<uint32_t> ids;
+    std::vector<uint64_t> values;
+    drmModeObjectProperties properties;
+};
+}
+
+TEST_F(RealKMSOutputTest, enables_variable_refresh_through_crtc_property)
+{
+    using namespace testing;
+
+    uint32_t const fb_id{67};
+    uint32_t const vrr_capable_id{100};
+    uint32_t const vrr_enabled_id{101};
+
+    FakeProperty vrr_capable{vrr_capable_id, "vrr_capable"};
+    FakeProperty vrr_enabled{vrr_enabled_id, "VRR_ENABLED"};
+    FakeObjectProperties connector_props{{vrr_capable_id}, {1}};
+    FakeObjectProperties crtc_props{{vrr_enabled_id}, {0}};
+
+    setup_outputs_connected_crtc();
+
+    ON_CALL(mock_drm, drmModeObjectGetProperties(_, connector_ids[0], DRM_MODE_OBJECT_CONNECTOR))
+        .WillByDefault(Return(&connector_props.properties));
+    ON_CALL(mock_drm, drmModeObjectGetProperties(_, crtc_ids[0], DRM_MODE_OBJECT_CRTC))
+        .WillByDefault(Return(&crtc_props.properties));
+    ON_CALL(mock_drm, drmModeGetProperty(_, vrr_capable_id))
+        .WillByDefault(Return(&vrr_capable.property));
+    ON_CALL(mock_drm, drmModeGetProperty(_, vrr_enabled_id))
+        .WillByDefault(Return(&vrr_enabled.property));
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(mock_page_flipper)};
+
+    EXPECT_TRUE(output.has_variable_refresh());
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+        drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, vrr_enabled_id, 1))
+        .WillOnce(Return(0));
+
+    EXPECT_TRUE(output.set_variable_refresh(true));
+    // Already enabled, so no further DRM calls
+    EXPECT_TRUE(output.set_variable_refresh(true));
+}
+
+TEST_F(RealKMSOutputTest, variable_refresh_unavailable_without_connector_support)
+{
+    using namespace testing;
+
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(mock_page_flipper)};
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(_, _, _, _, _)).Times(0);
+
+    EXPECT_FALSE(output.has_variable_refresh());
+    EXPECT_FALSE(output.set_variable_refresh(true));
+}
+
+TEST_F(RealKMSOutputTest, variable_refresh_is_withdrawn_when_crtc_properties_are_unavailable)
+{
+    using namespace testing;
+
+    uint32_t const fb_id{67};
+    uint32_t const vrr_capable_id{100};
+
+    FakeProperty vrr_capable{vrr_capable_id, "vrr_capable"};
+    FakeObjectProperties connector_props{{vrr_capable_id}, {1}};
+
+    setup_outputs_connected_crtc();
+
+    ON_CALL(mock_drm, drmModeObjectGetProperties(_, connector_ids[0], DRM_MODE_OBJECT_CONNECTOR))
+        .WillByDefault(Return(&connector_props.properties));
+    ON_CALL(mock_drm, drmModeObjectGetProperties(_, crtc_ids[0], DRM_MODE_OBJECT_CRTC))
+        .WillByDefault(DoAll(InvokeWithoutArgs([]{ errno = EINVAL; }), Return(nullptr)));
+    ON_CALL(mock_drm, drmModeGetProperty(_, vrr_capable_id))
+        .WillByDefault(Return(&vrr_capable.property));
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(mock_page_flipper)};
+
+    ASSERT_TRUE(output.has_variable_refresh());
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(_, _, _, _, _)).Times(0);
+
+    EXPECT_NO_THROW(EXPECT_FALSE(output.set_variable_refresh(true)));
+    EXPECT_FALSE(output.has_variable_refresh());
+    EXPECT_NO_THROW(output.clear_crtc());
+}
@@ -440,6 +440,15 @@ TEST_F(BasicSurfaceTest, restores_default_input_region_when_setting_empty_input_
     EXPECT_TRUE(surface.input_area_contains(rect.bottom_right() - geom::Displacement{1,1}));
 }
 
+TEST_F(BasicSurfaceTest, input_region_is_clipped_to_surface)
+{
+    auto const size = rect.size;
+    surface.set_input_region({{{0, 0}, {size.width.as_int() * 2, size.height.as_int() * 2}}});
+
+    EXPECT_TRUE(surface.input_area_contains(rect.bottom_right() - geom::Displacement{1,1}));
+    EXPECT_FALSE(surface.input_area_contains(rect.bottom_right()));
+}
+
 TEST_F(BasicSurfaceTest, disables_input_when_setting_input_region_with_empty_rectangle)
 {
     surface.set_input_region({geom::Rectangle()});
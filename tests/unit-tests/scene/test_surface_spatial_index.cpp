@@ -0,0 +1,128 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/scene/surface_spatial_index.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+struct SurfaceSpatialIndex : Test
+{
+    ms::Surface const* surface(int n)
+    {
+        return reinterpret_cast<ms::Surface const*>(&surfaces[n]);
+    }
+
+    std::vector<std::size_t> candidates_at(geom::Point const& point)
+    {
+        std::vector<std::size_t> visited;
+        index.topmost_at(point, [&](std::size_t position)
+            {
+                visited.push_back(position);
+                return false;
+            });
+        return visited;
+    }
+
+    char surfaces[8];
+    ms::SurfaceSpatialIndex index{16};
+};
+}
+
+TEST_F(SurfaceSpatialIndex, finds_nothing_when_empty)
+{
+    EXPECT_THAT(index.topmost_at({0, 0}, [](std::size_t) { return true; }),
+        Eq(ms::SurfaceSpatialIndex::npos));
+}
+
+TEST_F(SurfaceSpatialIndex, offers_surfaces_containing_point_topmost_first)
+{
+    index.insert(surface(0), 0, {{0, 0}, {100, 100}});
+    index.insert(surface(1), 1, {{50, 50}, {100, 100}});
+    index.insert(surface(2), 2, {{200, 200}, {10, 10}});
+    index.insert(surface(3), 3, {{-20, -20}, {100, 100}});
+
+    EXPECT_THAT(candidates_at({60, 60}), ElementsAre(3, 1, 0));
+    EXPECT_THAT(candidates_at({10, 10}), ElementsAre(3, 0));
+    EXPECT_THAT(candidates_at({-5, -5}), ElementsAre(3));
+    EXPECT_THAT(candidates_at({205, 205}), ElementsAre(2));
+    EXPECT_THAT(candidates_at({500, 500}), IsEmpty());
+}
+
+TEST_F(SurfaceSpatialIndex, stops_at_accepted_surface)
+{
+    index.insert(surface(0), 0, {{0, 0}, {100, 100}});
+    index.insert(surface(1), 1, {{0, 0}, {100, 100}});
+
+    EXPECT_THAT(index.topmost_at({10, 10}, [](std::size_t position) { return position == 0; }), Eq(0u));
+    EXPECT_THAT(index.topmost_at({10, 10}, [](std::size_t) { return true; }), Eq(1u));
+}
+
+TEST_F(SurfaceSpatialIndex, excludes_far_edges_of_bounds)
+{
+    index.insert(surface(0), 0, {{0, 0}, {16, 16}});
+
+    EXPECT_THAT(candidates_at({15, 15}), ElementsAre(0));
+    EXPECT_THAT(candidates_at({16, 15}), IsEmpty());
+    EXPECT_THAT(candidates_at({15, 16}), IsEmpty());
+}
+
+TEST_F(SurfaceSpatialIndex, updated_bounds_replace_old_ones)
+{
+    index.insert(surface(0), 0, {{0, 0}, {100, 100}});
+    index.insert(surface(1), 1, {{0, 0}, {10, 10}});
+
+    index.update(surface(1), {{500, 500}, {10, 10}});
+
+    EXPECT_THAT(candidates_at({5, 5}), ElementsAre(0));
+    EXPECT_THAT(candidates_at({505, 505}), ElementsAre(1));
+}
+
+TEST_F(SurfaceSpatialIndex, oversized_surfaces_interleave_by_stacking_order)
+{
+    index.insert(surface(0), 0, {{0, 0}, {10, 10}});
+    index.insert(surface(1), 1, {{-5000, -5000}, {10000, 10000}});
+    index.insert(surface(2), 2, {{0, 0}, {10, 10}});
+
+    EXPECT_THAT(candidates_at({5, 5}), ElementsAre(2, 1, 0));
+
+    index.update(surface(1), {{0, 0}, {10, 10}});
+    EXPECT_THAT(candidates_at({5, 5}), ElementsAre(2, 1, 0));
+    EXPECT_THAT(candidates_at({-100, -100}), IsEmpty());
+}
+
+TEST_F(SurfaceSpatialIndex, ignores_empty_bounds)
+{
+    index.insert(surface(0), 0, {{0, 0}, {0, 0}});
+
+    EXPECT_THAT(candidates_at({0, 0}), IsEmpty());
+}
+
+TEST_F(SurfaceSpatialIndex, clear_removes_everything)
+{
+    index.insert(surface(0), 0, {{0, 0}, {100, 100}});
+    index.clear();
+
+    EXPECT_THAT(candidates_at({5, 5}), IsEmpty());
+}
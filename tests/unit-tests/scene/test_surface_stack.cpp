@@ -79,6 +79,7 @@ struct MockSceneObserver : public ms::Observer
     MOCK_METHOD1(surface_removed, void(ms::Surface*));
     MOCK_METHOD0(surfaces_reordered, void());
     MOCK_METHOD0(scene_changed, void());
+    MOCK_METHOD1(scene_damaged, void(geom::Rectangle const&));
 
     MOCK_METHOD1(surface_exists, void(ms::Surface*));
     MOCK_METHOD0(end_observation, void());
@@ -986,6 +987,27 @@ TEST_F(SurfaceStack, returns_top_visible_surface_under_cursor)
     EXPECT_THAT(stack.surface_at(cursor_over_none).get(), IsNull());
 }
 
+TEST_F(SurfaceStack, surface_under_cursor_follows_moves_and_raises)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({100, 100});
+    stub_surface2->resize({100, 100});
+    stub_surface2->move_to({1000, 1000});
+
+    EXPECT_THAT(stack.input_surface_at({50, 50}), Eq(stub_surface1));
+
+    stub_surface2->move_to({0, 0});
+    EXPECT_THAT(stack.input_surface_at({50, 50}), Eq(stub_surface2));
+
+    stack.raise(stub_surface1);
+    EXPECT_THAT(stack.input_surface_at({50, 50}), Eq(stub_surface1));
+
+    stack.remove_surface(stub_surface1);
+    EXPECT_THAT(stack.input_surface_at({50, 50}), Eq(stub_surface2));
+}
+
 TEST_F(SurfaceStack, raise_surfaces_to_top)
 {
     stack.add_surface(stub_surface1, default_params.input_mode);
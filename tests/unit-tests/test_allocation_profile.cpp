@@ -0,0 +1,181 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/trace/allocation_profile.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <dlfcn.h>
+
+namespace mt = mir::trace;
+
+using namespace ::testing;
+
+namespace
+{
+// Sites outlive the tests: the profile report walks them at exit
+mt::AllocationSite& outer_site()
+{
+    static mt::AllocationSite site{"test.outer"};
+    return site;
+}
+
+mt::AllocationSite& inner_site()
+{
+    static mt::AllocationSite site{"test.inner"};
+    return site;
+}
+
+bool is_listed(mt::AllocationSite const& wanted)
+{
+    for (auto site = mt::allocation_sites(); site; site = site->next)
+    {
+        if (site == &wanted)
+            return true;
+    }
+
+    return false;
+}
+}
+
+TEST(AllocationProfile, no_site_is_current_outside_a_scope)
+{
+    EXPECT_THAT(mt::current_allocation_site(), IsNull());
+}
+
+TEST(AllocationProfile, scope_makes_its_site_current_and_restores_the_enclosing_one)
+{
+    {
+        mt::AllocationScope const outer{outer_site()};
+        EXPECT_THAT(mt::current_allocation_site(), Eq(&outer_site()));
+
+        {
+            mt::AllocationScope const inner{inner_site()};
+            EXPECT_THAT(mt::current_allocation_site(), Eq(&inner_site()));
+        }
+
+        EXPECT_THAT(mt::current_allocation_site(), Eq(&outer_site()));
+    }
+
+    EXPECT_THAT(mt::current_allocation_site(), IsNull());
+}
+
+TEST(AllocationProfile, scope_is_per_thread)
+{
+    mt::AllocationScope const scope{outer_site()};
+    mt::AllocationSite* seen_elsewhere{&outer_site()};
+
+    std::thread{[&] { seen_elsewhere = mt::current_allocation_site(); }}.join();
+
+    EXPECT_THAT(seen_elsewhere, IsNull());
+}
+
+TEST(AllocationProfile, counts_each_entry_to_a_site)
+{
+    auto const before = outer_site().entries.load();
+
+    for (auto i = 0; i != 3; ++i)
+        mt::AllocationScope const scope{outer_site()};
+
+    EXPECT_THAT(outer_site().entries.load(), Eq(before + 3));
+}
+
+TEST(AllocationProfile, lists_every_created_site)
+{
+    EXPECT_TRUE(is_listed(outer_site()));
+    EXPECT_TRUE(is_listed(inner_site()));
+}
+
+#ifdef MIR_ALLOC_PROFILING
+TEST(AllocationProfile, marker_opens_a_named_scope)
+{
+    MIR_ALLOC_PROFILING_SCOPE("test.marker");
+
+    ASSERT_THAT(mt::current_allocation_site(), NotNull());
+    EXPECT_THAT(mt::current_allocation_site()->name, StrEq("test.marker"));
+}
+
+TEST(AllocationProfile, charges_allocations_to_the_innermost_scope)
+{
+    auto const outer_before = outer_site().allocations.load();
+    auto const inner_before = inner_site().allocations.load();
+    auto const bytes_before = inner_site().bytes_allocated.load();
+    auto const frees_before = inner_site().deallocations.load();
+
+    {
+        mt::AllocationScope const outer{outer_site()};
+        mt::AllocationScope const inner{inner_site()};
+
+        ::operator delete(::operator new(64));
+    }
+
+    EXPECT_THAT(outer_site().allocations.load(), Eq(outer_before));
+    EXPECT_THAT(inner_site().allocations.load(), Eq(inner_before + 1));
+    EXPECT_THAT(inner_site().bytes_allocated.load(), Ge(bytes_before + 64));
+    EXPECT_THAT(inner_site().deallocations.load(), Eq(frees_before + 1));
+}
+
+// The interposed operator new only sees anything if the dynamic linker binds
+// every library's calls to it, libstdc++'s own included, rather than to the
+// one libstdc++ defines
+TEST(AllocationProfile, interposed_operator_new_wins_symbol_resolution)
+{
+    void* (*const global_new)(std::size_t) = &::operator new;
+    auto const profile_function = &mt::allocation_sites;
+
+    Dl_info new_info;
+    Dl_info profile_info;
+    ASSERT_THAT(dladdr(reinterpret_cast<void*>(global_new), &new_info), Ne(0));
+    ASSERT_THAT(dladdr(reinterpret_cast<void*>(profile_function), &profile_info), Ne(0));
+
+    EXPECT_THAT(new_info.dli_fname, StrEq(profile_info.dli_fname));
+}
+
+TEST(AllocationProfile, charges_allocations_made_inside_the_standard_library)
+{
+    auto const before = inner_site().allocations.load();
+
+    {
+        mt::AllocationScope const scope{inner_site()};
+        // Constructed out of line in libstdc++, which allocates the message
+        std::runtime_error const error{"a message long enough to need the heap"};
+    }
+
+    EXPECT_THAT(inner_site().allocations.load(), Gt(before));
+}
+
+TEST(AllocationProfile, does_not_charge_allocations_made_outside_any_scope)
+{
+    auto const before = outer_site().allocations.load();
+
+    std::make_shared<int>(42);
+
+    EXPECT_THAT(outer_site().allocations.load(), Eq(before));
+}
+#else
+TEST(AllocationProfile, marker_does_nothing_unless_profiling)
+{
+    MIR_ALLOC_PROFILING_SCOPE("test.marker");
+
+    EXPECT_THAT(mt::current_allocation_site(), IsNull());
+}
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/fnv1a_hash.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+
+TEST(Fnv1aHash, matches_the_published_test_vectors)
+{
+    mir::Fnv1aHash empty;
+    EXPECT_THAT(empty.value(), Eq(0xcbf29ce484222325ull));
+
+    mir::Fnv1aHash a;
+    a.add(std::string{"a"});
+    EXPECT_THAT(a.value(), Eq(0xaf63dc4c8601ec8cull));
+
+    mir::Fnv1aHash foobar;
+    foobar.add(std::string{"foobar"});
+    EXPECT_THAT(foobar.value(), Eq(0x85944171f73967e8ull));
+}
+
+TEST(Fnv1aHash, hashing_in_pieces_matches_hashing_at_once)
+{
+    std::string const text{"foobar"};
+
+    mir::Fnv1aHash at_once;
+    at_once.add(text);
+
+    mir::Fnv1aHash in_pieces;
+    in_pieces.add(text.data(), 3);
+    in_pieces.add(text.data() + 3, 3);
+
+    EXPECT_THAT(in_pieces.value(), Eq(at_once.value()));
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/trace/frame_timeline.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <future>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mt = mir::trace;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+std::string chrome_json_from(mt::FrameTimeline const& timeline)
+{
+    std::ostringstream out;
+    timeline.write_chrome_json(out);
+    return out.str();
+}
+
+/// Turns frame tracing off again after tests that install a timeline
+struct InstalledFrameTimeline : Test
+{
+    ~InstalledFrameTimeline()
+    {
+        mt::set_frame_timeline(nullptr);
+    }
+};
+}
+
+TEST(FrameTimeline, writes_empty_trace_when_nothing_recorded)
+{
+    mt::FrameTimeline timeline{16};
+
+    EXPECT_THAT(chrome_json_from(timeline), Eq("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n"));
+}
+
+TEST(FrameTimeline, writes_stages_as_complete_events_in_microseconds)
+{
+    mt::FrameTimeline timeline{16};
+
+    timeline.record(mt::FrameStage::render, 1234567ns, 2345678ns, 7, 0, 0);
+
+    EXPECT_THAT(chrome_json_from(timeline), HasSubstr(
+        "{\"name\":\"render\",\"cat\":\"frame\",\"ph\":\"X\",\"dur\":1111.111,\"ts\":1234.567,"));
+    EXPECT_THAT(chrome_json_from(timeline), HasSubstr("\"args\":{\"frame\":7}}"));
+}
+
+TEST(FrameTimeline, writes_instantaneous_events_with_their_correlation_ids)
+{
+    mt::FrameTimeline timeline{16};
+
+    timeline.record(mt::FrameStage::client_submit, 5000ns, 5000ns, 0, 42, 3);
+
+    EXPECT_THAT(chrome_json_from(timeline), HasSubstr(
+        "{\"name\":\"client_submit\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"t\",\"ts\":5.000,"));
+    EXPECT_THAT(chrome_json_from(timeline), HasSubstr("\"args\":{\"surface\":42,\"buffer\":3}}"));
+}
+
+TEST(FrameTimeline, names_the_threads_events_were_recorded_on)
+{
+    mt::FrameTimeline timeline{16};
+
+    long exited_tid{0};
+    std::thread{[&]
+        {
+            exited_tid = syscall(SYS_gettid);
+            timeline.record(mt::FrameStage::swap, 1000ns, 2000ns, 1, 0, 0);
+        }}.join();
+
+    std::promise<void> recorded;
+    std::promise<void> written;
+    std::thread named{[&]
+        {
+            pthread_setname_np(pthread_self(), "Test/Tracing");
+            timeline.record(mt::FrameStage::swap, 1000ns, 2000ns, 2, 0, 0);
+            recorded.set_value();
+            written.get_future().wait();
+        }};
+
+    recorded.get_future().wait();
+    auto const json = chrome_json_from(timeline);
+    written.set_value();
+    named.join();
+
+    auto const tid = std::to_string(exited_tid);
+    EXPECT_THAT(json, HasSubstr("\"args\":{\"name\":\"Test/Tracing\"}}"));
+    // A thread that has exited can only be named by its ID
+    EXPECT_THAT(json, HasSubstr("\"tid\":" + tid + ",\"args\":{\"name\":\"thread " + tid + "\"}}"));
+}
+
+TEST(FrameTimeline, keeps_only_the_most_recent_events)
+{
+    mt::FrameTimeline timeline{4};
+
+    for (uint64_t frame = 1; frame <= 10; ++frame)
+        timeline.record(mt::FrameStage::render, 1000ns, 2000ns, frame, 0, 0);
+
+    auto const json = chrome_json_from(timeline);
+
+    for (uint64_t frame = 1; frame <= 6; ++frame)
+        EXPECT_THAT(json, Not(HasSubstr("\"frame\":" + std::to_string(frame) + "}")));
+    for (uint64_t frame = 7; frame <= 10; ++frame)
+        EXPECT_THAT(json, HasSubstr("\"frame\":" + std::to_string(frame) + "}"));
+}
+
+TEST(FrameTimeline, records_from_concurrent_threads)
+{
+    int const threads = 4;
+    int const events_per_thread = 1000;
+    mt::FrameTimeline timeline{threads * events_per_thread};
+
+    std::vector<std::thread> recorders;
+    for (int t = 0; t != threads; ++t)
+    {
+        recorders.emplace_back([&]
+            {
+                for (int i = 0; i != events_per_thread; ++i)
+                    timeline.record(mt::FrameStage::scene_elements, 1000ns, 2000ns, i + 1, 0, 0);
+            });
+    }
+    for (auto& thread : recorders)
+        thread.join();
+
+    auto const json = chrome_json_from(timeline);
+    size_t events = 0;
+    for (auto pos = json.find("scene_elements"); pos != std::string::npos; pos = json.find("scene_elements", pos + 1))
+        ++events;
+
+    EXPECT_THAT(events, Eq(size_t{threads * events_per_thread}));
+}
+
+TEST_F(InstalledFrameTimeline, stage_traces_record_the_current_frame_once_installed)
+{
+    auto const timeline = std::make_shared<mt::FrameTimeline>(16);
+    mt::set_frame_timeline(timeline);
+    ASSERT_THAT(mt::frame_timeline(), Eq(timeline.get()));
+
+    mt::set_current_frame(99);
+    {
+        mt::FrameStageTrace const trace{mt::FrameStage::render};
+        std::this_thread::sleep_for(1ms);
+    }
+    mt::trace_frame_event(mt::FrameStage::buffer_release, 0, 5);
+    mt::set_current_frame(0);
+
+    auto const json = chrome_json_from(*timeline);
+    EXPECT_THAT(json, HasSubstr("{\"name\":\"render\",\"cat\":\"frame\",\"ph\":\"X\""));
+    EXPECT_THAT(json, HasSubstr("\"args\":{\"frame\":99}}"));
+    EXPECT_THAT(json, HasSubstr("\"args\":{\"frame\":99,\"buffer\":5}}"));
+}
+
+TEST_F(InstalledFrameTimeline, replaced_timelines_are_freed_once_no_thread_is_tracing_to_them)
+{
+    auto timeline = std::make_shared<mt::FrameTimeline>(16);
+    std::weak_ptr<mt::FrameTimeline> const installed{timeline};
+    mt::set_frame_timeline(timeline);
+    timeline.reset();
+
+    mt::trace_frame_event(mt::FrameStage::compositor_wake);
+    std::thread{[] { mt::trace_frame_event(mt::FrameStage::compositor_wake); }}.join();
+
+    mt::set_frame_timeline(nullptr);
+    EXPECT_FALSE(installed.expired());
+
+    mt::trace_frame_event(mt::FrameStage::compositor_wake);
+    EXPECT_TRUE(installed.expired());
+    EXPECT_THAT(mt::frame_timeline(), IsNull());
+}
+
+TEST_F(InstalledFrameTimeline, stage_traces_spanning_a_timeline_change_are_dropped)
+{
+    auto const first = std::make_shared<mt::FrameTimeline>(16);
+    auto const second = std::make_shared<mt::FrameTimeline>(16);
+    mt::set_frame_timeline(first);
+
+    {
+        mt::FrameStageTrace const trace{mt::FrameStage::render};
+        mt::set_frame_timeline(second);
+        mt::trace_frame_event(mt::FrameStage::buffer_release);
+    }
+
+    EXPECT_THAT(chrome_json_from(*first), Not(HasSubstr("render")));
+    EXPECT_THAT(chrome_json_from(*second), Not(HasSubstr("render")));
+    EXPECT_THAT(chrome_json_from(*second), HasSubstr("buffer_release"));
+}
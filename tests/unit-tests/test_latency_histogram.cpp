@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/time/latency_histogram.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+namespace mt = mir::time;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+// Values are reported as the top of their bucket, within 1/64 of what was recorded
+MATCHER_P(IsCloseTo, expected, "")
+{
+    std::chrono::nanoseconds const value{expected};
+    return arg >= value && arg <= value + value / 64;
+}
+}
+
+TEST(LatencyHistogram, is_empty_initially)
+{
+    mt::LatencyHistogram histogram;
+
+    EXPECT_THAT(histogram.count(), Eq(0u));
+    EXPECT_THAT(histogram.value_at_percentile(99.0), Eq(0ns));
+}
+
+TEST(LatencyHistogram, reports_small_values_exactly)
+{
+    mt::LatencyHistogram histogram;
+
+    histogram.record(17ns);
+
+    EXPECT_THAT(histogram.value_at_percentile(50.0), Eq(17ns));
+}
+
+TEST(LatencyHistogram, reports_percentiles_within_bucket_precision)
+{
+    mt::LatencyHistogram histogram;
+
+    for (int i = 1; i <= 1000; ++i)
+        histogram.record(i * 1us);
+
+    EXPECT_THAT(histogram.count(), Eq(1000u));
+    EXPECT_THAT(histogram.value_at_percentile(50.0), IsCloseTo(500us));
+    EXPECT_THAT(histogram.value_at_percentile(99.0), IsCloseTo(990us));
+    EXPECT_THAT(histogram.value_at_percentile(99.9), IsCloseTo(999us));
+    EXPECT_THAT(histogram.value_at_percentile(100.0), IsCloseTo(1000us));
+}
+
+TEST(LatencyHistogram, a_rare_outlier_only_shows_in_the_tail)
+{
+    mt::LatencyHistogram histogram;
+
+    for (int i = 0; i != 999; ++i)
+        histogram.record(1ms);
+    histogram.record(100ms);
+
+    EXPECT_THAT(histogram.value_at_percentile(99.0), IsCloseTo(1ms));
+    EXPECT_THAT(histogram.value_at_percentile(100.0), IsCloseTo(100ms));
+}
+
+TEST(LatencyHistogram, clamps_negative_and_huge_values)
+{
+    mt::LatencyHistogram histogram;
+
+    histogram.record(-5ns);
+    histogram.record(10h);
+
+    EXPECT_THAT(histogram.value_at_percentile(50.0), Eq(0ns));
+    EXPECT_THAT(histogram.value_at_percentile(100.0), Lt(10h));
+}
+
+TEST(LatencyHistogram, counts_concurrent_records)
+{
+    mt::LatencyHistogram histogram;
+    int const threads{4};
+    int const records_per_thread{10000};
+
+    std::vector<std::thread> recorders;
+    for (int i = 0; i != threads; ++i)
+        recorders.emplace_back([&] { for (int j = 0; j != records_per_thread; ++j) histogram.record(1ms); });
+    for (auto& recorder : recorders)
+        recorder.join();
+
+    EXPECT_THAT(histogram.count(), Eq(static_cast<uint64_t>(threads * records_per_thread)));
+}
+
+TEST(LatencyHistogram, reset_forgets_recorded_values)
+{
+    mt::LatencyHistogram histogram;
+    histogram.record(1ms);
+
+    histogram.reset();
+
+    EXPECT_THAT(histogram.count(), Eq(0u));
+}
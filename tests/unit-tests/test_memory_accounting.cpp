@@ -0,0 +1,187 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/memory/accounting.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+
+namespace mm = mir::memory;
+
+using namespace ::testing;
+
+namespace
+{
+mm::Account::Usage usage_of(mm::Accounting const& accounting, unsigned account, mm::Subsystem subsystem)
+{
+    return accounting.snapshot().at(account).usage[static_cast<unsigned>(subsystem)];
+}
+}
+
+TEST(MemoryAccounting, charges_are_returned_when_destroyed)
+{
+    mm::Accounting accounting{0, mm::QuotaAction::reject};
+    auto const account = accounting.open_account("client", 42);
+
+    {
+        auto const charge = account->charge(mm::Subsystem::shm_buffers, 4096);
+        EXPECT_THAT(charge.bytes(), Eq(4096u));
+        EXPECT_THAT(account->usage(mm::Subsystem::shm_buffers).bytes, Eq(4096u));
+        EXPECT_THAT(account->usage(mm::Subsystem::shm_buffers).allocations, Eq(1u));
+        EXPECT_THAT(account->total_bytes(), Eq(4096u));
+    }
+
+    EXPECT_THAT(account->usage(mm::Subsystem::shm_buffers).bytes, Eq(0u));
+    EXPECT_THAT(account->usage(mm::Subsystem::shm_buffers).allocations, Eq(0u));
+    EXPECT_THAT(account->total_bytes(), Eq(0u));
+}
+
+TEST(MemoryAccounting, moved_charges_are_returned_once)
+{
+    mm::Accounting accounting{0, mm::QuotaAction::reject};
+    auto const account = accounting.open_account("client", 42);
+
+    mm::Charge kept;
+    {
+        auto charge = account->charge(mm::Subsystem::textures, 100);
+        kept = std::move(charge);
+    }
+    EXPECT_THAT(account->total_bytes(), Eq(100u));
+
+    kept = account->charge(mm::Subsystem::textures, 50);
+    EXPECT_THAT(account->usage(mm::Subsystem::textures).bytes, Eq(50u));
+    EXPECT_THAT(account->usage(mm::Subsystem::textures).allocations, Eq(1u));
+}
+
+TEST(MemoryAccounting, tracks_subsystems_separately)
+{
+    mm::Accounting accounting{0, mm::QuotaAction::reject};
+    auto const account = accounting.open_account("client", 42);
+
+    auto const shm = account->charge(mm::Subsystem::shm_buffers, 10);
+    auto const hardware = account->charge(mm::Subsystem::hardware_buffers, 20);
+    auto const copy = account->charge(mm::Subsystem::wayland_shm_copies, 30);
+
+    EXPECT_THAT(usage_of(accounting, 1, mm::Subsystem::shm_buffers).bytes, Eq(10u));
+    EXPECT_THAT(usage_of(accounting, 1, mm::Subsystem::hardware_buffers).bytes, Eq(20u));
+    EXPECT_THAT(usage_of(accounting, 1, mm::Subsystem::wayland_shm_copies).bytes, Eq(30u));
+    EXPECT_THAT(usage_of(accounting, 1, mm::Subsystem::textures).bytes, Eq(0u));
+    EXPECT_THAT(accounting.snapshot().at(1).total_bytes, Eq(60u));
+}
+
+TEST(MemoryAccounting, charges_over_quota_throw_without_charging)
+{
+    mm::Accounting accounting{1000, mm::QuotaAction::reject};
+    auto const account = accounting.open_account("client", 42);
+
+    auto const first = account->charge(mm::Subsystem::shm_buffers, 600);
+    EXPECT_THROW(account->charge(mm::Subsystem::hardware_buffers, 600), mm::QuotaExceeded);
+
+    EXPECT_THAT(account->total_bytes(), Eq(600u));
+    EXPECT_THAT(account->usage(mm::Subsystem::hardware_buffers).allocations, Eq(0u));
+    EXPECT_NO_THROW(account->charge(mm::Subsystem::hardware_buffers, 400));
+}
+
+TEST(MemoryAccounting, adjusted_charges_stay_within_quota)
+{
+    mm::Accounting accounting{1000, mm::QuotaAction::reject};
+    auto const account = accounting.open_account("client", 42);
+
+    auto charge = account->charge(mm::Subsystem::shm_buffers, 600);
+    charge.adjust(400);
+    EXPECT_THAT(account->total_bytes(), Eq(400u));
+    EXPECT_THAT(account->usage(mm::Subsystem::shm_buffers).bytes, Eq(400u));
+
+    EXPECT_THROW(charge.adjust(1200), mm::QuotaExceeded);
+    EXPECT_THAT(charge.bytes(), Eq(400u));
+    EXPECT_THAT(account->total_bytes(), Eq(400u));
+
+    charge.adjust(1000);
+    EXPECT_THAT(account->total_bytes(), Eq(1000u));
+    EXPECT_THAT(account->usage(mm::Subsystem::shm_buffers).allocations, Eq(1u));
+
+    charge = mm::Charge{};
+    EXPECT_THAT(account->total_bytes(), Eq(0u));
+}
+
+TEST(MemoryAccounting, quota_applies_to_each_client_separately)
+{
+    mm::Accounting accounting{1000, mm::QuotaAction::reject};
+    auto const one = accounting.open_account("one", 1);
+    auto const two = accounting.open_account("two", 2);
+
+    auto const charge = one->charge(mm::Subsystem::shm_buffers, 1000);
+    EXPECT_NO_THROW(two->charge(mm::Subsystem::shm_buffers, 1000));
+}
+
+TEST(MemoryAccounting, server_account_is_unlimited)
+{
+    mm::Accounting accounting{1000, mm::QuotaAction::disconnect};
+
+    EXPECT_NO_THROW(accounting.server_account()->charge(mm::Subsystem::textures, 1000000));
+}
+
+TEST(MemoryAccounting, snapshot_lists_server_account_then_open_accounts)
+{
+    mm::Accounting accounting{0, mm::QuotaAction::reject};
+    auto one = accounting.open_account("one", 1);
+    auto const two = accounting.open_account("two", 2);
+
+    auto snapshot = accounting.snapshot();
+    ASSERT_THAT(snapshot.size(), Eq(3u));
+    EXPECT_THAT(snapshot[0].name, Eq("mirserver"));
+    EXPECT_THAT(snapshot[1].name, Eq("one"));
+    EXPECT_THAT(snapshot[1].pid, Eq(1));
+    EXPECT_THAT(snapshot[2].name, Eq("two"));
+
+    one.reset();
+
+    snapshot = accounting.snapshot();
+    ASSERT_THAT(snapshot.size(), Eq(2u));
+    EXPECT_THAT(snapshot[1].name, Eq("two"));
+}
+
+TEST(MemoryAccounting, charges_outliving_the_account_holder_keep_the_account_open)
+{
+    mm::Accounting accounting{0, mm::QuotaAction::reject};
+    auto account = accounting.open_account("client", 42);
+    auto const charge = account->charge(mm::Subsystem::wayland_shm_copies, 64);
+
+    account.reset();
+
+    auto const snapshot = accounting.snapshot();
+    ASSERT_THAT(snapshot.size(), Eq(2u));
+    EXPECT_THAT(snapshot[1].total_bytes, Eq(64u));
+}
+
+TEST(MemoryAccounting, report_has_a_row_per_account_and_totals)
+{
+    mm::Accounting accounting{0, mm::QuotaAction::reject};
+    auto const account = accounting.open_account("some-client", 42);
+    auto const charge = account->charge(mm::Subsystem::shm_buffers, 4096);
+
+    std::ostringstream out;
+    accounting.write_report(out);
+    auto const report = out.str();
+
+    EXPECT_THAT(report, HasSubstr("shm_buffers"));
+    EXPECT_THAT(report, HasSubstr("mirserver"));
+    EXPECT_THAT(report, HasSubstr("some-client"));
+    EXPECT_THAT(report, HasSubstr("4096/1"));
+    EXPECT_THAT(report, HasSubstr("total"));
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/metrics/registry.h"
+#include "src/server/report/metrics/openmetrics_endpoint.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace mm = mir::metrics;
+namespace mrm = mir::report::metrics;
+
+using namespace ::testing;
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+std::string openmetrics_from(mm::Registry const& registry)
+{
+    std::ostringstream out;
+    registry.write_openmetrics(out);
+    return out.str();
+}
+
+sockaddr_un address_of(std::string const& socket_path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path.c_str(), sizeof address.sun_path - 1);
+    return address;
+}
+
+std::string read_from(std::string const& socket_path)
+{
+    mir::Fd const client{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    auto const address = address_of(socket_path);
+    if (connect(client, reinterpret_cast<sockaddr const*>(&address), sizeof address) != 0)
+        throw std::runtime_error{"Failed to connect to " + socket_path};
+
+    std::string received;
+    char buffer[256];
+    for (ssize_t count; (count = read(client, buffer, sizeof buffer)) > 0;)
+        received.append(buffer, count);
+    return received;
+}
+
+struct OpenMetricsEndpoint : Test
+{
+    OpenMetricsEndpoint()
+    {
+        if (!mkdtemp(socket_dir))
+            throw std::runtime_error{"Failed to create temporary directory"};
+        socket_path = std::string{socket_dir} + "/metrics";
+    }
+
+    ~OpenMetricsEndpoint()
+    {
+        unlink(socket_path.c_str());
+        rmdir(socket_dir);
+    }
+
+    std::shared_ptr<mm::Registry> const registry{std::make_shared<mm::Registry>()};
+    char socket_dir[sizeof "/tmp/mir-metrics-XXXXXX"] = "/tmp/mir-metrics-XXXXXX";
+    std::string socket_path;
+};
+}
+
+TEST(MetricsRegistry, returns_the_same_metric_for_the_same_name_and_labels)
+{
+    mm::Registry registry;
+
+    auto& counter = registry.counter("frames", "Frames", {{"display", "0"}});
+
+    EXPECT_THAT(&registry.counter("frames", "Frames", {{"display", "0"}}), Eq(&counter));
+    EXPECT_THAT(&registry.counter("frames", "Frames", {{"display", "1"}}), Ne(&counter));
+}
+
+TEST(MetricsRegistry, rejects_reusing_a_name_for_another_type)
+{
+    mm::Registry registry;
+
+    registry.counter("frames", "Frames");
+
+    EXPECT_THROW(registry.gauge("frames", "Frames"), std::logic_error);
+}
+
+TEST(MetricsRegistry, rejects_invalid_names)
+{
+    mm::Registry registry;
+
+    EXPECT_THROW(registry.counter("0frames", "Frames"), std::invalid_argument);
+    EXPECT_THROW(registry.counter("frames", "Frames", {{"bad-label", "x"}}), std::invalid_argument);
+}
+
+TEST(MetricsRegistry, exports_counters_and_gauges)
+{
+    mm::Registry registry;
+
+    registry.counter("mir_frames", "Frames composited", {{"display", "0"}}).increment(3);
+    registry.gauge("mir_sessions", "Connected clients").set(2);
+
+    EXPECT_THAT(openmetrics_from(registry), Eq(
+        "# TYPE mir_frames counter\n"
+        "# HELP mir_frames Frames composited\n"
+        "mir_frames_total{display=\"0\"} 3\n"
+        "# TYPE mir_sessions gauge\n"
+        "# HELP mir_sessions Connected clients\n"
+        "mir_sessions 2\n"
+        "# EOF\n"));
+}
+
+TEST(MetricsRegistry, exports_histograms_as_summaries_in_seconds)
+{
+    mm::Registry registry;
+
+    registry.histogram("mir_frame_time_seconds", "Frame time").record(100ns);
+
+    EXPECT_THAT(openmetrics_from(registry), Eq(
+        "# TYPE mir_frame_time_seconds summary\n"
+        "# HELP mir_frame_time_seconds Frame time\n"
+        "mir_frame_time_seconds{quantile=\"0.5\"} 1e-07\n"
+        "mir_frame_time_seconds{quantile=\"0.9\"} 1e-07\n"
+        "mir_frame_time_seconds{quantile=\"0.99\"} 1e-07\n"
+        "mir_frame_time_seconds{quantile=\"0.999\"} 1e-07\n"
+        "mir_frame_time_seconds_count 1\n"
+        "# EOF\n"));
+}
+
+TEST(MetricsRegistry, exports_duration_gauges_in_seconds)
+{
+    mm::Registry registry;
+
+    registry.duration_gauge("mir_latency_seconds", "Latency", {{"percentile", "99"}}).set(2500000);
+
+    EXPECT_THAT(openmetrics_from(registry), Eq(
+        "# TYPE mir_latency_seconds gauge\n"
+        "# HELP mir_latency_seconds Latency\n"
+        "mir_latency_seconds{percentile=\"99\"} 0.0025\n"
+        "# EOF\n"));
+}
+
+TEST(MetricsRegistry, escapes_label_values)
+{
+    mm::Registry registry;
+
+    registry.counter("mir_errors", "Errors", {{"method", "a\"b\\c\nd"}}).increment();
+
+    EXPECT_THAT(openmetrics_from(registry), HasSubstr("mir_errors_total{method=\"a\\\"b\\\\c\\nd\"} 1\n"));
+}
+
+TEST_F(OpenMetricsEndpoint, sends_metrics_to_connecting_clients)
+{
+    registry->gauge("mir_sessions", "Connected clients").set(5);
+
+    mrm::OpenMetricsEndpoint endpoint{socket_path, registry};
+
+    EXPECT_THAT(read_from(socket_path), Eq(openmetrics_from(*registry)));
+}
+
+TEST_F(OpenMetricsEndpoint, replaces_a_socket_left_behind_by_an_earlier_server)
+{
+    {
+        mir::Fd const stale{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        auto const address = address_of(socket_path);
+        ASSERT_THAT(bind(stale, reinterpret_cast<sockaddr const*>(&address), sizeof address), Eq(0));
+    }
+
+    mrm::OpenMetricsEndpoint endpoint{socket_path, registry};
+
+    EXPECT_THAT(read_from(socket_path), Eq(openmetrics_from(*registry)));
+}
+
+TEST_F(OpenMetricsEndpoint, leaves_a_socket_in_use_alone)
+{
+    mrm::OpenMetricsEndpoint endpoint{socket_path, registry};
+
+    EXPECT_THROW((mrm::OpenMetricsEndpoint{socket_path, std::make_shared<mm::Registry>()}), std::runtime_error);
+    EXPECT_THAT(read_from(socket_path), Eq(openmetrics_from(*registry)));
+}
+
+TEST_F(OpenMetricsEndpoint, leaves_files_that_are_not_sockets_alone)
+{
+    close(open(socket_path.c_str(), O_CREAT | O_WRONLY | O_CLOEXEC, 0600));
+
+    EXPECT_THROW((mrm::OpenMetricsEndpoint{socket_path, registry}), std::runtime_error);
+
+    struct stat info;
+    ASSERT_THAT(stat(socket_path.c_str(), &info), Eq(0));
+    EXPECT_TRUE(S_ISREG(info.st_mode));
+}
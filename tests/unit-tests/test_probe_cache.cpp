@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/probe_cache.h"
+
+#include "mir_test_framework/temporary_environment_value.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
+namespace mtf = mir_test_framework;
+
+using namespace ::testing;
+
+namespace
+{
+struct ProbeCache : Test
+{
+    ProbeCache()
+    {
+        char tmp_name[] = "/tmp/mir_probe_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == nullptr)
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+
+        directory = tmp_name;
+        module = directory + "/graphics-module.so";
+        cache_file = directory + "/cache/platform-probe-cache";
+        std::ofstream{module} << "not really a module";
+    }
+
+    ~ProbeCache()
+    {
+        // Can't do anything useful in case of failure...
+        unlink(cache_file.c_str());
+        rmdir((directory + "/cache").c_str());
+        unlink(module.c_str());
+        rmdir(directory.c_str());
+    }
+
+    mir::ProbeCache::Entry entry_for(uint64_t device_set, int priority) const
+    {
+        return {module, mir::ProbeCache::mtime_of(module), device_set, priority};
+    }
+
+    std::string directory;
+    std::string module;
+    std::string cache_file;
+};
+}
+
+TEST_F(ProbeCache, finds_nothing_before_anything_is_stored)
+{
+    mir::ProbeCache const cache{cache_file};
+
+    EXPECT_FALSE(cache.lookup("graphics", 1));
+}
+
+TEST_F(ProbeCache, finds_stored_entry)
+{
+    mir::ProbeCache cache{cache_file};
+
+    cache.store("graphics", entry_for(7, 256));
+    auto const found = cache.lookup("graphics", 7);
+
+    ASSERT_TRUE(found);
+    EXPECT_THAT(found.value().module, Eq(module));
+    EXPECT_THAT(found.value().priority, Eq(256));
+}
+
+TEST_F(ProbeCache, stored_entries_survive_the_cache_object)
+{
+    mir::ProbeCache{cache_file}.store("graphics", entry_for(7, 256));
+
+    EXPECT_TRUE(mir::ProbeCache{cache_file}.lookup("graphics", 7));
+}
+
+TEST_F(ProbeCache, ignores_entry_for_other_device_set)
+{
+    mir::ProbeCache cache{cache_file};
+
+    cache.store("graphics", entry_for(7, 256));
+
+    EXPECT_FALSE(cache.lookup("graphics", 8));
+}
+
+TEST_F(ProbeCache, ignores_entry_once_module_is_modified)
+{
+    mir::ProbeCache cache{cache_file};
+    auto entry = entry_for(7, 256);
+    entry.mtime -= 1;
+
+    cache.store("graphics", entry);
+
+    EXPECT_FALSE(cache.lookup("graphics", 7));
+}
+
+TEST_F(ProbeCache, ignores_entry_once_module_is_removed)
+{
+    mir::ProbeCache cache{cache_file};
+
+    cache.store("graphics", entry_for(7, 256));
+    unlink(module.c_str());
+
+    EXPECT_FALSE(cache.lookup("graphics", 7));
+}
+
+TEST_F(ProbeCache, keeps_one_entry_per_kind)
+{
+    mir::ProbeCache cache{cache_file};
+
+    cache.store("graphics", entry_for(7, 128));
+    cache.store("other", entry_for(7, 1));
+    cache.store("graphics", entry_for(7, 256));
+
+    EXPECT_THAT(cache.lookup("graphics", 7).value().priority, Eq(256));
+    EXPECT_THAT(cache.lookup("other", 7).value().priority, Eq(1));
+}
+
+TEST_F(ProbeCache, empty_file_name_disables_cache)
+{
+    mir::ProbeCache cache{""};
+
+    cache.store("graphics", entry_for(7, 256));
+
+    EXPECT_FALSE(cache.lookup("graphics", 7));
+}
+
+TEST_F(ProbeCache, ignores_corrupt_lines)
+{
+    mir::ProbeCache cache{cache_file};
+    cache.store("graphics", entry_for(7, 256));
+
+    std::ofstream{cache_file, std::ios::app} << "garbage\n" << "graphics x y z\n";
+
+    EXPECT_TRUE(cache.lookup("graphics", 7));
+}
+
+TEST_F(ProbeCache, default_file_can_be_set_or_disabled_from_environment)
+{
+    {
+        mtf::TemporaryEnvironmentValue cache_env{"MIR_PLATFORM_PROBE_CACHE", "/somewhere/cache"};
+        EXPECT_THAT(mir::ProbeCache::default_file(), Eq("/somewhere/cache"));
+    }
+    {
+        mtf::TemporaryEnvironmentValue cache_env{"MIR_PLATFORM_PROBE_CACHE", "off"};
+        EXPECT_THAT(mir::ProbeCache::default_file(), Eq(""));
+    }
+    {
+        mtf::TemporaryEnvironmentValue cache_env{"MIR_PLATFORM_PROBE_CACHE", nullptr};
+        mtf::TemporaryEnvironmentValue xdg_env{"XDG_CACHE_HOME", "/xdg"};
+        EXPECT_THAT(mir::ProbeCache::default_file(), Eq("/xdg/mir/platform-probe-cache"));
+    }
+}
@@ -17,6 +17,7 @@
  */
 
 #include "mir/shared_library_prober.h"
+#include "mir/shared_library.h"
 
 #include "mir_test_framework/executable_path.h"
 
@@ -27,6 +28,7 @@
 #include <unordered_map>
 
 #include <system_error>
+#include <thread>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -246,3 +248,80 @@ TEST_F(SharedLibraryProber, does_not_log_failure_on_success)
     // libthis-arch should always be loadable...
     EXPECT_TRUE(probing_map.at("libthis-arch.so"));
 }
+
+TEST_F(SharedLibraryProber, parallel_probing_returns_loadable_libraries_in_order)
+{
+    using namespace testing;
+    NiceMock<MockSharedLibraryProberReport> report;
+
+    auto const this_arch = library_path + "/libthis-arch.so";
+    auto const invalid = library_path + "/libinvalid.so.3";
+
+    EXPECT_CALL(report, loading_failed(FilenameMatches(StrEq("libinvalid.so.3")), _));
+
+    auto const probed = mir::probe_libraries_in_parallel(
+        {this_arch, invalid, this_arch},
+        [](mir::SharedLibrary const&) { return 42; },
+        std::chrono::seconds{10},
+        report);
+
+    ASSERT_THAT(probed.size(), Eq(2u));
+    for (auto const& library : probed)
+    {
+        EXPECT_THAT(library.path, Eq(this_arch));
+        EXPECT_THAT(library.library, NotNull());
+        EXPECT_THAT(library.priority, Eq(42));
+    }
+}
+
+TEST_F(SharedLibraryProber, parallel_probing_reports_probe_failure)
+{
+    using namespace testing;
+    NiceMock<MockSharedLibraryProberReport> report;
+
+    auto const this_arch = library_path + "/libthis-arch.so";
+
+    EXPECT_CALL(report, loading_failed(Eq(this_arch), _));
+
+    auto const probed = mir::probe_libraries_in_parallel(
+        {this_arch},
+        [](mir::SharedLibrary const&) -> int { throw std::runtime_error{"Not this one"}; },
+        std::chrono::seconds{10},
+        report);
+
+    EXPECT_THAT(probed, IsEmpty());
+}
+
+TEST_F(SharedLibraryProber, parallel_probing_rethrows_other_probe_errors_to_the_caller)
+{
+    using namespace testing;
+    NiceMock<MockSharedLibraryProberReport> report;
+
+    auto const this_arch = library_path + "/libthis-arch.so";
+
+    EXPECT_THROW(
+        mir::probe_libraries_in_parallel(
+            {this_arch},
+            [](mir::SharedLibrary const&) -> int { throw std::logic_error{"Not a probe failure"}; },
+            std::chrono::seconds{10},
+            report),
+        std::logic_error);
+}
+
+TEST_F(SharedLibraryProber, parallel_probing_gives_up_on_slow_probes)
+{
+    using namespace testing;
+    NiceMock<MockSharedLibraryProberReport> report;
+
+    auto const this_arch = library_path + "/libthis-arch.so";
+
+    EXPECT_CALL(report, loading_failed(Eq(this_arch), _));
+
+    auto const probed = mir::probe_libraries_in_parallel(
+        {this_arch},
+        [](mir::SharedLibrary const&) { std::this_thread::sleep_for(std::chrono::milliseconds{500}); return 1; },
+        std::chrono::milliseconds{10},
+        report);
+
+    EXPECT_THAT(probed, IsEmpty());
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/thread_scheduling.h"
+
+#include <thread>
+#include <stdexcept>
+#include <sched.h>
+#include <pthread.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+
+TEST(ThreadScheduling, defaults_leave_the_thread_alone)
+{
+    auto const scheduling = mir::parse_thread_scheduling("inherit", "");
+
+    EXPECT_THAT(scheduling.policy, Eq(mir::ThreadScheduling::Policy::inherit));
+    EXPECT_THAT(scheduling.cpus, IsEmpty());
+}
+
+TEST(ThreadScheduling, parses_real_time_policies)
+{
+    auto const fifo = mir::parse_thread_scheduling("fifo:10", "");
+    auto const rr = mir::parse_thread_scheduling("rr:5", "");
+
+    EXPECT_THAT(fifo.policy, Eq(mir::ThreadScheduling::Policy::fifo));
+    EXPECT_THAT(fifo.priority, Eq(10));
+    EXPECT_THAT(rr.policy, Eq(mir::ThreadScheduling::Policy::round_robin));
+    EXPECT_THAT(rr.priority, Eq(5));
+}
+
+TEST(ThreadScheduling, parses_nice_values)
+{
+    auto const scheduling = mir::parse_thread_scheduling("nice:-5", "");
+
+    EXPECT_THAT(scheduling.policy, Eq(mir::ThreadScheduling::Policy::nice));
+    EXPECT_THAT(scheduling.priority, Eq(-5));
+}
+
+TEST(ThreadScheduling, parses_cpu_lists_and_ranges)
+{
+    auto const scheduling = mir::parse_thread_scheduling("inherit", "0,2-4,7");
+
+    EXPECT_THAT(scheduling.cpus, ElementsAre(0, 2, 3, 4, 7));
+}
+
+TEST(ThreadScheduling, rejects_malformed_options)
+{
+    EXPECT_THROW(mir::parse_thread_scheduling("fifo", ""), std::invalid_argument);
+    EXPECT_THROW(mir::parse_thread_scheduling("fifo:high", ""), std::invalid_argument);
+    EXPECT_THROW(mir::parse_thread_scheduling("fifo:1000", ""), std::invalid_argument);
+    EXPECT_THROW(mir::parse_thread_scheduling("nice:42", ""), std::invalid_argument);
+    EXPECT_THROW(mir::parse_thread_scheduling("deadline:1", ""), std::invalid_argument);
+    EXPECT_THROW(mir::parse_thread_scheduling("inherit", "3-1"), std::invalid_argument);
+    EXPECT_THROW(mir::parse_thread_scheduling("inherit", "0,,1"), std::invalid_argument);
+}
+
+TEST(ThreadScheduling, applies_affinity_to_calling_thread)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    ASSERT_THAT(pthread_getaffinity_np(pthread_self(), sizeof allowed, &allowed), Eq(0));
+
+    int first_cpu = 0;
+    while (!CPU_ISSET(first_cpu, &allowed))
+        ++first_cpu;
+
+    cpu_set_t result;
+    CPU_ZERO(&result);
+
+    std::thread{
+        [&]
+        {
+            mir::apply_thread_scheduling(mir::parse_thread_scheduling("inherit", std::to_string(first_cpu)));
+            pthread_getaffinity_np(pthread_self(), sizeof result, &result);
+        }}.join();
+
+    EXPECT_THAT(CPU_COUNT(&result), Eq(1));
+    EXPECT_TRUE(CPU_ISSET(first_cpu, &result));
+}
+
+TEST(ThreadScheduling, failure_to_get_real_time_priority_is_not_fatal)
+{
+    // Unprivileged test runs can't get SCHED_FIFO; that must only be logged
+    std::thread{
+        [&]
+        {
+            EXPECT_NO_THROW(mir::apply_thread_scheduling(mir::parse_thread_scheduling("fifo:1", "")));
+        }}.join();
+}